@@ -12,7 +12,7 @@ void pyAggregatedTask(py::module& m) {
         .def(py::init<std::shared_ptr<OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>>, const unsigned int>())
         .def(py::init<std::shared_ptr<OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>>,
              std::shared_ptr<OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>>, const unsigned int>())
-        .def("_update", &OpenSoT::tasks::Aggregated::_update)
+        .def("_update", &OpenSoT::tasks::Aggregated::_update, py::call_guard<py::gil_scoped_release>())
         .def("getOwnConstraints", &OpenSoT::tasks::Aggregated::getOwnConstraints, py::return_value_policy::reference_internal)
         .def("getAggregatedConstraints", &OpenSoT::tasks::Aggregated::getAggregatedConstraints, py::return_value_policy::reference_internal)
         .def("getTaskList", &OpenSoT::tasks::Aggregated::getTaskList, py::return_value_policy::reference_internal)
@@ -38,6 +38,6 @@ void pyAggregatedConstraint(py::module& m) {
              py::arg(), py::arg(), py::arg(), py::arg("aggregationPolicy") =
             OpenSoT::constraints::Aggregated::AggregationPolicy::EQUALITIES_TO_INEQUALITIES |
             OpenSoT::constraints::Aggregated::AggregationPolicy::UNILATERAL_TO_BILATERAL)
-        .def("update", &OpenSoT::constraints::Aggregated::update)
+        .def("update", &OpenSoT::constraints::Aggregated::update, py::call_guard<py::gil_scoped_release>())
         .def("getConstraintsList", &OpenSoT::constraints::Aggregated::getConstraintsList, py::return_value_policy::reference_internal);
 }
@@ -14,7 +14,7 @@ void pyAutostack(py::module& m) {
         .def(py::init<OpenSoT::tasks::Aggregated::TaskPtr, std::list<OpenSoT::constraints::Aggregated::ConstraintPtr>>())
         .def(py::init<OpenSoT::solvers::iHQP::Stack>())
         .def(py::init<OpenSoT::solvers::iHQP::Stack, std::list<OpenSoT::constraints::Aggregated::ConstraintPtr>>())
-        .def("update", &AutoStack::update)
+        .def("update", &AutoStack::update, py::call_guard<py::gil_scoped_release>())
         .def("log", &AutoStack::log)
         .def("checkConsistency", &AutoStack::checkConsistency)
         .def("getStack", &AutoStack::getStack)
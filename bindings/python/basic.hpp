@@ -20,6 +20,13 @@ public:
     }
 };
 
+/**
+ * Getters of matrices and vectors (getA(), getb(), getWeight(), getAineq(), ...) return read-only NumPy views
+ * over the internal buffers, without copies. A view keeps the task/constraint alive, however its content is
+ * overwritten by the next update() and it becomes invalid if the buffer is resized: use copy() to keep a snapshot.
+ *
+ * update() releases the GIL, so tasks and stacks owned by different threads can be updated in parallel.
+ */
 template<typename MatrixType, typename VectorType>
 void pyTask(py::module& m, const std::string& className) {
     py::class_<Task<MatrixType, VectorType>, std::shared_ptr<Task<MatrixType, VectorType>>, pyTaskTrampoline<MatrixType, VectorType>>(m, className.c_str())
@@ -28,14 +35,14 @@ void pyTask(py::module& m, const std::string& className) {
         .def("setWeightIsDiagonalFlag", &Task<MatrixType, VectorType>::setWeightIsDiagonalFlag)
         .def("setActive", &Task<MatrixType, VectorType>::setActive)
         .def("isActive", &Task<MatrixType, VectorType>::isActive)
-        .def("getA", &Task<MatrixType, VectorType>::getA)
+        .def("getA", &Task<MatrixType, VectorType>::getA, py::return_value_policy::reference_internal)
         .def("getHessianAtype", &Task<MatrixType, VectorType>::getHessianAtype)
-        .def("getb", &Task<MatrixType, VectorType>::getb)
-        .def("getWA", &Task<MatrixType, VectorType>::getWA)
-        .def("getATranspose", &Task<MatrixType, VectorType>::getATranspose)
-        .def("getWb", &Task<MatrixType, VectorType>::getWb)
-        .def("getc", &Task<MatrixType, VectorType>::getc)
-        .def("getWeight", &Task<MatrixType, VectorType>::getWeight)
+        .def("getb", &Task<MatrixType, VectorType>::getb, py::return_value_policy::reference_internal)
+        .def("getWA", &Task<MatrixType, VectorType>::getWA, py::return_value_policy::reference_internal)
+        .def("getATranspose", &Task<MatrixType, VectorType>::getATranspose, py::return_value_policy::reference_internal)
+        .def("getWb", &Task<MatrixType, VectorType>::getWb, py::return_value_policy::reference_internal)
+        .def("getc", &Task<MatrixType, VectorType>::getc, py::return_value_policy::reference_internal)
+        .def("getWeight", &Task<MatrixType, VectorType>::getWeight, py::return_value_policy::reference_internal)
         .def("setWeight", py::overload_cast<const MatrixType&>(&Task<MatrixType, VectorType>::setWeight))
         .def("setWeight", py::overload_cast<const double&>(&Task<MatrixType, VectorType>::setWeight))
         .def("getLambda", &Task<MatrixType, VectorType>::getLambda)
@@ -43,7 +50,7 @@ void pyTask(py::module& m, const std::string& className) {
         .def("getConstraints", &Task<MatrixType, VectorType>::getConstraints, py::return_value_policy::reference_internal)
         .def("getXSize", &Task<MatrixType, VectorType>::getXSize)
         .def("getTaskSize", &Task<MatrixType, VectorType>::getTaskSize)
-        .def("update", &Task<MatrixType, VectorType>::update)
+        .def("update", &Task<MatrixType, VectorType>::update, py::call_guard<py::gil_scoped_release>())
         .def("getTaskID", &Task<MatrixType, VectorType>::getTaskID)
         .def("getActiveJointsMask", &Task<MatrixType, VectorType>::getActiveJointsMask)
         .def("setActiveJointsMask", &Task<MatrixType, VectorType>::setActiveJointsMask)
@@ -76,13 +83,13 @@ void pyConstraint(py::module& m, const std::string& className) {
     py::class_<Constraint<MatrixType, VectorType>, std::shared_ptr<Constraint<MatrixType, VectorType>>> (m, className.c_str())
             .def(py::init<const std::string&, const unsigned int>())
             .def("getXSize", &Constraint<MatrixType, VectorType>::getXSize)
-            .def("getLowerBound", &Constraint<MatrixType, VectorType>::getLowerBound, py::return_value_policy::reference)
-            .def("getUpperBound", &Constraint<MatrixType, VectorType>::getUpperBound, py::return_value_policy::reference)
-            .def("getAeq", &Constraint<MatrixType, VectorType>::getAeq, py::return_value_policy::reference)
-            .def("getbeq", &Constraint<MatrixType, VectorType>::getbeq, py::return_value_policy::reference)
-            .def("getAineq", &Constraint<MatrixType, VectorType>::getAineq, py::return_value_policy::reference)
-            .def("getbLowerBound", &Constraint<MatrixType, VectorType>::getbLowerBound, py::return_value_policy::reference)
-            .def("getbUpperBound", &Constraint<MatrixType, VectorType>::getbUpperBound, py::return_value_policy::reference)
+            .def("getLowerBound", &Constraint<MatrixType, VectorType>::getLowerBound, py::return_value_policy::reference_internal)
+            .def("getUpperBound", &Constraint<MatrixType, VectorType>::getUpperBound, py::return_value_policy::reference_internal)
+            .def("getAeq", &Constraint<MatrixType, VectorType>::getAeq, py::return_value_policy::reference_internal)
+            .def("getbeq", &Constraint<MatrixType, VectorType>::getbeq, py::return_value_policy::reference_internal)
+            .def("getAineq", &Constraint<MatrixType, VectorType>::getAineq, py::return_value_policy::reference_internal)
+            .def("getbLowerBound", &Constraint<MatrixType, VectorType>::getbLowerBound, py::return_value_policy::reference_internal)
+            .def("getbUpperBound", &Constraint<MatrixType, VectorType>::getbUpperBound, py::return_value_policy::reference_internal)
             .def("isEqualityConstraint", &Constraint<MatrixType, VectorType>::isEqualityConstraint)
             .def("isInequalityConstraint", &Constraint<MatrixType, VectorType>::isInequalityConstraint)
             .def("isUnilateralConstraint", &Constraint<MatrixType, VectorType>::isUnilateralConstraint)
@@ -91,7 +98,7 @@ void pyConstraint(py::module& m, const std::string& className) {
             .def("isBound", &Constraint<MatrixType, VectorType>::isBound)
             .def("isConstraint", &Constraint<MatrixType, VectorType>::isConstraint)
             .def("getConstraintID", &Constraint<MatrixType, VectorType>::getConstraintID)
-            .def("update", &Constraint<MatrixType, VectorType>::update)
+            .def("update", &Constraint<MatrixType, VectorType>::update, py::call_guard<py::gil_scoped_release>())
             .def("log", &Constraint<MatrixType, VectorType>::log)
             .def("checkConsistency", &Constraint<MatrixType, VectorType>::checkConsistency)
             .def("__mod__", [](const std::shared_ptr<Constraint<MatrixType, VectorType>> constraint, const std::list<unsigned int>& rowIndices) {
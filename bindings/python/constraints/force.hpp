@@ -12,17 +12,17 @@ using namespace OpenSoT::constraints::force;
 void pyForceCoP(py::module& m) {
     py::class_<CoP, std::shared_ptr<CoP>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "CoP")
         .def(py::init<const std::string&, const AffineHelper&, XBot::ModelInterface&, const Eigen::Vector2d&, const Eigen::Vector2d&>())
-        .def("update", &CoP::update);
+        .def("update", &CoP::update, py::call_guard<py::gil_scoped_release>());
 
     py::class_<CoPs, std::shared_ptr<CoPs>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "CoPs")
         .def(py::init<const std::vector<AffineHelper>&, const std::vector<std::string>&, XBot::ModelInterface&, const std::vector<Eigen::Vector2d>&, const std::vector<Eigen::Vector2d>&>())
-        .def("update", &CoPs::update);
+        .def("update", &CoPs::update, py::call_guard<py::gil_scoped_release>());
 }
 
 void pyForceFrictionCone(py::module& m) {
     py::class_<FrictionCone, std::shared_ptr<FrictionCone>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "FrictionCone")
         .def(py::init<const std::string&, const AffineHelper&, XBot::ModelInterface&, const std::pair<Eigen::Matrix3d, double>&>())
-        .def("update", &FrictionCone::update)
+        .def("update", &FrictionCone::update, py::call_guard<py::gil_scoped_release>())
         .def("setFrictionCone", &FrictionCone::setFrictionCone)
         .def("setMu", &FrictionCone::setMu)
         .def("setContactRotationMatrix", &FrictionCone::setContactRotationMatrix);
@@ -30,19 +30,19 @@ void pyForceFrictionCone(py::module& m) {
     py::class_<FrictionCones, std::shared_ptr<FrictionCones>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "FrictionCones")
         .def(py::init<const std::vector<std::string>&, const std::vector<AffineHelper>&, XBot::ModelInterface&, const FrictionCones::friction_cones&>())
         .def("getFrictionCone", &FrictionCones::getFrictionCone)
-        .def("update", &FrictionCones::update);
+        .def("update", &FrictionCones::update, py::call_guard<py::gil_scoped_release>());
 }
 
 void pyForceNormalTorque(py::module& m) {
     py::class_<NormalTorque, std::shared_ptr<NormalTorque>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "NormalTorque")
         .def(py::init<const std::string&, const AffineHelper&, XBot::ModelInterface&, const Eigen::Vector2d&, const Eigen::Vector2d&, const double&>())
-        .def("update", &NormalTorque::update)
+        .def("update", &NormalTorque::update, py::call_guard<py::gil_scoped_release>())
         .def("setMu", &NormalTorque::setMu);
 
     py::class_<NormalTorques, std::shared_ptr<NormalTorques>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "NormalTorques")
         .def(py::init<const std::vector<std::string>&, const std::vector<AffineHelper>&, XBot::ModelInterface&, const std::vector<Eigen::Vector2d>&, const std::vector<Eigen::Vector2d>&, const std::vector<double>&>())
         .def("getNormalTorque", &NormalTorques::getNormalTorque)
-        .def("update", &NormalTorques::update);
+        .def("update", &NormalTorques::update, py::call_guard<py::gil_scoped_release>());
 }
 
 std::tuple<Eigen::VectorXd, Eigen::VectorXd> get_wrench_limits(const WrenchLimits& wlims)
@@ -65,5 +65,5 @@ void pyWrenchLimits(py::module& m) {
         .def(py::init<const std::vector<std::string>&, const std::vector<Eigen::VectorXd>&, const std::vector<Eigen::VectorXd>&, const std::vector<AffineHelper>&>())
         .def(py::init<const std::map<std::string, WrenchLimits::Ptr>&, const std::vector<AffineHelper>&>())
         .def("getWrenchLimits", &WrenchesLimits::getWrenchLimits)
-        .def("update", &WrenchesLimits::update);
+        .def("update", &WrenchesLimits::update, py::call_guard<py::gil_scoped_release>());
 }
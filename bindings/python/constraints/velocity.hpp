@@ -12,7 +12,7 @@ void pyVelocityJointLimits(py::module& m) {
     py::class_<JointLimits, std::shared_ptr<JointLimits>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "JointLimits")
         .def(py::init<const XBot::ModelInterface&, const Eigen::VectorXd&, const Eigen::VectorXd&, const double>(),
              py::arg(), py::arg(), py::arg(), py::arg("boundScaling") = 1.)
-        .def("update", &JointLimits::update)
+        .def("update", &JointLimits::update, py::call_guard<py::gil_scoped_release>())
         .def("setBoundScaling", &JointLimits::setBoundScaling);
 }
 
@@ -24,13 +24,13 @@ void pyVelocityLimits(py::module& m) {
         .def("setVelocityLimits", py::overload_cast<const double>(&VelocityLimits::setVelocityLimits))
         .def("setVelocityLimits", py::overload_cast<const Eigen::VectorXd&>(&VelocityLimits::setVelocityLimits))
         .def("getDT", &VelocityLimits::getDT)
-        .def("update", &VelocityLimits::update);
+        .def("update", &VelocityLimits::update, py::call_guard<py::gil_scoped_release>());
 }
 
 void pyVelocityOmniWheels4X(py::module& m) {
     py::class_<OmniWheels4X, std::shared_ptr<OmniWheels4X>, OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>>(m, "OmniWheels4X")
         .def(py::init<const double, const double, const double, const std::vector<std::string>, const std::string, XBot::ModelInterface&>())
-        .def("update", &OmniWheels4X::update)
+        .def("update", &OmniWheels4X::update, py::call_guard<py::gil_scoped_release>())
         .def("setIsGlobalVelocity", &OmniWheels4X::setIsGlobalVelocity)
         .def("getIsGlobalVelocity", &OmniWheels4X::getIsGlobalVelocity);
 
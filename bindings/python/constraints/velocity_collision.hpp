@@ -15,7 +15,7 @@ void pyVelocityCollisionAvoidance(py::module& m) {
         .def("getDetectionThreshold", &CollisionAvoidance::getDetectionThreshold)
         .def("setLinkPairThreshold", &CollisionAvoidance::setLinkPairThreshold)
         .def("setDetectionThreshold", &CollisionAvoidance::setDetectionThreshold)
-        .def("update", &CollisionAvoidance::update)
+        .def("update", &CollisionAvoidance::update, py::call_guard<py::gil_scoped_release>())
         .def("setMaxPairs", &CollisionAvoidance::setMaxPairs)
         .def("setCollisionList", &CollisionAvoidance::setCollisionList)
         .def("collisionModelUpdated", &CollisionAvoidance::collisionModelUpdated)
@@ -27,5 +27,7 @@ void pyVelocityCollisionAvoidance(py::module& m) {
         .def("getOrderedWitnessPointVector", &CollisionAvoidance::getOrderedWitnessPointVector)
         .def("getOrderedLinkPairVector", &CollisionAvoidance::getOrderedLinkPairVector)
         .def("getOrderedDistanceVector", &CollisionAvoidance::getOrderedDistanceVector)
-        .def("getCollisionJacobian", &CollisionAvoidance::getCollisionJacobian);
+        .def("getCollisionJacobian", &CollisionAvoidance::getCollisionJacobian)
+        .def("setCapsuleFastPath", &CollisionAvoidance::setCapsuleFastPath, py::arg("enable"), py::arg("fit_from_urdf") = true)
+        .def("isCapsuleFastPathEnabled", &CollisionAvoidance::isCapsuleFastPathEnabled);
 }
@@ -20,7 +20,7 @@ void pyGenericConstraint(py::module& m) {
         .def(py::init<std::string, const AffineHelper&, const Eigen::VectorXd&, const Eigen::VectorXd&, GenericConstraint::Type>())
         .def("setConstraint", &GenericConstraint::setConstraint)
         .def("setBounds", &GenericConstraint::setBounds)
-        .def("update", &GenericConstraint::update)
+        .def("update", &GenericConstraint::update, py::call_guard<py::gil_scoped_release>())
         .def("getType", &GenericConstraint::getType);
 }
 
@@ -5,6 +5,7 @@
 #include "sub.hpp"
 #include "autostack.hpp"
 #include "solver.hpp"
+#include "rollout.hpp"
 #include "tasks/velocity.hpp"
 #include "tasks/acceleration.hpp"
 #include "constraints/velocity.hpp"
@@ -25,10 +26,13 @@ PYBIND11_MODULE(pyopensot, m) {
     pyAutostack(m);
 
     pySolver<Eigen::MatrixXd, Eigen::VectorXd>(m, "Solver");
+    pyBackEnd(m);
     pyeHQP(m);
     pyiHQP(m);
     pynHQP(m);
 
+    pyRollout(m);
+
     auto m_t = m.def_submodule("tasks");
 
     auto m_tv = m_t.def_submodule("velocity");
@@ -0,0 +1,52 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include <pybind11/stl.h>
+#include <OpenSoT/utils/Rollout.h>
+
+namespace py = pybind11;
+using OpenSoT::utils::Rollout;
+
+/**
+ * Runs the rollout with the GIL released, the trajectories are moved into NumPy arrays without copies
+ */
+py::dict rollout_run(Rollout& rollout, const Eigen::VectorXd& q0, const int steps, const Eigen::VectorXd& qdot0)
+{
+    Rollout::Result result;
+    bool success;
+    {
+        py::gil_scoped_release release;
+        success = rollout.run(q0, qdot0, steps, result);
+    }
+    if(!success)
+        throw std::invalid_argument("Rollout: wrong initial state, number of steps or references");
+
+    py::dict trajectories;
+    trajectories["q"] = py::cast(std::move(result.q));
+    trajectories["qdot"] = py::cast(std::move(result.qdot));
+    trajectories["solutions"] = py::cast(std::move(result.solutions));
+    trajectories["success"] = py::cast(std::move(result.success));
+    trajectories["solve_time"] = py::cast(std::move(result.solve_time));
+    return trajectories;
+}
+
+void pyRollout(py::module& m) {
+    py::class_<Rollout, std::shared_ptr<Rollout>> rollout(m, "Rollout");
+
+    py::enum_<Rollout::Integration>(rollout, "Integration")
+        .value("DISPLACEMENT", Rollout::Integration::DISPLACEMENT)
+        .value("VELOCITY", Rollout::Integration::VELOCITY)
+        .value("ACCELERATION", Rollout::Integration::ACCELERATION)
+        .export_values();
+
+    rollout
+        .def(py::init<XBot::ModelInterface&, OpenSoT::AutoStack::Ptr, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::SolverPtr,
+             const Rollout::Integration, const double>(),
+             py::arg("model"), py::arg("stack"), py::arg("solver"),
+             py::arg("integration") = Rollout::Integration::DISPLACEMENT, py::arg("dt") = 0.01,
+             py::keep_alive<1, 2>())
+        .def("setReference", py::overload_cast<OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr, const Eigen::MatrixXd&>(&Rollout::setReference))
+        .def("setReference", py::overload_cast<const std::string&, const Eigen::MatrixXd&>(&Rollout::setReference))
+        .def("clearReferences", &Rollout::clearReferences)
+        .def("setJointVariable", &Rollout::setJointVariable)
+        .def("run", rollout_run, py::arg("q0"), py::arg("steps"), py::arg("qdot0") = Eigen::VectorXd());
+}
@@ -21,14 +21,45 @@ public:
     }
 };
 
+/**
+ * Solving releases the GIL: solvers owned by different threads can run in parallel
+ */
 template<typename MatrixType, typename VectorType>
 VectorType solve(Solver<MatrixType, VectorType>& solver)
 {
     VectorType solution;
+    py::gil_scoped_release release;
     solver.solve(solution);
     return solution;
 }
 
+/**
+ * @brief solveInPlace writes the solution into a preallocated float64 NumPy array (solve(out=x)),
+ * avoiding the allocation of a new array at each call.
+ * NOTE: the solution is computed in a buffer of the calling thread and then copied into out. The buffer is
+ * reallocated when the solver has a different number of variables than the one solved before by the same thread
+ * @return the result of Solver::solve()
+ */
+template<typename MatrixType, typename VectorType>
+bool solveInPlace(Solver<MatrixType, VectorType>& solver, Eigen::Ref<VectorType> out)
+{
+    // Solver::solve() needs a resizable vector: the buffer is reused between calls of the same thread,
+    // it is reallocated only when its size changes
+    static thread_local VectorType solution;
+
+    bool success;
+    {
+        py::gil_scoped_release release;
+        success = solver.solve(solution);
+    }
+
+    if(solution.size() != out.size())
+        throw py::value_error("solve: out has size " + std::to_string(out.size()) +
+                              ", solution has size " + std::to_string(solution.size()));
+    out = solution;
+    return success;
+}
+
 
 template<typename MatrixType, typename VectorType>
 void pySolver(py::module& m, const std::string& className) {
@@ -48,15 +79,37 @@ void pySolver(py::module& m, const std::string& className) {
         .def(py::init<std::vector<typename Solver<MatrixType, VectorType>::TaskPtr>&, typename Solver<MatrixType, VectorType>::ConstraintPtr>())
         .def(py::init<std::vector<typename Solver<MatrixType, VectorType>::TaskPtr>&, typename Solver<MatrixType, VectorType>::ConstraintPtr, typename Solver<MatrixType, VectorType>::ConstraintPtr>())
         .def("solve", solve<MatrixType, VectorType>)
+        .def("solve", solveInPlace<MatrixType, VectorType>, py::arg("out").noconvert())
         .def("getSolverID", &Solver<MatrixType, VectorType>::getSolverID)
         .def("setSolverID", &Solver<MatrixType, VectorType>::setSolverID)
         .def("log", &Solver<MatrixType, VectorType>::log);
 }
 
+/**
+ * Getters of the QP matrices return read-only NumPy views over the back-end buffers, see pyTask()
+ */
+void pyBackEnd(py::module& m) {
+    py::class_<solvers::BackEnd, std::shared_ptr<solvers::BackEnd>>(m, "BackEnd")
+        .def("getSolution", &solvers::BackEnd::getSolution, py::return_value_policy::reference_internal)
+        .def("getH", &solvers::BackEnd::getH, py::return_value_policy::reference_internal)
+        .def("getg", &solvers::BackEnd::getg, py::return_value_policy::reference_internal)
+        .def("getA", &solvers::BackEnd::getA, py::return_value_policy::reference_internal)
+        .def("getlA", &solvers::BackEnd::getlA, py::return_value_policy::reference_internal)
+        .def("getuA", &solvers::BackEnd::getuA, py::return_value_policy::reference_internal)
+        .def("getl", &solvers::BackEnd::getl, py::return_value_policy::reference_internal)
+        .def("getu", &solvers::BackEnd::getu, py::return_value_policy::reference_internal)
+        .def("getNumVariables", &solvers::BackEnd::getNumVariables)
+        .def("getNumConstraints", &solvers::BackEnd::getNumConstraints)
+        .def("getObjective", &solvers::BackEnd::getObjective)
+        .def("getEpsRegularisation", &solvers::BackEnd::getEpsRegularisation)
+        .def("setEpsRegularisation", &solvers::BackEnd::setEpsRegularisation);
+}
+
 void pyeHQP(py::module& m) {
     py::class_<solvers::eHQP, std::shared_ptr<solvers::eHQP>, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>>(m, "eHQP")
         .def(py::init<OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::Stack&>())
         .def("solve", solve<Eigen::MatrixXd, Eigen::VectorXd>)
+        .def("solve", solveInPlace<Eigen::MatrixXd, Eigen::VectorXd>, py::arg("out").noconvert())
         .def("getSigmaMin", &solvers::eHQP::getSigmaMin)
         .def("setSigmaMin", &solvers::eHQP::setSigmaMin);
 }
@@ -76,6 +129,7 @@ void pyiHQP(py::module& m) {
              py::arg(), py::arg(), py::arg(), py::arg("eps_regularisation") = DEFAULT_EPS_REGULARISATION, py::arg("be_solver") = OpenSoT::solvers::solver_back_ends::qpOASES)
         .def(py::init<OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::Stack&, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr, double, std::vector<OpenSoT::solvers::solver_back_ends>>())
         .def("solve", solve<Eigen::MatrixXd, Eigen::VectorXd>)
+        .def("solve", solveInPlace<Eigen::MatrixXd, Eigen::VectorXd>, py::arg("out").noconvert())
         .def("getNumberOfTasks", &solvers::iHQP::getNumberOfTasks)
         //.def("setOptions", &solvers::iHQP::setOptions) //TODO!
         //.def("getOptions", &solvers::iHQP::getOptions) //TODO!
@@ -85,7 +139,10 @@ void pyiHQP(py::module& m) {
         .def("getBackEndName", &solvers::iHQP::getBackEndName)
         .def("setEpsRegularisation", py::overload_cast<const double, const unsigned int>(&solvers::iHQP::setEpsRegularisation))
         .def("setEpsRegularisation", py::overload_cast<const double>(&solvers::iHQP::setEpsRegularisation))
-        .def("getBackEnd", &solvers::iHQP::getBackEnd);
+        .def("getBackEnd", [](solvers::iHQP& solver, const unsigned int i) {
+            solvers::BackEnd::Ptr back_end;
+            solver.getBackEnd(i, back_end);
+            return back_end;});
 }
 
 void pynHQP(py::module& m) {
@@ -93,6 +150,7 @@ void pynHQP(py::module& m) {
        .def(py::init<OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::Stack&, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr, double, OpenSoT::solvers::solver_back_ends>(),
             py::arg(), py::arg(), py::arg(), py::arg("be_solver") = OpenSoT::solvers::solver_back_ends::qpOASES)
        .def("solve", solve<Eigen::MatrixXd, Eigen::VectorXd>)
+       .def("solve", solveInPlace<Eigen::MatrixXd, Eigen::VectorXd>, py::arg("out").noconvert())
        .def("setMinSingularValueRatio", py::overload_cast<double>(&solvers::nHQP::setMinSingularValueRatio))
        .def("setMinSingularValueRatio", py::overload_cast<std::vector<double>>(&solvers::nHQP::setMinSingularValueRatio))
        .def("setPerformAbRegularization", py::overload_cast<int, bool>(&solvers::nHQP::setPerformAbRegularization))
@@ -22,18 +22,40 @@ template<typename MatrixType, typename VectorType>
 VectorType solve(Solver<MatrixType, VectorType>& solver)
 {
     VectorType solution;
+    py::gil_scoped_release release;
     solver.solve(solution);
     return solution;
 }
 
+template<typename MatrixType, typename VectorType>
+bool solveInPlace(Solver<MatrixType, VectorType>& solver, Eigen::Ref<VectorType> out)
+{
+    static thread_local VectorType solution;
+
+    bool success;
+    {
+        py::gil_scoped_release release;
+        success = solver.solve(solution);
+    }
+
+    if(solution.size() != out.size())
+        throw py::value_error("solve: out has size " + std::to_string(out.size()) +
+                              ", solution has size " + std::to_string(solution.size()));
+    out = solution;
+    return success;
+}
+
 
 void pyHCOD(py::module& m) {
     py::class_<solvers::HCOD, std::shared_ptr<solvers::HCOD>, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>>(m, "HCOD")
     .def(py::init<OpenSoT::AutoStack&, const double>())
         .def(py::init<OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::Stack&, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr, const double>())
         .def("solve", solve<Eigen::MatrixXd, Eigen::VectorXd>)
+        .def("solve", solveInPlace<Eigen::MatrixXd, Eigen::VectorXd>, py::arg("out").noconvert())
         .def("setDisableWeightsComputation", &solvers::HCOD::setDisableWeightsComputation)
         .def("getDisableWeightsComputation", &solvers::HCOD::getDisableWeightsComputation)
         .def("setDamping", &solvers::HCOD::setDamping)
+        .def("setActiveSetWarmStart", &solvers::HCOD::setActiveSetWarmStart)
+        .def("getActiveSetWarmStart", &solvers::HCOD::getActiveSetWarmStart)
         .def("printSOT", &solvers::HCOD::printSOT);
 }
@@ -0,0 +1,56 @@
+from xbot2_interface import pyxbot2_interface as xbi
+from pyopensot.tasks.velocity import Postural, Cartesian
+from pyopensot.constraints.velocity import JointLimits
+import pyopensot as pysot
+import numpy as np
+import unittest
+import os
+import time
+
+urdf_path = os.getcwd() + '/panda.urdf'
+urdf = open(urdf_path, 'r').read()
+model = xbi.ModelInterface2(urdf)
+
+q = np.array([0., -0.7, 0., -2.1, 0., 1.4, 0.])
+model.setJointPosition(q)
+model.update()
+
+qmin, qmax = model.getJointLimits()
+qlims = JointLimits(model, qmax, qmin)
+
+p = Postural(model)
+c = Cartesian("Cartesian", model, "panda_link8", "world")
+c.setLambda(0.1)
+
+s = ((c%[0,1,2]) / (c%[3,4,5]) / p) << qlims
+s.update()
+
+solver = pysot.iHQP(s)
+
+# circular reference trajectory for the Cartesian task, one pose (x y z qx qy qz qw) per row
+steps = 1000
+pose = c.getActualPose()
+t = np.linspace(0., 2.*np.pi, steps)
+trajectory = np.zeros((steps, 7))
+trajectory[:, 0] = pose.translation[0] + 0.1*np.sin(t)
+trajectory[:, 1] = pose.translation[1] + 0.1*(np.cos(t) - 1.)
+trajectory[:, 2] = pose.translation[2]
+# actual orientation as quaternion (x y z w)
+R = pose.linear
+w = 0.5*np.sqrt(1. + np.trace(R))
+trajectory[:, 3:7] = [(R[2,1] - R[1,2])/(4.*w), (R[0,2] - R[2,0])/(4.*w), (R[1,0] - R[0,1])/(4.*w), w]
+
+rollout = pysot.Rollout(model, s, solver, pysot.Rollout.DISPLACEMENT, 0.01)
+utest = unittest.TestCase()
+utest.assertTrue(rollout.setReference(c, trajectory))
+utest.assertTrue(rollout.setReference(p, q.reshape(1, -1)))
+
+start = time.time()
+result = rollout.run(q, steps)
+print(f"rollout of {steps} steps: {time.time() - start} s")
+
+utest.assertEqual(result["q"].shape, (steps + 1, model.getNq()))
+utest.assertEqual(result["solutions"].shape, (steps, model.getNv()))
+utest.assertTrue(result["success"].all())
+utest.assertTrue((result["q"][0] == q).all())
+print(f"mean solve time: {result['solve_time'].mean()} s")
@@ -0,0 +1,65 @@
+from pyopensot import GenericTask, AffineHelper, eHQP
+import numpy as np
+import threading
+import unittest
+
+utest = unittest.TestCase()
+
+n = 3
+v = AffineHelper(np.identity(n), np.zeros(n))
+
+A = np.random.rand(n, n)
+b = np.random.rand(n)
+t = GenericTask("foo", A, b, v)
+t.update()
+
+# getters return read-only views over the internal buffers
+A_view = t.getA()
+print(f"A_view.flags: {A_view.flags}")
+utest.assertFalse(A_view.flags.writeable)
+utest.assertFalse(A_view.flags.owndata)
+with utest.assertRaises(ValueError):
+    A_view[0, 0] = 1.
+
+# the content of a view follows the task, copy() keeps a snapshot
+A_copy = t.getA().copy()
+t.setA(2.*A)
+t.update()
+utest.assertTrue((A_view == 2.*A).all())
+utest.assertTrue((A_copy == A).all())
+
+# in-place solve
+solver = eHQP([t])
+x = np.zeros(n)
+utest.assertTrue(solver.solve(out=x))
+print(f"x: {x}")
+utest.assertTrue(np.allclose(x, solver.solve()))
+
+with utest.assertRaises(ValueError):
+    solver.solve(out=np.zeros(n+1))
+
+# arrays which can not be written without a conversion are rejected
+with utest.assertRaises(TypeError):
+    solver.solve(out=np.zeros(n, dtype=np.float32))
+
+# solvers owned by different threads run with the GIL released
+def control_loop(problem):
+    At = np.random.rand(n, n) + n*np.identity(n)
+    bt = np.random.rand(n)
+    task = GenericTask("task", At, bt, v)
+    s = eHQP([task])
+    for i in range(100):
+        task.update()
+        s.solve(out=problem["x"])
+    problem["A"] = At
+    problem["b"] = bt
+
+problems = [{"x": np.zeros(n)} for i in range(4)]
+threads = [threading.Thread(target=control_loop, args=(p,)) for p in problems]
+for th in threads:
+    th.start()
+for th in threads:
+    th.join()
+for p in problems:
+    print(f"x: {p['x']}")
+    utest.assertTrue(np.allclose(p["A"] @ p["x"], p["b"]))
@@ -0,0 +1,73 @@
+#include <OpenSoT/utils/CollisionPairPruning.h>
+#include <xbot2_interface/xbotinterface2.h>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+/**
+ * @brief This tool samples the joint space of a robot and computes a reduced list of link pairs
+ * to be checked by the CollisionAvoidance constraint. Usage:
+ *
+ *  collision_pair_pruning <urdf> <srdf> [samples=10000] [margin=0.05] [resolution=0.05] [output_prefix=collision_pairs]
+ *
+ * Pairs are classified by sampling, hence the result is a heuristic: margin and resolution (max joint
+ * displacement [rad] from the closest sample) should be chosen conservatively.
+ *
+ * Two files are written:
+ *  - <output_prefix>.txt: the pruned pair list, to be loaded with
+ *    OpenSoT::utils::CollisionPairPruning::loadPairList() and passed to CollisionAvoidance::setCollisionList()
+ *  - <output_prefix>_report.txt: classification and sampled min/max distances of all the pairs
+ */
+
+std::string readFile(const std::string& path)
+{
+    std::ifstream t(path);
+    std::stringstream buffer;
+    buffer << t.rdbuf();
+    return buffer.str();
+}
+
+int main(int argc, char** argv)
+{
+    if(argc < 3)
+    {
+        std::cout << "usage: " << argv[0] << " <urdf> <srdf> [samples=10000] [margin=0.05] [resolution=0.05] [output_prefix=collision_pairs]" << std::endl;
+        return 1;
+    }
+
+    const unsigned int samples = argc > 3 ? std::stoi(argv[3]) : 10000;
+    const double margin = argc > 4 ? std::stod(argv[4]) : 0.05;
+    const double resolution = argc > 5 ? std::stod(argv[5]) : 0.05;
+    const std::string prefix = argc > 6 ? argv[6] : "collision_pairs";
+
+    auto model = XBot::ModelInterface::getModel(readFile(argv[1]), readFile(argv[2]), "pin");
+
+    OpenSoT::utils::CollisionPairPruning pruning(model);
+
+    // the zero configuration is often the one where links are closest (e.g. adjacent links)
+    pruning.addSample(model->getNeutralQ());
+    pruning.sample(samples);
+
+    auto report = pruning.getReport(margin, resolution);
+    auto pairs = pruning.getPrunedPairs(margin, resolution);
+
+    int never = 0, always = 0;
+    for(const auto& r : report)
+    {
+        never += r.classification == OpenSoT::utils::CollisionPairPruning::PairClass::NEVER;
+        always += r.classification == OpenSoT::utils::CollisionPairPruning::PairClass::ALWAYS;
+    }
+
+    std::cout << "samples: " << pruning.getNumberOfSamples() << std::endl;
+    std::cout << "pairs: " << report.size() << " (never: " << never << ", always: " << always
+              << ", sometimes: " << pairs.size() << ")" << std::endl;
+
+    if(!OpenSoT::utils::CollisionPairPruning::savePairList(prefix + ".txt", pairs) ||
+       !pruning.saveReport(prefix + "_report.txt", margin, resolution))
+        return 1;
+
+    std::cout << "pair list written to " << prefix << ".txt" << std::endl;
+    std::cout << "report written to " << prefix << "_report.txt" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <OpenSoT/solvers/eiQuadProgBackEnd.h>
+#include <chrono>
+#include <iostream>
+
+/**
+ * @brief This example compares the double and single precision modes of the eiQuadProg back-end on random
+ * damped velocity IK problems (12x30 Jacobian, joint bounds). Usage:
+ *
+ *  example_eiquadprog_precision [iterations=10000]
+ *
+ * It prints the mean solve time of both modes and the max error of the single precision solution,
+ * so that the option can be evaluated on the target machine.
+ */
+
+int main(int argc, char** argv)
+{
+    using namespace OpenSoT::solvers;
+
+    const unsigned int iter = argc > 1 ? std::stoi(argv[1]) : 10000;
+    const unsigned int rows = 12;
+    const unsigned int cols = 30;
+
+    Eigen::VectorXd l = -Eigen::VectorXd::Ones(cols);
+    Eigen::VectorXd u = Eigen::VectorXd::Ones(cols);
+    Eigen::MatrixXd A(0, cols);
+    Eigen::VectorXd lA(0), uA(0);
+
+    BackEnd::Ptr solver_double = BackEndFactory(solver_back_ends::eiQuadProg, cols, 0, OpenSoT::HST_POSDEF, 0.);
+    BackEnd::Ptr solver_float = BackEndFactory(solver_back_ends::eiQuadProg, cols, 0, OpenSoT::HST_POSDEF, 0.);
+
+    eiQuadProgOptions opt;
+    opt.single_precision = true;
+    solver_float->setOptions(opt);
+
+    double t_double = 0., t_float = 0., err = 0.;
+    for(unsigned int i = 0; i < iter; ++i)
+    {
+        // damped velocity IK: H = J^T J + lambda I, g = -J^T v
+        Eigen::MatrixXd J = Eigen::MatrixXd::Random(rows, cols);
+        Eigen::VectorXd v = Eigen::VectorXd::Random(rows);
+        Eigen::MatrixXd H = J.transpose()*J + 1e-2*Eigen::MatrixXd::Identity(cols, cols);
+        Eigen::VectorXd g = -J.transpose()*v;
+
+        auto tic = std::chrono::high_resolution_clock::now();
+        if(!solver_double->initProblem(H, g, A, lA, uA, l, u))
+        {
+            std::cout << "double precision solve failed at iteration " << i << std::endl;
+            return 1;
+        }
+        auto toc = std::chrono::high_resolution_clock::now();
+        t_double += std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count()*1e-3;
+
+        tic = std::chrono::high_resolution_clock::now();
+        if(!solver_float->initProblem(H, g, A, lA, uA, l, u))
+        {
+            std::cout << "single precision solve failed at iteration " << i << std::endl;
+            return 1;
+        }
+        toc = std::chrono::high_resolution_clock::now();
+        t_float += std::chrono::duration_cast<std::chrono::nanoseconds>(toc-tic).count()*1e-3;
+
+        err = std::max(err, (solver_double->getSolution() - solver_float->getSolution()).cwiseAbs().maxCoeff());
+    }
+
+    std::cout << "EIQUADPROG DOUBLE----> Mean time for " << iter << " iterations: " << t_double/iter << " us" << std::endl;
+    std::cout << "EIQUADPROG FLOAT-----> Mean time for " << iter << " iterations: " << t_float/iter << " us" << std::endl;
+    std::cout << "EIQUADPROG FLOAT-----> Max error w.r.t. DOUBLE: " << err << std::endl;
+
+    return 0;
+}
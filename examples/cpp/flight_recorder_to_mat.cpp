@@ -0,0 +1,19 @@
+#include <OpenSoT/utils/FlightRecorder.h>
+#include <iostream>
+
+/**
+ * @brief This tool converts a recording of OpenSoT::utils::FlightRecorder to a MAT-file. Usage:
+ *
+ *  flight_recorder_to_mat <recording> <mat_file>
+ */
+
+int main(int argc, char** argv)
+{
+    if(argc < 3)
+    {
+        std::cout << "usage: " << argv[0] << " <recording> <mat_file>" << std::endl;
+        return 1;
+    }
+
+    return OpenSoT::utils::FlightRecorder::convertToMat(argv[1], argv[2]) ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+#include <OpenSoT/solvers/QPCapture.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <tuple>
+
+/**
+ * @brief This tool re-solves the QP problems captured with OpenSoT::solvers::QPCapture and reports,
+ * for each problem, timing and solution deltas with respect to the captured ones. Usage:
+ *
+ *  qp_replay <capture> [back_end=eiQuadProg] [eps_regularisation=0] [export_prefix]
+ *
+ * back_end is one of the names returned by OpenSoT::solvers::whichBackEnd() (e.g. qpOASES, OSQP, proxQP).
+ * If export_prefix is given, the problems are also exported to <export_prefix>_<i>.qps (QPS format)
+ * and to <export_prefix>.mat.
+ */
+
+double objective(const OpenSoT::solvers::QPCaptureReader::Problem& problem, const Eigen::VectorXd& x)
+{
+    return 0.5*x.dot(problem.H*x) + problem.g.dot(x);
+}
+
+int main(int argc, char** argv)
+{
+    using namespace OpenSoT::solvers;
+
+    if(argc < 2)
+    {
+        std::cout << "usage: " << argv[0] << " <capture> [back_end=eiQuadProg] [eps_regularisation=0] [export_prefix]" << std::endl;
+        return 1;
+    }
+
+    const std::string back_end_name = argc > 2 ? argv[2] : "eiQuadProg";
+    const double eps_regularisation = argc > 3 ? std::stod(argv[3]) : 0.;
+    const std::string prefix = argc > 4 ? argv[4] : "";
+
+    bool found = false;
+    solver_back_ends be_solver = solver_back_ends::eiQuadProg;
+    for(solver_back_ends be : solver_back_ends_iterator())
+    {
+        if(whichBackEnd(be) == back_end_name)
+        {
+            be_solver = be;
+            found = true;
+        }
+    }
+    if(!found)
+    {
+        std::cout << "unknown back-end " << back_end_name << std::endl;
+        return 1;
+    }
+
+    QPCaptureReader reader(argv[1]);
+    if(!reader.isOpen())
+        return 1;
+
+    // one back-end per problem structure: consecutive problems are solved with the same back-end as online
+    std::map<std::tuple<int, int, bool>, BackEnd::Ptr> back_ends;
+
+    unsigned int failures = 0, new_failures = 0;
+    double max_delta = 0., captured_time = 0., replay_time = 0.;
+
+    std::cout << "problem sequence id n m captured_success captured_time[s] success time[s] |dx|_inf dobjective" << std::endl;
+    for(std::size_t i = 0; i < reader.size(); ++i)
+    {
+        QPCaptureReader::Problem problem = reader.getProblem(i);
+
+        // problems without bounds are captured with infinite bounds
+        const bool has_bounds = problem.l.array().isFinite().any() || problem.u.array().isFinite().any();
+        Eigen::VectorXd l = has_bounds ? Eigen::VectorXd(problem.l) : Eigen::VectorXd(0);
+        Eigen::VectorXd u = has_bounds ? Eigen::VectorXd(problem.u) : Eigen::VectorXd(0);
+
+        auto key = std::make_tuple(problem.header->n, problem.header->m, has_bounds);
+        auto it = back_ends.find(key);
+
+        bool success;
+        auto tic = std::chrono::steady_clock::now();
+        if(it == back_ends.end())
+        {
+            BackEnd::Ptr back_end = BackEndFactory(be_solver, problem.header->n, problem.header->m,
+                                                   OpenSoT::HST_SEMIDEF, eps_regularisation);
+            success = back_end->initProblem(problem.H, problem.g, problem.A, problem.lA, problem.uA, l, u);
+            it = back_ends.emplace(key, back_end).first;
+        }
+        else
+        {
+            success = it->second->updateProblem(problem.H, problem.g, problem.A, problem.lA, problem.uA, l, u) &&
+                      it->second->solve();
+        }
+        auto toc = std::chrono::steady_clock::now();
+        const double time = std::chrono::duration<double>(toc-tic).count();
+
+        const Eigen::VectorXd& x = it->second->getSolution();
+        const double delta = (x - problem.solution).lpNorm<Eigen::Infinity>();
+        const double dobjective = objective(problem, x) - objective(problem, problem.solution);
+
+        failures += !success;
+        new_failures += !success && problem.header->success;
+        if(success && problem.header->success)
+            max_delta = std::max(max_delta, delta);
+        captured_time += problem.header->solve_time;
+        replay_time += time;
+
+        std::cout << i << " " << problem.header->sequence << " " << problem.header->id << " "
+                  << problem.header->n << " " << problem.header->m << " "
+                  << problem.header->success << " " << problem.header->solve_time << " "
+                  << success << " " << time << " " << delta << " " << dobjective << std::endl;
+
+        if(!prefix.empty())
+            QPCaptureReader::exportQPS(problem, prefix + "_" + std::to_string(i) + ".qps",
+                                       "P" + std::to_string(problem.header->sequence));
+    }
+
+    if(!prefix.empty())
+        reader.exportMat(prefix + ".mat");
+
+    std::cout << "problems: " << reader.size() << " (failures: " << failures << ", new failures: " << new_failures << ")" << std::endl;
+    std::cout << "max |dx|_inf: " << max_delta << std::endl;
+    std::cout << "total time [s]: captured " << captured_time << ", " << back_end_name << " " << replay_time << std::endl;
+
+    return new_failures > 0;
+}
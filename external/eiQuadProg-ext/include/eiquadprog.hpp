@@ -43,10 +43,8 @@ s.t.
   1. pay attention in setting up the vectors ce0 and ci0. 
 	   If the constraints of your problem are specified in the form 
 	   A^T x = b and C^T x >= d, then you should set ce0 = -b and ci0 = -d.
-  2. The matrix G is modified within the function since it is used to compute
-     the G = L^T L cholesky factorization for further computations inside the function. 
-     If you need the original matrix G you should make a copy of it and pass the copy
-     to the function.
+  2. The matrix G is not modified: the G = L^T L cholesky factorization used inside the
+     function is computed in the workspace of the QuadProgSolver (see the OpenSoT note below).
     
  
  The author will be grateful if the researchers using this software will
@@ -80,10 +78,18 @@ You should have received a copy of the GNU General Public License
 along with uquadprog; if not, write to the Free Software
 Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+ NOTE (OpenSoT): the method is implemented by the QuadProgSolver class, which owns its workspace.
+ QuadProgSolver<MaxN, MaxM> takes compile-time upper bounds on the number of variables (MaxN) and of
+ equality + inequality constraints (MaxM): in this case every matrix and vector of the workspace has a
+ fixed capacity and lives inside the solver object (no heap allocations by construction). With the
+ default Eigen::Dynamic the workspace is allocated at the first solve and reused while sizes do not change.
+ Scalar can be float, for problems in which single precision is enough.
+ solve_quadprog() and solve_quadprog2() are kept for backward compatibility.
 */
 
 #include <Eigen/Core>
 #include <Eigen/Cholesky>
+#include <limits>
 
 namespace Eigen {
 
@@ -111,210 +117,221 @@ inline Scalar distance(Scalar a, Scalar b)
 
 // }
 
-inline void compute_d(VectorXd &d, const MatrixXd& J, const VectorXd& np)
+template <int MaxN = Dynamic, int MaxM = Dynamic, typename Scalar = double>
+class QuadProgSolver
 {
-  d = J.adjoint() * np;
-}
-
-inline void update_z(VectorXd& z, const MatrixXd& J, const VectorXd& d,  int iq)
-{
-  z = J.rightCols(z.size()-iq) * d.tail(d.size()-iq);
-}
-
-inline void update_r(const MatrixXd& R, VectorXd& r, const VectorXd& d, int iq) 
-{
-  r.head(iq)= R.topLeftCorner(iq,iq).triangularView<Upper>().solve(d.head(iq));
-}
-
-bool add_constraint(MatrixXd& R, MatrixXd& J, VectorXd& d, int& iq, double& R_norm);
-void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u,  int p, int& iq, int l);
-
-/* solve_quadprog2 is used when the Cholesky decomposition of the G matrix is precomputed */
-double solve_quadprog2(LLT<MatrixXd,Lower> &chol,  double c1, VectorXd & g0,  
-                      const MatrixXd & CE, const VectorXd & ce0,  
-                      const MatrixXd & CI, const VectorXd & ci0, 
-                      VectorXd& x);
-
-/* solve_quadprog is used for on-demand QP solving */
-inline double solve_quadprog(MatrixXd & G,  VectorXd & g0,  
-                      const MatrixXd & CE, const VectorXd & ce0,  
-                      const MatrixXd & CI, const VectorXd & ci0, 
-                      VectorXd& x){
-						  
-  LLT<MatrixXd,Lower> chol(G.cols());
-  double c1;
-
-  /* compute the trace of the original matrix G */
-  c1 = G.trace();
+public:
+  typedef Matrix<Scalar, Dynamic, Dynamic, ColMajor, MaxN, MaxN> MatrixNN;
+  typedef Matrix<Scalar, Dynamic, 1, ColMajor, MaxN, 1> VectorN;
+  typedef Matrix<Scalar, Dynamic, 1, ColMajor, MaxM, 1> VectorM;
+  typedef Matrix<int, Dynamic, 1, ColMajor, MaxM, 1> VectorIM;
+  typedef LLT<MatrixNN, Lower> Cholesky;
+
+  /* solve is used for on-demand QP solving, G is not modified */
+  template <typename DerivedG, typename Derivedg0,
+            typename DerivedCE, typename Derivedce0,
+            typename DerivedCI, typename Derivedci0,
+            typename VectorX>
+  Scalar solve(const MatrixBase<DerivedG>& G, const MatrixBase<Derivedg0>& g0,
+               const MatrixBase<DerivedCE>& CE, const MatrixBase<Derivedce0>& ce0,
+               const MatrixBase<DerivedCI>& CI, const MatrixBase<Derivedci0>& ci0,
+               VectorX& x)
+  {
+    /* compute the trace of the original matrix G */
+    Scalar c1 = G.trace();
 
-  /* decompose the matrix G in the form LL^T */
-  chol.compute(G);
+    /* decompose the matrix G in the form LL^T */
+    chol_.compute(G);
 
-  return solve_quadprog2(chol, c1, g0, CE, ce0, CI, ci0, x);
+    return solve(chol_, c1, g0, CE, ce0, CI, ci0, x);
+  }
 
+  /* solve with the Cholesky decomposition of the G matrix precomputed */
+  template <typename Derivedg0,
+            typename DerivedCE, typename Derivedce0,
+            typename DerivedCI, typename Derivedci0,
+            typename VectorX>
+  Scalar solve(const Cholesky& chol, Scalar c1, const MatrixBase<Derivedg0>& g0,
+               const MatrixBase<DerivedCE>& CE, const MatrixBase<Derivedce0>& ce0,
+               const MatrixBase<DerivedCI>& CI, const MatrixBase<Derivedci0>& ci0,
+               VectorX& x);
+
+private:
+  void resize(int n, int m);
+
+  bool add_constraint(int& iq, Scalar& R_norm);
+  void delete_constraint(int p, int& iq, int l);
+
+  Cholesky chol_;
+  MatrixNN R, J;
+  VectorN z, d, np, x_old;
+  VectorM s, r, u, u_old;
+  VectorIM A, A_old, iai, iaexcl;
+};
+
+template <int MaxN, int MaxM, typename Scalar>
+inline void QuadProgSolver<MaxN, MaxM, Scalar>::resize(int n, int m)
+{
+  R.resize(n, n);
+  J.resize(n, n);
+  z.resize(n);
+  d.resize(n);
+  np.resize(n);
+  x_old.resize(n);
+  s.resize(m);
+  r.resize(m);
+  u.resize(m);
+  u_old.resize(m);
+  A.resize(m);
+  A_old.resize(m);
+  iai.resize(m);
+  iaexcl.resize(m);
 }
 
-/* solve_quadprog2 is used for when the Cholesky decomposition of G is pre-computed */
-inline double solve_quadprog2(LLT<MatrixXd,Lower> &chol,  double c1, VectorXd & g0,  
-                      const MatrixXd & CE, const VectorXd & ce0,  
-                      const MatrixXd & CI, const VectorXd & ci0, 
-                      VectorXd& x)
+template <int MaxN, int MaxM, typename Scalar>
+template <typename Derivedg0,
+          typename DerivedCE, typename Derivedce0,
+          typename DerivedCI, typename Derivedci0,
+          typename VectorX>
+inline Scalar QuadProgSolver<MaxN, MaxM, Scalar>::solve(const Cholesky& chol, Scalar c1, const MatrixBase<Derivedg0>& g0,
+                                                const MatrixBase<DerivedCE>& CE, const MatrixBase<Derivedce0>& ce0,
+                                                const MatrixBase<DerivedCI>& CI, const MatrixBase<Derivedci0>& ci0,
+                                                VectorX& x)
 {
-  int i, j, k, l; /* indices */
+  int i, k, l; /* indices */
   int ip, me, mi;
-  int n=g0.size();   
-  int p=CE.cols(); 
+  int n=g0.size();
+  int p=CE.cols();
   int m=CI.cols();
-  MatrixXd R(g0.size(),g0.size()), J(g0.size(),g0.size());
-  
- 
-  VectorXd s(m+p), z(n), r(m + p), d(n),  np(n), u(m + p);
-  VectorXd x_old(n), u_old(m + p);
-  double f_value, psi, c2, sum, ss, R_norm;
-  const double inf = std::numeric_limits<double>::infinity();
-  double t, t1, t2; /* t is the step length, which is the minimum of the partial step length t1 
+
+  resize(n, m + p);
+
+  Scalar f_value, psi, c2, sum, ss, R_norm;
+  const Scalar inf = std::numeric_limits<Scalar>::infinity();
+  Scalar t, t1, t2; /* t is the step length, which is the minimum of the partial step length t1 
     * and the full step length t2 */
-  VectorXi A(m + p), A_old(m + p), iai(m + p), iaexcl(m+p);
   int q;
   int iq, iter = 0;
- 	
+
   me = p; /* number of equality constraints */
   mi = m; /* number of inequality constraints */
   q = 0;  /* size of the active set A (containing the indices of the active constraints) */
-  
+
   /*
    * Preprocessing phase
    */
-	
-	
- 
+
   /* initialize the matrix R */
   d.setZero();
   R.setZero();
-	R_norm = 1.0; /* this variable will hold the norm of the matrix R */
-  
-	/* compute the inverse of the factorized matrix G^-1, this is the initial value for H */
+  R_norm = 1.0; /* this variable will hold the norm of the matrix R */
+
+  /* compute the inverse of the factorized matrix G^-1, this is the initial value for H */
   // J = L^-T
   J.setIdentity();
-  J = chol.matrixU().solve(J);
-	c2 = J.trace();
-#ifdef TRACE_SOLVER
- print_matrix("J", J, n);
-#endif
-  
-	/* c1 * c2 is an estimate for cond(G) */
-  
-	/* 
+  chol.matrixU().solveInPlace(J);
+  c2 = J.trace();
+
+  /* c1 * c2 is an estimate for cond(G) */
+
+  /* 
    * Find the unconstrained minimizer of the quadratic form 0.5 * x G x + g0 x 
    * this is a feasible point in the dual space
-	 * x = G^-1 * g0
+   * x = G^-1 * g0
    */
   x = chol.solve(g0);
   x = -x;
-	/* and compute the current solution value */ 
-	f_value = 0.5 * g0.dot(x);
-#ifdef TRACE_SOLVER
-  std::cerr << "Unconstrained solution: " << f_value << std::endl;
-  print_vector("x", x, n);
-#endif
-  
-	/* Add equality constraints to the working set A */
+  /* and compute the current solution value */ 
+  f_value = 0.5 * g0.dot(x);
+
+  /* Add equality constraints to the working set A */
   iq = 0;
-	for (i = 0; i < me; i++)
-	{
+  for (i = 0; i < me; i++)
+  {
     np = CE.col(i);
-    compute_d(d, J, np);
-		update_z(z, J, d,  iq);
-		update_r(R, r, d,  iq);
-#ifdef TRACE_SOLVER
-		print_matrix("R", R, iq);
-		print_vector("z", z, n);
-		print_vector("r", r, iq);
-		print_vector("d", d, n);
-#endif
-    
+    /* compute d = J^T np */
+    d.noalias() = J.adjoint() * np;
+    /* compute z = H np: the step direction in the primal space */
+    z.noalias() = J.rightCols(n - iq) * d.tail(n - iq);
+    /* compute N* np */
+    r.head(iq) = d.head(iq);
+    R.topLeftCorner(iq, iq).template triangularView<Upper>().solveInPlace(r.head(iq));
+
     /* compute full step length t2: i.e., the minimum step in primal space s.t. the contraint 
       becomes feasible */
     t2 = 0.0;
-	if (std::abs(z.dot(z)) > std::numeric_limits<double>::epsilon()) // i.e. z != 0
+    if (std::abs(z.dot(z)) > std::numeric_limits<Scalar>::epsilon()) // i.e. z != 0
       t2 = (-np.dot(x) - ce0(i)) / z.dot(np);
-    
+
     x += t2 * z;
 
     /* set u = u+ */
     u(iq) = t2;
     u.head(iq) -= t2 * r.head(iq);
-    
+
     /* compute the new solution value */
     f_value += 0.5 * (t2 * t2) * z.dot(np);
     A(i) = -i - 1;
-    
-    if (!add_constraint(R, J, d, iq, R_norm))
+
+    if (!add_constraint(iq, R_norm))
     {
       // FIXME: it should raise an error
       // Equality constraints are linearly dependent
       return f_value;
     }
   }
-  
-	/* set iai = K \ A */
-	for (i = 0; i < mi; i++)
-		iai(i) = i;
-  
-l1:	iter++;
-#ifdef TRACE_SOLVER
-  print_vector("x", x, n);
-#endif
+
+  /* set iai = K \ A */
+  for (i = 0; i < mi; i++)
+    iai(i) = i;
+
+l1: iter++;
   /* step 1: choose a violated constraint */
-	for (i = me; i < iq; i++)
-	{
-	  ip = A(i);
-		iai(ip) = -1;
-	}
-	
-	/* compute s(x) = ci^T * x + ci0 for all elements of K \ A */
-	ss = 0.0;
-	psi = 0.0; /* this value will contain the sum of all infeasibilities */
-	ip = 0; /* ip will be the index of the chosen violated constraint */
-	for (i = 0; i < mi; i++)
-	{
-		iaexcl(i) = 1;
-		sum = CI.col(i).dot(x) + ci0(i);
-		s(i) = sum;
-		psi += std::min(0.0, sum);
-	}
-#ifdef TRACE_SOLVER
-  print_vector("s", s, mi);
-#endif
+  for (i = me; i < iq; i++)
+  {
+    ip = A(i);
+    iai(ip) = -1;
+  }
 
-    
-	if (std::abs(psi) <= mi * std::numeric_limits<double>::epsilon() * c1 * c2* 100.0)
-	{
+  /* compute s(x) = ci^T * x + ci0 for all elements of K \ A */
+  ss = 0.0;
+  psi = 0.0; /* this value will contain the sum of all infeasibilities */
+  ip = 0; /* ip will be the index of the chosen violated constraint */
+  for (i = 0; i < mi; i++)
+  {
+    iaexcl(i) = 1;
+    sum = CI.col(i).dot(x) + ci0(i);
+    s(i) = sum;
+    psi += std::min(Scalar(0), sum);
+  }
+
+  if (std::abs(psi) <= mi * std::numeric_limits<Scalar>::epsilon() * c1 * c2* 100.0)
+  {
     /* numerically there are not infeasibilities anymore */
     q = iq;
-		return f_value;
+    return f_value;
   }
-    
+
   /* save old values for u, x and A */
-   u_old.head(iq) = u.head(iq);
-   A_old.head(iq) = A.head(iq);
-   x_old = x;
-    
+  u_old.head(iq) = u.head(iq);
+  A_old.head(iq) = A.head(iq);
+  x_old = x;
+
 l2: /* Step 2: check for feasibility and determine a new S-pair */
-	for (i = 0; i < mi; i++)
-	{
-		if (s(i) < ss && iai(i) != -1 && iaexcl(i))
-		{
-			ss = s(i);
-			ip = i;
-		}
-	}
+  for (i = 0; i < mi; i++)
+  {
+    if (s(i) < ss && iai(i) != -1 && iaexcl(i))
+    {
+      ss = s(i);
+      ip = i;
+    }
+  }
   if (ss >= 0.0)
   {
     q = iq;
     return f_value;
   }
-    
+
   /* set np = n(ip) */
   np = CI.col(ip);
   /* set u = (u 0)^T */
@@ -322,26 +339,14 @@ l2: /* Step 2: check for feasibility and determine a new S-pair */
   /* add ip to the active set A */
   A(iq) = ip;
 
-#ifdef TRACE_SOLVER
-	std::cerr << "Trying with constraint " << ip << std::endl;
-	print_vector("np", np, n);
-#endif
-    
 l2a:/* Step 2a: determine step direction */
   /* compute z = H np: the step direction in the primal space (through J, see the paper) */
-  compute_d(d, J, np);
-  update_z(z, J, d, iq);
+  d.noalias() = J.adjoint() * np;
+  z.noalias() = J.rightCols(n - iq) * d.tail(n - iq);
   /* compute N* np (if q > 0): the negative of the step direction in the dual space */
-  update_r(R, r, d, iq);
-#ifdef TRACE_SOLVER
-  std::cerr << "Step direction z" << std::endl;
-		print_vector("z", z, n);
-		print_vector("r", r, iq + 1);
-    print_vector("u", u, iq + 1);
-    print_vector("d", d, n);
-    print_ivector("A", A, iq + 1);
-#endif
-    
+  r.head(iq) = d.head(iq);
+  R.topLeftCorner(iq, iq).template triangularView<Upper>().solveInPlace(r.head(iq));
+
   /* Step 2b: compute step length */
   l = 0;
   /* Compute t1: partial step length (maximum step in dual space without violating dual feasibility */
@@ -349,7 +354,7 @@ l2a:/* Step 2a: determine step direction */
   /* find the index l s.t. it reaches the minimum of u+(x) / r */
   for (k = me; k < iq; k++)
   {
-    double tmp;
+    Scalar tmp;
     if (r(k) > 0.0 && ((tmp = u(k) / r(k)) < t1) )
     {
       t1 = tmp;
@@ -357,19 +362,16 @@ l2a:/* Step 2a: determine step direction */
     }
   }
   /* Compute t2: full step length (minimum step in primal space such that the constraint ip becomes feasible */
-  if (std::abs(z.dot(z))  > std::numeric_limits<double>::epsilon()) // i.e. z != 0
+  if (std::abs(z.dot(z))  > std::numeric_limits<Scalar>::epsilon()) // i.e. z != 0
     t2 = -s(ip) / z.dot(np);
   else
     t2 = inf; /* +inf */
 
   /* the step is chosen as the minimum of t1 and t2 */
   t = std::min(t1, t2);
-#ifdef TRACE_SOLVER
-  std::cerr << "Step sizes: " << t << " (t1 = " << t1 << ", t2 = " << t2 << ") ";
-#endif
-  
+
   /* Step 2c: determine new S-pair and take step: */
-  
+
   /* case (i): no step in primal or dual space */
   if (t >= inf)
   {
@@ -385,176 +387,128 @@ l2a:/* Step 2a: determine step direction */
     u.head(iq) -= t * r.head(iq);
     u(iq) += t;
     iai(l) = l;
-    delete_constraint(R, J, A, u, p, iq, l);
-#ifdef TRACE_SOLVER
-    std::cerr << " in dual space: " 
-      << f_value << std::endl;
-    print_vector("x", x, n);
-    print_vector("z", z, n);
-		print_ivector("A", A, iq + 1);
-#endif
+    delete_constraint(p, iq, l);
     goto l2a;
   }
-  
+
   /* case (iii): step in primal and dual space */
-  
+
   x += t * z;
   /* update the solution value */
   f_value += t * z.dot(np) * (0.5 * t + u(iq));
-  
+
   u.head(iq) -= t * r.head(iq);
   u(iq) += t;
-#ifdef TRACE_SOLVER
-  std::cerr << " in both spaces: " 
-    << f_value << std::endl;
-	print_vector("x", x, n);
-	print_vector("u", u, iq + 1);
-	print_vector("r", r, iq + 1);
-	print_ivector("A", A, iq + 1);
-#endif
-  
+
   if (t == t2)
   {
-#ifdef TRACE_SOLVER
-    std::cerr << "Full step has taken " << t << std::endl;
-    print_vector("x", x, n);
-#endif
     /* full step has taken */
     /* add constraint ip to the active set*/
-		if (!add_constraint(R, J, d, iq, R_norm))
-		{
-			iaexcl(ip) = 0;
-			delete_constraint(R, J, A, u, p, iq, ip);
-#ifdef TRACE_SOLVER
-      print_matrix("R", R, n);
-      print_ivector("A", A, iq);
-#endif
-			for (i = 0; i < m; i++)
-				iai(i) = i;
-			for (i = 0; i < iq; i++)
-			{
-				A(i) = A_old(i);
-				iai(A(i)) = -1;
-				u(i) = u_old(i);
-			}
-			x = x_old;
+    if (!add_constraint(iq, R_norm))
+    {
+      iaexcl(ip) = 0;
+      delete_constraint(p, iq, ip);
+      for (i = 0; i < m; i++)
+        iai(i) = i;
+      for (i = 0; i < iq; i++)
+      {
+        A(i) = A_old(i);
+        iai(A(i)) = -1;
+        u(i) = u_old(i);
+      }
+      x = x_old;
       goto l2; /* go to step 2 */
-		}    
+    }    
     else
       iai(ip) = -1;
-#ifdef TRACE_SOLVER
-    print_matrix("R", R, n);
-    print_ivector("A", A, iq);
-#endif
     goto l1;
   }
-  
+
   /* a patial step has taken */
-#ifdef TRACE_SOLVER
-  std::cerr << "Partial step has taken " << t << std::endl;
-  print_vector("x", x, n);
-#endif
   /* drop constraint l */
-	iai(l) = l;
-	delete_constraint(R, J, A, u, p, iq, l);
-#ifdef TRACE_SOLVER
-  print_matrix("R", R, n);
-  print_ivector("A", A, iq);
-#endif
-  
+  iai(l) = l;
+  delete_constraint(p, iq, l);
+
   s(ip) = CI.col(ip).dot(x) + ci0(ip);
 
-#ifdef TRACE_SOLVER
-  print_vector("s", s, mi);
-#endif
   goto l2a;
 }
 
-
-inline bool add_constraint(MatrixXd& R, MatrixXd& J, VectorXd& d, int& iq, double& R_norm)
+template <int MaxN, int MaxM, typename Scalar>
+inline bool QuadProgSolver<MaxN, MaxM, Scalar>::add_constraint(int& iq, Scalar& R_norm)
 {
- int n=J.rows();
-#ifdef TRACE_SOLVER
-  std::cerr << "Add constraint " << iq << '/';
-#endif
-	int i, j, k;
-	double cc, ss, h, t1, t2, xny;
-	
+  int n=J.rows();
+  int j, k;
+  Scalar cc, ss, h, t1, t2, xny;
+
   /* we have to find the Givens rotation which will reduce the element
-		d(j) to zero.
-		if it is already zero we don't have to do anything, except of
-		decreasing j */  
-	for (j = n - 1; j >= iq + 1; j--)
-	{
+    d(j) to zero.
+    if it is already zero we don't have to do anything, except of
+    decreasing j */  
+  for (j = n - 1; j >= iq + 1; j--)
+  {
     /* The Givens rotation is done with the matrix (cc cs, cs -cc).
-			 If cc is one, then element (j) of d is zero compared with element
-			 (j - 1). Hence we don't have to do anything. 
-			 If cc is zero, then we just have to switch column (j) and column (j - 1) 
-			 of J. Since we only switch columns in J, we have to be careful how we
-			 update d depending on the sign of gs.
-			 Otherwise we have to apply the Givens rotation to these columns.
-			 The i - 1 element of d has to be updated to h. */
-		cc = d(j - 1);
-		ss = d(j);
-		h = distance(cc, ss);
-		if (h == 0.0)
-			continue;
-		d(j) = 0.0;
-		ss = ss / h;
-		cc = cc / h;
-		if (cc < 0.0)
-		{
-			cc = -cc;
-			ss = -ss;
-			d(j - 1) = -h;
-		}
-		else
-			d(j - 1) = h;
-		xny = ss / (1.0 + cc);
-		for (k = 0; k < n; k++)
-		{
-			t1 = J(k,j - 1);
-			t2 = J(k,j);
-			J(k,j - 1) = t1 * cc + t2 * ss;
-			J(k,j) = xny * (t1 + J(k,j - 1)) - t2;
-		}
-	}
+       If cc is one, then element (j) of d is zero compared with element
+       (j - 1). Hence we don't have to do anything. 
+       If cc is zero, then we just have to switch column (j) and column (j - 1) 
+       of J. Since we only switch columns in J, we have to be careful how we
+       update d depending on the sign of gs.
+       Otherwise we have to apply the Givens rotation to these columns.
+       The i - 1 element of d has to be updated to h. */
+    cc = d(j - 1);
+    ss = d(j);
+    h = distance(cc, ss);
+    if (h == 0.0)
+      continue;
+    d(j) = 0.0;
+    ss = ss / h;
+    cc = cc / h;
+    if (cc < 0.0)
+    {
+      cc = -cc;
+      ss = -ss;
+      d(j - 1) = -h;
+    }
+    else
+      d(j - 1) = h;
+    xny = ss / (1.0 + cc);
+    for (k = 0; k < n; k++)
+    {
+      t1 = J(k,j - 1);
+      t2 = J(k,j);
+      J(k,j - 1) = t1 * cc + t2 * ss;
+      J(k,j) = xny * (t1 + J(k,j - 1)) - t2;
+    }
+  }
   /* update the number of constraints added*/
-	iq++;
+  iq++;
   /* To update R we have to put the iq components of the d vector
     into column iq - 1 of R
     */
   R.col(iq-1).head(iq) = d.head(iq);
-#ifdef TRACE_SOLVER
-  std::cerr << iq << std::endl;
-#endif
-  
-	if (std::abs(d(iq - 1)) <= std::numeric_limits<double>::epsilon() * R_norm)
-		// problem degenerate
-		return false;
-	R_norm = std::max<double>(R_norm, std::abs(d(iq - 1)));
-	return true;
-}
 
+  if (std::abs(d(iq - 1)) <= std::numeric_limits<Scalar>::epsilon() * R_norm)
+    // problem degenerate
+    return false;
+  R_norm = std::max<Scalar>(R_norm, std::abs(d(iq - 1)));
+  return true;
+}
 
-inline void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u,  int p, int& iq, int l)
+template <int MaxN, int MaxM, typename Scalar>
+inline void QuadProgSolver<MaxN, MaxM, Scalar>::delete_constraint(int p, int& iq, int l)
 {
-
   int n = R.rows();
-#ifdef TRACE_SOLVER
-  std::cerr << "Delete constraint " << l << ' ' << iq;
-#endif
-	int i, j, k, qq;
-	double cc, ss, h, xny, t1, t2;
-  
-	/* Find the index qq for active constraint l to be removed */
+  int i, j, k, qq = 0;
+  Scalar cc, ss, h, xny, t1, t2;
+
+  /* Find the index qq for active constraint l to be removed */
   for (i = p; i < iq; i++)
   if (A(i) == l)
   {
     qq = i;
     break;
   }
-      
+
   /* remove the constraint from the active set and the duals */
   for (i = qq; i < iq - 1; i++)
   {
@@ -562,7 +516,7 @@ inline void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u
     u(i) = u(i + 1);
     R.col(i) = R.col(i+1);
   }
-      
+
   A(iq - 1) = A(iq);
   u(iq - 1) = u(iq);
   A(iq) = 0; 
@@ -571,13 +525,10 @@ inline void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u
     R(j,iq - 1) = 0.0;
   /* constraint has been fully removed */
   iq--;
-#ifdef TRACE_SOLVER
-  std::cerr << '/' << iq << std::endl;
-#endif 
-  
+
   if (iq == 0)
     return;
-  
+
   for (j = qq; j < iq; j++)
   {
     cc = R(j,j);
@@ -596,7 +547,7 @@ inline void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u
     }
     else
       R(j,j) = h;
-    
+
     xny = ss / (1.0 + cc);
     for (k = j + 1; k < iq; k++)
     {
@@ -615,6 +566,26 @@ inline void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u
   }
 }
 
+/* solve_quadprog2 is used when the Cholesky decomposition of the G matrix is precomputed */
+inline double solve_quadprog2(LLT<MatrixXd,Lower> &chol,  double c1, VectorXd & g0,  
+                      const MatrixXd & CE, const VectorXd & ce0,  
+                      const MatrixXd & CI, const VectorXd & ci0, 
+                      VectorXd& x)
+{
+  QuadProgSolver<> solver;
+  return solver.solve(chol, c1, g0, CE, ce0, CI, ci0, x);
+}
+
+/* solve_quadprog is used for on-demand QP solving */
+inline double solve_quadprog(MatrixXd & G,  VectorXd & g0,  
+                      const MatrixXd & CE, const VectorXd & ce0,  
+                      const MatrixXd & CI, const VectorXd & ci0, 
+                      VectorXd& x)
+{
+  QuadProgSolver<> solver;
+  return solver.solve(G, g0, CE, ce0, CI, ci0, x);
+}
+
 }
 
 #endif
@@ -21,13 +21,26 @@ public:
     void setInitialActiveSet();
     void activeSearch(double* u);
 
+    /**
+     * @brief setWarmStart if true (default) each activeSearch starts from the optimal active set
+     * of the last successful one, otherwise from the twin (equality) constraints only
+     */
+    void setWarmStart(const bool warm_start);
+    bool getWarmStart() const;
+
     bool updateStage(const unsigned int i, const double* Jdata, const Bound* bdata);
 
 
 
 private:
+    struct Workspace;
+
+    void setLastActiveSet();
+
     std::shared_ptr<HCOD> _hcod;
+    std::shared_ptr<Workspace> _workspace;
     int _problem_size;
+    bool _warm_start;
 
 };
 
@@ -1,13 +1,25 @@
 #include "../include/soth/HCOD_wrapper.h"
 #include "../include/soth/HCOD.hpp"
 #include "../external/Eigen/Dense"
+#include <algorithm>
 
 using namespace soth;
 
+struct HCOD_wrapper::Workspace
+{
+    Eigen::VectorXd solution;
+    /* Optimal active set (twins excluded) of the last successful search. */
+    std::vector<cstref_vector_t> active_set;
+    bool has_active_set = false;
+};
+
 HCOD_wrapper::HCOD_wrapper(const unsigned int sizeProblem, const unsigned int nbStage):
-    _problem_size(sizeProblem)
+    _workspace(std::make_shared<Workspace>()),
+    _problem_size(sizeProblem),
+    _warm_start(true)
 {
     _hcod = std::make_shared<HCOD>(sizeProblem, nbStage);
+    _workspace->solution.resize(sizeProblem);
 }
 
 void HCOD_wrapper::pushBackStage(const unsigned int nr, const double *Jdata, const Bound *bdata)
@@ -27,16 +39,75 @@ void HCOD_wrapper::setDamping(const double &d)
 
 void HCOD_wrapper::activeSearch(double *u)
 {
-    Eigen::VectorXd solution(_problem_size);
+    if(_warm_start && _workspace->has_active_set)
+        setLastActiveSet();
+    else
+        _hcod->setInitialActiveSet();
+
+    try
+    {
+        _hcod->activeSearch(_workspace->solution);
+    }
+    catch(...)
+    {
+        /* The active set left by a failed search is not a guess worth keeping. */
+        _workspace->has_active_set = false;
+        throw;
+    }
+
+    if(_warm_start)
+    {
+        _workspace->active_set = _hcod->getOptimalActiveSet();
+        _workspace->has_active_set = true;
+    }
+
+    Eigen::VectorXd::Map(u, _problem_size) = _workspace->solution;
+}
+
+void HCOD_wrapper::setLastActiveSet()
+{
+    if(_workspace->active_set.size() != _hcod->stages.size())
+    {
+        _hcod->setInitialActiveSet();
+        return;
+    }
 
-    _hcod->activeSearch(solution);
+    /* Bounds may have changed type since the last search (e.g. a double bound
+     * collapsed into a twin): keep only the constraints which can still be
+     * active on the same side, twins are added back by setInitialActiveSet. */
+    for(std::size_t k = 0; k < _workspace->active_set.size(); ++k)
+    {
+        const Stage& stage = _hcod->stage(k);
+        cstref_vector_t& guess = _workspace->active_set[k];
+        guess.erase(std::remove_if(guess.begin(), guess.end(),
+                                   [&stage](const ConstraintRef& cst)
+                    {
+                        if(cst.row >= stage.nbConstraints())
+                            return true;
+                        const Bound::bound_t type = stage.getBoundRow(cst.row).getType();
+                        return type != Bound::BOUND_DOUBLE && type != cst.type;
+                    }), guess.end());
 
-    Eigen::VectorXd::Map(u, solution.size()) = solution;
+        _hcod->setInitialActiveSet(guess, k);
+    }
 }
 
 void HCOD_wrapper::setInitialActiveSet()
 {
     _hcod->setInitialActiveSet();
+    _workspace->has_active_set = false;
+}
+
+void HCOD_wrapper::setWarmStart(const bool warm_start)
+{
+    _warm_start = warm_start;
+    if(!_warm_start)
+        _workspace->has_active_set = false;
+}
+
+bool HCOD_wrapper::getWarmStart() const
+{
+    return _warm_start;
 }
 
 bool HCOD_wrapper::updateStage(const unsigned int i, const double* Jdata, const Bound* bdata)
@@ -24,6 +24,7 @@
 #include <xbot2_interface/logger.h>
 
 #include <OpenSoT/version.h>
+#include <OpenSoT/utils/FlightRecorder.h>
 
  namespace OpenSoT {
 
@@ -108,6 +109,12 @@
 
         }
 
+        /**
+         * @brief _recorder and _recorder_channels are used by record()
+         */
+        utils::FlightRecorder::Ptr _recorder;
+        std::vector<int> _recorder_channels;
+
     public:
         Constraint(const std::string constraint_id,
                    const unsigned int x_size) :
@@ -187,9 +194,9 @@
         virtual void log(XBot::MatLogger2::Ptr logger)
         {
             if(_Aeq.rows() > 0 && _Aeq.cols() > 0)
-                logger->add(_constraint_id + "_Aeq", _Aeq);
+                logger->add(_constraint_id + "_Aeq", getAeq());
             if(_Aineq.rows() > 0 && _Aineq.cols() > 0)
-                logger->add(_constraint_id + "_Aineq", _Aineq);
+                logger->add(_constraint_id + "_Aineq", getAineq());
             if(_beq.size() > 0)
                 logger->add(_constraint_id + "_beq", _beq);
             if(_bLowerBound.size() > 0)
@@ -203,6 +210,50 @@
             _log(logger);
         }
 
+        /**
+         * @brief setFlightRecorder registers the (non empty) matrices and vectors of the constraint as channels
+         * of a FlightRecorder, see record(). It has to be called before FlightRecorder::start().
+         * NOTE: the size of the channels is the actual size of the matrices, bigger samples are dropped
+         * @param recorder a FlightRecorder
+         * @param decimation of the channels
+         * @return false if the constraint is already registered in the recorder (e.g. it is shared by more tasks):
+         * the channels are not added again
+         */
+        bool setFlightRecorder(utils::FlightRecorder::Ptr recorder, const int decimation = 1)
+        {
+            if(_recorder == recorder)
+                return false;
+
+            _recorder = recorder;
+            _recorder_channels = {
+                recorder->addChannel(_constraint_id + "_Aeq", getAeq(), decimation),
+                recorder->addChannel(_constraint_id + "_Aineq", getAineq(), decimation),
+                recorder->addChannel(_constraint_id + "_beq", _beq, decimation),
+                recorder->addChannel(_constraint_id + "_bLowerBound", _bLowerBound, decimation),
+                recorder->addChannel(_constraint_id + "_bUpperBound", _bUpperBound, decimation),
+                recorder->addChannel(_constraint_id + "_upperBound", _upperBound, decimation),
+                recorder->addChannel(_constraint_id + "_lowerBound", _lowerBound, decimation)
+            };
+            return true;
+        }
+
+        /**
+         * @brief record logs the matrices and vectors of the constraint in the FlightRecorder
+         * set with setFlightRecorder(), it is real-time safe
+         */
+        void record()
+        {
+            if(!_recorder)
+                return;
+            _recorder->log(_recorder_channels[0], getAeq());
+            _recorder->log(_recorder_channels[1], getAineq());
+            _recorder->log(_recorder_channels[2], _beq);
+            _recorder->log(_recorder_channels[3], _bLowerBound);
+            _recorder->log(_recorder_channels[4], _bUpperBound);
+            _recorder->log(_recorder_channels[5], _upperBound);
+            _recorder->log(_recorder_channels[6], _lowerBound);
+        }
+
         /**
          * @brief checkConsistency checks if all internal matrices and vectors are correctly instantiated and the right size
          * @return true if everything is ok
@@ -113,6 +113,27 @@ using namespace std;
             else
                 _log(logger, _solver_id+"_");
         }
+
+        /**
+         * @brief setFlightRecorder registers the data related to the solver as channels of a FlightRecorder,
+         * see record(). It has to be called before FlightRecorder::start()
+         * @param recorder a FlightRecorder
+         * @param decimation of the channels
+         * @return false if the solver does not support the FlightRecorder
+         */
+        virtual bool setFlightRecorder(utils::FlightRecorder::Ptr recorder, const int decimation = 1)
+        {
+            return false;
+        }
+
+        /**
+         * @brief record logs the data related to the solver in the FlightRecorder set with setFlightRecorder(),
+         * it is real-time safe
+         */
+        virtual void record()
+        {
+
+        }
     };
  }
 
@@ -47,10 +47,33 @@ public:
 
     virtual void update();
 
+    /**
+     * @brief getAeq selects the rows of the father constraint Aeq, if needed
+     * @return the Aeq matrix of the subconstraint
+     */
+    virtual const Eigen::MatrixXd& getAeq();
+
+    /**
+     * @brief getAineq selects the rows of the father constraint Aineq, if needed
+     * @return the Aineq matrix of the subconstraint
+     */
+    virtual const Eigen::MatrixXd& getAineq();
+
+    /**
+     * @brief getRowIndices
+     * @return the rows of the father constraint selected by the subconstraint
+     */
+    const Indices& getRowIndices() const { return _subConstraintMap; }
+
 protected:
     Indices _subConstraintMap;
     ConstraintPtr _constraintPtr;
 
+    /**
+     * @brief _is_A_valid true if Aineq (or Aeq) has been selected from the father constraint after the last update
+     */
+    bool _is_A_valid;
+
     static const std::string _SUBCONSTRAINT_SEPARATION_;
 
     void generateBound(const Eigen::VectorXd& bound, Eigen::VectorXd& sub_bound);
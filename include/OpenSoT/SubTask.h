@@ -40,6 +40,7 @@
      * In the same way, the constraints of the SubTask are those of the father Task,
      * as well as the weight matrix W (the \f$W_\text{subtask}\f$ is a submatrix of \f$W\f$)
      * On the other side, the \f$\lambda\f$ for the SubTask is unique to the SubTask.
+     * The reduced A and W are selected from the father task by contiguous chunks of rows.
     */
     class SubTask : public Task<Eigen::MatrixXd, Eigen::VectorXd> {
 
@@ -61,6 +62,11 @@
 
         void generateWeight();
 
+        /**
+         * @brief _update_father_task if false, _update() does not update the father task
+         */
+        bool _update_father_task = true;
+
         /** Updates the A, b, Aeq, beq, Aineq, b*Bound matrices
             @param x variable state at the current step (input) */
         virtual void _update();
@@ -90,6 +96,26 @@
          */
         virtual void setWeight(const Eigen::MatrixXd& W);
 
+        /**
+         * @brief setWeight sets the task diagonal weight (the weight of the selected rows of the father task)
+         * @param w scalar diagonal weight
+         */
+        virtual void setWeight(const double& w);
+
+        /**
+         * @brief computeHessianAndGradient computes \f$H = A^TWA\f$, \f$g = -A^TWb\f$
+         * with the fixed-rows kernels
+         * @param H Hessian
+         * @param g gradient (the linear term c is not included)
+         */
+        void computeHessianAndGradient(Eigen::MatrixXd& H, Eigen::VectorXd& g) const;
+
+        /**
+         * @brief getRowIndices
+         * @return the rows of the father task selected by the subtask
+         */
+        const Indices& getRowIndices() const { return _subTaskMap; }
+
         /**
          * @brief getConstraints return a reference to the constraint list. Use the standard list methods
          * to add, remove, clear, ... the constraints list.
@@ -144,6 +170,20 @@
          */
         TaskPtr getTask() {return _taskPtr;}
 
+        /**
+         * @brief setUpdateFatherTask if false, update() does not update the father task but only
+         * selects its current rows: the father task has to be updated by the caller
+         * (e.g. by a compiled AutoStack, which updates each task once per control cycle)
+         * @param update_father_task default is true
+         */
+        void setUpdateFatherTask(const bool update_father_task) { _update_father_task = update_father_task; }
+
+        /**
+         * @brief getUpdateFatherTask
+         * @return true if update() updates the father task
+         */
+        bool getUpdateFatherTask() const { return _update_father_task; }
+
     };
 
 
@@ -112,6 +112,13 @@
          */
         std::vector<bool> _active_joints_mask;
 
+        /**
+         * @brief _recorder, _recorder_channels and _recorded_constraints are used by record()
+         */
+        utils::FlightRecorder::Ptr _recorder;
+        std::vector<int> _recorder_channels;
+        std::list<ConstraintPtr> _recorded_constraints;
+
         /** Updates the A, b, Aeq, beq, Aineq, b*Bound matrices */
         virtual void _update() = 0;
 
@@ -313,6 +320,12 @@
          */
         const Matrix_type& getWeight() const { return _W; }
 
+        /**
+         * @brief isWeightIdentity
+         * @return true if the weight of the task is the identity matrix
+         */
+        bool isWeightIdentity() const { return _W.isIdentity(); }
+
         /**
          * @brief setWeight sets the task weight.
          * Note the Weight needs to be positive definite.
@@ -436,12 +449,12 @@
          */
         virtual void log(XBot::MatLogger2::Ptr logger)
         {
-            if(_A.rows() > 0)
-                logger->add(_task_id + "_A", _A);
+            if(getA().rows() > 0)
+                logger->add(_task_id + "_A", getA());
             if(_b.size() > 0)
                 logger->add(_task_id + "_b", _b);
-            if(_W.rows() > 0)
-                logger->add(_task_id + "_W", _W);
+            if(getWeight().rows() > 0)
+                logger->add(_task_id + "_W", getWeight());
             if(_c.size() > 0)
                 logger->add(_task_id + "_c", _c);
             logger->add(_task_id + "_lambda", _lambda);
@@ -452,6 +465,57 @@
 
         }
 
+        /**
+         * @brief setFlightRecorder registers A, b, W, c and lambda of the task, and the variables of its constraints,
+         * as channels of a FlightRecorder, see record(). It has to be called before FlightRecorder::start().
+         * A constraint already registered in the recorder (e.g. by another task sharing it) is recorded
+         * only by the task which registered it first.
+         * NOTE: the size of the channels is the actual size of the matrices, bigger samples are dropped
+         * @param recorder a FlightRecorder
+         * @param decimation of the channels
+         * @return false if the task is already registered in the recorder: the channels are not added again
+         */
+        bool setFlightRecorder(utils::FlightRecorder::Ptr recorder, const int decimation = 1)
+        {
+            if(_recorder == recorder)
+                return false;
+
+            _recorder = recorder;
+            _recorder_channels = {
+                recorder->addChannel(_task_id + "_A", getA(), decimation),
+                recorder->addChannel(_task_id + "_b", _b, decimation),
+                recorder->addChannel(_task_id + "_W", getWeight(), decimation),
+                recorder->addChannel(_task_id + "_c", _c, decimation),
+                recorder->addChannel(_task_id + "_lambda", 1, 1, decimation)
+            };
+
+            _recorded_constraints.clear();
+            for(auto constraint : _constraints)
+            {
+                if(constraint->setFlightRecorder(recorder, decimation))
+                    _recorded_constraints.push_back(constraint);
+            }
+            return true;
+        }
+
+        /**
+         * @brief record logs A, b, W, c and lambda of the task, and the variables of its constraints,
+         * in the FlightRecorder set with setFlightRecorder(), it is real-time safe
+         */
+        void record()
+        {
+            if(!_recorder)
+                return;
+            _recorder->log(_recorder_channels[0], getA());
+            _recorder->log(_recorder_channels[1], _b);
+            _recorder->log(_recorder_channels[2], getWeight());
+            _recorder->log(_recorder_channels[3], _c);
+            _recorder->log(_recorder_channels[4], _lambda);
+
+            for(auto constraint : _recorded_constraints)
+                constraint->record();
+        }
+
     private: Vector_type _error_, _tmp_, _residual_;
     public:
         /**
@@ -466,8 +530,8 @@
          */
         double computeCost(const Eigen::VectorXd& x)
         {
-            _error_.noalias() = _A*x - _b;
-            _tmp_.noalias() = _error_.transpose()*_W;
+            _error_.noalias() = getA()*x - _b;
+            _tmp_.noalias() = _error_.transpose()*getWeight();
             _residual_.noalias() = _tmp_.transpose()*_error_;
             return _residual_[0];
         }
@@ -479,36 +543,38 @@
         bool checkConsistency()
         {
             bool a = true;
+            const Matrix_type& A = getA();
+            const Matrix_type& W = getWeight();
             //0) Check Weight size is not 0 if b.size > 0!
             if(_b.size() > 0)
             {
-                if(_W.rows() == 0){
-                    XBot::Logger::error("%s: _W.rows() == %i ! \n", _W.rows());
+                if(W.rows() == 0){
+                    XBot::Logger::error("%s: _W.rows() == %i ! \n", _task_id.c_str(), W.rows());
                     a = false;}
-                if(_W.cols() == 0){
-                    XBot::Logger::error("%s: _W.cols() == %i ! \n", _W.cols());
+                if(W.cols() == 0){
+                    XBot::Logger::error("%s: _W.cols() == %i ! \n", _task_id.c_str(), W.cols());
                     a = false;}
             }
 
             //1) Check Weight is square
-            if(_W.rows() != _W.cols()){
-                XBot::Logger::error("%s: _W.rows() != _W.cols() -> %i != %i! \n", _task_id.c_str(), _W.rows(), _W.cols());
+            if(W.rows() != W.cols()){
+                XBot::Logger::error("%s: _W.rows() != _W.cols() -> %i != %i! \n", _task_id.c_str(), W.rows(), W.cols());
                 a = false;
             }
 
             //2) Check consistency between matrices
-            if(_A.rows() != _b.size()){
-                XBot::Logger::error("%s: _A.rows() != _b.size() -> %i != %i! \n", _task_id.c_str(), _A.rows(), _b.size());
+            if(A.rows() != _b.size()){
+                XBot::Logger::error("%s: _A.rows() != _b.size() -> %i != %i! \n", _task_id.c_str(), A.rows(), _b.size());
                 a = false;
             }
-            if(_A.rows() != _W.rows()){
-                XBot::Logger::error("%s: _A.rows() != _W.rows() -> %i != %i! \n", _task_id.c_str(), _A.rows(), _W.rows());
+            if(A.rows() != W.rows()){
+                XBot::Logger::error("%s: _A.rows() != _W.rows() -> %i != %i! \n", _task_id.c_str(), A.rows(), W.rows());
                 a = false;
             }
 
             //3) Check task size
-            if(_A.cols() != _x_size){
-                XBot::Logger::error("%s: _A.cols() != _x_size -> %i != %i! \n", _task_id.c_str(), _A.cols(), _x_size);
+            if(A.cols() != _x_size){
+                XBot::Logger::error("%s: _A.cols() != _x_size -> %i != %i! \n", _task_id.c_str(), A.cols(), _x_size);
                 a = false;
             }
 
@@ -521,7 +587,7 @@
             //5) If the Hessian Type is ZERO we want to check that all the entries of _A and _b are zeros!
             if(_hessianType == HST_ZERO)
             {
-                if(!_A.isZero()){
+                if(!A.isZero()){
                     XBot::Logger::error("%s: Hessian is HST_ZERO but _A is not all zeros! \n", _task_id.c_str());
                     a = false;
                 }
@@ -533,8 +599,8 @@
             }
             else{
             //6) If the Hessian Type is NOT ZERO we want to check that _A and _b exists!
-                if(_A.rows() == 0 || _A.cols() == 0){
-                    XBot::Logger::error("%s: _A is [%i x %i]! \n", _task_id.c_str(), _A.rows(), _A.cols());
+                if(A.rows() == 0 || A.cols() == 0){
+                    XBot::Logger::error("%s: _A is [%i x %i]! \n", _task_id.c_str(), A.rows(), A.cols());
                     a = false;
                 }
                 if(_b.size() == 0){
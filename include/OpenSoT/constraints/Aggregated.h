@@ -58,33 +58,38 @@ using namespace OpenSoT::utils;
                 UNILATERAL_TO_BILATERAL = 0x100
             };
 
+            /**
+             * @brief The RowBlock struct: the rows [offset, offset + rows) of Aineq
+             */
+            struct RowBlock {
+                int offset;
+                int rows;
+            };
+
         protected:
-            std::vector<Eigen::VectorXd> _boundUpperBounds, _boundLowerBounds, _boundbeqs, _boundbUpperBounds, _boundbLowerBounds;
-            std::vector<Eigen::MatrixXd> _boundAeqs, _boundAineqs;
-            void initSupportVectorsAndMatrices(const int bound_size)
+            /**
+             * @brief The RowLayout struct stores where each constraint is written
+             * inside the aggregated Aeq and Aineq
+             */
+            struct RowLayout
             {
-                for(unsigned int i = 0; i < bound_size; ++i)
-                {
-                    _boundUpperBounds.push_back(Eigen::VectorXd(0));
-                    _boundLowerBounds.push_back(Eigen::VectorXd(0));
-                    _boundbeqs.push_back(Eigen::VectorXd(0));
-                    _boundbUpperBounds.push_back(Eigen::VectorXd(0));
-                    _boundbLowerBounds.push_back(Eigen::VectorXd(0));
-
-                    _boundAeqs.push_back(Eigen::MatrixXd(0,0));
-                    _boundAineqs.push_back(Eigen::MatrixXd(0,0));
-                }
-            }
+                int eq_offset, eq_rows;
+                int ineq_offset, ineq_rows;
+            };
 
-            VectorPiler _tmpupperBound;
-            VectorPiler _tmplowerBound;
+            /**
+             * @brief _layout one entry for each constraint, computed at the beginning of generateAll()
+             * so that constraints are written directly in their slice of the aggregated matrices
+             */
+            std::vector<RowLayout> _layout;
 
-            MatrixPiler _tmpAeq;
-            VectorPiler _tmpbeq;
+            /**
+             * @brief computeLayout fills _layout and resizes the aggregated matrices
+             * (no memory allocation if the number of rows did not change)
+             */
+            void computeLayout();
 
-            MatrixPiler _tmpAineq;
-            VectorPiler _tmpbUpperBound;
-            VectorPiler _tmpbLowerBound;
+            void appendAineqRowBlocks(std::vector<RowBlock>& blocks, const int offset) const;
 
             std::list< ConstraintPtr > _bounds;
             unsigned int _number_of_bounds;
@@ -149,6 +154,13 @@ using namespace OpenSoT::utils;
             std::list< ConstraintPtr >& getConstraintsList() { return _bounds; }
 
             void generateAll();
+
+            /**
+             * @brief getAineqRowBlocks gives the rows of Aineq written by each constraint at the last
+             * generateAll(). Nested Aggregated are split in the rows of their constraints
+             * @param blocks the row blocks, in the order of the constraints
+             */
+            void getAineqRowBlocks(std::vector<RowBlock>& blocks) const;
         };
     }
  }
@@ -22,6 +22,7 @@
 #include <OpenSoT/tasks/velocity/Cartesian.h>
 #include <xbot2_interface/xbotinterface2.h>
 #include <xbot2_interface/collision.h>
+#include <OpenSoT/utils/CapsuleCollisionModel.h>
 
 #include <srdfdom/model.h>
 #include <Eigen/Dense>
@@ -94,22 +95,37 @@ public:
     void setDetectionThreshold(const double detection_threshold);
 
     /**
-     * @brief update recomputes Aineq and bUpperBound if x is different than the
-     *  previously stored value
-     * @param x the state vector.
+     * @brief getActivePairsError
+     * @param e distance minus link pair threshold for each row of Aineq (max for unused rows),
+     * i.e. ordered as the constrained pairs of the last call to update()
+     */
+    void getActivePairsError(Eigen::VectorXd& e) const;
+
+    /**
+     * @brief update recomputes Aineq and bUpperBound. Distances, witness points and distance
+     * Jacobians are recomputed only if the robot joint position is different than the one used
+     * in the previous call (or the collision model has changed), so that the constraint can be
+     * shared with tasks::velocity::CollisionAvoidance and updated more times per control cycle
+     * at the cost of a single collision computation.
      */
     void update();
 
 
     void setMaxPairs(const unsigned int max_pairs);
 
+    /**
+     * @brief setCollisionList sets the link pairs to be checked
+     * NOTE: a reduced list can be computed offline with utils::CollisionPairPruning
+     * (see the collision_pair_pruning example) and loaded with utils::CollisionPairPruning::loadPairList()
+     * @param collisionList set of link pairs
+     */
     void setCollisionList(std::set<std::pair<std::string, std::string>> collisionList);
 
 
 
     /**
      * @brief collisionModelUpdated must be called after a collision has been added or
-     * removed from the model
+     * removed from the model, it also forces distances to be recomputed at the next update()
      */
     void collisionModelUpdated();
 
@@ -175,6 +191,42 @@ public:
 
     const Eigen::MatrixXd& getCollisionJacobian() const;
 
+    /**
+     * @brief setCapsuleFastPath enables/disables the computation of distances and distance Jacobians
+     * through a utils::CapsuleCollisionModel instead of the narrowphase collision model.
+     * When enabled, all the shapes need to be capsules or spheres: shapes added through
+     * addCollisionShape() which are not capsules/spheres disable the fast path.
+     * @param enable true to use the fast path
+     * @param fit_from_urdf if true, the collision geometries of the collision urdf are approximated by capsules
+     * (spheres, cylinders and boxes are supported, meshes are not)
+     * @return false if the fast path could not be enabled
+     */
+    bool setCapsuleFastPath(const bool enable, const bool fit_from_urdf = true);
+
+    /**
+     * @brief isCapsuleFastPathEnabled
+     * @return true if distances are computed through the capsule fast path
+     */
+    bool isCapsuleFastPathEnabled() const;
+
+    /**
+     * @brief getter for the internal capsule collision model
+     */
+    OpenSoT::utils::CapsuleCollisionModel::Ptr getCapsuleCollisionModel();
+
+    /**
+     * @brief setEnvironmentDistanceField replaces the pairwise checks between robot links and
+     * environment shapes with lookups in a precomputed distance field (see utils::DistanceField).
+     * Links are approximated by capsules, hence the capsule fast path is enabled; environment shapes
+     * added through addCollisionShape() are not considered while the field is set (and are not
+     * required to be capsules/spheres).
+     * @param field distance field with gradients, nullptr to go back to environment shapes
+     * @param points_per_capsule number of points sampled along each link capsule axis
+     * @return false if the robot links can not be approximated by capsules/spheres
+     */
+    bool setEnvironmentDistanceField(OpenSoT::utils::DistanceField::ConstPtr field,
+                                     const unsigned int points_per_capsule = 5);
+
     ~CollisionAvoidance();
 
 protected:
@@ -221,6 +273,30 @@ protected:
      */
     std::unique_ptr<XBot::Collision::CollisionModel> _dist_calc;
 
+    /**
+     * @brief _capsule_model used in place of _dist_calc when _use_capsules is true
+     */
+    OpenSoT::utils::CapsuleCollisionModel::Ptr _capsule_model;
+    bool _use_capsules;
+    bool _capsules_fitted;
+    bool _capsules_compatible;
+    bool _env_capsules_compatible;
+
+    const std::vector<int>& getOrderedCollisionPairIndices() const;
+
+    /**
+     * @brief computeCollisions updates the collision model and computes distances and Jacobians
+     */
+    void computeCollisions();
+
+    /**
+     * @brief joint position used in the last call to computeCollisions()
+     */
+    Eigen::VectorXd _q_collisions;
+    bool _collisions_valid;
+
+    Eigen::VectorXd _active_pairs_error;
+
     Eigen::VectorXd _distances;
     Eigen::MatrixXd _distance_J;
     int _num_active_pairs;
@@ -39,6 +39,11 @@
              * @brief The ConvexHull class implements a constraint of the type
              * \f$A_{\text{CH}}J_{\text{CoM}}\dot{q} \leq b_{\text{CH}}\f$, where every row in
              * \f$\left[ A_{\text{CH}} , -b_{\text{CH}}\right]\f$
+             *
+             * The vertices of the support polygon (i.e. which contacts lie on the hull) are cached and
+             * recomputed only when a contact moves more than a tolerance (see setContactTolerance()),
+             * the constraint is then built from the current contact positions. update() does not allocate
+             * memory. At most convex_hull::MAX_POINTS contacts are supported.
             */
             class ConvexHull: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
@@ -51,8 +56,17 @@
                 std::list<std::string> _links_in_contact;
                 Eigen::MatrixXd _JCoM;
                 Eigen::MatrixXd _C;
-                std::list<Eigen::Vector3d> _points;
-                std::vector<Eigen::Vector3d> _tmp_ch;
+
+                std::array<Eigen::Vector3d, convex_hull::MAX_POINTS> _contacts;
+                std::array<Eigen::Vector3d, convex_hull::MAX_POINTS> _cached_contacts;
+                std::array<int, convex_hull::MAX_POINTS> _hull_indices;
+                int _hull_size;
+                bool _hull_valid;
+                double _contact_tolerance;
+                Eigen::Affine3d _w_T_contact;
+                Eigen::Vector3d _com;
+
+                void resize();
 
             public:
                 /**
@@ -86,8 +100,20 @@
                 static void getLineCoefficients(const Eigen::Vector3d &p0, const Eigen::Vector3d &p1,
                                                 double &a, double& b, double &c);
 
+                /**
+                 * @brief getConvexHull computes the vertices of the support polygon w.r.t. the CoM
+                 * @param ch vertices in counter-clockwise order (z = 0)
+                 * @return false if the support polygon could not be computed
+                 */
                 bool getConvexHull(std::vector<Eigen::Vector3d>& ch);
 
+                /**
+                 * @brief setContactTolerance sets the displacement in [m] of a contact
+                 * above which the vertices of the support polygon are recomputed
+                 * @param tolerance
+                 */
+                void setContactTolerance(const double tolerance);
+
                 /**
                  * @brief setSafetyMargin sets a safety margin in [m] for the convex hull
                  * @param sagetyMargin
@@ -101,10 +127,7 @@
                     return _links_in_contact;
                 }
 
-                void setLinksInContact(const std::list<std::string>& links_inc_contact)
-                {
-                    _links_in_contact = links_inc_contact;
-                }
+                void setLinksInContact(const std::list<std::string>& links_inc_contact);
             };
         }
     }
@@ -2,9 +2,11 @@
 #define _WB_SOT_SOLVERS_BACK_END_H_
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include <xbot2_interface/logger.h>
 #include <boost/any.hpp>
 #include <OpenSoT/Task.h>
+#include <OpenSoT/solvers/QPCapture.h>
 
 namespace OpenSoT{
     namespace solvers{
@@ -44,6 +46,23 @@ namespace OpenSoT{
          */
         void log(XBot::MatLogger2::Ptr logger, int i, const std::string& prefix);
 
+        /**
+         * @brief setFlightRecorder registers H, g, A, lA, uA, l, u and the solution as channels of a FlightRecorder,
+         * named as in log(), see record(). It has to be called before FlightRecorder::start()
+         * @param recorder a FlightRecorder
+         * @param i an index related to the particular index of the problem
+         * @param prefix a prefix before the channel names
+         * @param decimation of the channels
+         */
+        void setFlightRecorder(utils::FlightRecorder::Ptr recorder, int i, const std::string& prefix,
+                               const int decimation = 1);
+
+        /**
+         * @brief record logs H, g, A, lA, uA, l, u and the solution in the FlightRecorder set with
+         * setFlightRecorder(), it is real-time safe
+         */
+        void record();
+
         /**
          * @brief updateProblem update the whole problem see updateTask(), updateConstraints() and updateBounds()
          * @param H updated task matrix
@@ -62,6 +81,28 @@ namespace OpenSoT{
         void printProblemInformation(const int problem_number, const std::string& problem_id,
                                      const std::string& constraints_id, const std::string& bounds_id);
 
+        /**
+         * @brief setCapture attaches a QPCapture to the back-end: the problems solved through solveAndCapture()
+         * are written to it, according to its trigger.
+         * NOTE: the solve done by initProblem() is not captured
+         * @param capture a QPCapture, nullptr to detach the actual one
+         * @param id written together with each captured problem (e.g. the level of the stack)
+         */
+        void setCapture(QPCapture::Ptr capture, const int id = 0);
+
+        /**
+         * @brief getCapture
+         * @return the attached QPCapture, nullptr if none
+         */
+        QPCapture::Ptr getCapture() const { return _capture; }
+
+        /**
+         * @brief solveAndCapture calls solve() and, if a QPCapture is attached and armed, passes it the problem
+         * together with the outcome and the time of the solve and the previous solution (warm-start)
+         * @return true if the QP problem is solved
+         */
+        bool solveAndCapture();
+
         ///VIRTUAL METHODS
 
         /**
@@ -170,6 +211,32 @@ namespace OpenSoT{
             return 0;
         }
 
+        /**
+         * @brief setConstraintsSparsity declares the structural nonzeros of the constraint matrix A:
+         * entries of A outside the pattern are assumed to be always zero.
+         * Has to be called before initProblem(), back-ends which do not exploit sparsity ignore it
+         * @param pattern number_of_constraints x number_of_variables matrix, its stored entries
+         * are the structural nonzeros of A
+         * @return true if the pattern is used by the back-end, false by default
+         */
+        virtual bool setConstraintsSparsity(const Eigen::SparseMatrix<double>& pattern)
+        {
+            return false;
+        }
+
+        /**
+         * @brief setHessianSparsity declares the structural nonzeros of the Hessian H:
+         * entries of H outside the pattern are assumed to be always zero.
+         * Has to be called before initProblem(), back-ends which do not exploit sparsity ignore it
+         * @param pattern number_of_variables x number_of_variables matrix, its stored entries
+         * are the structural nonzeros of H
+         * @return true if the pattern is used by the back-end, false by default
+         */
+        virtual bool setHessianSparsity(const Eigen::SparseMatrix<double>& pattern)
+        {
+            return false;
+        }
+
     protected:
         ///VIRTUAL METHODS
         /**
@@ -213,6 +280,14 @@ namespace OpenSoT{
          * @brief _number_of_variables which remain constant during BE existence
          */
         int _number_of_variables;
+
+    private:
+        utils::FlightRecorder::Ptr _recorder;
+        std::vector<int> _recorder_channels;
+
+        QPCapture::Ptr _capture;
+        int _capture_id = 0;
+        Eigen::VectorXd _warm_start;
     };
 
     }
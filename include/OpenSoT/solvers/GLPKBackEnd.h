@@ -23,6 +23,13 @@ public:
          */
         int ROUND_BOUNDS = 0;
 
+        /**
+         * @brief WARM_START
+         *  true: the LP is solved with the dual simplex starting from the last optimal basis (default)
+         *  false: the LP is solved starting from the standard basis
+         */
+        bool WARM_START = true;
+
         std::vector<var_id_kind> var_id_kind_;
         std::shared_ptr<glp_iocp> param;
 
@@ -57,6 +64,12 @@ public:
     Eigen::VectorXd getGLPKLowerConstraints();
     Eigen::MatrixXd getGLPKConstraintMatrix();
 
+    /**
+     * @brief getSimplexIterations
+     * @return number of simplex iterations of the LP (the LP relaxation for a MILP) at the last solve
+     */
+    int getSimplexIterations() const { return _simplex_iterations; }
+
     /**
      * @brief writeLP call glp_write_lp to have text file of the problem
      * @return check glpk.h
@@ -74,6 +87,19 @@ private:
 
     void createsVectorsFromConstraintsMatrix();
 
+    /**
+     * @brief loadChangedData loads in the glpk problem only the coefficients and bounds
+     * which changed since the last solve. The basis factorization remains valid if A did not change
+     */
+    void loadChangedData();
+
+    /**
+     * @brief solveLP solves the LP (or the LP relaxation of the MILP) with the simplex,
+     * starting from the last basis if WARM_START is true
+     * @return true if an optimal basis is found
+     */
+    bool solveLP();
+
     int checkConstrType(const double u, const double l);
 
     void roundBounds();
@@ -82,6 +108,29 @@ private:
 
     std::vector<var_id_kind> _var_id_kind;
 
+    /**
+     * @brief _is_mip true if some variable is not continuous
+     */
+    bool _is_mip;
+
+    /**
+     * @brief _simplex_iterations done by solveLP() at the last solve
+     */
+    int _simplex_iterations;
+
+    /**
+     * @brief _A_loaded, _g_loaded, _lA_loaded, _uA_loaded, _l_loaded and _u_loaded are the data
+     * currently loaded in the glpk problem
+     */
+    Eigen::MatrixXd _A_loaded;
+    Eigen::VectorXd _g_loaded, _lA_loaded, _uA_loaded, _l_loaded, _u_loaded;
+
+    /**
+     * @brief _col_index and _col_values are used to load a column of A (glpk arrays start from 1)
+     */
+    Eigen::VectorXi _col_index;
+    Eigen::VectorXd _col_values;
+
     /**
      * @brief printErrorOutput prints outputs error meaning (taken directly from the documentation of GLPK)
      * @param out the error code
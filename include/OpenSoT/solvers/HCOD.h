@@ -76,6 +76,19 @@ namespace OpenSoT{
                  */
                 void setDamping(double damping);
 
+                /**
+                 * @brief setActiveSetWarmStart
+                 * @param warm_start if true (default) each solve starts the active search from the
+                 * active set found at the previous solve, otherwise from the equality constraints only
+                 */
+                void setActiveSetWarmStart(const bool warm_start);
+
+                /**
+                 * @brief getActiveSetWarmStart
+                 * @return true if the active search is warm started
+                 */
+                bool getActiveSetWarmStart() const;
+
                 /**
                  * @brief printSOT print some SOT infos
                  */
@@ -125,6 +138,13 @@ namespace OpenSoT{
                  */
                 void copy_tasks();
 
+                /**
+                 * @brief update_weight_sqrt recomputes the square root of the i-th task weight
+                 * only if the weight (or its diagonal flag) changed since the last call
+                 * @param i task index
+                 */
+                void update_weight_sqrt(const unsigned int i);
+
                 /**
                  * @brief _A matrix to pile constraints matrices
                  */
@@ -148,6 +168,7 @@ namespace OpenSoT{
                 // TASKS WEIGHTS ARE HANDLED WITH THE FOLLOWING OBJECTS.
                 // NOTE THAT: FOR DIAGONAL MATRICES (WHEN THE WEIGHT IS DIAGONAL FLAG IS TRUE) THE
                 // WEIGHT FOR THE TASK IS THE SIMPLE SQRT OF THE ELEMENTS ON THE DIAGONAL.
+                // THE SQRT IS CACHED AND RECOMPUTED ONLY WHEN THE WEIGHT CHANGES.
                 //
                 // TO DISABLE COMPUTATIONS OF WEIGHTS PLEASE SET THE FLAG: disable_weights_computation (default false, weights are computed).
                 /**
@@ -155,11 +176,33 @@ namespace OpenSoT{
                  */
                 bool _disable_weights_computation;
 
+                enum class WeightType { IDENTITY, DIAGONAL, DENSE };
+
                 /**
-                 * @brief _W vector to handle task weights
+                 * @brief _W vector to store the task weights whose sqrt is cached
                  */
                 std::vector<Eigen::MatrixXd> _W;
 
+                /**
+                 * @brief _W_is_diagonal diagonal flag of the cached weights
+                 */
+                std::vector<bool> _W_is_diagonal;
+
+                /**
+                 * @brief _W_type how the cached sqrt is applied
+                 */
+                std::vector<WeightType> _W_type;
+
+                /**
+                 * @brief _W_sqrt sqrt of dense weights
+                 */
+                std::vector<Eigen::MatrixXd> _W_sqrt;
+
+                /**
+                 * @brief _W_sqrt_diagonal sqrt of diagonal weights
+                 */
+                std::vector<Eigen::VectorXd> _W_sqrt_diagonal;
+
                 /**
                  * @brief _sqrt is used to compute sqrt of positive-definite symmetric weight matrices
                  */
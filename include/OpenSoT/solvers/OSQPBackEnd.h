@@ -139,22 +139,77 @@ public:
         return _eps_regularisation;
     }
 
+    /**
+     * @brief setConstraintsSparsity the constraint part of A is stored in OSQP with the given
+     * structural nonzeros instead of as a dense block. Has to be called before initProblem(),
+     * entries of A outside the pattern are not passed to OSQP
+     * (in debug builds updateConstraints() fails if A has nonzeros outside the pattern)
+     * @param pattern number_of_constraints x number_of_variables structural nonzeros of A
+     * @return false if the size of the pattern is wrong
+     */
+    bool setConstraintsSparsity(const Eigen::SparseMatrix<double>& pattern);
+
+    /**
+     * @brief setHessianSparsity the Hessian is stored in OSQP with the upper triangular part of the
+     * given structural nonzeros (plus the diagonal) instead of as a full upper triangle.
+     * Has to be called before initProblem(), entries of H outside the pattern are not passed to OSQP
+     * (in debug builds updateTask() fails if H has nonzeros outside the pattern)
+     * @param pattern number_of_variables x number_of_variables structural nonzeros of H
+     * @return false if the size of the pattern is wrong
+     */
+    bool setHessianSparsity(const Eigen::SparseMatrix<double>& pattern);
+
+    /**
+     * @brief getHessianPattern
+     * @return the structural nonzeros of the upper triangular part of P passed to OSQP (values are not meaningful)
+     */
+    const Eigen::SparseMatrix<double>& getHessianPattern() const { return _Psparse; }
+
+    /**
+     * @brief getConstraintsPattern
+     * @return the structural nonzeros of the constraints (bounds included) passed to OSQP (values are not meaningful)
+     */
+    const Eigen::SparseMatrix<double>& getConstraintsPattern() const { return _Asparse; }
+
+protected:
+    /**
+     * @brief updateP passes the values of P to OSQP, which factorizes the KKT matrix again.
+     * It is called by solve() only if P changed
+     * @return the flag of osqp_update_P()
+     */
+    virtual c_int updateP();
+
+    /**
+     * @brief updateA same as updateP() for A
+     * @return the flag of osqp_update_A()
+     */
+    virtual c_int updateA();
+
 private:
     
     typedef Eigen::SparseMatrix<double> SparseMatrix;
     typedef Eigen::SparseMatrix<double, Eigen::RowMajor> SparseMatrixRowMajor;
     
     /**
-     * @brief __generate_data_struct creates DENSE Hessian and Constraints matrices using a SPARSE representation.
+     * @brief __generate_data_struct creates SPARSE Hessian (upper triangular) and Constraints matrices.
+     * If a sparsity pattern has been set it is used, otherwise the matrices are dense.
      * Note that bounds are treated as constraints.
      * @param number_of_variables of the QP
      * @param number_of_constraints of the QP
      * @param number_of_bounds of the QP
      */
     void __generate_data_struct(const int number_of_variables, const int number_of_constraints, const int number_of_bounds);
-    void update_data_struct();
-    
+
+    /**
+     * @brief upper_triangular_sparse_update copies the structural nonzeros of _H in _P_values
+     * and sets _P_changed if any value changed
+     */
     void upper_triangular_sparse_update();
+
+    /**
+     * @brief constraints_sparse_update same as upper_triangular_sparse_update() for _A and _A_values
+     */
+    void constraints_sparse_update();
     
     
     /**
@@ -177,9 +232,28 @@ private:
     SparseMatrix _Asparse, _Asparse_upper;
     SparseMatrixRowMajor _Asparse_rowmaj;
     SparseMatrix _Psparse;
-    Eigen::MatrixXd _Adense;
     Eigen::VectorXd _P_values;
 
+    /**
+     * @brief _A_pattern structural nonzeros of the constraints, empty if A is dense
+     */
+    SparseMatrix _A_pattern;
+
+    /**
+     * @brief _H_pattern structural nonzeros of the Hessian, empty if H is dense
+     */
+    SparseMatrix _H_pattern;
+
+    /**
+     * @brief _P_changed, _A_changed are true if values have changed since they were passed to OSQP
+     */
+    bool _P_changed, _A_changed;
+
+    /**
+     * @brief _A_values values of _Asparse (constraints and bounds) in CSC order
+     */
+    Eigen::VectorXd _A_values;
+
 
     std::shared_ptr<csc> _Acsc;
     std::shared_ptr<csc> _Pcsc;
@@ -0,0 +1,233 @@
+#ifndef _WB_SOT_SOLVERS_QP_CAPTURE_H_
+#define _WB_SOT_SOLVERS_QP_CAPTURE_H_
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenSoT{
+    namespace solvers{
+
+    /**
+     * @brief The QPCapture class writes the QP problems solved by one or more BackEnds into a binary file,
+     * to reproduce slow or failed solves offline (see QPCaptureReader and the qp_replay example).
+     *
+     * The file starts with a FileHeader and then contains one record per captured problem:
+     * a RecordHeader followed by H (n x n), g (n), A (m x n), lA (m), uA (m), l (n), u (n),
+     * the warm-start (the solution of the previous solve, n) and the solution (n),
+     * stored as column-major doubles. Records can be read in place from a memory-mapped file.
+     */
+    class QPCapture{
+    public:
+        typedef std::shared_ptr<QPCapture> Ptr;
+
+        /**
+         * @brief The Trigger enum selects which solves are written to file
+         */
+        enum class Trigger{
+            ALWAYS,                 /**< every solve */
+            SLOW_SOLVE,             /**< solves taking more than the slow solve time */
+            FAILURE,                /**< failed solves */
+            SLOW_SOLVE_OR_FAILURE   /**< slow or failed solves */
+        };
+
+        struct FileHeader{
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t record_header_size;
+        };
+
+        struct RecordHeader{
+            std::uint64_t size;     /**< size in bytes of the record, header included */
+            std::uint64_t sequence; /**< sequence number of the problem, counting also the not captured ones */
+            std::int32_t id;        /**< user defined id, e.g. the level of the stack */
+            std::int32_t n;         /**< number of variables */
+            std::int32_t m;         /**< number of constraints */
+            std::int32_t success;   /**< 1 if the back-end solved the problem */
+            double solve_time;      /**< [s] */
+        };
+
+        static const char MAGIC[8];
+        static const std::uint32_t VERSION = 1;
+
+        /**
+         * @brief QPCapture opens (and truncates) the capture file
+         * @param file_name of the capture
+         * @param trigger selects which solves are captured
+         * @param slow_solve_time [s] used by the SLOW_SOLVE triggers
+         */
+        QPCapture(const std::string& file_name, const Trigger trigger = Trigger::ALWAYS,
+                  const double slow_solve_time = 1e-3);
+        ~QPCapture();
+
+        QPCapture(const QPCapture&) = delete;
+        QPCapture& operator=(const QPCapture&) = delete;
+
+        /**
+         * @brief isOpen
+         * @return true if the capture file was correctly opened
+         */
+        bool isOpen() const { return _file != nullptr; }
+
+        /**
+         * @brief setArmed arms (default) or disarms the capture: while disarmed the back-ends only solve,
+         * without timing the solve nor copying the warm-start, and nothing is written
+         */
+        void setArmed(const bool armed){ _armed = armed; }
+
+        /**
+         * @brief isArmed
+         * @return true if the capture is armed and the file is open
+         */
+        bool isArmed() const { return _armed && _file != nullptr; }
+
+        /**
+         * @brief skip counts a solve which is not passed to capture(), to keep the sequence numbers
+         * of the captured problems
+         */
+        void skip(){ _sequence++; }
+
+        /**
+         * @brief isTriggered
+         * @param success of the solve
+         * @param solve_time [s] of the solve
+         * @return true if a solve with this outcome has to be captured
+         */
+        bool isTriggered(const bool success, const double solve_time) const;
+
+        /**
+         * @brief capture writes a QP problem to file if isTriggered(success, solve_time).
+         * Empty l and u are stored as infinite bounds
+         * @return false if the problem should have been written but writing failed
+         */
+        bool capture(const int id, const bool success, const double solve_time,
+                     const Eigen::MatrixXd& H, const Eigen::VectorXd& g,
+                     const Eigen::MatrixXd& A, const Eigen::VectorXd& lA, const Eigen::VectorXd& uA,
+                     const Eigen::VectorXd& l, const Eigen::VectorXd& u,
+                     const Eigen::VectorXd& warm_start, const Eigen::VectorXd& solution);
+
+        /**
+         * @brief flush the captured problems to disk
+         */
+        void flush();
+
+        /**
+         * @brief getNumberOfCapturedProblems
+         * @return number of problems written to file
+         */
+        std::uint64_t getNumberOfCapturedProblems() const { return _captured; }
+
+        void setTrigger(const Trigger trigger){ _trigger = trigger; }
+        Trigger getTrigger() const { return _trigger; }
+
+        void setSlowSolveTime(const double slow_solve_time){ _slow_solve_time = slow_solve_time; }
+        double getSlowSolveTime() const { return _slow_solve_time; }
+
+        const std::string& getFileName() const { return _file_name; }
+
+    private:
+        std::string _file_name;
+        std::FILE* _file;
+        bool _armed;
+        Trigger _trigger;
+        double _slow_solve_time;
+        std::uint64_t _sequence;
+        std::uint64_t _captured;
+
+        void write(const double* data, const Eigen::Index size);
+        void writeConstant(const double value, const Eigen::Index size);
+    };
+
+    /**
+     * @brief The QPCaptureReader class memory-maps a file written by QPCapture and gives access
+     * to the captured problems without copying them
+     */
+    class QPCaptureReader{
+    public:
+        typedef std::shared_ptr<QPCaptureReader> Ptr;
+
+        typedef Eigen::Map<const Eigen::MatrixXd> ConstMatrixMap;
+        typedef Eigen::Map<const Eigen::VectorXd> ConstVectorMap;
+
+        /**
+         * @brief The Problem struct views a captured QP problem:
+         *
+         *      min  0.5 x'Hx + g'x
+         *  st.     lA <= Ax <= uA
+         *           l <=  x <= u
+         */
+        struct Problem{
+            Problem(const QPCapture::RecordHeader* header);
+
+            const QPCapture::RecordHeader* header;
+            ConstMatrixMap H;
+            ConstVectorMap g;
+            ConstMatrixMap A;
+            ConstVectorMap lA;
+            ConstVectorMap uA;
+            ConstVectorMap l;
+            ConstVectorMap u;
+            ConstVectorMap warm_start;
+            ConstVectorMap solution;
+        };
+
+        /**
+         * @brief QPCaptureReader maps the capture file and indexes its records
+         * @param file_name of the capture
+         */
+        QPCaptureReader(const std::string& file_name);
+        ~QPCaptureReader();
+
+        QPCaptureReader(const QPCaptureReader&) = delete;
+        QPCaptureReader& operator=(const QPCaptureReader&) = delete;
+
+        /**
+         * @brief isOpen
+         * @return true if the file was mapped and its header is valid
+         */
+        bool isOpen() const { return _data != nullptr; }
+
+        /**
+         * @brief size
+         * @return number of captured problems
+         */
+        std::size_t size() const { return _records.size(); }
+
+        /**
+         * @brief getProblem
+         * @param i index of the captured problem
+         * @return a view of the i-th captured problem
+         */
+        Problem getProblem(const std::size_t i) const;
+
+        /**
+         * @brief exportQPS writes a problem in the (free) QPS format used by the Maros-Meszaros test set.
+         * Values with magnitude larger than or equal to 1e20 are considered infinite.
+         * @param problem to export
+         * @param file_name of the QPS file
+         * @param name of the problem
+         * @return false if the file can not be written
+         */
+        static bool exportQPS(const Problem& problem, const std::string& file_name, const std::string& name = "OPENSOT");
+
+        /**
+         * @brief exportMat writes all the problems to a MAT-file, using the names H_i, g_i, A_i, lA_i, uA_i, l_i, u_i,
+         * warm_start_i and solution_i for the i-th problem
+         * @param file_name of the MAT-file
+         * @return false if the file can not be written
+         */
+        bool exportMat(const std::string& file_name) const;
+
+    private:
+        const char* _data;
+        std::size_t _size;
+        std::vector<const QPCapture::RecordHeader*> _records;
+    };
+
+    }
+}
+
+#endif
@@ -6,26 +6,41 @@
 #include <Eigen/src/Core/util/Macros.h>
 #include <OpenSoT/tasks/Aggregated.h>
 
-#if EIGEN_MINOR_VERSION <= 0
-#include <Eigen/LU>
-#endif
-
 namespace OpenSoT{
     namespace solvers{
     struct stack_level
     {
         Eigen::MatrixXd _P;
         Eigen::MatrixXd _JP;
-        Eigen::MatrixXd _JPpinv;
+        /**
+         * @brief _JPsvd is preallocated in the constructor: JacobiSVD::compute() does not allocate
+         * for matrices of the preallocated size. BDCSVD::compute() copies its input and
+         * CompleteOrthogonalDecomposition does not give the singular values used by the damping
+         */
         Eigen::JacobiSVD<Eigen::MatrixXd> _JPsvd;
-#if EIGEN_MINOR_VERSION <= 0
-        Eigen::FullPivLU<Eigen::MatrixXd> _FPL;
-#endif
         /**
          * @brief _WChol is used to handle weights for each task.
-         * We compute W = LL' and then we multiply L'A and L'b
+         * We compute W = LL' and then we multiply L'A and L'b.
+         * The factorization is recomputed only when the weight _W changes; identity and
+         * diagonal weights are not factorized (_WSqrt is used instead)
          */
         Eigen::LLT<Eigen::MatrixXd> _WChol;
+        /**
+         * @brief _W_blocks are the diagonal blocks of the weight of an Aggregated task:
+         * each block is factorized and applied on its own, _WU holds the L' of the blocks
+         */
+        std::vector<tasks::Aggregated::WeightBlock> _W_blocks;
+        Eigen::MatrixXd _WU;
+        Eigen::MatrixXd _W;
+        Eigen::VectorXd _WSqrt;
+        bool _W_is_identity;
+        bool _W_is_diagonal;
+        /**
+         * @brief workspace preallocated in the constructor
+         */
+        Eigen::MatrixXd _tmp;
+        Eigen::VectorXd _residual, _tmp_residual;
+        Eigen::VectorXd _singular_values_inv, _Ut_residual;
     };
     /**
      * @brief The eHQP class implements an equality Hierarchical QP solver as the one used in:
@@ -40,14 +55,15 @@ namespace OpenSoT{
         std::vector<stack_level> _stack_levels;
 
         /**
-         * @brief getDampedPinv computes the weighted, damped pseudoinverse of A
-         *        The pseudoinverse is damped using one of the methods listed in 
-         *        "Deo and Walker, 1995, Overview of damped least-squares methods 
+         * @brief computeDampedSingularValuesInv computes the inverse of the singular values used by the
+         *        weighted, damped pseudoinverse of JP.
+         *        The pseudoinverse is damped using one of the methods listed in
+         *        "Deo and Walker, 1995, Overview of damped least-squares methods
          *        for inverse kinematics of robot manipulators", and used e.g. in
-         *        "The Tasks Priority Matrix: a new tool for hierarchical redundancy 
+         *        "The Tasks Priority Matrix: a new tool for hierarchical redundancy
          *        resolution". The pseudoinversion is computed by performing a "thin"
-         *        SVD decomposition \f$J = U \Sigma V^T\f$ with 
-         *        \f$J\in\mathcal{R}^{m\timesn}\f$, 
+         *        SVD decomposition \f$J = U \Sigma V^T\f$ with
+         *        \f$J\in\mathcal{R}^{m\timesn}\f$,
          *        \f$U\in\mathcal{R}^{m\timesr}\f$ unitary,
          *        \f$V\in\mathcal{R}^{n\timesr}\f$ unitary,
          *        \f$\Sigma\in\mathcal{R}^{r\timesr}\f$ diagonal, and with
@@ -59,19 +75,25 @@ namespace OpenSoT{
          *        manipulability of the robot.
          *        The JacobiSVD method from Eigen is used, which uses QR decomposition
          *        by Householder transformations with column pivoting.
-         *        The SVD decomposition is also used the compute the projectors, since
-         *        we have that \f$AA^\dagger=U_1U_1^T\f$
-         *
+         *        The rank is the number of singular values above sigma_min (relative to the biggest one).
+         *        The pseudoinverse is never formed: it is applied as \f$V (\Sigma^\dagger (U^T r))\f$,
+         *        and the SVD is also used the compute the projectors, since
+         *        we have that \f$A^\dagger A=V_1V_1^T\f$
+         * @return the rank of JP
+         */
+        int computeDampedSingularValuesInv(stack_level& level) const;
+
+        /**
+         * @brief updateWeight updates the factorization of the weight of task if it changed
          */
-        #if EIGEN_MINOR_VERSION <= 0
-        Eigen::MatrixXd getDampedPinv(  const Eigen::MatrixXd& J,
-                                const Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
-                                const Eigen::FullPivLU<Eigen::MatrixXd>& fpl) const;
-        #else
-        Eigen::MatrixXd getDampedPinv(  const Eigen::MatrixXd& J,
-                                        const Eigen::JacobiSVD<Eigen::MatrixXd>& svd) const;
-        #endif
-                                        
+        void updateWeight(stack_level& level, const TaskPtr& task) const;
+
+        /**
+         * @brief applyWeight computes M = L'*M, using tmp as workspace
+         */
+        template <typename Matrix>
+        void applyWeight(const stack_level& level, Matrix& M, Matrix& tmp) const;
+
         /** @brief sigma_min is the minimum value which is accepted for 
          *                   a singular value before regularization is enabled */
         double sigma_min;
@@ -13,6 +13,20 @@ using namespace OpenSoT::utils;
 namespace OpenSoT{
 namespace solvers{
 
+/**
+ * @brief The eiQuadProgOptions struct contains the options which can be passed to eiQuadProgBackEnd::setOptions()
+ */
+struct eiQuadProgOptions {
+    /**
+     * @brief single_precision if true H, g and the constraints, which are still assembled in double,
+     * are cast to float at each solve and the QP is solved in single precision: the relative accuracy of the
+     * solution is about 1e-6 (e.g. enough for velocity IK).
+     * NOTE: the casts are an additional cost and the active-set iterations are mostly scalar loops,
+     * hence there is no guaranteed speed-up: measure it on the target (see example_eiquadprog_precision)
+     */
+    bool single_precision = false;
+};
+
 /**
  * @brief The eiQuadProgBackEnd class implements a back-end based on eiQuadProg by B. Stepehn https://www.cs.cmu.edu/~bstephe1/eiquadprog.hpp
  */
@@ -63,6 +77,33 @@ private:
     MatrixPiler _CIPiler;
     VectorPiler _ci0Piler;
 
+    /**
+     * @brief _solver keeps the eiQuadProg workspace between two solve() calls
+     */
+    Eigen::QuadProgSolver<> _solver;
+
+    /**
+     * @brief _CI transposed inequality matrix passed to eiQuadProg
+     */
+    Eigen::MatrixXd _CI;
+
+    /**
+     * @brief _CE and _ce0 are empty: equality constraints are passed as inequalities
+     */
+    Eigen::MatrixXd _CE;
+    Eigen::VectorXd _ce0;
+
+    eiQuadProgOptions _options;
+
+    /**
+     * @brief single precision copies of the QP used when _options.single_precision is true
+     */
+    Eigen::QuadProgSolver<Eigen::Dynamic, Eigen::Dynamic, float> _solver_f;
+    Eigen::MatrixXf _Hf, _CIf, _CEf;
+    Eigen::VectorXf _gf, _ci0f, _ce0f, _solution_f;
+
+    bool __solve();
+
 
 
     void __generate_data_struct();
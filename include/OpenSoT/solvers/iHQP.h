@@ -192,6 +192,38 @@ namespace OpenSoT{
          */
         bool getBackEnd(const unsigned int i, BackEnd::Ptr& back_end);
 
+        /**
+         * @brief setCapture attaches the same QPCapture to the back-ends of all the levels,
+         * using the level as id of the captured problems (see BackEnd::setCapture()).
+         * NOTE: the problems solved in the constructor (by BackEnd::initProblem()) are not captured
+         * @param capture a QPCapture, nullptr to detach the actual one
+         */
+        void setCapture(QPCapture::Ptr capture);
+
+        /**
+         * @brief setFlightRecorder registers the QP problems of all the levels as channels of a FlightRecorder,
+         * named as in log(), see BackEnd::setFlightRecorder()
+         * @param recorder a FlightRecorder
+         * @param decimation of the channels
+         * @return true
+         */
+        bool setFlightRecorder(utils::FlightRecorder::Ptr recorder, const int decimation = 1) override;
+
+        /**
+         * @brief record logs the QP problems of all the levels in the FlightRecorder set with setFlightRecorder()
+         */
+        void record() override;
+
+        /**
+         * @brief setPerTaskHessian enables the computation of the cost of Aggregated levels as a sum of
+         * the contributions of the aggregated tasks (see tasks::Aggregated::computeHessianAndGradient()).
+         * The contributions are recomputed at each solve: it pays off when the aggregated tasks
+         * act on few columns each (e.g. end-effector tasks on disjoint chains).
+         * If false (default), the cost is computed from A, W and b of the level
+         * @param flag true or false
+         */
+        void setPerTaskHessian(const bool flag){ _per_task_hessian = flag; }
+
     protected:
         virtual void _log(XBot::MatLogger2::Ptr logger, const std::string& prefix);
 
@@ -215,6 +247,21 @@ namespace OpenSoT{
          */
         bool prepareSoT(const std::vector<solver_back_ends> be_solver);
 
+        /**
+         * @brief computeSparsityPattern computes the structural nonzeros of H and A of a level from the column
+         * supports at init of its blocks of rows: each task (the tasks of an Aggregated are taken one by one)
+         * and each constraint is assumed to act only on the columns it uses at init, as the variables of an
+         * AffineHelper or the joints of a kinematic chain. A SubTask takes the columns of its whole task,
+         * the columns masked by the active joints mask and the inactive tasks are kept as structural nonzeros.
+         * The patterns are used only by sparse back-ends.
+         * @param i level
+         * @param constraints_task_i constraints of the level
+         * @param H_pattern Hessian pattern, the diagonal is always included
+         * @param A_pattern pattern of the constraints of the level followed by the optimality constraints
+         */
+        void computeSparsityPattern(const unsigned int i, OpenSoT::constraints::Aggregated& constraints_task_i,
+                                    Eigen::SparseMatrix<double>& H_pattern, Eigen::SparseMatrix<double>& A_pattern);
+
         /**
          * @brief computeCostFunction compute a cost function for velocity control:
          *          F = ||Jdq - v||
@@ -242,6 +289,11 @@ namespace OpenSoT{
         Eigen::MatrixXd H;
         Eigen::VectorXd g;
 
+        /**
+         * @brief _per_task_hessian if true the cost of Aggregated levels exploits their structure
+         */
+        bool _per_task_hessian = false;
+
         //USER REGULARISATION
         Eigen::MatrixXd Hr;
         Eigen::VectorXd gr;
@@ -59,6 +59,11 @@ namespace solvers {
         OpenSoT::utils::MatrixPiler _b_lower;
         OpenSoT::utils::MatrixPiler _b_upper;
 
+        /**
+         * @brief _x_offset first column of x, -1 if x is not a plain variable and the whole
+         * constraint has to be computed at each update
+         */
+        int _x_offset;
     };
 
     class task_to_constraint_helper: public Constraint<Eigen::MatrixXd, Eigen::VectorXd>
@@ -93,6 +98,12 @@ namespace solvers {
         Eigen::VectorXd o, inf, ones;
         Eigen::MatrixXd O;
         double M = 10.; //This is for the Big-M constraint
+
+        /**
+         * @brief _x_offset first column of x, -1 if x or t are not plain variables and the whole
+         * constraint has to be computed at each update
+         */
+        int _x_offset;
     };
 
     class l1HQP: public Solver<Eigen::MatrixXd, Eigen::VectorXd>
@@ -117,11 +128,18 @@ namespace solvers {
              */
             unsigned int getFirstSlackIndex(){ return _first_slack_index;}
 
+            /**
+             * @brief getBackEnd
+             * NOTE: if the size of the constraints changes, solve() creates a new back-end and the
+             * returned one is not used anymore
+             * @param back_end internal solver
+             */
             void getBackEnd(BackEnd::Ptr& back_end);
 
             /**
              * @brief getInternalProblem(), getConstraints(), getHardConstraints(), getTasks() and
-             * getPriorityConstraints() are ONLY for debugging
+             * getPriorityConstraints() are ONLY for debugging.
+             * NOTE: the internal problem is not updated by solve(), which assembles the constraints in place
              * @return
              */
             const std::shared_ptr<AutoStack>& getInternalProblem(){ return _internal_stack;}
@@ -147,6 +165,7 @@ namespace solvers {
             double _epsRegularisation;
 
             OpenSoT::AutoStack& _stack_of_tasks;
+            solver_back_ends _be_solver;
             std::shared_ptr<OptvarHelper> _opt;
             /**
              * @brief _linear_gains vector of gains
@@ -183,10 +202,57 @@ namespace solvers {
             void creates_constraints();
             bool creates_solver(const solver_back_ends);
 
+            /**
+             * @brief assemble_constraints piles the whole internal constraints and computes their sparsity pattern
+             */
+            void assemble_constraints();
+
+            /**
+             * @brief update_constraints updates in place the blocks of the internal constraints which depend
+             * on the tasks and on the constraints of the original problem
+             * @return false if their size changed, then assemble_constraints() and creates_solver() have to be called
+             */
+            bool update_constraints();
+
             OpenSoT::solvers::BackEnd::Ptr _solver;
 
             Eigen::VectorXd _internal_solution;
             Eigen::MatrixXd _H;
+
+            /**
+             * @brief _H_pattern structural nonzeros of _H, passed to the back-end: the Hessian is zero
+             * or eps*I, hence only its diagonal
+             */
+            Eigen::SparseMatrix<double> _H_pattern;
+
+            /**
+             * @brief _c constant cost of the internal problem
+             */
+            Eigen::VectorXd _c;
+
+            /**
+             * @brief _A, _lA and _uA constraints of the internal problem
+             */
+            Eigen::MatrixXd _A;
+            Eigen::VectorXd _lA, _uA;
+
+            /**
+             * @brief _A_pattern structural nonzeros of _A, passed to the back-end
+             */
+            Eigen::SparseMatrix<double> _A_pattern;
+
+            /**
+             * @brief The variable_block struct stores the rows of the internal constraints coming from a
+             * task_to_constraint_helper or a constraint_helper. Only the first x_rows depend on x.
+             */
+            struct variable_block
+            {
+                ConstraintPtr constraint;
+                int row;
+                int rows;
+                int x_rows;
+            };
+            std::vector<variable_block> _variable_blocks;
             OpenSoT::HessianType _hessian_type;
 
             /**
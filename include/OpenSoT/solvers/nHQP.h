@@ -27,10 +27,13 @@
 #include <OpenSoT/Task.h>
 #include <OpenSoT/Solver.h>
 #include <OpenSoT/constraints/Aggregated.h>
+#include <OpenSoT/tasks/Aggregated.h>
 #include <OpenSoT/solvers/BackEndFactory.h>
 #include <OpenSoT/utils/Piler.h>
 
 #include <eigen3/Eigen/SVD>
+#include <eigen3/Eigen/Cholesky>
+#include <eigen3/Eigen/QR>
 
 
 namespace OpenSoT { namespace solvers {
@@ -51,13 +54,20 @@ namespace OpenSoT { namespace solvers {
      * Notice how each layer optimizes only over the remaining dofs after higher priority tasks
      * have been optimized. Hence, the size of QP probles decreases along the hierarchy.
      *
+     * Equality constraints are eliminated: with Aeq*x = beq, x = x_eq + Neq*x0 where x_eq is the minimum norm
+     * solution and Neq = Null(Aeq), so that all the layers optimize in the nullspace of the equality constraints.
+     * Local constraints of a layer are projected onto its reduced coordinates; local equalities are eliminated
+     * in the same way and affect the solution of that layer only.
+     *
      * Limitations:
-     *  - no support for equality constraints
-     *  - no support for local constraints
-     *  - [!!!] ranks of tasks should not change during runtime (e.g. disabling a task)
+     *  - [!!!] ranks of tasks and equality constraints should not change during runtime (e.g. disabling a task)
+     *
+     * Nullspace bases can be tracked across control cycles (see setNullSpaceTracking(), disabled by default):
+     * the basis of the previous cycle is projected onto the new nullspace and re-orthonormalized, so that the
+     * coordinates of the following layers change continuously between cycles (an SVD basis may rotate or flip
+     * inside the nullspace). Tracking is about continuity and adds cost: the SVD of each layer is still computed
+     * at every cycle, together with the projection and re-orthonormalization of the previous basis.
      *
-     * @todo: implement equality constraints by considering the nullspace Neq = Null(Aeq).
-     * All optimizations will then take place in the null space of equality constraints.
      * @todo: add reference
      */
     class nHQP: public Solver<Eigen::MatrixXd, Eigen::VectorXd>
@@ -134,6 +144,30 @@ namespace OpenSoT { namespace solvers {
          */
         void setPerformSelectiveNullSpaceRegularization(bool perform_selective_null_space_regularization);
 
+        /**
+         * @brief setNullSpaceTracking at a certain hierarchy level
+         * @param hierarchy_level
+         * @param track_nullspace if true the nullspace basis is updated from the one of the previous
+         * cycle, otherwise (default) it is taken from the full SVD of the projected task matrix
+         * @note throw if asked hierarchy that does not exists
+         */
+        void setNullSpaceTracking(int hierarchy_level, bool track_nullspace);
+
+        /**
+         * @brief setNullSpaceTracking to all leveles and to the nullspace of the equality constraints
+         * @param track_nullspace true or false (default is false for all levels)
+         */
+        void setNullSpaceTracking(bool track_nullspace);
+
+        /**
+         * @brief getNullSpaceBasis
+         * @param hierarchy_level
+         * @return the basis of the nullspace where the level is solved, i.e. the nullspace of the equality
+         * constraints (identity if there are none) and of the previous levels
+         * @note throw if asked hierarchy that does not exists
+         */
+        const Eigen::MatrixXd& getNullSpaceBasis(const unsigned int hierarchy_level) const;
+
     private:
 
         /**
@@ -147,7 +181,9 @@ namespace OpenSoT { namespace solvers {
 
             TaskData(int num_free_vars,
                      TaskPtr task,
-                     ConstraintPtr constraint,
+                     constraints::Aggregated::Ptr constraint,
+                     constraints::Aggregated::Ptr local_constraint,
+                     int local_eq_rank,
                      BackEnd::Ptr back_end);
 
             void set_min_sv_ratio(double sv);
@@ -188,14 +224,40 @@ namespace OpenSoT { namespace solvers {
              */
             void set_perform_selective_null_space_regularization(bool perform_selective_null_space_regularization_);
 
+            /**
+             * @brief set_track_nullspace update the nullspace basis from the one of the previous cycle (see compute_nullspace())
+             * @param track_nullspace_ true or false, default false
+             */
+            void set_track_nullspace(bool track_nullspace_);
+
         private:
 
 
             // this task
             TaskPtr task;
 
-            // global constraints
-            ConstraintPtr constraints;
+            // global constraints (equalities are eliminated by nHQP)
+            constraints::Aggregated::Ptr constraints;
+
+            // local constraints of this task (can be nullptr)
+            constraints::Aggregated::Ptr local_constraints;
+
+            // rank of the local equalities, F*z = f once projected onto previous tasks nullspace
+            int local_eq_rank;
+            Eigen::MatrixXd F;
+            Eigen::VectorXd f;
+            Eigen::BDCSVD<Eigen::MatrixXd> eq_svd;
+
+            // with local equalities the QP is solved in w: z = z_eq + Neq*w, x = q0_w + N_w*w
+            Eigen::MatrixXd Neq, N_w;
+            Eigen::VectorXd z_eq, q0_w, eq_tmp, z_sol;
+
+            // quadratic cost matrices in w
+            Eigen::MatrixXd H_eq;
+            Eigen::VectorXd g_eq;
+
+            // global and local bounds
+            Eigen::VectorXd lower_bound, upper_bound;
 
             // nullspace of AN (used by next task)
             Eigen::MatrixXd AN_nullspace;
@@ -206,6 +268,12 @@ namespace OpenSoT { namespace solvers {
             // b vector for this task
             Eigen::VectorXd b0;
 
+            // the task as Aggregated (or nullptr), its weight is applied block by block
+            tasks::Aggregated::Ptr aggregated_task;
+
+            // weight times AN
+            Eigen::MatrixXd WAN;
+
             // min singular value ratio
             double min_sv_ratio;
 
@@ -246,6 +314,17 @@ namespace OpenSoT { namespace solvers {
             // if true the selective regularization is performed in compute_cost()
             bool perform_selective_null_space_regularization;
 
+            // if true the nullspace basis is updated from the one of the previous cycle
+            bool track_nullspace;
+
+            // true if AN_nullspace refers to the last compute_cost()
+            bool nullspace_updated;
+
+            // workspace for the nullspace tracking
+            Eigen::MatrixXd ns_projection, ns_gram, ns_complement;
+            Eigen::LLT<Eigen::MatrixXd> ns_llt;
+            Eigen::HouseholderQR<Eigen::MatrixXd> ns_qr;
+
             /**
              * @brief Perform SVD-based regularization of AN and b0 as follows:
              *  - components of b0 along A's singular vectors with low singular value are deflated
@@ -255,8 +334,29 @@ namespace OpenSoT { namespace solvers {
              */
             void regularize_A_b(double threshold);
 
+            /**
+             * @brief compute_local_equalities computes the minimum norm solution z_eq and the nullspace Neq of the
+             * local equalities, and projects the cost onto Neq (compute_cost() must be called first)
+             */
+            void compute_local_equalities(const Eigen::MatrixXd * N,
+                                          const Eigen::VectorXd& q0);
+
+            bool has_local_equalities() const;
+
+            /**
+             * @brief merge_bounds intersects global and local bounds into lower_bound and upper_bound
+             * @return false if there are no bounds
+             */
+            bool merge_bounds();
+
         };
 
+        /**
+         * @brief compute_equalities computes the minimum norm solution of the global equality constraints,
+         * stored in _solution, and their nullspace, stored in _cumulated_nullspace[0]
+         */
+        void compute_equalities();
+
 
         virtual void _log(XBot::MatLogger2::Ptr logger, const std::string& prefix) override;
 
@@ -269,6 +369,19 @@ namespace OpenSoT { namespace solvers {
         // to store solution
         Eigen::VectorXd _solution;
 
+        // global constraints, re-aggregated keeping the equality constraints
+        constraints::Aggregated::Ptr _constraints;
+
+        // rank of the global equality constraints, svd and workspace
+        int _eq_rank;
+        Eigen::BDCSVD<Eigen::MatrixXd> _eq_svd;
+        Eigen::VectorXd _eq_tmp;
+
+        // if true the nullspace basis of the equality constraints is updated from the one of the previous cycle
+        bool _track_eq_nullspace;
+        Eigen::MatrixXd _eq_ns_projection, _eq_ns_gram;
+        Eigen::LLT<Eigen::MatrixXd> _eq_ns_llt;
+
 
     };
 
@@ -22,6 +22,7 @@
 #include <Eigen/Dense>
 #include <memory>
 #include <list>
+#include <vector>
 #include <OpenSoT/utils/Piler.h>
 
 using namespace OpenSoT::utils;
@@ -41,11 +42,25 @@ using namespace OpenSoT::utils;
          * it is comprised. Take a look at getConstraints(), getAggregatedConstraints(), getOwnConstraints() for more infos.
          * Notice that setLambda will change the lambda of all the internal tasks but if one of these lambda is changed outside this will be not visible in the aggregated
          *
+         * The weight of the Aggregated is block diagonal: its blocks are listed as WeightBlock, one for each
+         * (non aggregated) task, and only the diagonal blocks of W are copied during the update. If the weights
+         * of all the tasks are flagged as diagonal (see setWeightIsDiagonalFlag()), the Aggregated is flagged as well.
+         *
          */
         class Aggregated: public Task<Eigen::MatrixXd, Eigen::VectorXd> {
         public:
             typedef std::shared_ptr<Aggregated> Ptr;
             typedef MatrixPiler VectorPiler;
+
+            /**
+             * @brief The WeightBlock struct is a diagonal block of the weight of the Aggregated:
+             * the weight of task is applied to the rows [offset, offset + size) of A and b
+             */
+            struct WeightBlock {
+                int offset;
+                int size;
+                TaskPtr task;
+            };
         protected:
 
             std::list< TaskPtr > _tasks;
@@ -58,6 +73,38 @@ using namespace OpenSoT::utils;
 
             unsigned int _aggregationPolicy;
 
+            /**
+             * @brief _weight_blocks diagonal blocks of the weight, nested Aggregated are flattened
+             */
+            std::vector<WeightBlock> _weight_blocks;
+
+            /**
+             * @brief _aggregated_tasks same order of _tasks, the task as Aggregated or nullptr
+             */
+            std::vector<Aggregated::Ptr> _aggregated_tasks;
+
+            /**
+             * @brief The HessianBlock struct is the workspace for the contribution \f$A_i^TW_iA_i\f$ of a task
+             * restricted to the columns in which \f$A_i\f$ is not zero
+             */
+            struct HessianBlock {
+                std::vector<int> support;
+                Eigen::MatrixXd As;
+                Eigen::MatrixXd WAs;
+                Eigen::MatrixXd Hs;
+                Eigen::VectorXd gs;
+            };
+
+            /**
+             * @brief _hessian_blocks one for each WeightBlock
+             */
+            std::vector<HessianBlock> _hessian_blocks;
+
+            /**
+             * @brief _update_tasks if false, _update() does not update the aggregated tasks
+             */
+            bool _update_tasks = true;
+
             void generateAll();
 
             void generateConstraints();
@@ -190,6 +237,20 @@ using namespace OpenSoT::utils;
 
             const std::list< TaskPtr >& getTaskList() { return _tasks; }
 
+            /**
+             * @brief setUpdateTasks if false, update() does not update the aggregated tasks but only
+             * aggregates their current A, b, c and weights: the tasks have to be updated by the caller
+             * (e.g. by a compiled AutoStack, which updates each task once per control cycle)
+             * @param update_tasks default is true
+             */
+            void setUpdateTasks(const bool update_tasks) { _update_tasks = update_tasks; }
+
+            /**
+             * @brief getUpdateTasks
+             * @return true if update() updates the aggregated tasks
+             */
+            bool getUpdateTasks() const { return _update_tasks; }
+
             /**
              * @brief setLambda set the lambda to ALL the aggregated tasks to the same value lambda.
              * The lambda associated to the Aggregate and the lambda associated to the tasks are different if a
@@ -198,7 +259,41 @@ using namespace OpenSoT::utils;
              */
             void setLambda(double lambda);
 
+            /**
+             * @brief setWeight sets the diagonal blocks of W as weights of the aggregated tasks.
+             * Throws if W has nonzero off-diagonal blocks, i.e. if it couples different tasks
+             * @param W block diagonal weight matrix
+             */
             virtual void setWeight(const Eigen::MatrixXd& W);
+
+            /**
+             * @brief setWeight sets the same diagonal weight to all the aggregated tasks
+             * @param w scalar diagonal weight
+             */
+            virtual void setWeight(const double& w);
+
+            /**
+             * @brief weight computes \f$WM\f$ block by block, the off-diagonal blocks of W are not multiplied
+             * @param M matrix with as many rows as the Aggregated
+             * @param WM product between the weight and M
+             */
+            void weight(const Eigen::MatrixXd& M, Eigen::MatrixXd& WM) const;
+
+            /**
+             * @brief computeHessianAndGradient computes the cost of the Aggregated as a sum of the tasks contributions:
+             * \f$H = \sum_i A_i^TW_iA_i\f$, \f$g = -\sum_i A_i^TW_ib_i\f$.
+             * Each \f$A_i^TW_iA_i\f$ is computed only on the columns in which \f$A_i\f$ is not zero.
+             * The result is the same as \f$A^TWA\f$, \f$-A^TWb\f$ without multiplying the piled matrices
+             * @param H Hessian
+             * @param g gradient (the linear term c is not included)
+             */
+            void computeHessianAndGradient(Eigen::MatrixXd& H, Eigen::VectorXd& g);
+
+            /**
+             * @brief getWeightBlocks
+             * @return the diagonal blocks of the weight
+             */
+            const std::vector<WeightBlock>& getWeightBlocks() const { return _weight_blocks; }
               
             static bool isAggregated(OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr task);
         };
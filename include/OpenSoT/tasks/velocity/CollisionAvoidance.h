@@ -6,11 +6,19 @@
 
 namespace OpenSoT { namespace tasks { namespace velocity {
 
+/**
+ * @brief The CollisionAvoidance class is a soft version of constraints::velocity::CollisionAvoidance:
+ * pairs whose distance is below the link pair threshold are pushed back to the threshold.
+ * The task wraps a constraint, which can also be used in the same stack (e.g. as a hard limit):
+ * distances and Jacobians are computed once per control cycle and shared by both.
+ */
 class CollisionAvoidance : public Task<Eigen::MatrixXd, Eigen::VectorXd>
 {
 
 public:
 
+    typedef std::shared_ptr<CollisionAvoidance> Ptr;
+
     CollisionAvoidance(constraints::velocity::CollisionAvoidance::Ptr constr);
 
     void _update() override;
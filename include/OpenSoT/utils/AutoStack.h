@@ -49,6 +49,42 @@ namespace OpenSoT {
 
             std::vector<OpenSoT::solvers::iHQP::TaskPtr> flattenTask(
                     OpenSoT::solvers::iHQP::TaskPtr task);
+
+            /**
+             * @brief The CompositeTask struct is an Aggregated or a SubTask in the execution plan
+             */
+            struct CompositeTask {
+                OpenSoT::solvers::iHQP::TaskPtr task;
+                OpenSoT::tasks::Aggregated* aggregated;
+                OpenSoT::SubTask* sub_task;
+            };
+
+            /**
+             * @brief _is_compiled true if compile() has been called
+             */
+            bool _is_compiled = false;
+
+            /**
+             * @brief _compiled_stack levels and regularisation task when compile() was called,
+             * used to detect changes of the stack
+             */
+            OpenSoT::solvers::iHQP::Stack _compiled_stack;
+            OpenSoT::solvers::iHQP::TaskPtr _compiled_regularisation_task;
+
+            /**
+             * @brief _update_list tasks which are not composed of other tasks, each one appears once
+             */
+            std::vector<OpenSoT::solvers::iHQP::TaskPtr> _update_list;
+
+            /**
+             * @brief _composite_list Aggregated and SubTask of the stack, each one appears once
+             * and after the tasks it is composed of
+             */
+            std::vector<CompositeTask> _composite_list;
+
+            void compileTask(OpenSoT::solvers::iHQP::TaskPtr task);
+
+            bool isPlanValid() const;
         public:
 
             AutoStack(const int x_size);
@@ -64,8 +100,38 @@ namespace OpenSoT {
                       std::list<OpenSoT::constraints::Aggregated::ConstraintPtr> bounds);
 
 
+            /**
+             * @brief update updates all the tasks and bounds of the stack.
+             * If the stack has been compiled, each task is updated only once (even if it appears in more
+             * levels or inside more Aggregated/SubTask) and then Aggregated and SubTask are regenerated
+             * bottom-up, without updating again the tasks they are composed of
+             */
             void update();
 
+            /**
+             * @brief compile flattens the stack into an execution plan:
+             *  - an update list with each task of the stack (Aggregated and SubTask excluded) once,
+             *  - the Aggregated and SubTask of the stack ordered bottom-up.
+             * The plan is used by update(). If levels are added, removed or replaced, or the regularisation
+             * task is changed, the stack is compiled again at the next update(). Modifications inside
+             * an Aggregated are not detected: call compile() again in this case.
+             * NOTE: compile() only removes the repeated updates of shared tasks, the solvers still assemble
+             * the levels through the Task interface
+             */
+            void compile();
+
+            /**
+             * @brief isCompiled
+             * @return true if compile() has been called
+             */
+            bool isCompiled() const { return _is_compiled; }
+
+            /**
+             * @brief getUpdateList
+             * @return the tasks updated by update() after compile(), Aggregated and SubTask excluded
+             */
+            const std::vector<OpenSoT::solvers::iHQP::TaskPtr>& getUpdateList() const { return _update_list; }
+
             void log(XBot::MatLogger2::Ptr logger);
 
             bool checkConsistency();
@@ -0,0 +1,278 @@
+#ifndef _OPENSOT_UTILS_CAPSULE_COLLISION_MODEL_H_
+#define _OPENSOT_UTILS_CAPSULE_COLLISION_MODEL_H_
+
+#include <Eigen/Dense>
+#include <xbot2_interface/xbotinterface2.h>
+#include <xbot2_interface/collision.h>
+#include <urdf_model/model.h>
+#include <OpenSoT/utils/DistanceField.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The SegmentBatch struct stores N segments in structure-of-arrays layout,
+     * each segment is p + s*d with s in [0, 1], inflated by radius r (i.e. a capsule).
+     * A sphere is a segment with d = 0.
+     */
+    struct SegmentBatch
+    {
+        Eigen::ArrayXd px, py, pz;
+        Eigen::ArrayXd dx, dy, dz;
+        Eigen::ArrayXd r;
+
+        void resize(const int n);
+
+        int size() const { return r.size(); }
+    };
+
+    /**
+     * @brief The SegmentDistanceBatch class computes the distance between N pairs of capsules
+     * (a_i, b_i) with a branch-free version of the closest-point segment-segment algorithm
+     * (Ericson, Real-Time Collision Detection, 5.1.9) written on Eigen arrays, so that the
+     * whole batch is processed by Eigen vectorized (SSE/AVX) coefficient-wise kernels.
+     * All the workspace is allocated by resize(), compute() is allocation free.
+     */
+    class SegmentDistanceBatch
+    {
+    public:
+        SegmentDistanceBatch(const int n = 0);
+
+        void resize(const int n);
+
+        int size() const { return distance.size(); }
+
+        /**
+         * @brief compute distances and witness points between a.row(i) and b.row(i)
+         * @param a first capsules
+         * @param b second capsules
+         */
+        void compute(const SegmentBatch& a, const SegmentBatch& b);
+
+        /**
+         * @brief compute same as above, only for the first n pairs (the others are left untouched)
+         */
+        void compute(const SegmentBatch& a, const SegmentBatch& b, const int n);
+
+        /**
+         * @brief distance between capsule surfaces (negative if penetrating)
+         */
+        Eigen::ArrayXd distance;
+
+        /**
+         * @brief witness points on a and b
+         */
+        Eigen::ArrayXd wax, way, waz;
+        Eigen::ArrayXd wbx, wby, wbz;
+
+        /**
+         * @brief unit normal pointing from a to b
+         */
+        Eigen::ArrayXd nx, ny, nz;
+
+    private:
+        Eigen::ArrayXd _rx, _ry, _rz;
+        Eigen::ArrayXd _a, _b, _c, _e, _f, _denom;
+        Eigen::ArrayXd _s, _t, _tmp;
+        Eigen::ArrayXd _cx, _cy, _cz, _norm;
+    };
+
+    /**
+     * @brief The CapsuleCollisionModel class is a fast path for distance computation between
+     * robot links (and environment) whose geometry is approximated by capsules and spheres.
+     * Distances, witness points and distance Jacobians of all the pairs are computed in a single
+     * batched pass through SegmentDistanceBatch, without calling any narrowphase library.
+     * The interface mimics XBot::Collision::CollisionModel so that it can be used as a drop-in
+     * replacement inside constraints::velocity::CollisionAvoidance.
+     *
+     * Shapes attached to the "world" link are considered environment. Alternatively, the environment
+     * can be described by a precomputed DistanceField (see setDistanceField()).
+     */
+    class CapsuleCollisionModel
+    {
+    public:
+        typedef std::shared_ptr<CapsuleCollisionModel> Ptr;
+        typedef std::pair<std::string, std::string> LinkPair;
+        typedef std::vector<LinkPair> LinkPairVector;
+        typedef std::pair<Eigen::Vector3d, Eigen::Vector3d> WitnessPoint;
+        typedef std::vector<WitnessPoint> WitnessPointVector;
+
+        /**
+         * @brief The Capsule struct, a sphere has p0 == p1
+         */
+        struct Capsule
+        {
+            std::string name;
+            std::string link;
+            Eigen::Vector3d p0; // in link frame
+            Eigen::Vector3d p1; // in link frame
+            double radius;
+            std::set<std::string> disabled_links; // links the shape is not checked against
+        };
+
+        /**
+         * @brief CapsuleCollisionModel
+         * @param model used to compute link poses and jacobians
+         */
+        CapsuleCollisionModel(XBot::ModelInterface::ConstPtr model);
+
+        /**
+         * @brief addCapsule adds a capsule to link
+         * @param name unique name of the shape
+         * @param link to which the capsule is attached ("world" for environment)
+         * @param p0 first endpoint expressed in link frame
+         * @param p1 second endpoint expressed in link frame
+         * @param radius of the capsule
+         * @param disabled_collisions links the capsule is not checked against
+         * @return false if name already exists or link does not exist
+         */
+        bool addCapsule(const std::string& name,
+                        const std::string& link,
+                        const Eigen::Vector3d& p0,
+                        const Eigen::Vector3d& p1,
+                        const double radius,
+                        const std::vector<std::string>& disabled_collisions = {});
+
+        /**
+         * @brief addSphere adds a sphere to link
+         */
+        bool addSphere(const std::string& name,
+                       const std::string& link,
+                       const Eigen::Vector3d& center,
+                       const double radius,
+                       const std::vector<std::string>& disabled_collisions = {});
+
+        /**
+         * @brief addCollisionShape adds a shape with the same semantic of XBot::Collision::CollisionModel,
+         * only Capsule and Sphere are supported, the capsule axis is the z axis of link_T_shape
+         * @param disabled_collisions links the shape is not checked against
+         * @return false if the shape is neither a capsule nor a sphere
+         */
+        bool addCollisionShape(const std::string& name,
+                               const std::string& link,
+                               const XBot::Collision::Shape::Variant& shape,
+                               const Eigen::Affine3d& link_T_shape,
+                               const std::vector<std::string>& disabled_collisions = {});
+
+        /**
+         * @brief moveCollisionShape changes the pose w.r.t. the world of an environment shape
+         */
+        bool moveCollisionShape(const std::string& name, const Eigen::Affine3d& w_T_shape);
+
+        /**
+         * @brief fitFromUrdf approximates every collision element of the urdf with a capsule:
+         *  - sphere -> sphere
+         *  - cylinder -> capsule along the cylinder axis
+         *  - box -> capsule along the longest side enclosing the box
+         * meshes are not supported
+         * @param urdf model
+         * @return false if at least one collision element could not be fitted
+         */
+        bool fitFromUrdf(const urdf::ModelInterface& urdf);
+
+        /**
+         * @brief setLinkPairs sets the self-collision link pairs to check
+         */
+        void setLinkPairs(const std::set<LinkPair>& pairs);
+
+        /**
+         * @brief setLinksVsEnvironment sets the links checked against environment shapes
+         * (by default all the links are checked)
+         */
+        void setLinksVsEnvironment(const std::set<std::string>& links);
+
+        /**
+         * @brief setDistanceField replaces the environment shapes with a precomputed distance field:
+         * each link checked against the environment gives a single pair (link, "distance_field"),
+         * whose distance is the minimum over points sampled along the axes of the link capsules
+         * of the field distance minus the capsule radius.
+         * @param field the distance field (gradients must be computed), nullptr to go back to shapes
+         * @param points_per_capsule number of points sampled along each capsule axis
+         */
+        void setDistanceField(DistanceField::ConstPtr field, const unsigned int points_per_capsule = 5);
+
+        DistanceField::ConstPtr getDistanceField() const { return _field; }
+
+        /**
+         * @brief update poses of the capsules from the model
+         */
+        void update();
+
+        int getNumCollisionPairs(const bool include_env = true) const;
+
+        const LinkPairVector& getCollisionPairs(const bool include_env = true) const;
+
+        /**
+         * @brief computeDistance for all pairs, pairs are ordered as getCollisionPairs()
+         * @param d distances (min among the shapes of the two links)
+         */
+        void computeDistance(Eigen::VectorXd& d, const bool include_env = true);
+
+        /**
+         * @brief getDistanceJacobian of the last call to computeDistance()
+         */
+        void getDistanceJacobian(Eigen::MatrixXd& J, const bool include_env = true);
+
+        void getWitnessPoints(WitnessPointVector& wp, const bool include_env = true) const;
+
+        /**
+         * @brief getOrderedCollisionPairIndices indices of pairs in ascending distance order
+         */
+        const std::vector<int>& getOrderedCollisionPairIndices() const;
+
+        const std::vector<Capsule>& getCapsules() const { return _capsules; }
+
+    private:
+        void generatePairs();
+
+        void computeFieldDistance();
+
+        XBot::ModelInterface::ConstPtr _model;
+
+        std::vector<Capsule> _capsules;
+        std::map<std::string, Eigen::Affine3d> _world_shapes_pose;
+
+        std::set<LinkPair> _link_pairs;
+        std::set<std::string> _links_vs_env;
+        bool _all_links_vs_env;
+
+        LinkPairVector _self_pairs, _all_pairs;
+
+        // capsule pairs (index of first, index of second, index of the link pair)
+        std::vector<int> _pa, _pb, _pl;
+        int _num_self_capsule_pairs;
+
+        // per capsule world quantities
+        std::vector<Eigen::Vector3d> _w_p0, _w_d;
+
+        // per link quantities
+        std::vector<std::string> _links;
+        std::vector<int> _capsule_link;
+        std::vector<Eigen::Affine3d> _w_T_link;
+        std::vector<Eigen::MatrixXd> _J_link;
+
+        SegmentBatch _A, _B;
+        SegmentDistanceBatch _dist;
+
+        Eigen::VectorXd _d;
+        std::vector<int> _argmin;
+        std::vector<int> _ordered_idx;
+
+        Eigen::Matrix<double, 6, 1> _wa, _wb;
+
+        // distance field pairs follow the self-collision pairs
+        DistanceField::ConstPtr _field;
+        unsigned int _field_points;
+        std::vector<int> _field_link;
+        std::vector<std::vector<int>> _field_capsules;
+        std::vector<Eigen::Vector3d> _field_p, _field_g;
+        WitnessPointVector _field_wp;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef _OPENSOT_UTILS_COLLISION_PAIR_PRUNING_H_
+#define _OPENSOT_UTILS_COLLISION_PAIR_PRUNING_H_
+
+#include <xbot2_interface/xbotinterface2.h>
+#include <xbot2_interface/collision.h>
+#include <Eigen/Dense>
+#include <memory>
+#include <string>
+#include <vector>
+#include <set>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The CollisionPairPruning class is an offline tool to compute a reduced set of link pairs
+     * to be used with constraints::velocity::CollisionAvoidance::setCollisionList().
+     * The joint space is randomly sampled (within joint limits) and, for each link pair of the collision
+     * model (i.e. excluding SRDF disabled collisions), the minimum distance and the number of
+     * colliding samples are recorded. Pairs are then classified as:
+     *  - NEVER: the minimum sampled distance is above a margin, the pair can be removed
+     *  - ALWAYS: all the samples are in collision (e.g. adjacent links), the pair must be removed
+     *    otherwise the constraint would be always infeasible
+     *  - SOMETIMES: the pair has to be checked at run-time
+     * NOTE: the classification is a sampling HEURISTIC: the minimum sampled distance is an upper bound
+     * of the true minimum distance, so a NEVER pair may still collide between samples. The margin passed
+     * to getReport() has to cover this; a joint space resolution can be given to subtract, per pair,
+     * the largest sampled distance rate (1-norm of the distance Jacobian) times the resolution.
+     * NOTE: this is NOT meant to be used in a control loop.
+     */
+    class CollisionPairPruning
+    {
+    public:
+        typedef std::shared_ptr<CollisionPairPruning> Ptr;
+        typedef std::pair<std::string, std::string> LinksPair;
+
+        enum class PairClass
+        {
+            NEVER,
+            SOMETIMES,
+            ALWAYS
+        };
+
+        struct PairReport
+        {
+            LinksPair pair;
+            PairClass classification;
+            double min_distance;
+            double max_distance;
+            double max_distance_rate;
+            int colliding_samples;
+        };
+
+        /**
+         * @brief CollisionPairPruning
+         * @param model used for sampling, its joint positions will be changed
+         */
+        CollisionPairPruning(XBot::ModelInterface::Ptr model);
+
+        /**
+         * @brief sample the joint space and update pair statistics, can be called more times
+         * to accumulate samples
+         * @param number_of_samples random configurations within joint limits
+         */
+        void sample(const unsigned int number_of_samples);
+
+        /**
+         * @brief addSample evaluates a given configuration (e.g. from a recorded motion)
+         * @param q joint position
+         */
+        void addSample(const Eigen::VectorXd& q);
+
+        /**
+         * @brief getReport classifies all pairs
+         * @param margin pairs with minimum sampled distance above margin are classified as NEVER
+         * @param resolution max joint displacement [rad] between a configuration and the closest sample,
+         * the minimum sampled distance of each pair is lowered by max_distance_rate*resolution before
+         * comparing it with the margin
+         * @return a report for each pair of the collision model
+         */
+        std::vector<PairReport> getReport(const double margin, const double resolution = 0.) const;
+
+        /**
+         * @brief getPrunedPairs
+         * @param margin see getReport()
+         * @param resolution see getReport()
+         * @return the SOMETIMES pairs
+         */
+        std::set<LinksPair> getPrunedPairs(const double margin, const double resolution = 0.) const;
+
+        unsigned int getNumberOfSamples() const { return _number_of_samples; }
+
+        /**
+         * @brief savePairList writes one pair per line as "link1 link2"
+         */
+        static bool savePairList(const std::string& file_name, const std::set<LinksPair>& pairs);
+
+        /**
+         * @brief loadPairList reads a file written by savePairList(), lines starting with # are skipped
+         */
+        static std::set<LinksPair> loadPairList(const std::string& file_name);
+
+        /**
+         * @brief saveReport writes one line per pair as
+         * "link1 link2 class min_distance max_distance max_distance_rate colliding_samples"
+         */
+        bool saveReport(const std::string& file_name, const double margin, const double resolution = 0.) const;
+
+        static std::string toString(const PairClass c);
+
+    private:
+        XBot::ModelInterface::Ptr _model;
+        std::unique_ptr<XBot::Collision::CollisionModel> _collision_model;
+
+        XBot::Collision::CollisionModel::LinkPairVector _pairs;
+        Eigen::VectorXd _d;
+        Eigen::MatrixXd _J;
+        Eigen::VectorXd _min_d, _max_d, _max_rate;
+        Eigen::VectorXi _colliding;
+        unsigned int _number_of_samples;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef _OPENSOT_UTILS_DISTANCE_FIELD_H_
+#define _OPENSOT_UTILS_DISTANCE_FIELD_H_
+
+#include <Eigen/Dense>
+#include <xbot2_interface/collision.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The DistanceField class is a regular 3D grid storing, for each grid point, the
+     * (signed) distance from the environment and its gradient. The field is built once
+     * from primitive shapes and/or point clouds and then queried in constant time with
+     * trilinear interpolation. It can be saved to file and memory-mapped back (read-only),
+     * so that large fields are shared among processes and loaded without copies.
+     *
+     * Grid point (i,j,k) is at origin + resolution*(i,j,k).
+     */
+    class DistanceField
+    {
+    public:
+        typedef std::shared_ptr<DistanceField> Ptr;
+        typedef std::shared_ptr<const DistanceField> ConstPtr;
+
+        /**
+         * @brief DistanceField constructor, the field is initialized to max_distance everywhere
+         * @param origin position of the first grid point in world frame
+         * @param size number of grid points along x, y and z (at least 2)
+         * @param resolution grid spacing [m]
+         * @param max_distance distance used for empty space
+         */
+        DistanceField(const Eigen::Vector3d& origin,
+                      const Eigen::Vector3i& size,
+                      const double resolution,
+                      const double max_distance = 1.0);
+
+        ~DistanceField();
+
+        DistanceField(const DistanceField&) = delete;
+        DistanceField& operator=(const DistanceField&) = delete;
+
+        /**
+         * @brief load memory-maps a field saved with save()
+         * @return nullptr on failure
+         */
+        static Ptr load(const std::string& file_name);
+
+        /**
+         * @brief save the field (distances and gradients) in a binary file
+         */
+        bool save(const std::string& file_name) const;
+
+        /**
+         * @brief addShape merges the signed distance of a shape (min with the current field)
+         * Sphere, Box, Capsule and Cylinder are supported (capsule and cylinder axes are along z)
+         * @param shape
+         * @param w_T_shape pose of the shape in world
+         * @return false if the shape is not supported or the field is read-only
+         */
+        bool addShape(const XBot::Collision::Shape::Variant& shape, const Eigen::Affine3d& w_T_shape);
+
+        /**
+         * @brief addPointCloud merges the (unsigned) distance from a set of points in world frame,
+         * computed with an exact Euclidean distance transform of the occupied grid cells.
+         * The distance is reduced by half the cell diagonal, so that it is conservative.
+         * @return false if the field is read-only
+         */
+        bool addPointCloud(const std::vector<Eigen::Vector3d>& points);
+
+        /**
+         * @brief computeGradient must be called after all the shapes/point clouds have been added
+         */
+        void computeGradient();
+
+        /**
+         * @brief getDistance with trilinear interpolation
+         * @param p point in world frame
+         * @param gradient of the distance in p (zero outside the grid)
+         * @return distance in p, max distance outside the grid
+         */
+        double getDistance(const Eigen::Vector3d& p, Eigen::Vector3d& gradient) const;
+
+        double getDistance(const Eigen::Vector3d& p) const;
+
+        bool isInside(const Eigen::Vector3d& p) const;
+
+        const Eigen::Vector3d& getOrigin() const { return _origin; }
+        const Eigen::Vector3i& getSize() const { return _size; }
+        double getResolution() const { return _resolution; }
+        double getMaxDistance() const { return _max_distance; }
+        bool isReadOnly() const { return _mmap_ptr != nullptr; }
+
+    private:
+        DistanceField();
+
+        /**
+         * @brief each grid point stores 4 floats: distance, gradient x, y, z
+         */
+        static constexpr int CHANNELS = 4;
+
+        int index(const int i, const int j, const int k) const
+        {
+            return ((k*_size.y() + j)*_size.x() + i)*CHANNELS;
+        }
+
+        Eigen::Vector3d point(const int i, const int j, const int k) const
+        {
+            return _origin + _resolution*Eigen::Vector3d(i, j, k);
+        }
+
+        Eigen::Vector3d _origin;
+        Eigen::Vector3i _size;
+        double _resolution;
+        double _max_distance;
+
+        float* _data;
+        std::vector<float> _storage;
+
+        void* _mmap_ptr;
+        size_t _mmap_size;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,150 @@
+#ifndef _OPENSOT_UTILS_FIXED_ROWS_H_
+#define _OPENSOT_UTILS_FIXED_ROWS_H_
+
+#include <Eigen/Dense>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The FixedRows struct collects the kernels used to build the cost function of a task
+     * (\f$A^TWA\f$, \f$WA\f$ and \f$-A^TWb\f$) for a task Jacobian with Rows rows known at compile time.
+     * Cartesian, Contact, CoM, Gaze and momentum tasks have 6 or 3 rows: viewing their (dynamic) matrices
+     * through fixed-rows maps lets Eigen unroll the products over the rows, without temporaries.
+     * Rows = Eigen::Dynamic is the generic fallback.
+     * NOTE: matrices are passed as Eigen::Ref, so blocks (e.g. rows of an Aggregated task) are not copied
+     */
+    template <int Rows>
+    struct FixedRows {
+
+        typedef Eigen::Matrix<double, Rows, Eigen::Dynamic> RowsMatrix;
+        typedef Eigen::Matrix<double, Rows, Rows> SquareMatrix;
+        typedef Eigen::Matrix<double, Rows, 1> RowsVector;
+
+        typedef Eigen::Map<const RowsMatrix, 0, Eigen::OuterStride<> > ConstRowsMap;
+        typedef Eigen::Map<const SquareMatrix, 0, Eigen::OuterStride<> > ConstSquareMap;
+        typedef Eigen::Map<RowsMatrix> RowsMap;
+        typedef Eigen::Map<const RowsVector> ConstVectorMap;
+
+        static ConstRowsMap map(const Eigen::Ref<const Eigen::MatrixXd>& A)
+        {
+            return ConstRowsMap(A.data(), A.rows(), A.cols(), Eigen::OuterStride<>(A.outerStride()));
+        }
+
+        /**
+         * @brief hessian computes H = A^T*A
+         */
+        static void hessian(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& H)
+        {
+            ConstRowsMap Af = map(A);
+
+            H.resize(A.cols(), A.cols());
+            H.triangularView<Eigen::Upper>() = Af.transpose()*Af;
+            H = H.selfadjointView<Eigen::Upper>();
+        }
+
+        /**
+         * @brief hessian computes H = A^T*WA
+         */
+        static void hessian(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                            const Eigen::Ref<const Eigen::MatrixXd>& WA,
+                            Eigen::MatrixXd& H)
+        {
+            H.resize(A.cols(), A.cols());
+            H.triangularView<Eigen::Upper>() = map(A).transpose()*map(WA);
+            H = H.selfadjointView<Eigen::Upper>();
+        }
+
+        /**
+         * @brief weight computes WA = W*A
+         * @param weight_is_diagonal if true only the diagonal of W is used
+         */
+        static void weight(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                           const Eigen::Ref<const Eigen::MatrixXd>& W,
+                           const bool weight_is_diagonal,
+                           Eigen::MatrixXd& WA)
+        {
+            ConstSquareMap Wf(W.data(), W.rows(), W.cols(), Eigen::OuterStride<>(W.outerStride()));
+
+            WA.resize(A.rows(), A.cols());
+            RowsMap WAf(WA.data(), A.rows(), A.cols());
+            if(weight_is_diagonal)
+                WAf.noalias() = Wf.diagonal().asDiagonal()*map(A);
+            else
+                WAf.noalias() = Wf*map(A);
+        }
+
+        /**
+         * @brief gradient computes g = -WA^T*b (WA can be A itself if the weight is the identity)
+         */
+        static void gradient(const Eigen::Ref<const Eigen::MatrixXd>& WA,
+                             const Eigen::Ref<const Eigen::VectorXd>& b,
+                             Eigen::VectorXd& g)
+        {
+            ConstVectorMap bf(b.data(), b.size());
+
+            g.noalias() = -1.0 * map(WA).transpose()*bf;
+        }
+    };
+
+    /**
+     * @brief hessian computes H = A^T*A using the fixed-rows kernels for 3 and 6 rows matrices
+     */
+    inline void hessian(const Eigen::Ref<const Eigen::MatrixXd>& A, Eigen::MatrixXd& H)
+    {
+        switch(A.rows())
+        {
+        case 6: FixedRows<6>::hessian(A, H); break;
+        case 3: FixedRows<3>::hessian(A, H); break;
+        default: FixedRows<Eigen::Dynamic>::hessian(A, H);
+        }
+    }
+
+    /**
+     * @brief hessian computes H = A^T*WA using the fixed-rows kernels for 3 and 6 rows matrices
+     */
+    inline void hessian(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                        const Eigen::Ref<const Eigen::MatrixXd>& WA,
+                        Eigen::MatrixXd& H)
+    {
+        switch(A.rows())
+        {
+        case 6: FixedRows<6>::hessian(A, WA, H); break;
+        case 3: FixedRows<3>::hessian(A, WA, H); break;
+        default: FixedRows<Eigen::Dynamic>::hessian(A, WA, H);
+        }
+    }
+
+    /**
+     * @brief weight computes WA = W*A using the fixed-rows kernels for 3 and 6 rows matrices
+     */
+    inline void weight(const Eigen::Ref<const Eigen::MatrixXd>& A,
+                       const Eigen::Ref<const Eigen::MatrixXd>& W,
+                       const bool weight_is_diagonal,
+                       Eigen::MatrixXd& WA)
+    {
+        switch(A.rows())
+        {
+        case 6: FixedRows<6>::weight(A, W, weight_is_diagonal, WA); break;
+        case 3: FixedRows<3>::weight(A, W, weight_is_diagonal, WA); break;
+        default: FixedRows<Eigen::Dynamic>::weight(A, W, weight_is_diagonal, WA);
+        }
+    }
+
+    /**
+     * @brief gradient computes g = -WA^T*b using the fixed-rows kernels for 3 and 6 rows matrices
+     */
+    inline void gradient(const Eigen::Ref<const Eigen::MatrixXd>& WA,
+                         const Eigen::Ref<const Eigen::VectorXd>& b,
+                         Eigen::VectorXd& g)
+    {
+        switch(WA.rows())
+        {
+        case 6: FixedRows<6>::gradient(WA, b, g); break;
+        case 3: FixedRows<3>::gradient(WA, b, g); break;
+        default: FixedRows<Eigen::Dynamic>::gradient(WA, b, g);
+        }
+    }
+
+} }
+
+#endif
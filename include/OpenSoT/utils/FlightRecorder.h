@@ -0,0 +1,199 @@
+#ifndef _OPENSOT_UTILS_FLIGHT_RECORDER_H_
+#define _OPENSOT_UTILS_FLIGHT_RECORDER_H_
+
+#include <Eigen/Dense>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The FlightRecorder class is a low-overhead logger which keeps the last samples of a set of
+     * channels (matrices) in a memory-mapped binary file.
+     *
+     * Channels are registered before start() and identified by an integer id. log() only copies the sample
+     * into a preallocated lock-free single-producer/single-consumer queue (no allocations, no locks, no system
+     * calls): a background thread moves the samples into the file, where each channel is a circular buffer of
+     * its last samples. If the queue is full the sample is dropped and counted (see getDroppedSamples()).
+     * Since the file is mapped, the data logged before a crash is not lost.
+     * The file can be converted to a MAT-file with convertToMat().
+     *
+     * NOTE: log() has to be called always from the same thread (e.g. the control loop)
+     */
+    class FlightRecorder {
+    public:
+        typedef std::shared_ptr<FlightRecorder> Ptr;
+
+        struct FileHeader{
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t channels;
+            std::uint64_t dropped;
+        };
+
+        struct ChannelHeader{
+            char name[64];
+            std::int32_t rows;          /**< max rows of the samples */
+            std::int32_t cols;          /**< max cols of the samples */
+            std::int32_t decimation;
+            std::uint32_t samples;      /**< size of the circular buffer */
+            std::uint64_t count;        /**< number of written samples */
+            std::uint64_t offset;       /**< [bytes] of the circular buffer from the beginning of the file */
+        };
+
+        static const char MAGIC[8];
+        static const std::uint32_t VERSION = 1;
+
+        /**
+         * @brief FlightRecorder
+         * @param file_name of the recording, created by start()
+         * @param samples default number of samples kept for each channel
+         * @param queue_size [doubles] of the queue between log() and the background thread
+         * @param period of the background thread
+         */
+        FlightRecorder(const std::string& file_name,
+                       const unsigned int samples = 1000,
+                       const std::size_t queue_size = 1 << 20,
+                       const std::chrono::microseconds period = std::chrono::microseconds(1000));
+        ~FlightRecorder();
+
+        FlightRecorder(const FlightRecorder&) = delete;
+        FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+        /**
+         * @brief addChannel registers a channel, has to be called before start()
+         * @param name of the channel (max 63 characters)
+         * @param rows max rows of the samples
+         * @param cols max cols of the samples
+         * @param decimation only one every decimation calls to log() is recorded
+         * @param samples number of samples kept, 0 to use the default one
+         * @return the id of the channel, -1 if the channel can not be added
+         */
+        int addChannel(const std::string& name, const int rows, const int cols = 1,
+                       const int decimation = 1, const unsigned int samples = 0);
+
+        /**
+         * @brief addChannel registers a channel with the size of a matrix, has to be called before start()
+         * @param name of the channel (max 63 characters)
+         * @param value matrix used to size the channel
+         * @param decimation only one every decimation calls to log() is recorded
+         * @return the id of the channel, -1 if the matrix is empty or the channel can not be added
+         */
+        template <typename Derived>
+        int addChannel(const std::string& name, const Eigen::MatrixBase<Derived>& value, const int decimation = 1)
+        {
+            if(value.size() == 0)
+                return -1;
+            return addChannel(name, value.rows(), value.cols(), decimation);
+        }
+
+        /**
+         * @brief getChannel
+         * @param name of the channel
+         * @return the id of the channel, -1 if it does not exist
+         */
+        int getChannel(const std::string& name) const;
+
+        /**
+         * @brief start creates and maps the file and starts the background thread
+         * @return false if the file can not be created
+         */
+        bool start();
+
+        /**
+         * @brief stop writes the samples in the queue, stops the background thread and unmaps the file
+         */
+        void stop();
+
+        /**
+         * @brief isStarted can be called from any thread
+         * @return true if the file is mapped, between start() and stop()
+         */
+        bool isStarted() const { return _file.load(std::memory_order_acquire) != nullptr; }
+
+        /**
+         * @brief log pushes a sample of a channel in the queue, it is real-time safe
+         * @param channel id
+         * @param value with size smaller or equal than the one of the channel
+         * @return false if the recorder is not started, the sample is too big, or the queue is full.
+         * A decimated sample is not an error.
+         */
+        template <typename Derived>
+        bool log(const int channel, const Eigen::MatrixBase<Derived>& value)
+        {
+            double* sample = reserve(channel, value.rows(), value.cols());
+            if(!sample)
+                return _decimated;
+            Eigen::Map<Eigen::MatrixXd>(sample, value.rows(), value.cols()) = value;
+            commit();
+            return true;
+        }
+
+        bool log(const int channel, const double value)
+        {
+            return log(channel, Eigen::Matrix<double, 1, 1>::Constant(value));
+        }
+
+        /**
+         * @brief getDroppedSamples
+         * @return number of samples dropped since the queue was full or the sample was too big
+         */
+        std::uint64_t getDroppedSamples() const { return _dropped.load(std::memory_order_relaxed); }
+
+        const std::string& getFileName() const { return _file_name; }
+
+        /**
+         * @brief convertToMat converts a recording to a MAT-file. Each channel is saved, from the oldest
+         * to the newest sample, as a rows x cols x samples variable (smaller samples are zero padded)
+         * together with the name_time and name_size variables
+         * @param file_name of the recording
+         * @param mat_file_name of the MAT-file
+         * @return false if the recording can not be read
+         */
+        static bool convertToMat(const std::string& file_name, const std::string& mat_file_name);
+
+    private:
+        struct Channel{
+            ChannelHeader header;
+            int counter;    /**< calls to log() modulo decimation */
+        };
+
+        static const std::size_t SAMPLE_HEADER_SIZE = 4;
+
+        double* reserve(const int channel, const Eigen::Index rows, const Eigen::Index cols);
+        void commit();
+        void consume();
+        void run();
+
+        std::string _file_name;
+        unsigned int _samples;
+        std::chrono::microseconds _period;
+        std::vector<Channel> _channels;
+
+        std::vector<double> _queue;
+        std::atomic<std::size_t> _head;
+        std::atomic<std::size_t> _tail;
+        std::size_t _next_head;
+        bool _decimated;
+        std::atomic<std::uint64_t> _dropped;
+
+        std::chrono::steady_clock::time_point _start_time;
+        std::atomic<bool> _running;
+        std::mutex _mutex;
+        std::condition_variable _condition;
+        std::thread _thread;
+
+        std::atomic<char*> _file;
+        std::size_t _file_size;
+    };
+
+} }
+
+#endif
@@ -42,15 +42,16 @@ public:
 private:
 
     ChunkList _contiguousChunks;
+
+    /**
+     * @brief _rowsList same as _rowsVector, kept for asList()
+     */
     std::list<unsigned int> _rowsList;
-    std::vector<unsigned int> _rowsVector;
 
     /**
-     * @brief getNextAdjacentChunk returns an iterator pointing to the last element of a chunk
-     * @param searchBegin iterator pointing to the first element where we start looking for chunks
-     * @return the iterator pointing to the last element of a chunk
+     * @brief _rowsVector sorted row indices, without duplicates
      */
-    std::list<unsigned int>::iterator getNextAdjacentChunk(std::list<unsigned int>::iterator searchBegin);
+    std::vector<unsigned int> _rowsVector;
 
     void generateChunks();
 
@@ -69,9 +70,10 @@ public:
     Indices(Iterator it, const Iterator end) {
         while( it != end)
         {
-            _rowsList.push_back(*it);
+            _rowsVector.push_back(*it);
             ++it;
         }
+        this->generateChunks();
     }
 
     Indices(const Indices& indices);
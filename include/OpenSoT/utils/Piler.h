@@ -3,6 +3,7 @@
 
 #include <Eigen/Dense>
 #include <xbot2_interface/logger.h>
+#include <OpenSoT/utils/RtLogger.h>
 
 using XBot::Logger;
 
@@ -108,7 +109,7 @@ inline void OpenSoT::utils::MatrixPiler::pile(const Eigen::MatrixBase<Derived>&
     int rows_needed = _current_row + matrix.rows();
     
     if( rows_needed > _mat.rows() ){
-        Logger::info("PilerHelper: expanding to %d x %d \n", rows_needed, _cols);
+        RtLogger::info("PilerHelper: expanding to %d x %d \n", rows_needed, _cols);
         _mat.conservativeResize(rows_needed, _cols);
     }
     
@@ -0,0 +1,111 @@
+#ifndef _OPENSOT_UTILS_ROLLOUT_H_
+#define _OPENSOT_UTILS_ROLLOUT_H_
+
+#include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/utils/Affine.h>
+#include <xbot2_interface/xbotinterface2.h>
+#include <functional>
+
+namespace OpenSoT {
+namespace utils{
+
+/**
+ * @brief The Rollout class runs N control cycles of a stack natively: for each cycle the model is updated with
+ * the actual state, the task references are taken from a trajectory, the stack is updated and solved, and the
+ * state is integrated with the solution.
+ *
+ * Supported references are positions of velocity/acceleration Cartesian (x y z qx qy qz qw), CoM (x y z) and
+ * Postural (q) tasks.
+ */
+class Rollout{
+
+public:
+    typedef std::shared_ptr<Rollout> Ptr;
+
+    enum class Integration{
+        DISPLACEMENT, // q = q + x (velocity tasks where lambda is the gain of the position error, e.g. IK)
+        VELOCITY,     // qdot = x, q = q + x*dt
+        ACCELERATION  // explicit second-order Taylor step with x constant over dt: q = q + qdot*dt + 0.5*x*dt^2, qdot = qdot + x*dt
+    };
+
+    /**
+     * @brief The Result struct contains the rolled-out trajectories, one row per cycle
+     */
+    struct Result{
+        Eigen::MatrixXd q;          // (steps+1) x nq, the first row is the initial configuration
+        Eigen::MatrixXd qdot;       // (steps+1) x nv
+        Eigen::MatrixXd solutions;  // steps x number of variables
+        Eigen::VectorXi success;    // steps, 1 if the solver succeeded
+        Eigen::VectorXd solve_time; // steps, [s]
+    };
+
+    /**
+     * @brief Rollout constructor
+     * @param model used by the tasks of the stack
+     * @param stack
+     * @param solver created with stack
+     * @param integration scheme used to integrate the solution
+     * @param dt control period
+     */
+    Rollout(XBot::ModelInterface& model,
+            OpenSoT::AutoStack::Ptr stack,
+            OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::SolverPtr solver,
+            const Integration integration,
+            const double dt);
+
+    /**
+     * @brief setReference sets the reference trajectory of a task of the stack
+     * @param task a Cartesian, CoM or Postural task (SubTasks are resolved to the original task)
+     * @param trajectory one reference per row, a single row is used for all the cycles
+     * @return false if the task type is not supported or the number of columns is wrong
+     */
+    bool setReference(OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr task, const Eigen::MatrixXd& trajectory);
+
+    /**
+     * @brief setReference sets the reference trajectory of a task of the stack, given its id
+     */
+    bool setReference(const std::string& task_id, const Eigen::MatrixXd& trajectory);
+
+    void clearReferences();
+
+    /**
+     * @brief setJointVariable sets the affine mapping the solution to the integrated quantity (e.g. the joint
+     * accelerations of an inverse dynamics problem); by default the first nv elements of the solution are used
+     */
+    void setJointVariable(const AffineHelper& variable);
+
+    /**
+     * @brief run the rollout
+     * @param q0 initial configuration
+     * @param qdot0 initial velocity (used by ACCELERATION only), if empty zero
+     * @param steps number of control cycles
+     * @param result trajectories
+     * @return false if the references have less rows than steps or the initial state has wrong size,
+     * a failure of the solver does not stop the rollout (a zero joint variable is integrated)
+     */
+    bool run(const Eigen::VectorXd& q0, const Eigen::VectorXd& qdot0, const int steps, Result& result);
+
+private:
+    struct Reference{
+        std::function<void(const Eigen::VectorXd&)> set;
+        Eigen::MatrixXd trajectory;
+    };
+
+    XBot::ModelInterface& _model;
+    OpenSoT::AutoStack::Ptr _stack;
+    OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::SolverPtr _solver;
+    Integration _integration;
+    double _dt;
+
+    std::vector<Reference> _references;
+
+    bool _use_joint_variable;
+    AffineHelper _joint_variable;
+
+    Eigen::VectorXd _q, _qdot, _x, _joint, _ref;
+};
+
+}
+}
+
+#endif
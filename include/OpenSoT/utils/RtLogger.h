@@ -0,0 +1,180 @@
+#ifndef _OPENSOT_UTILS_RT_LOGGER_H_
+#define _OPENSOT_UTILS_RT_LOGGER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The RtLogger class prints printf-like messages through XBot::Logger, with an optional real-time mode.
+     *
+     * By default messages are formatted and printed synchronously. In real-time mode (see setRtMode()) a call only
+     * copies the format string pointer and the arguments into a lock-free queue owned by the calling thread:
+     * formatting and printing are done by a background thread. If the queue is full the message is dropped and
+     * counted (see getDroppedMessages()).
+     *
+     * NOTE: the format string must be a string literal (its pointer is queued); string arguments are copied
+     * (and truncated if longer than the message storage). Logging never allocates: a thread which did not call
+     * registerThread() takes one of the free queues allocated by setRtMode(), or its messages are dropped.
+     * The queue of a thread is released when the thread exits and reused by the next one.
+     * Real-time threads should call registerThread() during initialization. The background thread is stopped,
+     * and the queued messages printed, when the program exits
+     */
+    class RtLogger {
+    public:
+
+        enum class Level { INFO, WARNING, ERROR, SUCCESS };
+
+        typedef std::function<void(const char*, Level)> OnPrintCallback;
+
+        static const int MAX_ARGUMENTS = 8;
+        static const int STRING_STORAGE = 256;
+
+        struct Argument{
+            enum class Type : std::uint8_t { INTEGER, UNSIGNED, DOUBLE, STRING, POINTER };
+            Type type;
+            union{
+                long long integer;
+                unsigned long long unsigned_integer;
+                double floating;
+                std::uint16_t string_offset;
+                const void* pointer;
+            };
+        };
+
+        struct Message{
+            const char* fmt;
+            Level level;
+            std::uint8_t arguments_size;
+            std::uint16_t strings_size;
+            Argument arguments[MAX_ARGUMENTS];
+            char strings[STRING_STORAGE];
+        };
+
+        template <typename... Args>
+        static void info(const char* fmt, const Args&... args){ log(Level::INFO, fmt, args...); }
+
+        template <typename... Args>
+        static void warning(const char* fmt, const Args&... args){ log(Level::WARNING, fmt, args...); }
+
+        template <typename... Args>
+        static void error(const char* fmt, const Args&... args){ log(Level::ERROR, fmt, args...); }
+
+        template <typename... Args>
+        static void success(const char* fmt, const Args&... args){ log(Level::SUCCESS, fmt, args...); }
+
+        /**
+         * @brief setRtMode enables/disables the real-time mode, starting/stopping the background thread.
+         * When enabled, a few queues are allocated for the threads which do not call registerThread().
+         * When disabled, the queued messages are printed before returning
+         * @param flag true to enable the real-time mode
+         */
+        static void setRtMode(const bool flag);
+
+        static bool isRtMode();
+
+        /**
+         * @brief registerThread assigns a queue to the calling thread, allocating it if no free queue is available.
+         * It has to be called outside the real-time loop
+         * @return false if the maximum number of threads logging at the same time was reached
+         */
+        static bool registerThread();
+
+        /**
+         * @brief flush waits for the queued messages to be printed. If not in real-time mode, it prints
+         * the messages queued after the real-time mode was disabled
+         */
+        static void flush();
+
+        /**
+         * @brief getDroppedMessages
+         * @return number of messages dropped since the queues were full or no queue was available
+         */
+        static std::uint64_t getDroppedMessages();
+
+        /**
+         * @brief setOnPrintCallback replaces the default printing through XBot::Logger
+         * @param f callback, an empty function restores the default one
+         */
+        static void setOnPrintCallback(OnPrintCallback f);
+
+        /**
+         * @brief format writes a message into a buffer, as snprintf() would do with the same format and arguments
+         * @return the number of written characters (without the terminating null character)
+         */
+        static int format(const Message& message, char* buffer, const std::size_t size);
+
+    private:
+        RtLogger() = delete;
+
+        template <typename... Args>
+        static void log(const Level level, const char* fmt, const Args&... args)
+        {
+            static_assert(sizeof...(Args) <= MAX_ARGUMENTS, "RtLogger: too many arguments");
+
+            Message* message = reserve();
+            Message local;
+            if(!message)
+            {
+                if(isRtMode())
+                    return;
+                message = &local;
+            }
+
+            message->fmt = fmt;
+            message->level = level;
+            message->arguments_size = 0;
+            message->strings_size = 0;
+            int unpack[] = {0, (push(*message, args), 0)...};
+            (void)unpack;
+
+            if(message == &local)
+                print(local);
+            else
+                commit();
+        }
+
+        template <typename T>
+        static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+        push(Message& message, const T& value)
+        {
+            Argument& a = message.arguments[message.arguments_size++];
+            a.type = Argument::Type::INTEGER;
+            a.integer = value;
+        }
+
+        template <typename T>
+        static typename std::enable_if<(std::is_integral<T>::value && std::is_unsigned<T>::value) || std::is_enum<T>::value>::type
+        push(Message& message, const T& value)
+        {
+            Argument& a = message.arguments[message.arguments_size++];
+            a.type = Argument::Type::UNSIGNED;
+            a.unsigned_integer = static_cast<unsigned long long>(value);
+        }
+
+        template <typename T>
+        static typename std::enable_if<std::is_floating_point<T>::value>::type
+        push(Message& message, const T& value)
+        {
+            Argument& a = message.arguments[message.arguments_size++];
+            a.type = Argument::Type::DOUBLE;
+            a.floating = value;
+        }
+
+        static void push(Message& message, const char* value);
+        static void push(Message& message, const std::string& value){ push(message, value.c_str()); }
+        static void push(Message& message, const void* value);
+
+        static Message* reserve();
+        static void commit();
+        static void print(const Message& message);
+    };
+
+} }
+
+#endif
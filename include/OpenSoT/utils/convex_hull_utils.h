@@ -20,21 +20,27 @@
 #ifndef _CONVEX_HULL_H__
 #define _CONVEX_HULL_H__
 
-#include <pcl/point_cloud.h>
-#include <pcl/point_types.h>
-#include <kdl/frames.hpp>
-#include <pcl/ModelCoefficients.h>
-#include <pcl/sample_consensus/method_types.h>
-#include <pcl/sample_consensus/model_types.h>
-#include <pcl/filters/passthrough.h>
-#include <pcl/filters/project_inliers.h>
-#include <pcl/surface/concave_hull.h>
-#include <pcl/surface/convex_hull.h>
+#include <Eigen/Dense>
 #include <xbot2_interface/xbotinterface2.h>
+#include <array>
+#include <list>
+#include <vector>
+#include <string>
 
+/**
+ * @brief The convex_hull class computes the 2D convex hull (support polygon) of a set of points
+ * projected on the plane z = 0, through Andrew's monotone chain algorithm.
+ * All the workspace has fixed capacity (MAX_POINTS), so that the pointer based getConvexHull()
+ * does not allocate memory and can be used in real-time loops.
+ */
 class convex_hull
 {
 public:
+    /**
+     * @brief MAX_POINTS maximum number of points handled by the hull
+     */
+    static constexpr int MAX_POINTS = 32;
+
     convex_hull();
     ~convex_hull();
 
@@ -59,42 +65,35 @@ public:
     /**
      * @brief getConvexHull returns a minimum representation of the convex hull
      * @param points a list of points representing the convex hull
-     * @param ch a list of points which are the vertices of the convex hull
+     * @param ch a list of points which are the vertices of the convex hull (counter-clockwise,
+     * projected on z = 0)
      * @return true on success
      */
     bool getConvexHull(const std::list<Eigen::Vector3d>& points,
                              std::vector<Eigen::Vector3d>& ch);
-    //void setRansacDistanceThr(const double x){_ransac_distance_thr = x;}
+
+    /**
+     * @brief getConvexHullIndices allocation free computation of the convex hull
+     * @param points array of n points (only x and y are considered)
+     * @param n number of points, at most MAX_POINTS
+     * @param indices on output, the indices of the points which are vertices of the convex hull,
+     * in counter-clockwise order (collinear and duplicated points are discarded)
+     * @return number of vertices, 0 if the hull is degenerate (less than 3 non collinear points)
+     * or n > MAX_POINTS
+     */
+    int getConvexHullIndices(const Eigen::Vector3d* points, const int n,
+                             std::array<int, MAX_POINTS>& indices);
 
 private:
-    double _ransac_distance_thr;
-    pcl::PointCloud<pcl::PointXYZ>::Ptr _pointCloud;
-    pcl::PointCloud<pcl::PointXYZ>::Ptr _projectedPointCloud;
+    std::array<int, MAX_POINTS> _order;
+    std::array<int, 2*MAX_POINTS> _chain;
+    std::array<int, MAX_POINTS> _indices;
+    std::array<Eigen::Vector3d, MAX_POINTS> _points;
 
     Eigen::Affine3d world_T_CoM;
     Eigen::Affine3d world_T_point;
     Eigen::Affine3d referenceFrame_T_point;
     Eigen::Affine3d CoM_T_point;
-    pcl::PointXYZ _tmp_pcl;
-    pcl::PointCloud<pcl::PointXYZ> pointsInConvexHull;
-    std::vector<pcl::Vertices> indicesOfVertexes;
-    pcl::ConvexHull<pcl::PointXYZ> huller;
-    Eigen::Vector3d _tmp_vector;
-    pcl::ProjectInliers<pcl::PointXYZ> proj;
-
-    /**
-     * @brief projectPCL2Plane projects a point cloud on a plane
-     * @param cloud the input cloud
-     * @param ransac_distance_thr threshold for the ransac algorithm to detect outliers
-     * @param projected_point_cloud the output (projected) point cloud
-     */
-    void projectPCL2Plane(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr cloud,
-                          const double ransac_distance_thr,
-                          pcl::PointCloud<pcl::PointXYZ>::Ptr projected_point_cloud);
-
-
-    void printIndexAndPointsInfo(const pcl::PointCloud<pcl::PointXYZ>& pointsInConvexHull,
-                                 const std::vector<pcl::Vertices>& indicesOfVertexes);
 };
 
 #endif
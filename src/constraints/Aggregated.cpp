@@ -70,190 +70,213 @@ void Aggregated::update() {
     this->generateAll();
 }
 
-void Aggregated::generateAll() {
-    /* resetting all internal data */
-    _tmpupperBound.reset(1);
-    _tmplowerBound.reset(1);
+void Aggregated::computeLayout()
+{
+    _layout.resize(_bounds.size());
+
+    int eq_rows = 0, ineq_rows = 0;
+    unsigned int j = 0;
+    for(const ConstraintPtr& b : _bounds)
+    {
+        RowLayout layout;
+
+        /* equalities become one (bilateral) or two (unilateral) blocks of inequalities */
+        const int n_eq = b->getAeq().rows();
+        layout.eq_rows = 0;
+        layout.ineq_rows = 0;
+        if(_aggregationPolicy & EQUALITIES_TO_INEQUALITIES)
+            layout.ineq_rows += (_aggregationPolicy & UNILATERAL_TO_BILATERAL) ? n_eq : 2*n_eq;
+        else
+            layout.eq_rows += n_eq;
+
+        /* bilateral inequalities become two blocks of unilateral inequalities */
+        const int n_ineq = b->getAineq().rows();
+        if(!(_aggregationPolicy & UNILATERAL_TO_BILATERAL) &&
+           b->getbUpperBound().rows() != 0 && b->getbLowerBound().rows() != 0)
+            layout.ineq_rows += 2*n_ineq;
+        else
+            layout.ineq_rows += n_ineq;
+
+        layout.eq_offset = eq_rows;
+        layout.ineq_offset = ineq_rows;
+        eq_rows += layout.eq_rows;
+        ineq_rows += layout.ineq_rows;
+
+        _layout[j++] = layout;
+    }
 
-    _tmpAeq.reset(_x_size);
-    _tmpbeq.reset(1);
+    /* resize is a no-op if sizes did not change */
+    _Aeq.resize(eq_rows, _x_size);
+    _beq.resize(eq_rows);
 
-    _tmpAineq.reset(_x_size);
-    _tmpbUpperBound.reset(1);
-    _tmpbLowerBound.reset(1);
+    _Aineq.resize(ineq_rows, _x_size);
+    _bUpperBound.resize(ineq_rows);
+    _bLowerBound.resize((_aggregationPolicy & UNILATERAL_TO_BILATERAL) ? ineq_rows : 0);
+}
+
+void Aggregated::generateAll() {
 
     if(_constraint_id.empty() || _number_of_bounds != _bounds.size()){
         _number_of_bounds = _bounds.size();
         _constraint_id = concatenateConstraintsIds(getConstraintsList());}
 
-    if(_number_of_bounds != _boundUpperBounds.size())
-        initSupportVectorsAndMatrices(_number_of_bounds);
+    computeLayout();
+
+    bool has_bounds = false;
 
     /* iterating on all bounds.. */
     unsigned int j = 0;
-    for(typename std::list< ConstraintPtr >::iterator i = _bounds.begin(); i != _bounds.end(); i++) {
+    for(const ConstraintPtr& b : _bounds) {
 
-        ConstraintPtr &b = *i;
-
-        _boundUpperBounds[j] = b->getUpperBound();
-        _boundLowerBounds[j] = b->getLowerBound();
-
-        _boundAeqs[j] = b->getAeq();
-        _boundbeqs[j] = b->getbeq();
-
-        _boundAineqs[j] = b->getAineq();
-        _boundbUpperBounds[j] = b->getbUpperBound();
-        _boundbLowerBounds[j] = b->getbLowerBound();
-
-        Eigen::VectorXd& boundUpperBound = _boundUpperBounds[j];
-        Eigen::VectorXd& boundLowerBound = _boundLowerBounds[j];
+        const RowLayout& layout = _layout[j++];
 
-        Eigen::MatrixXd& boundAeq = _boundAeqs[j];
-        Eigen::VectorXd& boundbeq = _boundbeqs[j];
+        const Eigen::VectorXd& boundUpperBound = b->getUpperBound();
+        const Eigen::VectorXd& boundLowerBound = b->getLowerBound();
 
-        Eigen::MatrixXd& boundAineq = _boundAineqs[j];
-        Eigen::VectorXd& boundbUpperBound = _boundbUpperBounds[j];
-        Eigen::VectorXd& boundbLowerBound = _boundbLowerBounds[j];
+        const Eigen::MatrixXd& boundAeq = b->getAeq();
+        const Eigen::VectorXd& boundbeq = b->getbeq();
 
+        const Eigen::MatrixXd& boundAineq = b->getAineq();
+        const Eigen::VectorXd& boundbUpperBound = b->getbUpperBound();
+        const Eigen::VectorXd& boundbLowerBound = b->getbLowerBound();
 
-//        Eigen::VectorXd boundUpperBound = b->getUpperBound();
-//        Eigen::VectorXd boundLowerBound = b->getLowerBound();
-
-//        Eigen::MatrixXd boundAeq = b->getAeq();
-//        Eigen::VectorXd boundbeq = b->getbeq();
-
-//        Eigen::MatrixXd boundAineq = b->getAineq();
-//        Eigen::VectorXd boundbUpperBound = b->getbUpperBound();
-//        Eigen::VectorXd boundbLowerBound = b->getbLowerBound();
-
-        /* copying lowerBound, upperBound */
+        /* merging lowerBound, upperBound */
         if(boundUpperBound.rows() != 0 ||
            boundLowerBound.rows() != 0) {
             assert(boundUpperBound.rows() == _x_size);
             assert(boundLowerBound.rows() == _x_size);
 
-            if(_tmpupperBound.rows() == 0 ||
-               _tmplowerBound.rows() == 0) { // first valid bounds found
-                assert(_tmpupperBound.rows() == _tmplowerBound.rows());
-                _tmpupperBound.set(boundUpperBound);
-                _tmplowerBound.set(boundLowerBound);
+            if(!has_bounds) { // first valid bounds found
+                _upperBound = boundUpperBound;
+                _lowerBound = boundLowerBound;
+                has_bounds = true;
             } else {
-                for(unsigned int i = 0; i < _x_size; ++i) {
-                    // compute the minimum between current and new upper bounds
-                    _tmpupperBound[i] = std::min(  _tmpupperBound[i],
-                                                boundUpperBound[i]);
-                    // compute the maximum between current and new lower bounds
-                    _tmplowerBound[i] = std::max(  _tmplowerBound[i],
-                                                boundLowerBound[i]);
-                }
+                // minimum between current and new upper bounds,
+                // maximum between current and new lower bounds
+                _upperBound = _upperBound.cwiseMin(boundUpperBound);
+                _lowerBound = _lowerBound.cwiseMax(boundLowerBound);
             }
         }
 
+        int ineq_row = layout.ineq_offset;
+
         /* copying Aeq, beq */
-        if( boundAeq.rows() != 0 ||
-            boundbeq.rows() != 0) {
+        const int n_eq = boundAeq.rows();
+        if(n_eq != 0) {
             assert(boundAeq.rows() == boundbeq.rows());
+            assert(boundAeq.cols() == _x_size);
             /* when transforming equalities to inequalities,
                 Aeq*x = beq becomes
                 beq <= Aeq*x <= beq */
             if(_aggregationPolicy & EQUALITIES_TO_INEQUALITIES) {
-                assert(_tmpAineq.cols() == boundAeq.cols());
-                _tmpAineq.pile(boundAeq);
-                _tmpbUpperBound.pile(boundbeq);
+                _Aineq.middleRows(ineq_row, n_eq) = boundAeq;
+                _bUpperBound.segment(ineq_row, n_eq) = boundbeq;
                 if(_aggregationPolicy & UNILATERAL_TO_BILATERAL) {
-                    _tmpbLowerBound.pile(boundbeq);
+                    _bLowerBound.segment(ineq_row, n_eq) = boundbeq;
                 /* we want to have only unilateral constraints, so
                    beq <= Aeq*x <= beq becomes
                    -Aeq*x <= -beq && Aeq*x <= beq */
                 } else {
-                    assert(_tmpAineq.cols() == boundAeq.cols());
-                    _tmpAineq.pile(-1.0*boundAeq);
-                    _tmpbUpperBound.pile( -1.0 * boundbeq);
+                    _Aineq.middleRows(ineq_row + n_eq, n_eq) = -boundAeq;
+                    _bUpperBound.segment(ineq_row + n_eq, n_eq) = -boundbeq;
+                    ineq_row += n_eq;
                 }
+                ineq_row += n_eq;
             } else {
-                assert(_tmpAeq.cols() == boundAeq.cols());
-                _tmpAeq.pile(boundAeq);
-                _tmpbeq.pile(boundbeq);
+                _Aeq.middleRows(layout.eq_offset, n_eq) = boundAeq;
+                _beq.segment(layout.eq_offset, n_eq) = boundbeq;
             }
         }
 
         /* copying Aineq, bUpperBound, bLowerBound*/
-        if( boundAineq.rows() != 0 ||
-            boundbUpperBound.rows() != 0 ||
-            boundbLowerBound.rows() != 0) {
+        const int n_ineq = boundAineq.rows();
+        if(n_ineq != 0) {
 
-            assert(boundAineq.rows() > 0);
             assert(boundbLowerBound.rows() > 0 ||
                    boundbUpperBound.rows() > 0);
             assert(boundAineq.cols() == _x_size);
 
+            _Aineq.middleRows(ineq_row, n_ineq) = boundAineq;
+
             /* if we need to transform all unilateral bounds to bilateral.. */
             if(_aggregationPolicy & UNILATERAL_TO_BILATERAL) {
                 if(boundbUpperBound.rows() == 0) {
                     assert(boundAineq.rows() == boundbLowerBound.rows());
-                    boundbUpperBound.resize(boundAineq.rows());
-                    boundbUpperBound<<boundbUpperBound.setOnes(boundAineq.rows())*std::numeric_limits<double>::infinity();
+                    _bUpperBound.segment(ineq_row, n_ineq).setConstant(std::numeric_limits<double>::infinity());
+                    _bLowerBound.segment(ineq_row, n_ineq) = boundbLowerBound;
                 } else if(boundbLowerBound.rows() == 0) {
                     assert(boundAineq.rows() == boundbUpperBound.rows());
-                    boundbLowerBound.resize(boundAineq.rows());
-                    boundbLowerBound<<boundbLowerBound.setOnes(boundAineq.rows())*-std::numeric_limits<double>::max();
+                    _bUpperBound.segment(ineq_row, n_ineq) = boundbUpperBound;
+                    _bLowerBound.segment(ineq_row, n_ineq).setConstant(-std::numeric_limits<double>::max());
                 } else {
                     assert(boundAineq.rows() == boundbLowerBound.rows());
                     assert(boundAineq.rows() == boundbUpperBound.rows());
+                    _bUpperBound.segment(ineq_row, n_ineq) = boundbUpperBound;
+                    _bLowerBound.segment(ineq_row, n_ineq) = boundbLowerBound;
                 }
             /* if we need to transform all bilateral bounds to unilateral.. */
             } else {
                 /* we need to transform l < Ax into -Ax < -l */
                 if(boundbUpperBound.rows() == 0) {
-                    boundAineq = -1.0 * boundAineq;
-                    boundbLowerBound = -1.0 * boundbLowerBound;
                     assert(boundAineq.rows() == boundbLowerBound.rows());
+                    _Aineq.middleRows(ineq_row, n_ineq) *= -1.0;
+                    _bUpperBound.segment(ineq_row, n_ineq) = -boundbLowerBound;
                 } else if(boundbLowerBound.rows() == 0) {
                     assert(boundAineq.rows() == boundbUpperBound.rows());
+                    _bUpperBound.segment(ineq_row, n_ineq) = boundbUpperBound;
                 } else {
                     assert(boundAineq.rows() == boundbLowerBound.rows());
                     assert(boundAineq.rows() == boundbUpperBound.rows());
-                    pile(boundAineq,-1.0 * boundAineq);
-                    pile(boundbUpperBound,-1.0 * boundbLowerBound);
+                    _Aineq.middleRows(ineq_row + n_ineq, n_ineq) = -boundAineq;
+                    _bUpperBound.segment(ineq_row, n_ineq) = boundbUpperBound;
+                    _bUpperBound.segment(ineq_row + n_ineq, n_ineq) = -boundbLowerBound;
                 }
             }
-
-            assert(_tmpAineq.cols() == boundAineq.cols());
-            _tmpAineq.pile(boundAineq);
-            _tmpbUpperBound.pile(boundbUpperBound);
-            /*  if using UNILATERAL_TO_BILATERAL we always have lower bounds,
-                otherwise, we never have them */
-            if(_aggregationPolicy & UNILATERAL_TO_BILATERAL)
-                _tmpbLowerBound.pile( boundbLowerBound);
         }
-        j += 1;
     }
 
-    /* checking everything went fine */
-    assert(_tmplowerBound.rows() == 0 || _tmplowerBound.rows() == _x_size);
-    assert(_tmpupperBound.rows() == 0 || _tmpupperBound.rows() == _x_size);
-
-    assert(_tmpAeq.rows() == _tmpbeq.rows());
-    if(_tmpAeq.rows() > 0)
-        assert(_tmpAeq.cols() == _x_size);
-
-    assert(_tmpAineq.rows() == _tmpbUpperBound.rows());
-    if(!(_aggregationPolicy & UNILATERAL_TO_BILATERAL))
-        assert(_tmpAineq.rows() == _tmpbLowerBound.rows());
-    if(_tmpAineq.rows() > 0)
-        assert(_tmpAineq.cols() == _x_size);
-
+    if(!has_bounds)
+    {
+        _upperBound.resize(0);
+        _lowerBound.resize(0);
+    }
 
-    _upperBound = _tmpupperBound.generate_and_get();
-    _lowerBound = _tmplowerBound.generate_and_get();
+    /* checking everything went fine */
+    assert(_lowerBound.rows() == 0 || _lowerBound.rows() == _x_size);
+    assert(_upperBound.rows() == 0 || _upperBound.rows() == _x_size);
+    assert(_Aeq.rows() == _beq.rows());
+    assert(_Aineq.rows() == _bUpperBound.rows());
+}
 
-    _Aeq = _tmpAeq.generate_and_get();
-    _beq = _tmpbeq.generate_and_get();
+void Aggregated::getAineqRowBlocks(std::vector<RowBlock>& blocks) const
+{
+    blocks.clear();
+    appendAineqRowBlocks(blocks, 0);
+}
 
-    _Aineq = _tmpAineq.generate_and_get();
-    _bUpperBound = _tmpbUpperBound.generate_and_get();
-    _bLowerBound = _tmpbLowerBound.generate_and_get();
+void Aggregated::appendAineqRowBlocks(std::vector<RowBlock>& blocks, const int offset) const
+{
+    if(_layout.size() != _bounds.size())
+    {
+        if(_Aineq.rows() > 0)
+            blocks.push_back({offset, int(_Aineq.rows())});
+        return;
+    }
 
+    unsigned int j = 0;
+    for(const ConstraintPtr& b : _bounds)
+    {
+        const RowLayout& layout = _layout[j++];
+        if(layout.ineq_rows == 0)
+            continue;
+
+        /* a nested Aggregated copied as it is (no equalities, no split bilateral rows) */
+        Aggregated::Ptr aggregated = std::dynamic_pointer_cast<Aggregated>(b);
+        if(aggregated && b->getAeq().rows() == 0 && layout.ineq_rows == b->getAineq().rows())
+            aggregated->appendAineqRowBlocks(blocks, offset + layout.ineq_offset);
+        else
+            blocks.push_back({offset + layout.ineq_offset, layout.ineq_rows});
+    }
 }
 
 void Aggregated::checkSizes()
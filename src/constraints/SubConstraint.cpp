@@ -7,7 +7,8 @@ const std::string SubConstraint::_SUBCONSTRAINT_SEPARATION_ = "_";
 SubConstraint::SubConstraint(ConstraintPtr constrPtr, const std::list<unsigned int> rowIndices):
     Constraint(constrPtr->getConstraintID() + _SUBCONSTRAINT_SEPARATION_ + std::string(Indices(rowIndices)), constrPtr->getXSize()),
     _subConstraintMap(rowIndices),
-    _constraintPtr(constrPtr)
+    _constraintPtr(constrPtr),
+    _is_A_valid(true)
 {
     if(constrPtr->isBound()) //1. constraint ptr is a bound, we transform it into a constraint with less rows
     {
@@ -58,13 +59,33 @@ void SubConstraint::update()
     {
         generateBound(this->_constraintPtr->getbLowerBound(), this->_bLowerBound);
         generateBound(this->_constraintPtr->getbUpperBound(), this->_bUpperBound);
-        generateConstraint(this->_constraintPtr->getAineq(), this->_Aineq);
+        _is_A_valid = false;
     }
     else //if(constrPtr->isEqualityConstraint()) //3. is equality constraint (NOT USED)
     {
         generateBound(this->_constraintPtr->getbeq(), this->_beq);
+        _is_A_valid = false;
+    }
+}
+
+const Eigen::MatrixXd& SubConstraint::getAeq()
+{
+    if(!_is_A_valid && _Aeq.rows() > 0)
+    {
         generateConstraint(this->_constraintPtr->getAeq(), this->_Aeq);
+        _is_A_valid = true;
+    }
+    return _Aeq;
+}
+
+const Eigen::MatrixXd& SubConstraint::getAineq()
+{
+    if(!_is_A_valid && _Aineq.rows() > 0)
+    {
+        generateConstraint(this->_constraintPtr->getAineq(), this->_Aineq);
+        _is_A_valid = true;
     }
+    return _Aineq;
 }
 
 void SubConstraint::generateConstraint(const Eigen::MatrixXd& A, Eigen::MatrixXd& sub_A)
@@ -74,7 +95,7 @@ void SubConstraint::generateConstraint(const Eigen::MatrixXd& A, Eigen::MatrixXd
     for(Indices::ChunkList::const_iterator i = _subConstraintMap.getChunks().begin(); i != _subConstraintMap.getChunks().end(); ++i)
     {
         chunk_size = i->size();
-        sub_A.block(j,0,chunk_size,_x_size) = A.block(i->front(),0,i->back()-i->front()+1, _x_size);
+        sub_A.middleRows(j, chunk_size) = A.middleRows(i->front(), chunk_size);
         j+=chunk_size;
     }
 }
@@ -33,7 +33,12 @@ CollisionAvoidance::CollisionAvoidance(
     _robot(robot),
     _bound_scaling(1.0),
     _max_pairs(max_pairs),
-    _skip_infeasible_pairs(skip_infeasible_pairs)
+    _skip_infeasible_pairs(skip_infeasible_pairs),
+    _use_capsules(false),
+    _capsules_fitted(false),
+    _capsules_compatible(true),
+    _env_capsules_compatible(true),
+    _collisions_valid(false)
 {
     // enable collisions vs env
     _include_env = true;
@@ -47,6 +52,11 @@ CollisionAvoidance::CollisionAvoidance(
     // construct link distance computation util
     _dist_calc = std::make_unique<Collision::CollisionModel>(_collision_model);
 
+    // capsule fast path, shapes are fitted when enabled, same link pairs considered by the narrowphase model
+    _capsule_model = std::make_shared<OpenSoT::utils::CapsuleCollisionModel>(_collision_model);
+    const auto& link_pairs = _dist_calc->getCollisionPairs(false);
+    _capsule_model->setLinkPairs(std::set<LinksPair>(link_pairs.begin(), link_pairs.end()));
+
     // if max pairs not specified, set it as number of total
     // link pairs
     if(_max_pairs < 0)
@@ -93,37 +103,68 @@ void CollisionAvoidance::setLinkPairThreshold(const double linkPair_threshold)
 void CollisionAvoidance::setDetectionThreshold(const double detection_threshold)
 {
     _detection_threshold = std::fabs(detection_threshold);
+
+    // narrowphase distances depend on the detection threshold
+    _collisions_valid = false;
 }
 
-void CollisionAvoidance::update()
+void CollisionAvoidance::getActivePairsError(Eigen::VectorXd& e) const
+{
+    e = _active_pairs_error;
+}
+
+void CollisionAvoidance::computeCollisions()
 {
     // update collision model
     //_collision_model->syncFrom(_robot, ControlMode::POSITION); <-- not updating
     _collision_model->setJointPosition(_robot.getJointPosition());
     _collision_model->update();
-    _dist_calc->update();
-
-    // reset constraint
-    _Aineq.setZero(_max_pairs, getXSize());
-    _bUpperBound.setConstant(_max_pairs, std::numeric_limits<double>::max());
-    _bLowerBound.setConstant(_max_pairs, std::numeric_limits<double>::lowest());
+    if(_use_capsules)
+        _capsule_model->update();
+    else
+        _dist_calc->update();
 
+    if(_use_capsules)
+    {
+        // batched distances and jacobians of all the capsule pairs
+        _capsule_model->computeDistance(_distances, _include_env);
+        _capsule_model->getDistanceJacobian(_distance_J, _include_env);
+    }
+    else
+    {
+        _distance_J.setZero(_dist_calc->getNumCollisionPairs(_include_env), _distance_J.cols());
+        _distances.setZero(_distance_J.rows());
 
-    _distance_J.setZero(_dist_calc->getNumCollisionPairs(_include_env), _distance_J.cols());
-    _distances.setZero(_distance_J.rows());
 
+        // compute distances
+        _dist_calc->computeDistance(_distances, _include_env, _detection_threshold);
 
-    // compute distances
-    _dist_calc->computeDistance(_distances, _include_env, _detection_threshold);
+        // compute jacobians
+        _dist_calc->getDistanceJacobian(_distance_J, _include_env);
+    }
+}
 
-    // compute jacobians
-    _dist_calc->getDistanceJacobian(_distance_J, _include_env);
+void CollisionAvoidance::update()
+{
+    // collisions are computed once per joint position, further calls
+    // (e.g. from tasks::velocity::CollisionAvoidance) only rebuild the bounds
+    const Eigen::VectorXd& q = _robot.getJointPosition();
+    if(!_collisions_valid || _q_collisions.size() != q.size() || _q_collisions != q)
+    {
+        computeCollisions();
+        _q_collisions = q;
+        _collisions_valid = true;
+    }
 
-    const auto& pairs = _dist_calc->getCollisionPairs(_include_env);
+    // reset constraint
+    _Aineq.setZero(_max_pairs, getXSize());
+    _bUpperBound.setConstant(_max_pairs, std::numeric_limits<double>::max());
+    _bLowerBound.setConstant(_max_pairs, std::numeric_limits<double>::lowest());
+    _active_pairs_error.setConstant(_max_pairs, std::numeric_limits<double>::max());
 
     // populate Aineq and bUpperBound
     int row_idx = 0;
-    for(int i : _dist_calc->getOrderedCollisionPairIndices())
+    for(int i : getOrderedCollisionPairIndices())
     {
         if(row_idx >= _max_pairs)
         {
@@ -141,6 +182,7 @@ void CollisionAvoidance::update()
 
         _Aineq.row(row_idx) = -_distance_J.row(i);
         _bUpperBound(row_idx) = _bound_scaling*(_distances(i) - _distance_threshold);
+        _active_pairs_error(row_idx) = _distances(i) - _distance_threshold;
 
         // to avoid infeasibilities, cap upper bound to zero
         // (i.e. don't change current distance if in collision)
@@ -163,11 +205,37 @@ bool CollisionAvoidance::addCollisionShape(const std::string &name,
                        const Eigen::Affine3d &link_T_shape,
                        const std::vector<std::string> &disabled_collisions)
 {
-    return _dist_calc->addCollisionShape(name, link, shape, link_T_shape, disabled_collisions);
+    if(!_dist_calc->addCollisionShape(name, link, shape, link_T_shape, disabled_collisions))
+        return false;
+
+    _collisions_valid = false;
+
+    if(!_capsule_model->addCollisionShape(name, link, shape, link_T_shape, disabled_collisions))
+    {
+        // environment shapes are not needed when a distance field is used
+        if(link == "world")
+            _env_capsules_compatible = false;
+        else
+            _capsules_compatible = false;
+
+        if(_use_capsules && !(_capsules_compatible && _capsule_model->getDistanceField()))
+        {
+            XBot::Logger::warning("CollisionAvoidance: shape %s is not a capsule/sphere, capsule fast path disabled \n",
+                                  name.c_str());
+            setCapsuleFastPath(false);
+        }
+    }
+
+    return true;
 }
 
 bool CollisionAvoidance::moveCollisionShape(const std::string& id, const Eigen::Affine3d& new_pose)
 {
+    if(_capsules_compatible && _env_capsules_compatible)
+        _capsule_model->moveCollisionShape(id, new_pose);
+
+    _collisions_valid = false;
+
     return _dist_calc->moveCollisionShape(id, new_pose);
 }
 
@@ -180,11 +248,20 @@ void CollisionAvoidance::setMaxPairs(const unsigned int max_pairs)
 void CollisionAvoidance::setCollisionList(std::set<std::pair<std::string, std::string>> collisionList)
 {
     _dist_calc->setLinkPairs(collisionList);
+
+    _capsule_model->setLinkPairs(collisionList);
+
+    _collisions_valid = false;
 }
 
 void CollisionAvoidance::collisionModelUpdated()
 {
-    _lpv = _dist_calc->getCollisionPairs(_include_env);
+    _collisions_valid = false;
+
+    if(_use_capsules)
+        _lpv = _capsule_model->getCollisionPairs(_include_env);
+    else
+        _lpv = _dist_calc->getCollisionPairs(_include_env);
 }
 
 
@@ -206,6 +283,10 @@ void CollisionAvoidance::setBoundScaling(const double boundScaling)
 void CollisionAvoidance::setLinksVsEnvironment(const std::set<std::string> &links)
 {
     _dist_calc->setLinksVsEnvironment(links);
+
+    _capsule_model->setLinksVsEnvironment(links);
+
+    _collisions_valid = false;
 }
 
 Collision::CollisionModel &CollisionAvoidance::getCollisionModel()
@@ -222,9 +303,12 @@ void CollisionAvoidance::getOrderedWitnessPointVector(WitnessPointVector &wp) co
 {
     wp.clear();
 
-    _dist_calc->getWitnessPoints(_wpv, _include_env);
+    if(_use_capsules)
+        _capsule_model->getWitnessPoints(_wpv, _include_env);
+    else
+        _dist_calc->getWitnessPoints(_wpv, _include_env);
 
-    const auto& ordered_idx = _dist_calc->getOrderedCollisionPairIndices();
+    const auto& ordered_idx = getOrderedCollisionPairIndices();
 
     for(int i = 0; i < _num_active_pairs && i < _distances.size(); i++)
     {
@@ -236,7 +320,7 @@ void CollisionAvoidance::getOrderedLinkPairVector(LinkPairVector &lp) const
 {
     lp.clear();
 
-    const auto& ordered_idx = _dist_calc->getOrderedCollisionPairIndices();
+    const auto& ordered_idx = getOrderedCollisionPairIndices();
 
     for(int i = 0; i < _num_active_pairs && i < _distances.size(); i++)
     {
@@ -248,7 +332,7 @@ void CollisionAvoidance::getOrderedDistanceVector(std::vector<double> &d) const
 {
     d.clear();
 
-    const auto& ordered_idx = _dist_calc->getOrderedCollisionPairIndices();
+    const auto& ordered_idx = getOrderedCollisionPairIndices();
 
     for(int i = 0; i < _num_active_pairs && i < _distances.size(); i++)
     {
@@ -261,5 +345,80 @@ const Eigen::MatrixXd& CollisionAvoidance::getCollisionJacobian() const
     return _distance_J;
 }
 
+bool CollisionAvoidance::setCapsuleFastPath(const bool enable, const bool fit_from_urdf)
+{
+    if(!enable)
+    {
+        _use_capsules = false;
+        collisionModelUpdated();
+        return true;
+    }
+
+    if(fit_from_urdf && !_capsules_fitted)
+    {
+        if(!_capsule_model->fitFromUrdf(*_collision_model->getUrdf()))
+            _capsules_compatible = false;
+
+        _capsules_fitted = true;
+    }
+
+    if(!_capsules_compatible || (!_env_capsules_compatible && !_capsule_model->getDistanceField()))
+    {
+        XBot::Logger::error("CollisionAvoidance: collision shapes can not be approximated by capsules/spheres \n");
+        return false;
+    }
+
+    _use_capsules = true;
+    collisionModelUpdated();
+
+    update();
+
+    return true;
+}
+
+bool CollisionAvoidance::isCapsuleFastPathEnabled() const
+{
+    return _use_capsules;
+}
+
+OpenSoT::utils::CapsuleCollisionModel::Ptr CollisionAvoidance::getCapsuleCollisionModel()
+{
+    return _capsule_model;
+}
+
+bool CollisionAvoidance::setEnvironmentDistanceField(OpenSoT::utils::DistanceField::ConstPtr field,
+                                                     const unsigned int points_per_capsule)
+{
+    _capsule_model->setDistanceField(field, points_per_capsule);
+
+    if(!field)
+    {
+        if(_use_capsules && !_env_capsules_compatible)
+        {
+            XBot::Logger::warning("CollisionAvoidance: environment shapes are not capsules/spheres, capsule fast path disabled \n");
+            return setCapsuleFastPath(false);
+        }
+
+        collisionModelUpdated();
+        update();
+        return true;
+    }
+
+    if(!setCapsuleFastPath(true))
+    {
+        _capsule_model->setDistanceField(nullptr);
+        return false;
+    }
+
+    return true;
+}
+
+const std::vector<int>& CollisionAvoidance::getOrderedCollisionPairIndices() const
+{
+    if(_use_capsules)
+        return _capsule_model->getOrderedCollisionPairIndices();
+    return _dist_calc->getOrderedCollisionPairIndices();
+}
+
 CollisionAvoidance::~CollisionAvoidance() = default;
 
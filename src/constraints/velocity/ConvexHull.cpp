@@ -17,6 +17,7 @@
 
 #include <OpenSoT/constraints/velocity/ConvexHull.h>
 #include <OpenSoT/utils/convex_hull_utils.h>
+#include <xbot2_interface/logger.h>
 #include <exception>
 #include <cmath>
 
@@ -29,15 +30,25 @@ ConvexHull::ConvexHull(XBot::ModelInterface& robot,
     _links_in_contact(links_in_contact),_robot(robot),
     _boundScaling(safetyMargin),
     _JCoM(3, _x_size),
-    _C(links_in_contact.size(), 2)
+    _hull_size(0),
+    _hull_valid(false),
+    _contact_tolerance(1e-3)
 {
     _convex_hull = std::make_shared<convex_hull>();
-    _bUpperBound.resize(links_in_contact.size());
-    _bLowerBound.resize(links_in_contact.size());
-    _bLowerBound = -1.0e20*_bLowerBound.setOnes(_bUpperBound.size());
+    _ch.reserve(convex_hull::MAX_POINTS);
+    resize();
     this->update();
 }
 
+void ConvexHull::resize()
+{
+    _C.setZero(_links_in_contact.size(), 2);
+    _Aineq.setZero(_links_in_contact.size(), _x_size);
+    _bUpperBound.setZero(_links_in_contact.size());
+    _bLowerBound.setConstant(_links_in_contact.size(), -1.0e20);
+    _hull_valid = false;
+}
+
 void ConvexHull::update() {
 
     /************************ COMPUTING BOUNDS ****************************/
@@ -49,33 +60,57 @@ void ConvexHull::update() {
 
 
 
-    _Aineq = _C * _JCoM.block(0,0,2,_x_size);
-    //_bLowerBound = -1.0e20*_bLowerBound.setOnes(_bUpperBound.size());
+    _Aineq.noalias() = _C * _JCoM.topRows(2);
     /**********************************************************************/
 }
 
 bool ConvexHull::getConvexHull(std::vector<Eigen::Vector3d> &ch)
 {
-    _points.clear();
-    // get support polygon points w.r.t. COM
-    if(_convex_hull->getSupportPolygonPoints(_points,_links_in_contact,_robot,"COM")){
+    if(_links_in_contact.size() < 3)
+    {
+        XBot::Logger::info("Too few points for Convex Hull computation!, old Convex Hull will be used");
+        return false;
+    }
+
+    if(_links_in_contact.size() > convex_hull::MAX_POINTS)
+    {
+        XBot::Logger::info("Too many points for Convex Hull computation!, old Convex Hull will be used");
+        return false;
+    }
+
+    // contact positions in world frame
+    int n = 0;
+    bool moved = !_hull_valid;
+    for(const auto& link : _links_in_contact)
+    {
+        _robot.getPose(link, _w_T_contact);
+        _contacts[n] = _w_T_contact.translation();
+        moved = moved || (_contacts[n] - _cached_contacts[n]).norm() > _contact_tolerance;
+        n++;
+    }
 
-        if(_points.size() > 2)
+    // the vertices of the hull are recomputed only if contacts moved
+    if(moved)
+    {
+        const int hull_size = _convex_hull->getConvexHullIndices(_contacts.data(), n, _hull_indices);
+        if(hull_size == 0)
         {
-            _tmp_ch.clear();
-            if(_convex_hull->getConvexHull(_points, _tmp_ch)){
-                ch = _tmp_ch;
-                return true;}
-            else
-                XBot::Logger::info("Problems computing Convex Hull, old Convex Hull will be used\n");
+            XBot::Logger::info("Problems computing Convex Hull, old Convex Hull will be used\n");
+            return false;
         }
-        else
-            XBot::Logger::info("Too few points for Convex Hull computation!, old Convex Hull will be used");
+
+        _hull_size = hull_size;
+        _cached_contacts = _contacts;
+        _hull_valid = true;
     }
-    else
-        XBot::Logger::info("Problems getting Points for Convex Hull computation!, old Convex Hull will be used");
 
-    return false;
+    // support polygon w.r.t. the CoM, projected on z = 0
+    _com = _robot.getCOM();
+    ch.resize(_hull_size);
+    for(int j = 0; j < _hull_size; ++j)
+        ch[j] << _contacts[_hull_indices[j]].x() - _com.x(), _contacts[_hull_indices[j]].y() - _com.y(), 0.0;
+
+    return true;
 }
 
 
@@ -138,3 +173,14 @@ void ConvexHull::setSafetyMargin(const double safetyMargin)
 {
     _boundScaling = safetyMargin;
 }
+
+void ConvexHull::setContactTolerance(const double tolerance)
+{
+    _contact_tolerance = std::fabs(tolerance);
+}
+
+void ConvexHull::setLinksInContact(const std::list<std::string>& links_inc_contact)
+{
+    _links_in_contact = links_inc_contact;
+    resize();
+}
@@ -1,4 +1,6 @@
 #include <OpenSoT/solvers/BackEnd.h>
+#include <OpenSoT/utils/RtLogger.h>
+#include <chrono>
 
 using namespace OpenSoT::solvers;
 
@@ -21,21 +23,21 @@ bool BackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
                                 const Eigen::Ref<const Eigen::VectorXd> &uA)
 {
     if(_A.rows() != A.rows()){
-        XBot::Logger::error("A rows: %i \n", A.rows());
-        XBot::Logger::error("should be: %i \n", _A.rows());
+        utils::RtLogger::error("A rows: %i \n", A.rows());
+        utils::RtLogger::error("should be: %i \n", _A.rows());
         return false;
     }
     if(!(A.cols() == _H.cols())){
-        XBot::Logger::error("A cols: %i \n", A.cols());
-        XBot::Logger::error("should be: %i \n", _H.cols());
+        utils::RtLogger::error("A cols: %i \n", A.cols());
+        utils::RtLogger::error("should be: %i \n", _H.cols());
         return false;}
     if(!(lA.rows() == A.rows())){
-        XBot::Logger::error("lA size: %i \n", lA.rows());
-        XBot::Logger::error("A rows: %i \n", A.rows());
+        utils::RtLogger::error("lA size: %i \n", lA.rows());
+        utils::RtLogger::error("A rows: %i \n", A.rows());
         return false;}
     if(!(lA.rows() == uA.rows())){
-        XBot::Logger::error("lA size: %i \n", lA.rows());
-        XBot::Logger::error("uA size: %i \n", uA.rows());
+        utils::RtLogger::error("lA size: %i \n", lA.rows());
+        utils::RtLogger::error("uA size: %i \n", uA.rows());
         return false;}
 
     if(A.rows() == _A.rows())
@@ -52,12 +54,12 @@ bool BackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
 bool BackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
 {
     if(!(_g.size() == g.size())){
-        XBot::Logger::error("g size: %i \n", g.size());
-        XBot::Logger::error("should be: %i \n", _g.size());
+        utils::RtLogger::error("g size: %i \n", g.size());
+        utils::RtLogger::error("should be: %i \n", _g.size());
         return false;}
     if(!(_H.cols() == H.cols())){
-        XBot::Logger::error("H cols: %i \n", H.cols());
-        XBot::Logger::error("should be: %i \n", _H.cols());
+        utils::RtLogger::error("H cols: %i \n", H.cols());
+        utils::RtLogger::error("should be: %i \n", _H.cols());
         return false;}
 
     if(_H.rows() == H.rows())
@@ -74,16 +76,16 @@ bool BackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
 bool BackEnd::updateBounds(const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
     if(!(l.rows() == _l.rows())){
-        XBot::Logger::error("l size: %i \n", l.rows());
-        XBot::Logger::error("should be: %i \n", _l.rows());
+        utils::RtLogger::error("l size: %i \n", l.rows());
+        utils::RtLogger::error("should be: %i \n", _l.rows());
         return false;}
     if(!(u.rows() == _u.rows())){
-        XBot::Logger::error("u size: %i \n", u.rows());
-        XBot::Logger::error("should be: %i \n", _u.rows());
+        utils::RtLogger::error("u size: %i \n", u.rows());
+        utils::RtLogger::error("should be: %i \n", _u.rows());
         return false;}
     if(!(l.rows() == u.rows())){
-        XBot::Logger::error("l size: %i \n", l.rows());
-        XBot::Logger::error("u size: %i \n", u.rows());
+        utils::RtLogger::error("l size: %i \n", l.rows());
+        utils::RtLogger::error("u size: %i \n", u.rows());
         return false;}
 
     _l = l;
@@ -129,6 +131,36 @@ void BackEnd::log(XBot::MatLogger2::Ptr logger, int i, const std::string& prefix
     _log(logger, i, prefix);
 }
 
+void BackEnd::setFlightRecorder(utils::FlightRecorder::Ptr recorder, int i, const std::string& prefix,
+                                const int decimation)
+{
+    _recorder = recorder;
+    _recorder_channels = {
+        recorder->addChannel(prefix+"H_"+std::to_string(i), _H, decimation),
+        recorder->addChannel(prefix+"g_"+std::to_string(i), _g, decimation),
+        recorder->addChannel(prefix+"A_"+std::to_string(i), _A, decimation),
+        recorder->addChannel(prefix+"lA_"+std::to_string(i), _lA, decimation),
+        recorder->addChannel(prefix+"uA_"+std::to_string(i), _uA, decimation),
+        recorder->addChannel(prefix+"l_"+std::to_string(i), _l, decimation),
+        recorder->addChannel(prefix+"u_"+std::to_string(i), _u, decimation),
+        recorder->addChannel(prefix+"solution_"+std::to_string(i), _solution, decimation)
+    };
+}
+
+void BackEnd::record()
+{
+    if(!_recorder)
+        return;
+    _recorder->log(_recorder_channels[0], _H);
+    _recorder->log(_recorder_channels[1], _g);
+    _recorder->log(_recorder_channels[2], _A);
+    _recorder->log(_recorder_channels[3], _lA);
+    _recorder->log(_recorder_channels[4], _uA);
+    _recorder->log(_recorder_channels[5], _l);
+    _recorder->log(_recorder_channels[6], _u);
+    _recorder->log(_recorder_channels[7], _solution);
+}
+
 void BackEnd::printProblemInformation(const int problem_number, const std::string& problem_id,
                                       const std::string& constraints_id, const std::string& bounds_id)
 {
@@ -161,3 +193,32 @@ int OpenSoT::solvers::BackEnd::getNumVariables() const
     return _number_of_variables;
 }
 
+
+void OpenSoT::solvers::BackEnd::setCapture(QPCapture::Ptr capture, const int id)
+{
+    _capture = capture;
+    _capture_id = id;
+}
+
+bool OpenSoT::solvers::BackEnd::solveAndCapture()
+{
+    if(!_capture)
+        return solve();
+
+    if(!_capture->isArmed())
+    {
+        _capture->skip();
+        return solve();
+    }
+
+    _warm_start = _solution;
+
+    auto tic = std::chrono::steady_clock::now();
+    bool success = solve();
+    auto toc = std::chrono::steady_clock::now();
+
+    _capture->capture(_capture_id, success, std::chrono::duration<double>(toc-tic).count(),
+                      _H, _g, _A, _lA, _uA, _l, _u, _warm_start, _solution);
+
+    return success;
+}
@@ -1,5 +1,6 @@
 #include <OpenSoT/solvers/BackEndFactory.h>
 #include <xbot2_interface/common/dynamic_loading.h>
+#include <OpenSoT/utils/RtLogger.h>
 
 OpenSoT::solvers::BackEnd::Ptr CreateBackend(std::string name,
                                              const int number_of_variables,
@@ -22,10 +23,8 @@ OpenSoT::solvers::BackEnd::Ptr OpenSoT::solvers::BackEndFactory(const solver_bac
                                                                 OpenSoT::HessianType hessian_type,
                                                                 const double eps_regularisation)
 {
-    std::cout << "BackEndFactory will load solver " <<
-        number_of_variables << " variables, " <<
-        number_of_constraints << " constraints,  " <<
-        eps_regularisation << " regularization \n";
+    OpenSoT::utils::RtLogger::info("BackEndFactory will load solver %i variables, %i constraints,  %g regularization \n",
+                                   number_of_variables, number_of_constraints, eps_regularisation);
 
     if (be_solver == solver_back_ends::qpOASES) {
         return CreateBackend("QPOases",
@@ -1,5 +1,6 @@
 #include <OpenSoT/solvers/GLPKBackEnd.h>
 #include <OpenSoT/utils/SoLib.h>
+#include <OpenSoT/utils/RtLogger.h>
 #include <memory>
 #include <boost/date_time.hpp>
 
@@ -22,7 +23,11 @@ GLPKBackEnd::GLPKBackEnd(const int number_of_variables, const int number_of_cons
     BackEnd(number_of_variables, number_of_constraints),
     _rows((number_of_constraints*number_of_variables)+1),
     _cols(_rows.size()),
-    _a(_rows.size())
+    _a(_rows.size()),
+    _is_mip(false),
+    _simplex_iterations(0),
+    _col_index(number_of_constraints+1),
+    _col_values(number_of_constraints+1)
 {
     _mip = glp_create_prob();
     glp_set_prob_name(_mip, "mip_problem");
@@ -31,6 +36,19 @@ GLPKBackEnd::GLPKBackEnd(const int number_of_variables, const int number_of_cons
     glp_add_rows(_mip, number_of_constraints);
     glp_add_cols(_mip, number_of_variables);
 
+    for(int i = 0; i < _col_index.size(); ++i)
+        _col_index[i] = i;
+    _col_values[0] = 0.;
+
+    // parameters are initialized here so that the ones passed with setOptions() before initProblem() are kept
+    glp_init_iocp(&_param);
+    _param.fp_heur = GLP_OFF;
+    _opt.param = std::make_shared<glp_iocp>(_param);
+
+    glp_init_smcp(&_param_simplex);
+    // dual simplex from the last basis, switching to the primal one if needed
+    _param_simplex.meth = GLP_DUALP;
+
     glp_term_out(GLP_OFF);
 }
 
@@ -42,19 +60,19 @@ GLPKBackEnd::~GLPKBackEnd()
 void GLPKBackEnd::printErrorOutput(const int out)
 {
     if(out == GLP_EBOUND)
-        XBot::Logger::error("Unable to start the search, because some double-bounded "
+        utils::RtLogger::error("Unable to start the search, because some double-bounded "
                             "variables have incorrect bounds or some integer variables "
                             "have non-integer (fractional) bounds. \n");
     if(out == GLP_EROOT)
-        XBot::Logger::error("Unable to start the search, because optimal basis for initial "
+        utils::RtLogger::error("Unable to start the search, because optimal basis for initial "
                             "LP relaxation is not provided. (This code may appear only "
                             "if the presolver is disabled.) \n");
     if(out == GLP_ENOPFS)
-        XBot::Logger::error("Unable to start the search, because LP relaxation of the "
+        utils::RtLogger::error("Unable to start the search, because LP relaxation of the "
                             "MIP problem instance has no primal feasible solution. "
                             "(This code may appear only if the presolver is enabled.) \n");
     if(out == GLP_ENODFS)
-        XBot::Logger::error("Unable to start the search, because LP relaxation of the "
+        utils::RtLogger::error("Unable to start the search, because LP relaxation of the "
                             "MIP problem instance has no dual feasible solution. In "
                             "other word, this code means that if the LP relaxation has "
                             "at least one primal feasible solution, its optimal solution is "
@@ -63,16 +81,16 @@ void GLPKBackEnd::printErrorOutput(const int out)
                             "(This code may appear only if the presolver is "
                             "enabled.) \n");
     if(out == GLP_EFAIL)
-        XBot::Logger::error("The search was prematurely terminated due to the solver "
+        utils::RtLogger::error("The search was prematurely terminated due to the solver "
                             "failure. \n");
     if(out == GLP_EMIPGAP)
-        XBot::Logger::error("The search was prematurely terminated, because the relative "
+        utils::RtLogger::error("The search was prematurely terminated, because the relative "
                             "mip gap tolerance has been reached. \n");
     if(out == GLP_ETMLIM)
-        XBot::Logger::error("The search was prematurely terminated, because the time "
+        utils::RtLogger::error("The search was prematurely terminated, because the time "
                             "limit has been exceeded. \n");
     if(out == GLP_ESTOP)
-        XBot::Logger::error("The search was prematurely terminated by application. "
+        utils::RtLogger::error("The search was prematurely terminated by application. "
                             "(This code may appear only if the advanced solver interface "
                             "is used.) \n");
 
@@ -91,50 +109,113 @@ void GLPKBackEnd::printErrorOutput(const int out)
 
 bool GLPKBackEnd::solve()
 {
-    createsVectorsFromConstraintsMatrix();
     roundBounds();
+    loadChangedData();
 
-    //SETTING BOUNDS & COST FUNCTION
-    if(_l.rows() != 0)
+    if(!solveLP())
+        return false;
+
+    if(_is_mip)
     {
-        for(unsigned int i = 0; i < _l.rows(); ++i)
-            glp_set_col_bnds(_mip, i+1, checkConstrType(_u[i], _l[i]), _l[i], _u[i]);
+        // the LP relaxation is optimal, branch & bound starts from its basis
+        int out = glp_intopt(_mip, &_param);
+        if(out != 0)
+        {
+            utils::RtLogger::error("GLPK return false in solve!\n");
+            printErrorOutput(out);
+            return false;
+        }
+
+        for(unsigned int i = 0; i < _solution.size(); ++i)
+            _solution[i] = glp_mip_col_val(_mip, i+1);
     }
     else
     {
-        for(unsigned int i = 0; i < getNumVariables(); ++i)
-        {
-            int type = glp_get_col_type(_mip, i+1);
-            if(type == GLP_FX)
-                glp_set_col_bnds(_mip, i+1, GLP_DB, -1e10, 1e10);
-        }
+        for(unsigned int i = 0; i < _solution.size(); ++i)
+            _solution[i] = glp_get_col_prim(_mip, i+1);
+    }
+    return true;
+}
+
+bool GLPKBackEnd::solveLP()
+{
+    if(!_opt.WARM_START)
+        glp_std_basis(_mip);
+
+    const int iterations = glp_get_it_cnt(_mip);
+    int out = glp_simplex(_mip, &_param_simplex);
+    if(out != 0 || glp_get_status(_mip) != GLP_OPT)
+    {
+        // the last basis may be singular or ill-conditioned for the new data: start again from scratch
+        glp_adv_basis(_mip, 0);
+        out = glp_simplex(_mip, &_param_simplex);
     }
+    _simplex_iterations = glp_get_it_cnt(_mip) - iterations;
+
+    if(out != 0 || glp_get_status(_mip) != GLP_OPT)
+    {
+        utils::RtLogger::error("GLPK: simplex returned %i with status %i \n", out, glp_get_status(_mip));
+        return false;
+    }
+    return true;
+}
 
+void GLPKBackEnd::loadChangedData()
+{
+    //BOUNDS
+    const bool load_bounds = _l_loaded.size() != _l.size() || _u_loaded.size() != _u.size();
+    for(unsigned int i = 0; i < _l.rows(); ++i)
+    {
+        if(load_bounds || _l[i] != _l_loaded[i] || _u[i] != _u_loaded[i])
+            glp_set_col_bnds(_mip, i+1, checkConstrType(_u[i], _l[i]), _l[i], _u[i]);
+    }
+    _l_loaded = _l;
+    _u_loaded = _u;
 
+    //COST FUNCTION
+    const bool load_cost = _g_loaded.size() != _g.size();
     for(unsigned int i = 0; i < _g.size(); ++i)
-        glp_set_obj_coef(_mip, i+1, _g[i]);
-    //SETTING CONSTRAINTS
+    {
+        if(load_cost || _g[i] != _g_loaded[i])
+            glp_set_obj_coef(_mip, i+1, _g[i]);
+    }
+    _g_loaded = _g;
+
+    //CONSTRAINTS
+    const bool load_constraints = _lA_loaded.size() != _lA.size() || _uA_loaded.size() != _uA.size();
     for(unsigned int i = 0; i < _A.rows(); ++i)
-        glp_set_row_bnds(_mip, i+1, checkConstrType(_uA[i], _lA[i]), _lA[i], _uA[i]);
-    //SETTING CONSTRAINT MATRIX
-    glp_load_matrix(_mip, _A.rows()*_A.cols(), _rows.data(), _cols.data(), _a.data());
+    {
+        if(load_constraints || _lA[i] != _lA_loaded[i] || _uA[i] != _uA_loaded[i])
+            glp_set_row_bnds(_mip, i+1, checkConstrType(_uA[i], _lA[i]), _lA[i], _uA[i]);
+    }
+    _lA_loaded = _lA;
+    _uA_loaded = _uA;
 
-    int out = glp_intopt(_mip, &_param);
-    if(out != 0)
+    //CONSTRAINT MATRIX: only changed columns are loaded
+    if(_A_loaded.rows() != _A.rows() || _A_loaded.cols() != _A.cols())
     {
-        XBot::Logger::error("GLPK return false in solve!\n");
-        printErrorOutput(out);
-        return false;
+        createsVectorsFromConstraintsMatrix();
+        glp_load_matrix(_mip, _A.rows()*_A.cols(), _rows.data(), _cols.data(), _a.data());
+        _A_loaded = _A;
+        return;
     }
 
-    for(unsigned int i = 0; i < _solution.size(); ++i)
-        _solution[i] = glp_mip_col_val(_mip, i+1);
-    return true;
+    for(unsigned int j = 0; j < _A.cols(); ++j)
+    {
+        if(_A.col(j) != _A_loaded.col(j))
+        {
+            _col_values.tail(_A.rows()) = _A.col(j);
+            glp_set_mat_col(_mip, j+1, _A.rows(), _col_index.data(), _col_values.data());
+            _A_loaded.col(j) = _A.col(j);
+        }
+    }
 }
 
 double GLPKBackEnd::getObjective()
 {
-    return glp_mip_obj_val(_mip);
+    if(_is_mip)
+        return glp_mip_obj_val(_mip);
+    return glp_get_obj_val(_mip);
 }
 
 bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
@@ -145,9 +226,6 @@ bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
 
     createsVectorsFromConstraintsMatrix();
 
-    _opt.ROUND_BOUNDS = 0; //bounds are not rounded (default)
-
-
     roundBounds();
 
 
@@ -168,8 +246,16 @@ bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
         return false;}
 
     //SETTING BOUNDS & COST FUNCTION
-    for(unsigned int i = 0; i < _l.rows(); ++i)
-        glp_set_col_bnds(_mip, i+1, checkConstrType(_u[i], _l[i]), _l[i], _u[i]);
+    if(_l.rows() != 0)
+    {
+        for(unsigned int i = 0; i < _l.rows(); ++i)
+            glp_set_col_bnds(_mip, i+1, checkConstrType(_u[i], _l[i]), _l[i], _u[i]);
+    }
+    else //columns are created fixed to 0
+    {
+        for(unsigned int i = 0; i < getNumVariables(); ++i)
+            glp_set_col_bnds(_mip, i+1, GLP_DB, -1e10, 1e10);
+    }
     for(unsigned int i = 0; i < _g.size(); ++i)
         glp_set_obj_coef(_mip, i+1, _g[i]);
     //SETTING CONSTRAINTS
@@ -178,35 +264,12 @@ bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
     //SETTING CONSTRAINT MATRIX
     glp_load_matrix(_mip, _A.rows()*_A.cols(), _rows.data(), _cols.data(), _a.data());
 
-
-    glp_init_iocp(&_param);
-
-
-    glp_init_smcp(&_param_simplex);
-
-    glp_simplex(_mip, &_param_simplex);
-
-
-    _param.fp_heur = GLP_OFF;
-
-
-
+    _A_loaded = _A; _g_loaded = _g; _lA_loaded = _lA; _uA_loaded = _uA; _l_loaded = _l; _u_loaded = _u;
 
 
-    int out = glp_intopt(_mip, &_param);
-
-    if(out != 0)
-    {
-        XBot::Logger::error("GLPK return false in solve!\n");
-        printErrorOutput(out);
+    glp_adv_basis(_mip, 0);
+    if(!solve())
         return false;
-    }
-
-    for(unsigned int i = 0; i < _solution.size(); ++i)
-        _solution[i] = glp_mip_col_val(_mip, i+1);
-
-
-    _opt.param = std::make_shared<glp_iocp>(_param);
 
     //glp_write_lp(_mip, NULL, "test_cplex_lp");
     return true;
@@ -318,6 +381,8 @@ void GLPKBackEnd::setOptions(const boost::any& options)
         if(_param.cb_info != GLP_MSG_OFF)
             glp_term_out(GLP_ON);
     }
+    else
+        _opt.param = std::make_shared<glp_iocp>(_param);
 
 
     if(!(_opt.var_id_kind_.empty()))
@@ -326,6 +391,14 @@ void GLPKBackEnd::setOptions(const boost::any& options)
     for(unsigned int i = 0; i < _var_id_kind.size(); ++i)
         glp_set_col_kind(_mip, _var_id_kind[i].first+1, _var_id_kind[i].second);
 
+    _is_mip = false;
+    for(unsigned int i = 0; i < _var_id_kind.size(); ++i)
+        _is_mip = _is_mip || _var_id_kind[i].second != GLP_CV;
+
+    // changing the kind of a column may change its bounds in glpk, they are loaded again at next solve
+    _l_loaded.resize(0);
+    _u_loaded.resize(0);
+
 
 }
 
@@ -9,6 +9,10 @@ using namespace OpenSoT::solvers;
 HCOD::HCOD(OpenSoT::AutoStack &stack_of_tasks, const double damping):
     Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
     _W(stack_of_tasks.getStack().size()),
+    _W_is_diagonal(stack_of_tasks.getStack().size()),
+    _W_type(stack_of_tasks.getStack().size()),
+    _W_sqrt(stack_of_tasks.getStack().size()),
+    _W_sqrt_diagonal(stack_of_tasks.getStack().size()),
     _sqrt(stack_of_tasks.getStack().size()),
     _Wb(stack_of_tasks.getStack().size()),
     _disable_weights_computation(DEFAULT_DISABLE_WEIGHTS_COMPUTATION)
@@ -32,6 +36,10 @@ HCOD::HCOD(OpenSoT::AutoStack &stack_of_tasks, const double damping):
 HCOD::HCOD(Stack& stack_of_tasks, ConstraintPtr bounds, const double damping):
     Solver(stack_of_tasks, bounds),
     _W(stack_of_tasks.size()),
+    _W_is_diagonal(stack_of_tasks.size()),
+    _W_type(stack_of_tasks.size()),
+    _W_sqrt(stack_of_tasks.size()),
+    _W_sqrt_diagonal(stack_of_tasks.size()),
     _sqrt(stack_of_tasks.size()),
     _Wb(stack_of_tasks.size()),
     _disable_weights_computation(DEFAULT_DISABLE_WEIGHTS_COMPUTATION)
@@ -145,25 +153,30 @@ void HCOD::copy_tasks()
         }
         else
         {
-            _W[i] = _tasks[i]->getWeight();
-            if(_tasks[i]->getWeightIsDiagonalFlag()) //weight matrix is diagonal
-            {
-                for(unsigned int j = 0; i < _W[j].rows(); ++j)
-                    _W[i](j,j) = std::sqrt(_tasks[i]->getWeight()(j,j));
-            }
-            else //if not diagonal we assume weight matrix positive-definite symmetric
+            update_weight_sqrt(i);
+
+            const Eigen::MatrixXd& A = _tasks[i]->getA();
+            const Eigen::VectorXd& b = _tasks[i]->getb();
+            switch(_W_type[i])
             {
-                _sqrt[i].compute(_tasks[i]->getWeight());
-                _W[i] = _sqrt[i].operatorSqrt();
+            case WeightType::IDENTITY:
+                _vector_J[c] = A;
+                _Wb[i] = b;
+                break;
+            case WeightType::DIAGONAL:
+                _vector_J[c] = _W_sqrt_diagonal[i].asDiagonal()*A;
+                _Wb[i] = _W_sqrt_diagonal[i].cwiseProduct(b);
+                break;
+            case WeightType::DENSE:
+                _vector_J[c].noalias() = _W_sqrt[i]*A;
+                _Wb[i].noalias() = _W_sqrt[i]*b;
+                break;
             }
 
-            _vector_J[c] = _W[i]*_tasks[i]->getA();
-
-            int ss = _tasks[i]->getb().size();
+            int ss = b.size();
             if(_vector_bounds[c].size() != ss)
                 _vector_bounds[c].resize(ss);
 
-            _Wb[i] = _W[i]*_tasks[i]->getb();
             for(unsigned int j = 0; j < ss; ++j)
                 _vector_bounds[c][j] = _Wb[i][j];
         }
@@ -172,6 +185,48 @@ void HCOD::copy_tasks()
     }
 }
 
+void HCOD::update_weight_sqrt(const unsigned int i)
+{
+    const Eigen::MatrixXd& W = _tasks[i]->getWeight();
+    const bool is_diagonal = _tasks[i]->getWeightIsDiagonalFlag();
+
+    if(W.rows() == _W[i].rows() && W.cols() == _W[i].cols() &&
+       is_diagonal == _W_is_diagonal[i] && W == _W[i])
+        return;
+
+    _W[i] = W;
+    _W_is_diagonal[i] = is_diagonal;
+
+    if(W.isIdentity(0.))
+        _W_type[i] = WeightType::IDENTITY;
+    else if(is_diagonal) //weight matrix is diagonal
+    {
+        _W_type[i] = WeightType::DIAGONAL;
+        _W_sqrt_diagonal[i] = W.diagonal().cwiseSqrt();
+    }
+    else //if not diagonal we assume weight matrix positive-definite symmetric
+    {
+        _W_type[i] = WeightType::DENSE;
+
+        // the sqrt of a block diagonal weight is block diagonal
+        tasks::Aggregated::Ptr aggregated = std::dynamic_pointer_cast<tasks::Aggregated>(_tasks[i]);
+        if(aggregated)
+        {
+            _W_sqrt[i].setZero(W.rows(), W.cols());
+            for(const auto& block : aggregated->getWeightBlocks())
+            {
+                _sqrt[i].compute(W.block(block.offset, block.offset, block.size, block.size));
+                _W_sqrt[i].block(block.offset, block.offset, block.size, block.size) = _sqrt[i].operatorSqrt();
+            }
+        }
+        else
+        {
+            _sqrt[i].compute(W);
+            _W_sqrt[i] = _sqrt[i].operatorSqrt();
+        }
+    }
+}
+
 void HCOD::copy_bounds()
 {
     _A.reset();
@@ -233,6 +288,16 @@ void HCOD::setDamping(double damping)
     _hcod->setDamping(damping);
 }
 
+void HCOD::setActiveSetWarmStart(const bool warm_start)
+{
+    _hcod->setWarmStart(warm_start);
+}
+
+bool HCOD::getActiveSetWarmStart() const
+{
+    return _hcod->getWarmStart();
+}
+
 
 
 HCOD::~HCOD()
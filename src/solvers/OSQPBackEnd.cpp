@@ -3,10 +3,48 @@
 #include <error.h>  // this is from osqp!
 #include <exception>
 #include <memory>
+#include <algorithm>
+#include <OpenSoT/utils/RtLogger.h>
 using namespace OpenSoT::solvers;
 
 #define BASE_REGULARISATION 2.22E-13 //previous 1E-12
 
+namespace {
+
+/**
+ * @brief isStored true if (row, col) is a stored entry of the compressed matrix S
+ */
+bool isStored(const Eigen::SparseMatrix<double>& S, const int row, const int col)
+{
+    if(row >= S.rows() || col >= S.cols())
+        return false;
+    const int* begin = S.innerIndexPtr() + S.outerIndexPtr()[col];
+    const int* end = S.innerIndexPtr() + S.outerIndexPtr()[col+1];
+    return std::binary_search(begin, end, row);
+}
+
+#ifndef NDEBUG
+/**
+ * @brief isInsidePattern true if the nonzeros of the first rows of M (of its upper triangular part if upper)
+ * are stored entries of the compressed matrix S
+ */
+bool isInsidePattern(const Eigen::MatrixXd& M, const Eigen::SparseMatrix<double>& S, const int rows, const bool upper)
+{
+    for(int c = 0; c < M.cols(); ++c)
+    {
+        const int end = upper ? std::min(c + 1, rows) : rows;
+        for(int r = 0; r < end; ++r)
+        {
+            if(M(r, c) != 0. && !isStored(S, r, c))
+                return false;
+        }
+    }
+    return true;
+}
+#endif
+
+}
+
 
 /* Define factories for dynamic loading */
 extern "C" BackEnd * create_instance(const int number_of_variables,
@@ -26,6 +64,8 @@ OSQPBackEnd::OSQPBackEnd(const int number_of_variables,
                          const int number_of_constraints,
                          const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
+    _workspace(nullptr),
+    _P_changed(true), _A_changed(true),
     _eps_regularisation(eps_regularisation*BASE_REGULARISATION) //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
 {
     
@@ -33,8 +73,6 @@ OSQPBackEnd::OSQPBackEnd(const int number_of_variables,
         throw std::runtime_error("DLONG option in OSQP should be set to OFF in CMakeLists!");
     #endif
     
-    _P_values.resize(getNumVariables()*(getNumVariables() + 1)/2);
-    
     _settings = std::make_shared<OSQPSettings>();
      osqp_set_default_settings(_settings.get());
     _settings->verbose = 0;
@@ -52,38 +90,64 @@ void OSQPBackEnd::__generate_data_struct(const int number_of_variables,
                                          const int number_of_constraints, 
                                          const int number_of_bounds)
 {
-    _lb_piled.setConstant(number_of_bounds + number_of_constraints, -1.0);
-    _ub_piled.setConstant(number_of_bounds + number_of_constraints,  1.0);
+    if(_lb_piled.size() != number_of_bounds + number_of_constraints)
+    {
+        _lb_piled.setConstant(number_of_bounds + number_of_constraints, -1.0);
+        _ub_piled.setConstant(number_of_bounds + number_of_constraints,  1.0);
+    }
 
-    /* Set appropriate sparsity pattern to P (upper triangular) */
-    
-    Eigen::MatrixXd sp_pattern, ones;
-    sp_pattern.setZero(getNumVariables(), getNumVariables());
-    ones.setOnes(getNumVariables(), getNumVariables());
-    
-    sp_pattern.triangularView<Eigen::Upper>() = ones;
-    
-    _Psparse = sp_pattern.sparseView();
+    /* Set appropriate sparsity pattern to P (upper triangular part of the given pattern plus diagonal, dense otherwise) */
+    const bool H_given = _H_pattern.rows() == number_of_variables && _H_pattern.cols() == number_of_variables;
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for(int c = 0; c < number_of_variables; ++c)
+    {
+        for(int r = 0; r <= c; ++r)
+        {
+            if(!H_given || r == c || isStored(_H_pattern, r, c) || isStored(_H_pattern, c, r))
+                triplets.emplace_back(r, c, 1.);
+        }
+    }
+
+    _Psparse.resize(number_of_variables, number_of_variables);
+    _Psparse.setFromTriplets(triplets.begin(), triplets.end());
     _Psparse.makeCompressed();
+
+    _P_values = Eigen::Map<Eigen::VectorXd>(_Psparse.valuePtr(), _Psparse.nonZeros());
     
     setCSCMatrix(_Pcsc.get(), _Psparse);
     _Pcsc->x = _P_values.data();
 
 
-    /* Set appropriate sparsity pattern to A (dense + diagonal) */
-    ones.setOnes(number_of_constraints, number_of_variables);
-    sp_pattern.setZero(number_of_constraints + number_of_bounds, number_of_variables);
-    sp_pattern.topRows(number_of_constraints) = ones;
-    sp_pattern.bottomRows(number_of_bounds) = Eigen::MatrixXd::Identity(number_of_bounds, number_of_variables);
+    /* Set appropriate sparsity pattern to A (given pattern, dense otherwise, plus diagonal for the bounds) */
+    const bool A_given = _A_pattern.rows() == number_of_constraints && _A_pattern.cols() == number_of_variables;
 
-    _Asparse = sp_pattern.sparseView();
+    triplets.clear();
+    if(A_given)
+    {
+        triplets.reserve(_A_pattern.nonZeros() + number_of_bounds);
+        for(int k = 0; k < _A_pattern.outerSize(); ++k)
+            for(SparseMatrix::InnerIterator it(_A_pattern, k); it; ++it)
+                triplets.emplace_back(it.row(), it.col(), 1.);
+    }
+    else
+    {
+        triplets.reserve(number_of_constraints*number_of_variables + number_of_bounds);
+        for(int c = 0; c < number_of_variables; ++c)
+            for(int r = 0; r < number_of_constraints; ++r)
+                triplets.emplace_back(r, c, 1.);
+    }
+    for(int i = 0; i < number_of_bounds; ++i)
+        triplets.emplace_back(number_of_constraints + i, i, 1.);
+
+    _Asparse.resize(number_of_constraints + number_of_bounds, number_of_variables);
+    _Asparse.setFromTriplets(triplets.begin(), triplets.end());
     _Asparse.makeCompressed();
 
-    int bounds_defined = number_of_bounds > 0 ? 1 : 0;
-    _Adense.setOnes(number_of_constraints + bounds_defined, number_of_variables);
+    _A_values = Eigen::Map<Eigen::VectorXd>(_Asparse.valuePtr(), _Asparse.nonZeros());
 
     setCSCMatrix(_Acsc.get(), _Asparse);
-    _Acsc->x = _Adense.data();
+    _Acsc->x = _A_values.data();
 
 
 
@@ -102,8 +166,47 @@ void OSQPBackEnd::__generate_data_struct(const int number_of_variables,
     
 }
 
-void OpenSoT::solvers::OSQPBackEnd::update_data_struct()
+void OSQPBackEnd::upper_triangular_sparse_update()
 {
+    const int* outer = _Psparse.outerIndexPtr();
+    const int* inner = _Psparse.innerIndexPtr();
+    for(int c = 0; c < _Psparse.outerSize(); ++c)
+    {
+        for(int k = outer[c]; k < outer[c+1]; ++k)
+        {
+            const int r = inner[k];
+            double value = _H(r, c);
+            if(r == c)
+                value += _eps_regularisation;
+
+            if(_P_values[k] != value)
+            {
+                _P_values[k] = value;
+                _P_changed = true;
+            }
+        }
+    }
+}
+
+void OSQPBackEnd::constraints_sparse_update()
+{
+    const int number_of_constraints = getNumConstraints();
+
+    // in each column the entries of the constraints come before the one of the bounds
+    const int* outer = _Asparse.outerIndexPtr();
+    const int* inner = _Asparse.innerIndexPtr();
+    for(int c = 0; c < _Asparse.outerSize(); ++c)
+    {
+        for(int k = outer[c]; k < outer[c+1] && inner[k] < number_of_constraints; ++k)
+        {
+            const int r = inner[k];
+            if(_A_values[k] != _A(r, c))
+            {
+                _A_values[k] = _A(r, c);
+                _A_changed = true;
+            }
+        }
+    }
 }
 
 
@@ -127,13 +230,16 @@ bool OSQPBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
     }
     
     
-    int idx = 0;
-    for(int c = 0; c < getNumVariables(); c++)
+    /* Only the structural nonzeros of the upper triangular part are read */
+    upper_triangular_sparse_update();
+
+#ifndef NDEBUG
+    if(!isInsidePattern(_H, _Psparse, _H.rows(), true))
     {
-        _P_values.segment(idx, c+1) = _H.col(c).head(c+1);
-        _P_values.segment(idx, c+1)(c) += _eps_regularisation;
-        idx += c+1;
+        utils::RtLogger::error("OSQP: H has nonzeros outside the sparsity pattern \n");
+        return false;
     }
+#endif
     
     setCSCMatrix(_Pcsc.get(), _Psparse);
     _data->P->x = _P_values.data();
@@ -159,10 +265,18 @@ bool OSQPBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
         }
         
 
-        /* Update values in A upper part (constraints) */
-        _Adense.topRows(getNumConstraints()) = _A;
+        /* Update values in A upper part (constraints), only the structural nonzeros are read */
+        constraints_sparse_update();
+
+#ifndef NDEBUG
+        if(!isInsidePattern(_A, _Asparse, _A.rows(), false))
+        {
+            utils::RtLogger::error("OSQP: A has nonzeros outside the sparsity pattern \n");
+            return false;
+        }
+#endif
         setCSCMatrix(_Acsc.get(), _Asparse); // Asparse may be reallocated???
-        _data->A->x = _Adense.data();
+        _data->A->x = _A_values.data();
         
         /* Update constraints bounds */
         _lb_piled.head(getNumConstraints()) = _lA;
@@ -201,12 +315,22 @@ bool OSQPBackEnd::solve()
     c_int update_bound_flag = osqp_update_bounds(_workspace, _lb_piled.data(), _ub_piled.data());
     if(update_bound_flag != 0)
         return false;
-    c_int update_A_flag = osqp_update_A(_workspace, _Adense.data(), OSQP_NULL, _Adense.size());
-    if(update_A_flag != 0)
-        return false;
-    c_int update_P_flag = osqp_update_P(_workspace, _P_values.data(), OSQP_NULL, _P_values.size());
-    if(update_P_flag != 0)
-        return false;
+
+    /* P and A are passed (and the KKT matrix refactorized) only if their values changed */
+    if(_A_changed)
+    {
+        c_int update_A_flag = updateA();
+        if(update_A_flag != 0)
+            return false;
+        _A_changed = false;
+    }
+    if(_P_changed)
+    {
+        c_int update_P_flag = updateP();
+        if(update_P_flag != 0)
+            return false;
+        _P_changed = false;
+    }
     
     
     
@@ -216,7 +340,7 @@ bool OSQPBackEnd::solve()
     
     c_int workspace_flag = _workspace->info->status_val;
     if(workspace_flag != 1 && workspace_flag != 2){
-        XBot::Logger::error("%s", _workspace->info->status);
+        utils::RtLogger::error("%s", _workspace->info->status);
         return false;}
 
     _solution = Eigen::Map<Eigen::VectorXd>(_workspace->solution->x, _solution.size());
@@ -225,6 +349,16 @@ bool OSQPBackEnd::solve()
     
 }
 
+c_int OSQPBackEnd::updateP()
+{
+    return osqp_update_P(_workspace, _P_values.data(), OSQP_NULL, _P_values.size());
+}
+
+c_int OSQPBackEnd::updateA()
+{
+    return osqp_update_A(_workspace, _A_values.data(), OSQP_NULL, _A_values.size());
+}
+
 boost::any OSQPBackEnd::getOptions()
 {
     return _settings;
@@ -245,7 +379,7 @@ bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
 {
     //couple of checks
     if(A.rows() != _A.rows()){
-        XBot::Logger::error("A.rows() != _A.rows() --> %f != %f", A.rows(), _A.rows());
+        utils::RtLogger::error("A.rows() != _A.rows() --> %f != %f", A.rows(), _A.rows());
         return false;}
 
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u; //this is needed since updateX should be used just to update and not init (maybe can be done in the base class)
@@ -260,29 +394,31 @@ bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
     
     if( ((_ub_piled - _lb_piled).array() < 0).any() )
     {
-        XBot::Logger::error("OSQP: invalid bounds\n");
+        utils::RtLogger::error("OSQP: invalid bounds\n");
         return false;
     }
     
 
-    //_workspace.reset( osqp_setup(_data.get(), _settings.get()) );
-    
     c_int setup_return = 0;
     if(_data && _settings)
         setup_return = osqp_setup(&_workspace, _data.get(), _settings.get());
     else
     {
-        XBot::Logger::error("OSQP: data or settings not created before setup\n");
+        utils::RtLogger::error("OSQP: data or settings not created before setup\n");
         return false;
     }
 
 
-    if(!_workspace)
+    if(setup_return != 0 || !_workspace)
     {
-        XBot::Logger::error("OSQP: unable to setup workspace\n");
+        utils::RtLogger::error("OSQP: unable to setup workspace\n");
         return false;
     }
 
+    // P and A have been passed to OSQP by the setup
+    _P_changed = false;
+    _A_changed = false;
+
 
     success = solve() && success;
     
@@ -320,6 +456,34 @@ OSQPBackEnd::~OSQPBackEnd()
     osqp_cleanup(_workspace);
 }
 
+bool OSQPBackEnd::setConstraintsSparsity(const Eigen::SparseMatrix<double>& pattern)
+{
+    if(pattern.rows() != getNumConstraints() || pattern.cols() != getNumVariables())
+    {
+        XBot::Logger::error("OSQP: sparsity pattern is %i x %i, should be %i x %i \n",
+                            int(pattern.rows()), int(pattern.cols()), getNumConstraints(), getNumVariables());
+        return false;
+    }
+
+    _A_pattern = pattern;
+    _A_pattern.makeCompressed();
+    return true;
+}
+
+bool OSQPBackEnd::setHessianSparsity(const Eigen::SparseMatrix<double>& pattern)
+{
+    if(pattern.rows() != getNumVariables() || pattern.cols() != getNumVariables())
+    {
+        XBot::Logger::error("OSQP: Hessian sparsity pattern is %i x %i, should be %i x %i \n",
+                            int(pattern.rows()), int(pattern.cols()), getNumVariables(), getNumVariables());
+        return false;
+    }
+
+    _H_pattern = pattern;
+    _H_pattern.makeCompressed();
+    return true;
+}
+
 bool OSQPBackEnd::setEpsRegularisation(const double eps)
 {
     if(eps < 0.0)
@@ -0,0 +1,355 @@
+#include <OpenSoT/solvers/QPCapture.h>
+#include <xbot2_interface/logger.h>
+#include <matlogger2/matlogger2.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace OpenSoT::solvers;
+
+const char QPCapture::MAGIC[8] = {'O', 'S', 'O', 'T', 'Q', 'P', 'C', '\0'};
+
+namespace {
+
+std::uint64_t recordSize(const std::int64_t n, const std::int64_t m)
+{
+    return sizeof(QPCapture::RecordHeader) + sizeof(double)*(n*n + 5*n + m*n + 2*m);
+}
+
+bool isInfinite(const double v)
+{
+    return std::fabs(v) >= 1e20;
+}
+
+}
+
+QPCapture::QPCapture(const std::string& file_name, const Trigger trigger, const double slow_solve_time):
+    _file_name(file_name),
+    _file(nullptr),
+    _armed(true),
+    _trigger(trigger),
+    _slow_solve_time(slow_solve_time),
+    _sequence(0),
+    _captured(0)
+{
+    _file = std::fopen(file_name.c_str(), "wb");
+    if(!_file)
+    {
+        XBot::Logger::error("QPCapture: can not open %s \n", file_name.c_str());
+        return;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.record_header_size = sizeof(RecordHeader);
+    std::fwrite(&header, sizeof(FileHeader), 1, _file);
+}
+
+QPCapture::~QPCapture()
+{
+    if(_file)
+        std::fclose(_file);
+}
+
+bool QPCapture::isTriggered(const bool success, const double solve_time) const
+{
+    switch(_trigger)
+    {
+    case Trigger::ALWAYS: return true;
+    case Trigger::SLOW_SOLVE: return solve_time > _slow_solve_time;
+    case Trigger::FAILURE: return !success;
+    case Trigger::SLOW_SOLVE_OR_FAILURE: return !success || solve_time > _slow_solve_time;
+    }
+    return false;
+}
+
+void QPCapture::write(const double* data, const Eigen::Index size)
+{
+    if(size > 0)
+        std::fwrite(data, sizeof(double), size, _file);
+}
+
+void QPCapture::writeConstant(const double value, const Eigen::Index size)
+{
+    for(Eigen::Index i = 0; i < size; ++i)
+        std::fwrite(&value, sizeof(double), 1, _file);
+}
+
+bool QPCapture::capture(const int id, const bool success, const double solve_time,
+                        const Eigen::MatrixXd& H, const Eigen::VectorXd& g,
+                        const Eigen::MatrixXd& A, const Eigen::VectorXd& lA, const Eigen::VectorXd& uA,
+                        const Eigen::VectorXd& l, const Eigen::VectorXd& u,
+                        const Eigen::VectorXd& warm_start, const Eigen::VectorXd& solution)
+{
+    _sequence++;
+
+    if(!isArmed() || !isTriggered(success, solve_time))
+        return _file != nullptr;
+
+    const Eigen::Index n = g.size();
+    const Eigen::Index m = A.rows();
+
+    if(H.rows() != n || H.cols() != n || (m > 0 && A.cols() != n) || lA.size() != m || uA.size() != m ||
+       (l.size() != n && l.size() != 0) || u.size() != l.size() || warm_start.size() != n || solution.size() != n)
+    {
+        XBot::Logger::error("QPCapture: problem %lu has inconsistent sizes and will not be captured \n", _sequence);
+        return false;
+    }
+
+    RecordHeader header;
+    header.size = recordSize(n, m);
+    header.sequence = _sequence;
+    header.id = id;
+    header.n = n;
+    header.m = m;
+    header.success = success;
+    header.solve_time = solve_time;
+
+    std::fwrite(&header, sizeof(RecordHeader), 1, _file);
+    write(H.data(), H.size());
+    write(g.data(), n);
+    write(A.data(), A.size());
+    write(lA.data(), m);
+    write(uA.data(), m);
+    //problems without bounds are stored with infinite bounds
+    if(l.size() > 0)
+    {
+        write(l.data(), n);
+        write(u.data(), n);
+    }
+    else
+    {
+        writeConstant(-std::numeric_limits<double>::infinity(), n);
+        writeConstant(std::numeric_limits<double>::infinity(), n);
+    }
+    write(warm_start.data(), n);
+    write(solution.data(), n);
+
+    if(std::ferror(_file))
+    {
+        XBot::Logger::error("QPCapture: error writing %s \n", _file_name.c_str());
+        return false;
+    }
+
+    _captured++;
+    return true;
+}
+
+void QPCapture::flush()
+{
+    if(_file)
+        std::fflush(_file);
+}
+
+QPCaptureReader::Problem::Problem(const QPCapture::RecordHeader* header):
+    header(header),
+    H(reinterpret_cast<const double*>(reinterpret_cast<const char*>(header) + sizeof(QPCapture::RecordHeader)),
+      header->n, header->n),
+    g(H.data() + H.size(), header->n),
+    A(g.data() + header->n, header->m, header->n),
+    lA(A.data() + A.size(), header->m),
+    uA(lA.data() + header->m, header->m),
+    l(uA.data() + header->m, header->n),
+    u(l.data() + header->n, header->n),
+    warm_start(u.data() + header->n, header->n),
+    solution(warm_start.data() + header->n, header->n)
+{
+
+}
+
+QPCaptureReader::QPCaptureReader(const std::string& file_name):
+    _data(nullptr),
+    _size(0)
+{
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        XBot::Logger::error("QPCaptureReader: can not open %s \n", file_name.c_str());
+        return;
+    }
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(QPCapture::FileHeader)))
+    {
+        XBot::Logger::error("QPCaptureReader: %s is not a valid capture \n", file_name.c_str());
+        ::close(fd);
+        return;
+    }
+
+    void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED)
+    {
+        XBot::Logger::error("QPCaptureReader: can not map %s \n", file_name.c_str());
+        return;
+    }
+
+    const QPCapture::FileHeader* header = static_cast<const QPCapture::FileHeader*>(data);
+    if(std::memcmp(header->magic, QPCapture::MAGIC, sizeof(QPCapture::MAGIC)) != 0 ||
+       header->version != QPCapture::VERSION ||
+       header->record_header_size != sizeof(QPCapture::RecordHeader))
+    {
+        XBot::Logger::error("QPCaptureReader: %s is not a valid capture \n", file_name.c_str());
+        ::munmap(data, st.st_size);
+        return;
+    }
+
+    _data = static_cast<const char*>(data);
+    _size = st.st_size;
+
+    std::size_t offset = sizeof(QPCapture::FileHeader);
+    while(offset + sizeof(QPCapture::RecordHeader) <= _size)
+    {
+        const QPCapture::RecordHeader* record = reinterpret_cast<const QPCapture::RecordHeader*>(_data + offset);
+        if(record->n < 0 || record->m < 0 || record->size != recordSize(record->n, record->m) ||
+           offset + record->size > _size)
+        {
+            //a capture which was not closed can end with a partially written record
+            XBot::Logger::warning("QPCaptureReader: %s is truncated after %lu problems \n",
+                                  file_name.c_str(), _records.size());
+            break;
+        }
+        _records.push_back(record);
+        offset += record->size;
+    }
+}
+
+QPCaptureReader::~QPCaptureReader()
+{
+    if(_data)
+        ::munmap(const_cast<char*>(_data), _size);
+}
+
+QPCaptureReader::Problem QPCaptureReader::getProblem(const std::size_t i) const
+{
+    return Problem(_records.at(i));
+}
+
+bool QPCaptureReader::exportQPS(const Problem& problem, const std::string& file_name, const std::string& name)
+{
+    std::ofstream qps(file_name);
+    if(!qps.is_open())
+    {
+        XBot::Logger::error("QPCaptureReader: can not write %s \n", file_name.c_str());
+        return false;
+    }
+    qps << std::setprecision(17);
+
+    const Eigen::Index n = problem.header->n;
+    const Eigen::Index m = problem.header->m;
+
+    qps << "NAME " << name << "\n";
+
+    qps << "ROWS\n";
+    qps << " N obj\n";
+    for(Eigen::Index i = 0; i < m; ++i)
+    {
+        const bool has_lower = !isInfinite(problem.lA[i]);
+        const bool has_upper = !isInfinite(problem.uA[i]);
+        if(has_lower && has_upper && problem.lA[i] == problem.uA[i])
+            qps << " E c" << i << "\n";
+        else if(has_lower)
+            qps << " G c" << i << "\n";
+        else if(has_upper)
+            qps << " L c" << i << "\n";
+        else
+            qps << " N c" << i << "\n";
+    }
+
+    qps << "COLUMNS\n";
+    for(Eigen::Index j = 0; j < n; ++j)
+    {
+        if(problem.g[j] != 0.)
+            qps << " x" << j << " obj " << problem.g[j] << "\n";
+        for(Eigen::Index i = 0; i < m; ++i)
+        {
+            if(problem.A(i,j) != 0.)
+                qps << " x" << j << " c" << i << " " << problem.A(i,j) << "\n";
+        }
+    }
+
+    qps << "RHS\n";
+    for(Eigen::Index i = 0; i < m; ++i)
+    {
+        if(!isInfinite(problem.lA[i]))
+            qps << " rhs c" << i << " " << problem.lA[i] << "\n";
+        else if(!isInfinite(problem.uA[i]))
+            qps << " rhs c" << i << " " << problem.uA[i] << "\n";
+    }
+
+    qps << "RANGES\n";
+    for(Eigen::Index i = 0; i < m; ++i)
+    {
+        if(!isInfinite(problem.lA[i]) && !isInfinite(problem.uA[i]) && problem.lA[i] != problem.uA[i])
+            qps << " rng c" << i << " " << problem.uA[i] - problem.lA[i] << "\n";
+    }
+
+    qps << "BOUNDS\n";
+    for(Eigen::Index j = 0; j < n; ++j)
+    {
+        const bool has_lower = !isInfinite(problem.l[j]);
+        const bool has_upper = !isInfinite(problem.u[j]);
+        if(has_lower && has_upper && problem.l[j] == problem.u[j])
+            qps << " FX bnd x" << j << " " << problem.l[j] << "\n";
+        else if(!has_lower && !has_upper)
+            qps << " FR bnd x" << j << "\n";
+        else
+        {
+            if(has_lower)
+                qps << " LO bnd x" << j << " " << problem.l[j] << "\n";
+            else
+                qps << " MI bnd x" << j << "\n";
+            if(has_upper)
+                qps << " UP bnd x" << j << " " << problem.u[j] << "\n";
+        }
+    }
+
+    qps << "QUADOBJ\n";
+    for(Eigen::Index j = 0; j < n; ++j)
+    {
+        for(Eigen::Index i = j; i < n; ++i)
+        {
+            if(problem.H(i,j) != 0.)
+                qps << " x" << i << " x" << j << " " << problem.H(i,j) << "\n";
+        }
+    }
+
+    qps << "ENDATA\n";
+
+    return qps.good();
+}
+
+bool QPCaptureReader::exportMat(const std::string& file_name) const
+{
+    if(!_data)
+        return false;
+
+    XBot::MatLogger2::Ptr logger = XBot::MatLogger2::MakeLogger(file_name);
+    if(!logger)
+        return false;
+
+    for(std::size_t i = 0; i < _records.size(); ++i)
+    {
+        Problem problem = getProblem(i);
+        std::string suffix = "_" + std::to_string(i);
+
+        logger->add("H" + suffix, problem.H);
+        logger->add("g" + suffix, problem.g);
+        logger->add("A" + suffix, problem.A);
+        logger->add("lA" + suffix, problem.lA);
+        logger->add("uA" + suffix, problem.uA);
+        logger->add("l" + suffix, problem.l);
+        logger->add("u" + suffix, problem.u);
+        logger->add("warm_start" + suffix, problem.warm_start);
+        logger->add("solution" + suffix, problem.solution);
+    }
+
+    return true;
+}
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <qpOASES/Matrices.hpp>
 #include <xbot2_interface/logger.h>
+#include <OpenSoT/utils/RtLogger.h>
 
 using namespace OpenSoT::solvers;
 
@@ -90,7 +91,7 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
 {
     //couple of checks
     if(A.rows() != _A.rows()){
-        XBot::Logger::error("A.rows() != _A.rows() --> %f != %f", A.rows(), _A.rows());
+        utils::RtLogger::error("A.rows() != _A.rows() --> %f != %f", A.rows(), _A.rows());
         return false;}
 
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u;
@@ -104,18 +105,18 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
 
 
     if(!(_l.rows() == _u.rows())){
-        XBot::Logger::error("l size: %i \n", _l.rows());
-        XBot::Logger::error("u size: %i \n", _u.rows());
+        utils::RtLogger::error("l size: %i \n", _l.rows());
+        utils::RtLogger::error("u size: %i \n", _u.rows());
         assert(_l.rows() == _u.rows());
         return false;}
     if(!(_lA.rows() == _A.rows())){
-        XBot::Logger::error("lA size: %i \n", _lA.rows());
-        XBot::Logger::error("A rows: %i \n", _A.rows());
+        utils::RtLogger::error("lA size: %i \n", _lA.rows());
+        utils::RtLogger::error("A rows: %i \n", _A.rows());
         assert(_lA.rows() == _A.rows());
         return false;}
     if(!(_lA.rows() == _uA.rows())){
-        XBot::Logger::error("lA size: %i \n", _lA.rows());
-        XBot::Logger::error("uA size: %i \n", _uA.rows());
+        utils::RtLogger::error("lA size: %i \n", _lA.rows());
+        utils::RtLogger::error("uA size: %i \n", _uA.rows());
         assert(_lA.rows() == _uA.rows());
         return false;}
 
@@ -140,8 +141,8 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
         if(val == qpOASES::RET_INIT_FAILED_INFEASIBILITY)
             printConstraintsInfo();
 
-        XBot::Logger::error("ERROR INITIALIZING QP PROBLEM \n");
-        XBot::Logger::error("CODE ERROR: %i \n", val);
+        utils::RtLogger::error("ERROR INITIALIZING QP PROBLEM \n");
+        utils::RtLogger::error("CODE ERROR: %i \n", val);
 #endif
 
         return false;
@@ -161,7 +162,7 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
 
     if(success != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
-        XBot::Logger::error("ERROR GETTING PRIMAL SOLUTION IN INITIALIZATION! ERROR %i \n", success);
+        utils::RtLogger::error("ERROR GETTING PRIMAL SOLUTION IN INITIALIZATION! ERROR %i \n", success);
 #endif
         return false;}
     return true;
@@ -170,12 +171,12 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
 bool QPOasesBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
 {
     if(!(_g.size() == g.size())){
-        XBot::Logger::error("g size: %i \n", g.size());
-        XBot::Logger::error("should be: %i \n", _g.size());
+        utils::RtLogger::error("g size: %i \n", g.size());
+        utils::RtLogger::error("should be: %i \n", _g.size());
         return false;}
     if(!(_H.cols() == H.cols())){
-        XBot::Logger::error("H cols: %i \n", H.cols());
-        XBot::Logger::error("should be: %i \n", _H.cols());
+        utils::RtLogger::error("H cols: %i \n", H.cols());
+        utils::RtLogger::error("should be: %i \n", _H.cols());
         return false;}
 
     if(_H.rows() == H.rows())
@@ -207,16 +208,16 @@ bool QPOasesBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>&
                                const Eigen::Ref<const Eigen::VectorXd> &uA)
 {
     if(!(A.cols() == _H.cols())){
-        XBot::Logger::error("A cols: %i \n", A.cols());
-        XBot::Logger::error("should be: %i \n", _H.cols());
+        utils::RtLogger::error("A cols: %i \n", A.cols());
+        utils::RtLogger::error("should be: %i \n", _H.cols());
         return false;}
     if(!(lA.rows() == A.rows())){
-        XBot::Logger::error("lA size: %i \n", lA.rows());
-        XBot::Logger::error("A rows: %i \n", A.rows());
+        utils::RtLogger::error("lA size: %i \n", lA.rows());
+        utils::RtLogger::error("A rows: %i \n", A.rows());
         return false;}
     if(!(lA.rows() == uA.rows())){
-        XBot::Logger::error("lA size: %i \n", lA.rows());
-        XBot::Logger::error("uA size: %i \n", uA.rows());
+        utils::RtLogger::error("lA size: %i \n", lA.rows());
+        utils::RtLogger::error("uA size: %i \n", uA.rows());
         return false;}
 
     if(A.rows() == _A.rows())
@@ -263,8 +264,8 @@ bool QPOasesBackEnd::solve()
 
     if(val != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
-        XBot::Logger::warning("WARNING OPTIMIZING TASK IN HOTSTART! ERROR  %i \n", val);
-        XBot::Logger::success("RETRYING INITING WITH WARMSTART \n");
+        utils::RtLogger::warning("WARNING OPTIMIZING TASK IN HOTSTART! ERROR  %i \n", val);
+        utils::RtLogger::success("RETRYING INITING WITH WARMSTART \n");
 #endif
 
         val =_problem->init(_H.data(),_g.data(),
@@ -277,8 +278,8 @@ bool QPOasesBackEnd::solve()
 
         if(val != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
-            XBot::Logger::warning("WARNING OPTIMIZING TASK IN WARMSTART! ERROR  %i \n", val);
-            XBot::Logger::success("RETRYING INITING \n");
+            utils::RtLogger::warning("WARNING OPTIMIZING TASK IN WARMSTART! ERROR  %i \n", val);
+            utils::RtLogger::success("RETRYING INITING \n");
 #endif
 
             return initProblem(_H, _g, _A, _lA, _uA, _l ,_u);}
@@ -299,7 +300,7 @@ bool QPOasesBackEnd::solve()
 
     if(qpOASES::getSimpleStatus(success) < 0){
 #ifdef OPENSOT_VERBOSE
-        XBot::Logger::info("ERROR GETTING PRIMAL SOLUTION! ERROR %i \n", success);
+        utils::RtLogger::info("ERROR GETTING PRIMAL SOLUTION! ERROR %i \n", success);
 #endif
         return initProblem(_H, _g, _A, _lA, _uA, _l ,_u);
     }
@@ -16,39 +16,34 @@ eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigm
         _x_size = _tasks[0]->getXSize();
         // We reserve some memory
         // this goes from 0 to stack.size() !!!
-        stack_level lvl;
+        _stack_levels.resize(stack.size() + 1);
         for(unsigned int i = 0; i <= stack.size(); ++i)
         {
-            if(i == 0)
-            {
-                lvl._P = Eigen::MatrixXd::Identity(_x_size, _x_size);
-            }
-            else
+            stack_level& lvl = _stack_levels[i];
+            lvl._P = Eigen::MatrixXd::Identity(_x_size, _x_size);
+
+            if(i > 0)
             {
                 if(_tasks[i-1]->getHessianAtype() == HessianType::HST_ZERO){
                     std::stringstream error_ss;
                     error_ss << "Task "<<i-1<<" has Hessian Type HST_ZERO which is not handled by eHQP, aborting!"<<std::endl;
                     throw std::runtime_error(error_ss.str());}
 
-                lvl._P = Eigen::MatrixXd::Identity(_x_size, _x_size);
-                lvl._JP = Eigen::MatrixXd::Identity(
-                    _tasks[i-1]->getA().rows(), _x_size);
-                lvl._JPpinv = Eigen::MatrixXd::Identity(
-                    _x_size, _tasks[i-1]->getA().rows());
-
-                lvl._JPsvd = Eigen::JacobiSVD<Eigen::MatrixXd>(
-                            _tasks[i-1]->getA().rows(),_x_size,
-                            Eigen::ComputeThinU | Eigen::ComputeThinV);
-
-                #if EIGEN_MINOR_VERSION <= 0
-                lvl._FPL = Eigen::FullPivLU<Eigen::MatrixXd>(
-                            _tasks[i-1]->getA().rows(), _x_size);
+                const int rows = _tasks[i-1]->getA().rows();
+                const int rank_max = std::min(rows, _x_size);
 
-                #endif
+                lvl._JP.setZero(rows, _x_size);
+                lvl._tmp.setZero(rows, _x_size);
+                lvl._residual.setZero(rows);
+                lvl._tmp_residual.setZero(rows);
+                lvl._singular_values_inv.setZero(rank_max);
+                lvl._Ut_residual.setZero(rank_max);
 
+                lvl._JPsvd = Eigen::JacobiSVD<Eigen::MatrixXd>(rows, _x_size,
+                                                               Eigen::ComputeThinU | Eigen::ComputeThinV);
 
+                updateWeight(lvl, _tasks[i-1]);
             }
-            _stack_levels.push_back(lvl);
 
             if(i < stack.size())
                 printProblemInformation(i, _tasks[i]->getTaskID(),"NONE", "NONE");
@@ -66,109 +61,131 @@ bool eHQP::solve(Eigen::VectorXd& solution)
     solution.setZero(_x_size);
     for(unsigned int i = 1; i <= _tasks.size(); ++i)
     {
-        _stack_levels[i]._WChol.compute(_tasks[i-1]->getWeight());
+        stack_level& lvl = _stack_levels[i];
+        const Eigen::MatrixXd& A = _tasks[i-1]->getA();
 
-        _stack_levels[i]._JP = _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getA()*_stack_levels[i-1]._P;
-        _stack_levels[i]._JPsvd.compute(_stack_levels[i]._JP);
+        updateWeight(lvl, _tasks[i-1]);
 
-#if EIGEN_MINOR_VERSION <= 0
-        _stack_levels[i]._FPL.compute(_stack_levels[i]._JP);
-        _stack_levels[i]._JPpinv = this->getDampedPinv(
-                    _stack_levels[i]._JP, _stack_levels[i]._JPsvd,
-                    _stack_levels[i]._FPL);
-#else
-        _stack_levels[i]._JPpinv = this->getDampedPinv(_stack_levels[i]._JP,
-                                                       _stack_levels[i]._JPsvd);
-#endif
+        // JP = L'*A*P (the first projector is the identity)
+        if(i == 1)
+            lvl._JP = A;
+        else
+            lvl._JP.noalias() = A * _stack_levels[i-1]._P;
+        applyWeight(lvl, lvl._JP, lvl._tmp);
 
-         solution += _stack_levels[i]._JPpinv * (
-                     _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getb()-
-                 _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getA()*solution
-                 );
+        // residual = L'*(b - A*x)
+        lvl._residual = _tasks[i-1]->getb();
+        lvl._residual.noalias() -= A * solution;
+        applyWeight(lvl, lvl._residual, lvl._tmp_residual);
 
+        lvl._JPsvd.compute(lvl._JP);
+        const int rank = computeDampedSingularValuesInv(lvl);
 
+        const auto U = lvl._JPsvd.matrixU().leftCols(rank);
+        const auto V = lvl._JPsvd.matrixV().leftCols(rank);
 
-        _stack_levels[i]._P = _stack_levels[i-1]._P -
-                _stack_levels[i]._JPsvd.matrixV() * _stack_levels[i]._JPsvd.matrixV().transpose();
+        // x += JP^# * residual, with JP^# = V*Sigma^#*U'
+        lvl._Ut_residual.head(rank).noalias() = U.transpose() * lvl._residual;
+        lvl._Ut_residual.head(rank).array() *= lvl._singular_values_inv.head(rank).array();
+        solution.noalias() += V * lvl._Ut_residual.head(rank);
+
+        // P = P - V*V' with the first rank columns of V only, i.e. the rowspace of JP (not needed by the last level)
+        if(i < _tasks.size())
+        {
+            lvl._P = _stack_levels[i-1]._P;
+            lvl._P.noalias() -= V * V.transpose();
+        }
     }
     return true;
 }
 
-#if EIGEN_MINOR_VERSION <= 0
-Eigen::MatrixXd eHQP::getDampedPinv(  const Eigen::MatrixXd& J,
-                        const Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
-                        const Eigen::FullPivLU<Eigen::MatrixXd>& fpl) const
+int eHQP::computeDampedSingularValuesInv(stack_level& level) const
 {
-    int rank = fpl.rank();
-    Eigen::MatrixXd singularValuesInv(J.cols(), J.cols());
-    singularValuesInv.setZero(J.rows(), J.rows());
+    const Eigen::VectorXd& singular_values = level._JPsvd.singularValues();
+    const int rank = level._JPsvd.rank();
 
-    double lambda = svd.singularValues().minCoeff();
+    if(singular_values.size() == 0)
+        return 0;
 
+    const double lambda = singular_values.minCoeff();
 
-    if(svd.singularValues().minCoeff() >= sigma_min)
+    if(lambda >= sigma_min)
     {
-        for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) = 1./svd.singularValues()[i];
+        level._singular_values_inv.head(rank) = singular_values.head(rank).cwiseInverse();
     } else {
         //double lambda = std::pow(lambda_max,2) * (1. -  std::pow(svd.singularValues()[rank-1]/sigma_min,2));
-        for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) =
-                    svd.singularValues()[i]/(std::pow(svd.singularValues()[i],2)+lambda*lambda);
+        level._singular_values_inv.head(rank) = singular_values.head(rank).array() /
+                (singular_values.head(rank).array().square() + lambda*lambda);
     }
 
-
-    return svd.matrixV()* singularValuesInv *svd.matrixU().transpose();
+    return rank;
 }
-#else
-Eigen::MatrixXd eHQP::getDampedPinv( const Eigen::MatrixXd& J,
-                                                    const Eigen::JacobiSVD<Eigen::MatrixXd>& svd) const
-{
-    int rank = svd.rank();
-    Eigen::MatrixXd singularValuesInv(J.cols(), J.cols());
-    singularValuesInv.setZero(J.rows(), J.rows());
 
-    double lambda = svd.singularValues().minCoeff();
+void eHQP::updateWeight(stack_level& level, const TaskPtr& task) const
+{
+    const Eigen::MatrixXd& W = task->getWeight();
+    if(level._W.rows() == W.rows() && level._W.cols() == W.cols() && level._W == W)
+        return;
+
+    level._W = W;
+    level._W_is_identity = W.isIdentity(0.);
+    level._W_is_diagonal = !level._W_is_identity && W.isDiagonal(0.);
+    level._W_blocks.clear();
+
+    if(level._W_is_diagonal)
+        level._WSqrt = W.diagonal().cwiseSqrt();
+    else if(!level._W_is_identity)
+    {
+        tasks::Aggregated::Ptr aggregated = std::dynamic_pointer_cast<tasks::Aggregated>(task);
+        if(aggregated)
+        {
+            level._W_blocks = aggregated->getWeightBlocks();
+            level._WU.setZero(W.rows(), W.cols());
+            for(const auto& block : level._W_blocks)
+            {
+                level._WChol.compute(W.block(block.offset, block.offset, block.size, block.size));
+                level._WU.block(block.offset, block.offset, block.size, block.size) = level._WChol.matrixU();
+            }
+        }
+        else
+            level._WChol.compute(W);
+    }
+}
 
+template <typename Matrix>
+void eHQP::applyWeight(const stack_level& level, Matrix& M, Matrix& tmp) const
+{
+    if(level._W_is_identity)
+        return;
 
-    if(svd.singularValues().minCoeff() >= sigma_min)
+    if(level._W_is_diagonal)
     {
-        for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) = 1./svd.singularValues()[i];
-    } else {
-        //double lambda = std::pow(lambda_max,2) * (1. -  std::pow(svd.singularValues()[rank-1]/sigma_min,2));
-        for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) =
-                    svd.singularValues()[i]/(std::pow(svd.singularValues()[i],2)+lambda*lambda);
+        M.array().colwise() *= level._WSqrt.array();
+    }
+    else if(!level._W_blocks.empty())
+    {
+        for(const auto& block : level._W_blocks)
+            tmp.middleRows(block.offset, block.size).noalias() =
+                    level._WU.block(block.offset, block.offset, block.size, block.size).triangularView<Eigen::Upper>() *
+                    M.middleRows(block.offset, block.size);
+        M.swap(tmp);
+    }
+    else
+    {
+        tmp.noalias() = level._WChol.matrixU() * M;
+        M.swap(tmp);
     }
-
-    return svd.matrixV()* singularValuesInv *svd.matrixU().transpose();
 }
-#endif
 
 double eHQP::getSigmaMin() const
 {
     return sigma_min;
 }
 
-#if EIGEN_MINOR_VERSION <= 0
-void eHQP::setSigmaMin(const double& sigma_min)
-{
-    if(sigma_min > 0)
-    {
-        for(unsigned int i = 0; i < _stack_levels.size(); ++i)
-            _stack_levels[i]._FPL.setThreshold(sigma_min);
-
-        this->sigma_min = sigma_min;
-    }
-}
-#else
 void eHQP::setSigmaMin(const double& sigma_min)
 {
     if(sigma_min > 0)
     {
-        // for(unsigned int i = 0; i < _JPsvd.size(); ++i)
-        //    _JPsvd[i].setThreshold(sigma_min);
         for(unsigned int i = 0; i < _stack_levels.size(); ++i)
             _stack_levels[i]._JPsvd.setThreshold(sigma_min);
 
@@ -176,7 +193,6 @@ void eHQP::setSigmaMin(const double& sigma_min)
         this->sigma_min = sigma_min;
     }
 }
-#endif
 
 void eHQP::printProblemInformation(const int problem_number, const std::string& problem_id,
                                       const std::string& constraints_id, const std::string& bounds_id)
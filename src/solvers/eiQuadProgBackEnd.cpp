@@ -1,5 +1,6 @@
 #include <OpenSoT/solvers/eiQuadProgBackEnd.h>
 #include <xbot2_interface/logger.h>
+#include <OpenSoT/utils/RtLogger.h>
 
 
 using namespace OpenSoT::solvers;
@@ -29,6 +30,10 @@ eiQuadProgBackEnd::eiQuadProgBackEnd(const int number_of_variables,
     _ci0Piler(1)
 {
     _I.setIdentity(number_of_variables, number_of_variables);
+    _CE.setZero(number_of_variables, 0);
+    _ce0.setZero(0);
+    _CEf.setZero(number_of_variables, 0);
+    _ce0f.setZero(0);
 }
 
 eiQuadProgBackEnd::~eiQuadProgBackEnd()
@@ -72,25 +77,13 @@ bool eiQuadProgBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::Vecto
 {
     //couple of checks
     if(A.rows() != _A.rows()){
-        XBot::Logger::error("A.rows() != _A.rows() --> %f != %f", A.rows(), _A.rows());
+        utils::RtLogger::error("A.rows() != _A.rows() --> %f != %f", A.rows(), _A.rows());
         return false;}
 
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u; //this is needed since updateX should be used just to update and not init (maybe can be done in the base class)
     __generate_data_struct();
 
-    const double inf = std::numeric_limits<double>::infinity();
-
-
-    _f_value = solve_quadprog(_H, _g, Eigen::MatrixXd(), Eigen::VectorXd(),
-                              _CIPiler.generate_and_get().transpose(),
-                              _ci0Piler.generate_and_get(),
-                              _solution);
-    if(_f_value == inf)
-    {
-        XBot::Logger::error("QPP is infeasible");
-        return false;
-    }
-    return true;
+    return __solve();
 
 }
 
@@ -98,16 +91,35 @@ bool eiQuadProgBackEnd::solve()
 {
     __generate_data_struct();
 
+    return __solve();
+}
+
+bool eiQuadProgBackEnd::__solve()
+{
     const double inf = std::numeric_limits<double>::infinity();
 
+    _CI = _CIPiler.generate_and_get().transpose();
+
+    if(_options.single_precision)
+    {
+        _Hf = _H.cast<float>();
+        _gf = _g.cast<float>();
+        _CIf = _CI.cast<float>();
+        _ci0f = _ci0Piler.generate_and_get().col(0).cast<float>();
+
+        _f_value = _solver_f.solve(_Hf, _gf, _CEf, _ce0f, _CIf, _ci0f, _solution_f);
+        _solution = _solution_f.cast<double>();
+    }
+    else
+    {
+        _f_value = _solver.solve(_H, _g, _CE, _ce0,
+                                 _CI, _ci0Piler.generate_and_get().col(0),
+                                 _solution);
+    }
 
-    _f_value = solve_quadprog(_H, _g, Eigen::MatrixXd(), Eigen::VectorXd(),
-                              _CIPiler.generate_and_get().transpose(),
-                              _ci0Piler.generate_and_get(),
-                              _solution);
     if(_f_value == inf)
     {
-        XBot::Logger::error("QPP is infeasible");
+        utils::RtLogger::error("QPP is infeasible");
         return false;
     }
     return true;
@@ -120,12 +132,12 @@ double eiQuadProgBackEnd::getObjective()
 
 boost::any eiQuadProgBackEnd::getOptions()
 {
-    return boost::any();
+    return _options;
 }
 
 void eiQuadProgBackEnd::setOptions(const boost::any& options)
 {
-    ///DO NOTHING
+    _options = boost::any_cast<eiQuadProgOptions>(options);
 }
 
 bool eiQuadProgBackEnd::setEpsRegularisation(const double eps)
@@ -1,11 +1,79 @@
 #include <OpenSoT/solvers/iHQP.h>
 #include <OpenSoT/constraints/BilateralConstraint.h>
+#include <OpenSoT/tasks/Aggregated.h>
+#include <OpenSoT/SubTask.h>
+#include <OpenSoT/utils/FixedRows.h>
 #include <xbot2_interface/logger.h>
 #include <OpenSoT/utils/AutoStack.h>
 
 
 using namespace OpenSoT::solvers;
 
+namespace {
+
+/**
+ * @brief The SupportBlock struct is a block of rows with the columns it acts on
+ */
+struct SupportBlock {
+    int offset;
+    int rows;
+    std::vector<bool> support;
+};
+
+void addColumnSupport(const Eigen::Ref<const Eigen::MatrixXd>& M, std::vector<bool>& support)
+{
+    for(int c = 0; c < M.cols(); ++c)
+    {
+        if(!support[c] && (M.col(c).array() != 0.).any())
+            support[c] = true;
+    }
+}
+
+void appendTaskBlocks(const OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr& task, const int offset,
+                      std::vector<SupportBlock>& blocks)
+{
+    const Eigen::MatrixXd& A = task->getA();
+    if(A.rows() == 0)
+        return;
+
+    std::vector<OpenSoT::tasks::Aggregated::WeightBlock> weight_blocks;
+    OpenSoT::tasks::Aggregated::Ptr aggregated = std::dynamic_pointer_cast<OpenSoT::tasks::Aggregated>(task);
+    if(aggregated)
+        weight_blocks = aggregated->getWeightBlocks();
+    if(weight_blocks.empty() || weight_blocks.back().offset + weight_blocks.back().size != A.rows())
+        weight_blocks.assign(1, {0, int(A.rows()), task});
+
+    for(const auto& wb : weight_blocks)
+    {
+        if(wb.size == 0)
+            continue;
+
+        SupportBlock block{offset + wb.offset, wb.size, std::vector<bool>(A.cols(), false)};
+        if(!wb.task->isActive() || !task->isActive())
+            block.support.assign(A.cols(), true);
+        else
+        {
+            addColumnSupport(A.middleRows(wb.offset, wb.size), block.support);
+
+            OpenSoT::SubTask::Ptr sub_task = std::dynamic_pointer_cast<OpenSoT::SubTask>(wb.task);
+            if(sub_task)
+                addColumnSupport(sub_task->getTask()->getA(), block.support);
+
+            for(const auto& mask : {wb.task->getActiveJointsMask(), task->getActiveJointsMask()})
+            {
+                for(unsigned int c = 0; c < mask.size(); ++c)
+                {
+                    if(!mask[c])
+                        block.support[c] = true;
+                }
+            }
+        }
+        blocks.push_back(block);
+    }
+}
+
+}
+
 const std::string iHQP::_IHQP_CONSTRAINTS_PLUS_ = "+";
 const std::string iHQP::_IHQP_CONSTRAINTS_OPTIMALITY_ = "_OPTIMALITY";
 
@@ -132,14 +200,24 @@ void iHQP::computeCostFunction(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::V
 //    g = -1.0 * task->getA().transpose() * task->getWeight() * task->getb();
 
 
+    if(_per_task_hessian)
+    {
+        OpenSoT::tasks::Aggregated::Ptr aggregated = std::dynamic_pointer_cast<OpenSoT::tasks::Aggregated>(task);
+        if(aggregated && task->getA().size() != 0)
+        {
+            aggregated->computeHessianAndGradient(H, g);
+            g += task->getc();
+            return;
+        }
+    }
+
     H.resize(task->getXSize(), task->getXSize());
-    if(task->getWeight().isIdentity())
+    if(task->isWeightIdentity())
     {
         if(task->getA().size() != 0)
         {
-            H.triangularView<Eigen::Upper>() = task->getATranspose()*task->getA();
-            H = H.selfadjointView<Eigen::Upper>();
-            g.noalias() = -1.0 * task->getATranspose() * task->getb();
+            utils::hessian(task->getA(), H);
+            utils::gradient(task->getA(), task->getb(), g);
             g += task->getc();
         }
         else
@@ -149,9 +227,8 @@ void iHQP::computeCostFunction(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::V
     {
         if(task->getA().size() != 0)
         {
-            H.triangularView<Eigen::Upper>() = task->getATranspose()*task->getWA();
-            H = H.selfadjointView<Eigen::Upper>();
-            g.noalias() = -1.0 * task->getATranspose() * task->getWb();
+            utils::hessian(task->getA(), task->getWA(), H);
+            utils::gradient(task->getWA(), task->getb(), g);
             g += task->getc();
         }
         else
@@ -169,6 +246,67 @@ void iHQP::computeOptimalityConstraint(  const TaskPtr& task, BackEnd::Ptr& prob
     uA = lA;
 }
 
+void iHQP::computeSparsityPattern(const unsigned int i, OpenSoT::constraints::Aggregated& constraints_task_i,
+                                  Eigen::SparseMatrix<double>& H_pattern, Eigen::SparseMatrix<double>& A_pattern)
+{
+    const int x_size = _tasks[i]->getXSize();
+
+    std::vector<SupportBlock> cost_blocks;
+    appendTaskBlocks(_tasks[i], 0, cost_blocks);
+    if(_regularisation_task)
+        appendTaskBlocks(_regularisation_task, 0, cost_blocks);
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for(int c = 0; c < x_size; ++c)
+        triplets.emplace_back(c, c, 1.);
+    for(const auto& block : cost_blocks)
+    {
+        for(int r = 0; r < x_size; ++r)
+        {
+            if(!block.support[r])
+                continue;
+            for(int c = 0; c < x_size; ++c)
+            {
+                if(block.support[c])
+                    triplets.emplace_back(r, c, 1.);
+            }
+        }
+    }
+    H_pattern.resize(x_size, x_size);
+    H_pattern.setFromTriplets(triplets.begin(), triplets.end());
+
+    std::vector<SupportBlock> constraint_blocks;
+    const Eigen::MatrixXd& Aineq = constraints_task_i.getAineq();
+    std::vector<OpenSoT::constraints::Aggregated::RowBlock> row_blocks;
+    constraints_task_i.getAineqRowBlocks(row_blocks);
+    for(const auto& rb : row_blocks)
+    {
+        SupportBlock block{rb.offset, rb.rows, std::vector<bool>(x_size, false)};
+        addColumnSupport(Aineq.middleRows(rb.offset, rb.rows), block.support);
+        constraint_blocks.push_back(block);
+    }
+    int rows = Aineq.rows();
+    for(unsigned int j = 0; j < i; ++j)
+    {
+        appendTaskBlocks(_tasks[j], rows, constraint_blocks);
+        rows += _tasks[j]->getA().rows();
+    }
+
+    triplets.clear();
+    for(const auto& block : constraint_blocks)
+    {
+        for(int c = 0; c < x_size; ++c)
+        {
+            if(!block.support[c])
+                continue;
+            for(int r = block.offset; r < block.offset + block.rows; ++r)
+                triplets.emplace_back(r, c, 1.);
+        }
+    }
+    A_pattern.resize(rows, x_size);
+    A_pattern.setFromTriplets(triplets.begin(), triplets.end());
+}
+
 bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
 {   
     if(_regularisation_task)
@@ -239,6 +377,11 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
         BackEnd::Ptr problem_i = BackEndFactory(be_solver[i],_tasks[i]->getXSize(), A.rows(), (OpenSoT::HessianType)(_tasks[i]->getHessianAtype()),
                                            _epsRegularisation);
 
+        Eigen::SparseMatrix<double> H_pattern, A_pattern;
+        computeSparsityPattern(i, constraints_task_i, H_pattern, A_pattern);
+        problem_i->setHessianSparsity(H_pattern);
+        problem_i->setConstraintsSparsity(A_pattern);
+
         if(problem_i->initProblem(H, g, A.generate_and_get(), lA.generate_and_get(), uA.generate_and_get(), l, u)){
             _qp_stack_of_tasks.push_back(problem_i);
             std::string bounds_string = "";
@@ -343,7 +486,7 @@ bool iHQP::solve(Eigen::VectorXd &solution)
                     return false;
             }
 
-            if(!_qp_stack_of_tasks[i]->solve())
+            if(!_qp_stack_of_tasks[i]->solveAndCapture())
                 return false;
 
             solution = _qp_stack_of_tasks[i]->getSolution();
@@ -435,6 +578,26 @@ bool iHQP::getBackEnd(const unsigned int i, BackEnd::Ptr& back_end)
     return true;
 }
 
+void iHQP::setCapture(QPCapture::Ptr capture)
+{
+    for(unsigned int i = 0; i < _qp_stack_of_tasks.size(); ++i)
+        _qp_stack_of_tasks[i]->setCapture(capture, i);
+}
+
+bool iHQP::setFlightRecorder(utils::FlightRecorder::Ptr recorder, const int decimation)
+{
+    std::string prefix = _solver_id.empty() ? _solver_id : _solver_id + "_";
+    for(unsigned int i = 0; i < _qp_stack_of_tasks.size(); ++i)
+        _qp_stack_of_tasks[i]->setFlightRecorder(recorder, i, prefix, decimation);
+    return true;
+}
+
+void iHQP::record()
+{
+    for(unsigned int i = 0; i < _qp_stack_of_tasks.size(); ++i)
+        _qp_stack_of_tasks[i]->record();
+}
+
 bool iHQP::setEpsRegularisation(const double eps, const unsigned int i)
 {
     if(i >= _qp_stack_of_tasks.size())
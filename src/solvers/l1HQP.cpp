@@ -8,10 +8,33 @@
 
 using namespace OpenSoT::solvers;
 
+namespace {
+
+/**
+ * @brief variable_offset
+ * @return the first column of a variable of the form [0 I 0]*x, -1 for a generic affine variable
+ */
+int variable_offset(const OpenSoT::AffineHelper& var)
+{
+    const Eigen::MatrixXd& M = var.getM();
+    if(M.rows() == 0 || !var.getq().isZero(0.) || (M.array() != 0.).count() != M.rows())
+        return -1;
+
+    for(int c = 0; c + M.rows() <= M.cols(); ++c)
+    {
+        if(M(0, c) != 0.)
+            return M.middleCols(c, M.rows()).isIdentity(0.) ? c : -1;
+    }
+    return -1;
+}
+
+}
+
 l1HQP::l1HQP(OpenSoT::AutoStack& stack_of_tasks, const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
     _epsRegularisation(eps_regularisation),
     _stack_of_tasks(stack_of_tasks),
+    _be_solver(be_solver),
     _first_slack_index(-1)
 {    
     if(std::fpclassify(eps_regularisation) == FP_ZERO) //No L2-regularisation
@@ -24,6 +47,8 @@ l1HQP::l1HQP(OpenSoT::AutoStack& stack_of_tasks, const double eps_regularisation
 
     creates_problem_variables();
     _H.setZero(_opt->getSize(), _opt->getSize());
+    _H_pattern.resize(_H.rows(), _H.cols());
+    _H_pattern.setIdentity();
     creates_tasks();
     creates_constraints();
     creates_internal_problem();
@@ -43,11 +68,10 @@ bool l1HQP::creates_solver(const solver_back_ends solver_back_end)
                    _internal_stack->getBounds()->getAineq().rows(),
                    _hessian_type, _epsRegularisation);
 
-    bool success = _solver->initProblem(_H,
-                   _internal_stack->getStack()[0]->getc().transpose(),
-                   _internal_stack->getBounds()->getAineq(),
-                   _internal_stack->getBounds()->getbLowerBound(), _internal_stack->getBounds()->getbUpperBound(),
-                   Eigen::VectorXd(0), Eigen::VectorXd(0));
+    _solver->setHessianSparsity(_H_pattern);
+    _solver->setConstraintsSparsity(_A_pattern);
+
+    bool success = _solver->initProblem(_H, _c, _A, _lA, _uA, Eigen::VectorXd(0), Eigen::VectorXd(0));
 
     if(success)
         _internal_solution = _solver->getSolution();
@@ -82,8 +106,72 @@ void l1HQP::creates_internal_problem()
 
     _internal_stack = std::make_shared<OpenSoT::AutoStack>(aggregated, constraint_list);
 
+    // the cost is constant
+    _internal_stack->update();
+    _c = _internal_stack->getStack()[0]->getc();
 
+    assemble_constraints();
+}
+
+void l1HQP::assemble_constraints()
+{
     _internal_stack->update();
+
+    _A = _internal_stack->getBounds()->getAineq();
+    _lA = _internal_stack->getBounds()->getbLowerBound();
+    _uA = _internal_stack->getBounds()->getbUpperBound();
+
+    // rows depending on the tasks and on the constraints, in the order they are piled in the internal problem,
+    // the remaining ones (slack variables, big-M, priorities and bounds on x) are constant
+    _variable_blocks.clear();
+    int row = 0;
+    for(const auto& constraint : _constraints)
+    {
+        const int rows = constraint.second->getAineq().rows();
+        _variable_blocks.push_back({constraint.second, row, rows, 2*rows/3});
+        row += rows;
+    }
+    if(_constraints2)
+    {
+        const int rows = _constraints2->getAineq().rows();
+        _variable_blocks.push_back({_constraints2, row, rows, int(_stack_of_tasks.getBounds()->getAineq().rows())});
+    }
+
+    // structural nonzeros: constant entries plus the whole x columns of the variable rows
+    const int x_size = _first_slack_index;
+    Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> pattern = _A.array() != 0.;
+    for(const auto& block : _variable_blocks)
+        pattern.block(block.row, 0, block.x_rows, x_size).setConstant(true);
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    for(int c = 0; c < pattern.cols(); ++c)
+    {
+        for(int r = 0; r < pattern.rows(); ++r)
+        {
+            if(pattern(r, c))
+                triplets.emplace_back(r, c, 1.);
+        }
+    }
+    _A_pattern.resize(_A.rows(), _A.cols());
+    _A_pattern.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+bool l1HQP::update_constraints()
+{
+    const int x_size = _first_slack_index;
+    for(const auto& block : _variable_blocks)
+    {
+        block.constraint->update();
+
+        const Eigen::MatrixXd& A = block.constraint->getAineq();
+        if(A.rows() != block.rows || A.cols() != _A.cols())
+            return false;
+
+        _A.block(block.row, 0, block.x_rows, x_size) = A.topLeftCorner(block.x_rows, x_size);
+        _lA.segment(block.row, block.rows) = block.constraint->getbLowerBound();
+        _uA.segment(block.row, block.rows) = block.constraint->getbUpperBound();
+    }
+    return true;
 }
 
 void l1HQP::creates_constraints()
@@ -169,15 +257,21 @@ void l1HQP::creates_problem_variables()
 
 bool l1HQP::solve(Eigen::VectorXd& solution)
 {   
-    _internal_stack->update();
+    if(!update_constraints())
+    {
+        XBot::Logger::warning("l1HQP: size of the constraints changed, internal problem and solver are created again \n");
+        assemble_constraints();
+        if(!creates_solver(_be_solver))
+        {
+            XBot::Logger::error("l1HQP: can not initialize internal solver after the size of the constraints changed! \n");
+            return false;
+        }
+    }
 
-    if(!_solver->updateProblem(_H, _internal_stack->getStack()[0]->getc().transpose(),
-        _internal_stack->getBounds()->getAineq(),
-        _internal_stack->getBounds()->getbLowerBound(), _internal_stack->getBounds()->getbUpperBound(),
-        Eigen::VectorXd(0), Eigen::VectorXd(0)))
+    if(!_solver->updateProblem(_H, _c, _A, _lA, _uA, Eigen::VectorXd(0), Eigen::VectorXd(0)))
         return false;
 
-    if(!_solver->solve())
+    if(!_solver->solveAndCapture())
         return false;
 
     _internal_solution = _solver->getSolution();
@@ -206,7 +300,8 @@ bool l1HQP::getInternalVariable(const std::string& var, Eigen::VectorXd& value)
 task_to_constraint_helper::task_to_constraint_helper(std::string id, OpenSoT::tasks::Aggregated::TaskPtr& task,
            const AffineHelper& x, const AffineHelper& t):
     OpenSoT::Constraint< Eigen::MatrixXd, Eigen::VectorXd >(id, x.getInputSize()),
-    _task(task), _x(x), _t(t), _II(task->getA().rows()), _AA(_task->getA().cols()), _bb(1)
+    _task(task), _x(x), _t(t), _II(task->getA().rows()), _AA(_task->getA().cols()), _bb(1),
+    _x_offset(-1)
 {
     Eigen::MatrixXd I;
     I.setIdentity(task->getA().rows(),task->getA().rows());
@@ -225,10 +320,26 @@ task_to_constraint_helper::task_to_constraint_helper(std::string id, OpenSoT::ta
     _bLowerBound << -inf, -inf, o;
 
     update();
+
+    // the blocks of t are constant, only the ones of x are updated in place
+    if(variable_offset(_t) >= 0)
+        _x_offset = variable_offset(_x);
 }
 
 void task_to_constraint_helper::update()
 {
+    const int m = _task->getA().rows();
+    if(_x_offset >= 0 && _Aineq.rows() == 3*m)
+    {
+        const Eigen::MatrixXd& WA = _task->getWA();
+        _Aineq.block(0, _x_offset, m, WA.cols()) = WA;
+        _Aineq.block(m, _x_offset, m, WA.cols()) = -WA;
+
+        _bUpperBound.head(m) = _task->getWb();
+        _bUpperBound.segment(m, m) = -_task->getWb();
+        return;
+    }
+
     _AA.pile(_task->getWA());
     _AA.pile(-_task->getWA());
     _AA.pile(O);
@@ -249,16 +360,38 @@ void task_to_constraint_helper::update()
 constraint_helper::constraint_helper(std::string id, OpenSoT::constraints::Aggregated::ConstraintPtr constraints,
                                      const AffineHelper& x):
     OpenSoT::Constraint< Eigen::MatrixXd, Eigen::VectorXd >(id, x.getInputSize()),
-    _constraints(constraints), _x(x), _A(x.getInputSize()), _b_lower(1), _b_upper(1)
+    _constraints(constraints), _x(x), _A(x.getInputSize()), _b_lower(1), _b_upper(1),
+    _x_offset(-1)
 {
     if(_constraints->getLowerBound().size() > 0)
         I.setIdentity(_constraints->getLowerBound().size(), _constraints->getLowerBound().size());
 
     update();
+
+    // the rows of the bounds are constant, only the ones of Aineq are updated in place
+    _x_offset = variable_offset(_x);
 }
 
 void constraint_helper::update()
 {
+    const int n_ineq = _constraints->getAineq().rows();
+    const int n_bounds = _constraints->getLowerBound().size();
+    if(_x_offset >= 0 && _Aineq.rows() == n_ineq + n_bounds && n_bounds == I.rows())
+    {
+        if(n_ineq > 0)
+        {
+            _Aineq.block(0, _x_offset, n_ineq, _x.getOutputSize()) = _constraints->getAineq();
+            _bLowerBound.head(n_ineq) = _constraints->getbLowerBound();
+            _bUpperBound.head(n_ineq) = _constraints->getbUpperBound();
+        }
+        if(n_bounds > 0)
+        {
+            _bLowerBound.tail(n_bounds) = _constraints->getLowerBound();
+            _bUpperBound.tail(n_bounds) = _constraints->getUpperBound();
+        }
+        return;
+    }
+
 
 
     if(_constraints->getAineq().rows() > 0)
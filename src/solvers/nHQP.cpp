@@ -1,5 +1,70 @@
 #include <OpenSoT/solvers/nHQP.h>
 
+namespace {
+
+// a tracked nullspace basis is recomputed from scratch when, once projected onto the new nullspace,
+// one of its directions keeps less than this fraction of its norm (i.e. rotated by more than 60 deg)
+const double NULLSPACE_TRACKING_MIN_PIVOT = 0.5;
+
+// singular values under this threshold are considered null when computing ranks
+const double SV_THRESH = 1e-6;
+
+typedef OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr ConstraintPtr;
+
+void flatten(ConstraintPtr constraint, std::list<ConstraintPtr>& constraints)
+{
+    auto aggregated = std::dynamic_pointer_cast<OpenSoT::constraints::Aggregated>(constraint);
+    if(aggregated)
+    {
+        for(auto& c : aggregated->getConstraintsList())
+            flatten(c, constraints);
+    }
+    else
+    {
+        constraints.push_back(constraint);
+    }
+}
+
+// aggregates the constraints keeping the equalities, which are eliminated by nHQP
+OpenSoT::constraints::Aggregated::Ptr aggregate(const std::list<ConstraintPtr>& constraints, const int x_size)
+{
+    std::list<ConstraintPtr> flattened;
+    for(auto& c : constraints)
+        flatten(c, flattened);
+
+    return std::make_shared<OpenSoT::constraints::Aggregated>(flattened, x_size,
+                                                              OpenSoT::constraints::Aggregated::UNILATERAL_TO_BILATERAL);
+}
+
+int compute_rank(const Eigen::MatrixXd& A)
+{
+    Eigen::BDCSVD<Eigen::MatrixXd> svd(A);
+    return (svd.singularValues().array() >= SV_THRESH).count();
+}
+
+// removes from the basis of the previous cycle its components along the (orthonormal) rowspace V_rank, and
+// re-orthonormalizes it (Cholesky QR): the result is a basis of the new nullspace which changes continuously
+// with the previous one (not the closest one, which would be the polar factor of the projected basis).
+// Returns false if the projected basis is too ill conditioned, in which case it has to be recomputed
+bool track_nullspace_basis(const Eigen::Ref<const Eigen::MatrixXd>& V_rank,
+                           Eigen::MatrixXd& basis,
+                           Eigen::MatrixXd& projection,
+                           Eigen::MatrixXd& gram,
+                           Eigen::LLT<Eigen::MatrixXd>& llt)
+{
+    projection.noalias() = V_rank.transpose() * basis;
+    basis.noalias() -= V_rank * projection;
+
+    gram.noalias() = basis.transpose() * basis;
+    llt.compute(gram);
+    if(llt.info() != Eigen::Success || llt.matrixLLT().diagonal().minCoeff() <= NULLSPACE_TRACKING_MIN_PIVOT)
+        return false;
+
+    llt.matrixU().solveInPlace<Eigen::OnTheRight>(basis);
+    return true;
+}
+
+}
 
 
 
@@ -7,18 +72,33 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
                              OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr bounds,
                              const double eps_regularisation,
                              const OpenSoT::solvers::solver_back_ends be_solver):
-    Solver(stack_of_tasks, bounds)
+    Solver(stack_of_tasks, bounds),
+    _eq_rank(0),
+    _track_eq_nullspace(false)
 {
     // nx = number of optimization variables
     const int nx = stack_of_tasks.front()->getXSize();
     _solution.setZero(nx);
 
-    // initialize number of free variables to nx
-    // this value will decrease when going down the hierarchy
-    int num_free_vars = nx;
+    // global constraints, equalities are kept separated
+    _constraints = aggregate({bounds}, nx);
+    const bool has_equalities = _constraints->getAeq().rows() > 0;
 
-    // first cumulated nullspace is eye(nx)
+    // first cumulated nullspace is eye(nx), or the nullspace of the equality constraints
+    // (in which case the solution is initialized with their minimum norm solution)
     _cumulated_nullspace.push_back(Eigen::MatrixXd::Identity(nx, nx));
+    if(has_equalities)
+    {
+        _eq_rank = compute_rank(_constraints->getAeq());
+        compute_equalities();
+
+        printf("[nHQP] Equality constraints eliminated: %d rows, rank = %d \n",
+               int(_constraints->getAeq().rows()), _eq_rank);
+    }
+
+    // initialize number of free variables to nx minus the rank of the equalities
+    // this value will decrease when going down the hierarchy
+    int num_free_vars = nx - _eq_rank;
 
     // iterate over hierarchy of tasks
     const int n_tasks = stack_of_tasks.size();
@@ -36,41 +116,52 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
             throw std::runtime_error("[nHQP] No free variables left at layer #" + std::to_string(i) + ": decrease the number of layers!");
         }
 
-        // local constraints not supported (TODO)
+        // local constraints, local equalities are eliminated from the variables of this layer
+        constraints::Aggregated::Ptr local_constraints;
+        int local_eq_rank = 0;
         if(t->getConstraints().size() > 0)
         {
-            throw std::runtime_error("[nHQP] Local constraints not supported");
+            local_constraints = aggregate(t->getConstraints(), nx);
+
+            if(local_constraints->getAeq().rows() > 0)
+            {
+                local_eq_rank = compute_rank(local_constraints->getAeq() * _cumulated_nullspace[i]);
+            }
         }
+        const bool has_local_equalities = local_constraints && local_constraints->getAeq().rows() > 0;
 
-        // equality constraints not supported (TODO)
-        if(bounds->getAeq().rows() > 0)
+        if(num_free_vars - local_eq_rank <= 0)
         {
-            throw std::runtime_error("[nHQP] Equality constraints not supported");
+            throw std::runtime_error("[nHQP] No free variables left at layer #" + std::to_string(i) + " after local equality constraints");
         }
 
-        printf("[nHQP] Free variables at layer #%d = %d \n", i, num_free_vars);
+        printf("[nHQP] Free variables at layer #%d = %d \n", i, num_free_vars - local_eq_rank);
 
-        // compute number of constraints and bounds (TBD: consider equalities)
-        int num_constr = bounds->getAineq().rows();
-        int num_bounds = nx;
+        // compute number of constraints and bounds
+        int num_constr = _constraints->getAineq().rows();
+        bool has_bounds = _constraints->getLowerBound().size() > 0;
+        if(local_constraints)
+        {
+            num_constr += local_constraints->getAineq().rows();
+            has_bounds = has_bounds || local_constraints->getLowerBound().size() > 0;
+        }
 
-        // for all layers except the first, bounds must be turned into constraints
-        if(num_free_vars != nx)
+        // if the layer does not optimize directly x, bounds must be turned into constraints
+        if(has_bounds && (i > 0 || has_equalities || has_local_equalities))
         {
-            num_constr += num_bounds;
-            num_bounds = 0;
+            num_constr += nx;
         }
 
         // construct backend
         auto backend = BackEndFactory(be_solver,
-                                      num_free_vars,
+                                      num_free_vars - local_eq_rank,
                                       num_constr,
                                       HessianType::HST_SEMIDEF,
                                       eps_regularisation);
 
 
         // construct task data and push it into a vector
-        _data_struct.emplace_back(num_free_vars, t, bounds, backend);
+        _data_struct.emplace_back(num_free_vars, t, _constraints, local_constraints, local_eq_rank, backend);
 
         // if we are processing the last task, skip nullspace dim computation
         if(i == n_tasks - 1)
@@ -79,8 +170,9 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
         }
 
         // compute cost without regularization to get nullspace dimension
+        // (first layer without equalities: the nullspace would be the nx-by-nx identity)
         auto& data = _data_struct.back();
-        if(i == 0)
+        if(i == 0 && !has_equalities)
         {
             data.compute_cost(nullptr,
                               _solution);
@@ -92,7 +184,6 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
         }
 
         // nullspace dimension
-        const double SV_THRESH = 1e-6;
         int ns_dim = data.compute_nullspace_dimension(SV_THRESH);
         data.set_nullspace_dimension(ns_dim);
 
@@ -152,13 +243,37 @@ void OpenSoT::solvers::nHQP::setPerformSelectiveNullSpaceRegularization(int hier
     data.set_perform_selective_null_space_regularization(perform_selective_null_space_regularization);
 }
 
+void OpenSoT::solvers::nHQP::setNullSpaceTracking(bool track_nullspace)
+{
+    _track_eq_nullspace = track_nullspace;
+    for(auto& data : _data_struct)
+        data.set_track_nullspace(track_nullspace);
+}
+
+void OpenSoT::solvers::nHQP::setNullSpaceTracking(int hierarchy_level, bool track_nullspace)
+{
+    if(hierarchy_level >= _data_struct.size())
+        throw std::invalid_argument("hierarchy_level >= # layers");
+    auto& data = _data_struct[hierarchy_level];
+    data.set_track_nullspace(track_nullspace);
+}
+
 bool OpenSoT::solvers::nHQP::solve(Eigen::VectorXd& solution)
 {
     const int n_tasks = _tasks.size();
     const int n_x = _tasks.front()->getXSize();
 
-    // initialize solution with zeros
-    _solution.setZero(n_x);
+    // initialize solution with the minimum norm solution of the equality constraints, or zeros
+    _constraints->generateAll();
+    const bool has_equalities = _constraints->getAeq().rows() > 0;
+    if(has_equalities)
+    {
+        compute_equalities();
+    }
+    else
+    {
+        _solution.setZero(n_x);
+    }
 
     // iterate over the hierarchy
     for(int i = 0; i < n_tasks; i++)
@@ -166,8 +281,8 @@ bool OpenSoT::solvers::nHQP::solve(Eigen::VectorXd& solution)
         // get i-th task data
         TaskData& data = _data_struct[i];
 
-        // first layer, no nullspace to be considered (i.e. it would be the nx-by-nx identity)
-        if(i == 0)
+        // first layer without equalities, no nullspace to be considered (i.e. it would be the nx-by-nx identity)
+        if(i == 0 && !has_equalities)
         {
             data.compute_cost(nullptr, _solution);
             data.compute_contraints(nullptr, _solution);
@@ -203,6 +318,36 @@ bool OpenSoT::solvers::nHQP::solve(Eigen::VectorXd& solution)
     return true;
 }
 
+void OpenSoT::solvers::nHQP::compute_equalities()
+{
+    /* Aeq*x = beq -> x = V1*S1^-1*U1'*beq + V2*x0 */
+
+    const Eigen::MatrixXd& Aeq = _constraints->getAeq();
+
+    _eq_svd.compute(Aeq, Eigen::ComputeThinU|Eigen::ComputeFullV);
+
+    _eq_tmp.noalias() = _eq_svd.matrixU().leftCols(_eq_rank).transpose() * _constraints->getbeq();
+    _eq_tmp.array() /= _eq_svd.singularValues().head(_eq_rank).array();
+
+    _solution.noalias() = _eq_svd.matrixV().leftCols(_eq_rank) * _eq_tmp;
+
+    // the nullspace basis is tracked as the ones of the layers (see TaskData::compute_nullspace())
+    Eigen::MatrixXd& Neq = _cumulated_nullspace[0];
+    const int ns_dim = Aeq.cols() - _eq_rank;
+    if(!_track_eq_nullspace || Neq.rows() != Aeq.cols() || Neq.cols() != ns_dim ||
+       !track_nullspace_basis(_eq_svd.matrixV().leftCols(_eq_rank), Neq, _eq_ns_projection, _eq_ns_gram, _eq_ns_llt))
+    {
+        Neq = _eq_svd.matrixV().rightCols(ns_dim);
+    }
+}
+
+const Eigen::MatrixXd& OpenSoT::solvers::nHQP::getNullSpaceBasis(const unsigned int hierarchy_level) const
+{
+    if(hierarchy_level >= _cumulated_nullspace.size())
+        throw std::invalid_argument("hierarchy_level >= # layers");
+    return _cumulated_nullspace[hierarchy_level];
+}
+
 void OpenSoT::solvers::nHQP::setMinSingularValueRatio(double sv_min)
 {
     setMinSingularValueRatio(std::vector<double>(_data_struct.size(), sv_min));
@@ -283,37 +428,148 @@ void OpenSoT::solvers::nHQP::TaskData::compute_contraints(const Eigen::MatrixXd*
                                                           const Eigen::VectorXd& q0)
 {
 
-    if(constraints->getAeq().size() > 0)
-    {
-        throw std::runtime_error("Equality constraits not supported by nHQP solver");
-    }
-
     Aineq.reset();
     lb.reset();
     ub.reset();
+    lb_bound.resize(0);
+    ub_bound.resize(0);
 
-    if(!N)
+    if(local_constraints)
     {
-        Aineq.pile(constraints->getAineq());
+        local_constraints->generateAll();
+    }
 
-        lb_bound = constraints->getLowerBound();
-        ub_bound = constraints->getUpperBound();
+    // with local equalities constraints are written in w: x = q0_w + N_w*w
+    const Eigen::VectorXd* x0 = &q0;
+    if(has_local_equalities())
+    {
+        compute_local_equalities(N, q0);
+        N = &N_w;
+        x0 = &q0_w;
+    }
 
+    const bool has_bounds = merge_bounds();
+
+    if(!N)
+    {
+        Aineq.pile(constraints->getAineq());
         ub.pile(constraints->getbUpperBound());
         lb.pile(constraints->getbLowerBound());
+
+        if(local_constraints)
+        {
+            Aineq.pile(local_constraints->getAineq());
+            ub.pile(local_constraints->getbUpperBound());
+            lb.pile(local_constraints->getbLowerBound());
+        }
+
+        if(has_bounds)
+        {
+            lb_bound = lower_bound;
+            ub_bound = upper_bound;
+        }
     }
     else
     {
         Aineq.pile(constraints->getAineq() * (*N));
-        Aineq.pile(*N);
+        lb.pile(constraints->getbLowerBound() - constraints->getAineq()*(*x0));
+        ub.pile(constraints->getbUpperBound() - constraints->getAineq()*(*x0));
+
+        if(local_constraints)
+        {
+            Aineq.pile(local_constraints->getAineq() * (*N));
+            lb.pile(local_constraints->getbLowerBound() - local_constraints->getAineq()*(*x0));
+            ub.pile(local_constraints->getbUpperBound() - local_constraints->getAineq()*(*x0));
+        }
+
+        if(has_bounds)
+        {
+            Aineq.pile(*N);
+            lb.pile(lower_bound - *x0);
+            ub.pile(upper_bound - *x0);
+        }
+    }
+
+}
+
+void OpenSoT::solvers::nHQP::TaskData::compute_local_equalities(const Eigen::MatrixXd* N,
+                                                                const Eigen::VectorXd& q0)
+{
+    /* E*(N*z + q0) = e -> F*z = f -> z = z_eq + Neq*w */
+
+    const Eigen::MatrixXd& E = local_constraints->getAeq();
+    const Eigen::VectorXd& e = local_constraints->getbeq();
+
+    if(!N)
+    {
+        F = E;
+        f = e;
+    }
+    else
+    {
+        F.noalias() = E * (*N);
+        f = e;
+        f.noalias() -= E * q0;
+    }
+
+    eq_svd.compute(F, Eigen::ComputeThinU|Eigen::ComputeFullV);
+
+    eq_tmp.noalias() = eq_svd.matrixU().leftCols(local_eq_rank).transpose() * f;
+    eq_tmp.array() /= eq_svd.singularValues().head(local_eq_rank).array();
+
+    z_eq.noalias() = eq_svd.matrixV().leftCols(local_eq_rank) * eq_tmp;
+    Neq = eq_svd.matrixV().rightCols(F.cols() - local_eq_rank);
+
+    /* 1/2 z'Hz + g'z -> 1/2 w'(Neq'H Neq)w + (Neq'(H z_eq + g))'w */
+
+    eq_tmp = g;
+    eq_tmp.noalias() += H * z_eq;
+    g_eq.noalias() = Neq.transpose() * eq_tmp;
+
+    N_w.noalias() = H * Neq;
+    H_eq.noalias() = Neq.transpose() * N_w;
+
+    if(!N)
+    {
+        N_w = Neq;
+        q0_w = z_eq;
+    }
+    else
+    {
+        N_w.noalias() = (*N) * Neq;
+        q0_w = q0;
+        q0_w.noalias() += (*N) * z_eq;
+    }
+}
+
+bool OpenSoT::solvers::nHQP::TaskData::has_local_equalities() const
+{
+    return local_constraints && local_constraints->getAeq().rows() > 0;
+}
 
-        lb.pile(constraints->getbLowerBound() - constraints->getAineq()*q0);
-        lb.pile(constraints->getLowerBound() - q0);
+bool OpenSoT::solvers::nHQP::TaskData::merge_bounds()
+{
+    const bool global_bounds = constraints->getLowerBound().size() > 0;
+    const bool local_bounds = local_constraints && local_constraints->getLowerBound().size() > 0;
 
-        ub.pile(constraints->getbUpperBound() - constraints->getAineq()*q0);
-        ub.pile(constraints->getUpperBound() - q0);
+    if(global_bounds)
+    {
+        lower_bound = constraints->getLowerBound();
+        upper_bound = constraints->getUpperBound();
+
+        if(local_bounds)
+        {
+            lower_bound = lower_bound.cwiseMax(local_constraints->getLowerBound());
+            upper_bound = upper_bound.cwiseMin(local_constraints->getUpperBound());
+        }
+    }
+    else if(local_bounds)
+    {
+        lower_bound = local_constraints->getLowerBound();
+        upper_bound = local_constraints->getUpperBound();
     }
 
+    return global_bounds || local_bounds;
 }
 
 const Eigen::MatrixXd & OpenSoT::solvers::nHQP::TaskData::get_nullspace() const
@@ -324,19 +580,25 @@ const Eigen::MatrixXd & OpenSoT::solvers::nHQP::TaskData::get_nullspace() const
 
 OpenSoT::solvers::nHQP::TaskData::TaskData(int num_free_vars,
                                            OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr a_task,
-                                           OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr a_constraint,
+                                           constraints::Aggregated::Ptr a_constraint,
+                                           constraints::Aggregated::Ptr a_local_constraint,
+                                           int a_local_eq_rank,
                                            BackEnd::Ptr a_back_end):
     task(a_task),
     constraints(a_constraint),
+    local_constraints(a_local_constraint),
+    local_eq_rank(a_local_eq_rank),
     min_sv_ratio(nHQP::DEFAULT_MIN_SV_RATIO),
-    Aineq(num_free_vars), lb(1), ub(1),
+    Aineq(num_free_vars - a_local_eq_rank), lb(1), ub(1),
     ns_dim(num_free_vars - a_task->getTaskSize()),
     back_end(a_back_end),
     back_end_initialized(false),
     perform_A_b_regularization(true),
-    perform_selective_null_space_regularization(true)
+    perform_selective_null_space_regularization(true),
+    track_nullspace(false),
+    nullspace_updated(false)
 {
-
+    aggregated_task = std::dynamic_pointer_cast<tasks::Aggregated>(a_task);
 }
 
 void OpenSoT::solvers::nHQP::TaskData::set_min_sv_ratio(double sv)
@@ -371,17 +633,29 @@ void OpenSoT::solvers::nHQP::TaskData::compute_cost(const Eigen::MatrixXd* N,
         b0.noalias() = task->getb() - task->getA() * q0;
     }
 
-    svd.compute(AN, Eigen::ComputeFullU|Eigen::ComputeFullV);
+    // when the nullspace is tracked only the rowspace of AN is needed, hence the thin V is enough
+    const bool thin_v = track_nullspace && ns_dim > 0 && AN.cols() - ns_dim <= std::min(AN.rows(), AN.cols());
+    svd.compute(AN, Eigen::ComputeFullU | (thin_v ? Eigen::ComputeThinV : Eigen::ComputeFullV));
+    nullspace_updated = false;
 
     if(perform_A_b_regularization)
         regularize_A_b(min_sv_ratio);
 
-    H.noalias() =  AN.transpose() * task->getWeight() * AN;
-    g.noalias() = -AN.transpose() * task->getWeight() * b0;
+    if(aggregated_task)
+        aggregated_task->weight(AN, WAN);
+    else if(task->getWeightIsDiagonalFlag())
+        WAN.noalias() = task->getWeight().diagonal().asDiagonal() * AN;
+    else
+        WAN.noalias() = task->getWeight() * AN;
+
+    H.noalias() =  AN.transpose() * WAN;
+    g.noalias() = -WAN.transpose() * b0;
 
     if(compute_nullspace()) // if there is some nullspace left..
     {
-        if(perform_selective_null_space_regularization)
+        // with local equalities the nullspace of AN is not free (the local equalities may need it to be satisfied),
+        // hence the regularization is left to the back-end
+        if(perform_selective_null_space_regularization && !has_local_equalities())
         {
             const double sv_max = svd.singularValues()[0];
             H.noalias() += sv_max * get_nullspace() * get_nullspace().transpose(); // add selective nullspace regularization
@@ -393,10 +667,15 @@ bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
 {
     bool success = false;
 
+    // with local equalities the QP is solved in w
+    const bool local_equalities = has_local_equalities();
+    const Eigen::MatrixXd& H_qp = local_equalities ? H_eq : H;
+    const Eigen::VectorXd& g_qp = local_equalities ? g_eq : g;
+
     // solver is not initialized
     if(!back_end_initialized)
     {
-        success = back_end->initProblem(H, g,
+        success = back_end->initProblem(H_qp, g_qp,
                                         Aineq.generate_and_get(),
                                         lb.generate_and_get(),
                                         ub.generate_and_get(),
@@ -412,7 +691,7 @@ bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
     else // solver was initialized already
     {
 
-        back_end->updateTask(H, g);
+        back_end->updateTask(H_qp, g_qp);
 
 
         back_end->updateConstraints(Aineq.generate_and_get(),
@@ -422,7 +701,7 @@ bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
         back_end->updateBounds(lb_bound, ub_bound);
 
 
-        success = back_end->solve();
+        success = back_end->solveAndCapture();
 
     }
 
@@ -431,11 +710,23 @@ bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
         logger->add(log_prefix + "solution", back_end->getSolution());
     }
 
+    // z = z_eq + Neq*w
+    if(local_equalities)
+    {
+        z_sol = z_eq;
+        z_sol.noalias() += Neq * back_end->getSolution();
+    }
+
     return success;
 }
 
 const Eigen::VectorXd& OpenSoT::solvers::nHQP::TaskData::get_solution() const
 {
+    if(has_local_equalities())
+    {
+        return z_sol;
+    }
+
     return back_end->getSolution();
 }
 
@@ -458,12 +749,37 @@ bool OpenSoT::solvers::nHQP::TaskData::compute_nullspace()
     {
         return false;
     }
-    else
+
+    if(nullspace_updated)
     {
-        AN_nullspace = svd.matrixV().rightCols(ns_dim); // svd was computed during compute_cost
         return true;
     }
 
+    // svd was computed during compute_cost
+    const int n = AN.cols();
+    const int rank = n - ns_dim;
+    const auto V_rank = svd.matrixV().leftCols(rank);
+
+    // the previous basis is projected onto the nullspace of AN and re-orthonormalized
+    const bool tracked = track_nullspace && AN_nullspace.rows() == n && AN_nullspace.cols() == ns_dim &&
+            track_nullspace_basis(V_rank, AN_nullspace, ns_projection, ns_gram, ns_llt);
+
+    // no tracking, first cycle or nullspace changed too much: orthogonal complement of the rowspace
+    if(!tracked)
+    {
+        if(svd.matrixV().cols() == n)
+        {
+            AN_nullspace = svd.matrixV().rightCols(ns_dim);
+        }
+        else
+        {
+            ns_qr.compute(V_rank);
+            ns_complement = ns_qr.householderQ();
+            AN_nullspace = ns_complement.rightCols(ns_dim);
+        }
+    }
+
+    nullspace_updated = true;
     return true;
 }
 
@@ -476,6 +792,10 @@ int OpenSoT::solvers::nHQP::TaskData::compute_nullspace_dimension(double thresho
 void OpenSoT::solvers::nHQP::TaskData::set_nullspace_dimension(int a_ns_dim)
 {
     ns_dim = a_ns_dim;
+
+    // the basis has to be recomputed with the new dimension
+    AN_nullspace.resize(0, 0);
+    nullspace_updated = false;
 }
 
 void OpenSoT::solvers::nHQP::TaskData::set_perform_A_b_regularization(bool perform_A_b_regularization_)
@@ -488,5 +808,10 @@ void OpenSoT::solvers::nHQP::TaskData::set_perform_selective_null_space_regulari
     perform_selective_null_space_regularization = perform_selective_null_space_regularization_;
 }
 
+void OpenSoT::solvers::nHQP::TaskData::set_track_nullspace(bool track_nullspace_)
+{
+    track_nullspace = track_nullspace_;
+}
+
 
 
@@ -16,6 +16,7 @@
 */
 
 #include <OpenSoT/tasks/Aggregated.h>
+#include <OpenSoT/utils/FixedRows.h>
 #include <algorithm>
 #include <exception>
 #include <stdexcept>
@@ -36,9 +37,6 @@ Aggregated::Aggregated(const std::list<TaskPtr> tasks,
     /* calling update to generate bounds */
     this->generateAll();
 
-    _W.resize(_A.rows(),_A.rows());
-    _W.setIdentity(_A.rows(),_A.rows());
-
     generateWeight();
 
     _hessianType = this->computeHessianType();
@@ -57,9 +55,6 @@ Task(task1->getTaskID()+_TASK_PLUS_+task2->getTaskID(),x_size)
     /* calling update to generate bounds */
     this->generateAll();
 
-    _W.resize(_A.rows(),_A.rows());
-    _W.setIdentity(_A.rows(),_A.rows());
-
     generateWeight();
 
     _hessianType = this->computeHessianType();
@@ -76,9 +71,6 @@ Task(task->getTaskID(),x_size)
     /* calling update to generate bounds */
     this->generateAll();
 
-    _W.resize(_A.rows(),_A.rows());
-    _W.setIdentity(_A.rows(),_A.rows());
-
     generateWeight();
 
     _hessianType = this->computeHessianType();
@@ -90,10 +82,13 @@ Aggregated::~Aggregated()
 }
 
 void Aggregated::_update() {
-    for(std::list< TaskPtr >::iterator i = _tasks.begin();
-        i != _tasks.end(); ++i) {
-        TaskPtr t = *i;
-        t->update();
+    if(_update_tasks)
+    {
+        for(std::list< TaskPtr >::iterator i = _tasks.begin();
+            i != _tasks.end(); ++i) {
+            TaskPtr t = *i;
+            t->update();
+        }
     }
     this->generateAll();
 
@@ -264,18 +259,65 @@ void OpenSoT::tasks::Aggregated::log(XBot::MatLogger2::Ptr logger)
 
 void OpenSoT::tasks::Aggregated::generateWeight()
 {
-        //this->_W.setZero(_W.rows(), _W.cols());
+    /* the task list does not change, aggregated tasks are found once */
+    if(_aggregated_tasks.size() != _tasks.size())
+    {
+        _aggregated_tasks.clear();
+        for(const auto& t : _tasks)
+            _aggregated_tasks.push_back(std::dynamic_pointer_cast<Aggregated>(t));
+    }
+
+    bool layout_changed = false;
+    unsigned int k = 0;
+    auto set_block = [&](const int offset, const int size, const TaskPtr& task)
+    {
+        if(k == _weight_blocks.size())
+        {
+            _weight_blocks.push_back({offset, size, task});
+            layout_changed = true;
+        }
+        else
+        {
+            WeightBlock& block = _weight_blocks[k];
+            layout_changed = layout_changed || block.offset != offset || block.size != size;
+            block = {offset, size, task};
+        }
+        ++k;
+    };
 
-        int block = 0;
-        std::list< TaskPtr >::iterator t;
-        for(t = _tasks.begin(); t != _tasks.end(); t++)
+    int offset = 0;
+    auto aggregated = _aggregated_tasks.begin();
+    for(const auto& t : _tasks)
+    {
+        if(*aggregated)
         {
-            for(unsigned int r = 0; r < (*t)->getWeight().rows(); ++r)
-                for(unsigned int c = 0; c < (*t)->getWeight().cols(); ++c)
-                    this->_W.block(block, block, (*t)->getWeight().rows(), (*t)->getWeight().cols())(r,c) =
-                        (*t)->getWeight()(r,c);
-            block += (*t)->getWeight().rows();
+            for(const auto& block : (*aggregated)->getWeightBlocks())
+                set_block(offset + block.offset, block.size, block.task);
         }
+        else
+            set_block(offset, int(t->getA().rows()), t);
+
+        offset += t->getA().rows();
+        ++aggregated;
+    }
+
+    if(k != _weight_blocks.size())
+    {
+        _weight_blocks.resize(k);
+        layout_changed = true;
+    }
+
+    /* off-diagonal blocks are zero and never written, they are reset only if the blocks change */
+    if(layout_changed || _W.rows() != _A.rows())
+        _W.setZero(_A.rows(), _A.rows());
+
+    _weight_is_diagonal = true;
+    for(const auto& block : _weight_blocks)
+    {
+        assert(block.task->getWeight().rows() == block.size);
+        _W.block(block.offset, block.offset, block.size, block.size) = block.task->getWeight();
+        _weight_is_diagonal = _weight_is_diagonal && block.task->getWeightIsDiagonalFlag();
+    }
 }
 
 void OpenSoT::tasks::Aggregated::setWeight(const Eigen::MatrixXd &W)
@@ -283,13 +325,94 @@ void OpenSoT::tasks::Aggregated::setWeight(const Eigen::MatrixXd &W)
     assert(W.rows() == this->getTaskSize());
     assert(W.cols() == W.rows());
 
-    this->_W = W;
+    double blocks_norm = 0.;
+    for(const auto& block : _weight_blocks)
+        blocks_norm += W.block(block.offset, block.offset, block.size, block.size).squaredNorm();
+
+    if(W.squaredNorm() - blocks_norm > 1e-12)
+        throw std::runtime_error("ERROR. " + _task_id + ": the weight is not block diagonal, "
+                                 "the weights of different tasks can not be coupled.\n");
 
-    std::list< TaskPtr >::iterator t;
-    int block = 0;
-    for(t = _tasks.begin(); t != _tasks.end(); t++)
+    int offset = 0;
+    for(const auto& t : _tasks)
     {
-        (*t)->setWeight(W.block(block, block, (*t)->getWeight().rows(),(*t)->getWeight().cols()));
-        block += (*t)->getWeight().rows();
+        const int size = t->getA().rows();
+        t->setWeight(W.block(offset, offset, size, size));
+        offset += size;
+    }
+
+    for(const auto& block : _weight_blocks)
+        _W.block(block.offset, block.offset, block.size, block.size) = block.task->getWeight();
+}
+
+void OpenSoT::tasks::Aggregated::setWeight(const double& w)
+{
+    for(const auto& t : _tasks)
+        t->setWeight(w);
+
+    for(const auto& block : _weight_blocks)
+        _W.block(block.offset, block.offset, block.size, block.size) = block.task->getWeight();
+}
+
+void OpenSoT::tasks::Aggregated::weight(const Eigen::MatrixXd& M, Eigen::MatrixXd& WM) const
+{
+    assert(M.rows() == _W.rows());
+
+    WM.resize(M.rows(), M.cols());
+    for(const auto& block : _weight_blocks)
+    {
+        auto Wi = _W.block(block.offset, block.offset, block.size, block.size);
+        if(block.task->getWeightIsDiagonalFlag())
+            WM.middleRows(block.offset, block.size).noalias() =
+                    Wi.diagonal().asDiagonal()*M.middleRows(block.offset, block.size);
+        else
+            WM.middleRows(block.offset, block.size).noalias() = Wi*M.middleRows(block.offset, block.size);
+    }
+}
+
+void OpenSoT::tasks::Aggregated::computeHessianAndGradient(Eigen::MatrixXd& H, Eigen::VectorXd& g)
+{
+    H.setZero(_x_size, _x_size);
+    g.setZero(_x_size);
+
+    _hessian_blocks.resize(_weight_blocks.size());
+    for(unsigned int i = 0; i < _weight_blocks.size(); ++i)
+    {
+        const WeightBlock& block = _weight_blocks[i];
+        HessianBlock& ws = _hessian_blocks[i];
+
+        auto Ai = _A.middleRows(block.offset, block.size);
+        auto bi = _b.segment(block.offset, block.size);
+        auto Wi = _W.block(block.offset, block.offset, block.size, block.size);
+
+        /* contribution restricted to the columns in which the task is not zero */
+        ws.support.clear();
+        for(int j = 0; j < Ai.cols(); ++j)
+            if(!Ai.col(j).isZero(0.))
+                ws.support.push_back(j);
+
+        ws.As.resize(Ai.rows(), ws.support.size());
+        for(unsigned int k = 0; k < ws.support.size(); ++k)
+            ws.As.col(k) = Ai.col(ws.support[k]);
+
+        utils::weight(ws.As, Wi, block.task->getWeightIsDiagonalFlag(), ws.WAs);
+        utils::hessian(ws.As, ws.WAs, ws.Hs);
+        utils::gradient(ws.WAs, bi, ws.gs);
+
+        const int ns = ws.support.size();
+        if(ns == int(_x_size))
+        {
+            H += ws.Hs;
+            g += ws.gs;
+        }
+        else
+        {
+            for(int c = 0; c < ns; ++c)
+            {
+                for(int r = 0; r < ns; ++r)
+                    H(ws.support[r], ws.support[c]) += ws.Hs(r, c);
+                g[ws.support[c]] += ws.gs[c];
+            }
+        }
     }
 }
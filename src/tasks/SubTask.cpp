@@ -1,4 +1,5 @@
 #include "OpenSoT/SubTask.h"
+#include <OpenSoT/utils/FixedRows.h>
 
 const std::string OpenSoT::SubTask::_SUBTASK_SEPARATION_ = "_";
 
@@ -8,10 +9,7 @@ OpenSoT::SubTask::SubTask(OpenSoT::SubTask::TaskPtr taskPtr, const std::list<uns
     _subTaskMap(rowIndices),
     _taskPtr(taskPtr)
 {
-    this->_A.resize(rowIndices.size(), _x_size);
-    this->_b.resize(rowIndices.size());
-    this->_W.resize(rowIndices.size(), rowIndices.size());
-    fullW = _taskPtr->getWeight();
+    this->_b.resize(_subTaskMap.size());
 
     this->generateA();
     this->generateb();
@@ -21,13 +19,21 @@ OpenSoT::SubTask::SubTask(OpenSoT::SubTask::TaskPtr taskPtr, const std::list<uns
 
 void OpenSoT::SubTask::generateA()
 {
+    this->_A.resize(_subTaskMap.size(), _x_size);
+
+    if(!this->isActive())
+    {
+        this->_A.setZero();
+        return;
+    }
+
     unsigned int chunk_size = 0;
     unsigned int j = 0;
     for(Indices::ChunkList::const_iterator i = _subTaskMap.getChunks().begin();
         i != _subTaskMap.getChunks().end(); ++i)
     {
         chunk_size = i->size();
-        this->_A.block(j,0,chunk_size,_x_size) = _taskPtr->getA().block(i->front(),0,i->back()-i->front()+1, _x_size);
+        this->_A.middleRows(j, chunk_size) = _taskPtr->getA().middleRows(i->front(), chunk_size);
         j+=chunk_size;
     }
 }
@@ -60,12 +66,29 @@ void OpenSoT::SubTask::generateb()
 
 void OpenSoT::SubTask::generateWeight()
 {
-        this->_W.setZero(_W.rows(), _W.cols());
+    const Eigen::MatrixXd& W = _taskPtr->getWeight();
+    this->_W.resize(_subTaskMap.size(), _subTaskMap.size());
 
-        for(unsigned int r = 0; r < this->getTaskSize(); ++r)
-            for(unsigned int c = 0; c < this->getTaskSize(); ++c)
-                this->_W(r,c) = _taskPtr->getWeight()(this->_subTaskMap.asVector()[r],
-                                                      this->_subTaskMap.asVector()[c]);
+    unsigned int r = 0;
+    for(const auto& row_chunk : _subTaskMap.getChunks())
+    {
+        unsigned int c = 0;
+        for(const auto& col_chunk : _subTaskMap.getChunks())
+        {
+            this->_W.block(r, c, row_chunk.size(), col_chunk.size()) =
+                    W.block(row_chunk.front(), col_chunk.front(), row_chunk.size(), col_chunk.size());
+            c += col_chunk.size();
+        }
+        r += row_chunk.size();
+    }
+}
+
+void OpenSoT::SubTask::computeHessianAndGradient(Eigen::MatrixXd& H, Eigen::VectorXd& g) const
+{
+    const Eigen::MatrixXd& WA = this->getWA();
+
+    utils::hessian(_A, WA, H);
+    utils::gradient(WA, _b, g);
 }
 
 void OpenSoT::SubTask::setWeight(const Eigen::MatrixXd &W)
@@ -74,15 +97,30 @@ void OpenSoT::SubTask::setWeight(const Eigen::MatrixXd &W)
     assert(W.cols() == W.rows());
 
     this->_W = W;
+
     fullW = _taskPtr->getWeight();
-    for(unsigned int r = 0; r < this->getTaskSize(); ++r)
-        for(unsigned int c = 0; c < this->getTaskSize(); ++c)
-            fullW(this->_subTaskMap.asVector()[r],
-                  this->_subTaskMap.asVector()[c]) = this->_W(r,c);
+    unsigned int r = 0;
+    for(const auto& row_chunk : _subTaskMap.getChunks())
+    {
+        unsigned int c = 0;
+        for(const auto& col_chunk : _subTaskMap.getChunks())
+        {
+            fullW.block(row_chunk.front(), col_chunk.front(), row_chunk.size(), col_chunk.size()) =
+                    this->_W.block(r, c, row_chunk.size(), col_chunk.size());
+            c += col_chunk.size();
+        }
+        r += row_chunk.size();
+    }
 
     _taskPtr->setWeight(fullW);
 }
 
+void OpenSoT::SubTask::setWeight(const double& w)
+{
+    assert(w>=0.0);
+    this->setWeight(Eigen::MatrixXd(w*Eigen::MatrixXd::Identity(_subTaskMap.size(), _subTaskMap.size())));
+}
+
 std::list<OpenSoT::SubTask::ConstraintPtr> &OpenSoT::SubTask::getConstraints()
 {
     return _taskPtr->getConstraints();
@@ -105,7 +143,8 @@ const unsigned int OpenSoT::SubTask::getTaskSize() const
 
 void OpenSoT::SubTask::_update()
 {
-    _taskPtr->update();
+    if(_update_father_task)
+        _taskPtr->update();
     this->generateA();
     this->generateb();
     this->generateHessianAtype();
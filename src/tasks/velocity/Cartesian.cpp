@@ -55,8 +55,8 @@ Cartesian::Cartesian(std::string task_id,
 
     _W.setIdentity(_A.rows(), _A.rows());
 
-    _tmp_A.setZero(_A.rows(), _A.cols());
-    _tmp_b.setZero(_b.size());
+    _tmp_A.setZero(6, _A.cols());
+    _tmp_b.setZero(6);
 
     _hessianType = HST_SEMIDEF;
 }
@@ -98,11 +98,16 @@ void Cartesian::_update() {
     //Here we rotate A and b
     if(_rotate_to_local)
     {
+        // adjointFromRotation(R^T) is block diagonal: linear and angular rows are rotated separately
+        const Eigen::Matrix3d R = _actualPose.linear().transpose();
+
         _tmp_A = _A;
-        _A = XBot::Utils::adjointFromRotation(_actualPose.linear().transpose())*_tmp_A;
+        _A.topRows<3>().noalias() = R*_tmp_A.topRows<3>();
+        _A.bottomRows<3>().noalias() = R*_tmp_A.bottomRows<3>();
 
         _tmp_b = _b;
-        _b = XBot::Utils::adjointFromRotation(_actualPose.linear().transpose())*_tmp_b;
+        _b.head<3>().noalias() = R*_tmp_b.head<3>();
+        _b.tail<3>().noalias() = R*_tmp_b.tail<3>();
     }
 
     this->_desiredTwist.setZero(6);
@@ -16,13 +16,12 @@ OpenSoT::tasks::velocity::CollisionAvoidance::CollisionAvoidance(
 
 void CollisionAvoidance::_update()
 {
-    // update underlying constraint
+    // update underlying constraint, collisions are not recomputed
+    // if the constraint has already been updated at this joint position
     _constr->update();
 
-    // error is good if positive
-    _constr->getError(_error);
-
-    std::cout << _error.minCoeff() << "\n";
+    // error is good if positive, one entry for each row of Aineq
+    _constr->getActivePairsError(_error);
 
     // compute
     _A.setZero();
@@ -382,9 +382,71 @@ OpenSoT::AutoStack::AutoStack(OpenSoT::solvers::iHQP::Stack stack,
 
 }
 
+namespace {
+
+/**
+ * @brief The ChildrenUpdateGuard class disables the update of the tasks composing an Aggregated or a SubTask
+ * and restores the previous setting when destroyed, also if the update of the composite task throws
+ */
+class ChildrenUpdateGuard
+{
+public:
+    ChildrenUpdateGuard(OpenSoT::tasks::Aggregated* aggregated, OpenSoT::SubTask* sub_task):
+        _aggregated(aggregated),
+        _sub_task(sub_task)
+    {
+        if(_aggregated)
+        {
+            _previous = _aggregated->getUpdateTasks();
+            _aggregated->setUpdateTasks(false);
+        }
+        else
+        {
+            _previous = _sub_task->getUpdateFatherTask();
+            _sub_task->setUpdateFatherTask(false);
+        }
+    }
+
+    ~ChildrenUpdateGuard()
+    {
+        if(_aggregated)
+            _aggregated->setUpdateTasks(_previous);
+        else
+            _sub_task->setUpdateFatherTask(_previous);
+    }
+
+    ChildrenUpdateGuard(const ChildrenUpdateGuard&) = delete;
+    ChildrenUpdateGuard& operator=(const ChildrenUpdateGuard&) = delete;
+
+private:
+    OpenSoT::tasks::Aggregated* _aggregated;
+    OpenSoT::SubTask* _sub_task;
+    bool _previous;
+};
+
+}
+
 void OpenSoT::AutoStack::update()
 {
     _boundsAggregated->update();
+
+    if(_is_compiled)
+    {
+        if(!isPlanValid())
+            compile();
+
+        for(const auto& task : _update_list)
+            task->update();
+
+        // the tasks composing Aggregated and SubTask have already been updated
+        for(const auto& composite : _composite_list)
+        {
+            ChildrenUpdateGuard guard(composite.aggregated, composite.sub_task);
+            composite.task->update();
+        }
+        return;
+    }
+
     typedef std::vector<OpenSoT::tasks::Aggregated::TaskPtr>::iterator it_t;
     for(it_t task = _stack.begin(); task != _stack.end(); ++task)
         (*task)->update();
@@ -392,6 +454,53 @@ void OpenSoT::AutoStack::update()
         _regularisation_task->update();
 }
 
+void OpenSoT::AutoStack::compile()
+{
+    _update_list.clear();
+    _composite_list.clear();
+
+    for(const auto& task : _stack)
+        compileTask(task);
+    if(_regularisation_task)
+        compileTask(_regularisation_task);
+
+    _compiled_stack = _stack;
+    _compiled_regularisation_task = _regularisation_task;
+    _is_compiled = true;
+}
+
+void OpenSoT::AutoStack::compileTask(OpenSoT::solvers::iHQP::TaskPtr task)
+{
+    if(std::find(_update_list.begin(), _update_list.end(), task) != _update_list.end())
+        return;
+    for(const auto& composite : _composite_list)
+    {
+        if(composite.task == task)
+            return;
+    }
+
+    if(OpenSoT::tasks::Aggregated::isAggregated(task))
+    {
+        OpenSoT::tasks::Aggregated::Ptr aggregated =
+                std::dynamic_pointer_cast<OpenSoT::tasks::Aggregated>(task);
+        for(const auto& t : aggregated->getTaskList())
+            compileTask(t);
+        _composite_list.push_back({task, aggregated.get(), nullptr});
+    }
+    else if(OpenSoT::SubTask::Ptr sub_task = OpenSoT::SubTask::asSubTask(task))
+    {
+        compileTask(sub_task->getTask());
+        _composite_list.push_back({task, nullptr, sub_task.get()});
+    }
+    else
+        _update_list.push_back(task);
+}
+
+bool OpenSoT::AutoStack::isPlanValid() const
+{
+    return _stack == _compiled_stack && _regularisation_task == _compiled_regularisation_task;
+}
+
 std::list<OpenSoT::constraints::Aggregated::ConstraintPtr>& OpenSoT::AutoStack::getBoundsList()
 {
     return _boundsAggregated->getConstraintsList();
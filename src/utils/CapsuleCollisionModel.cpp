@@ -0,0 +1,593 @@
+#include <OpenSoT/utils/CapsuleCollisionModel.h>
+#include <xbot2_interface/logger.h>
+#include <algorithm>
+#include <numeric>
+
+using namespace OpenSoT::utils;
+
+namespace
+{
+    const std::string WORLD_LINK = "world";
+    const std::string DISTANCE_FIELD = "distance_field";
+
+    Eigen::Affine3d toEigen(const urdf::Pose& pose)
+    {
+        Eigen::Affine3d T;
+        T.translation() << pose.position.x, pose.position.y, pose.position.z;
+        T.linear() = Eigen::Quaterniond(pose.rotation.w, pose.rotation.x,
+                                        pose.rotation.y, pose.rotation.z).toRotationMatrix();
+        return T;
+    }
+}
+
+void SegmentBatch::resize(const int n)
+{
+    px.setZero(n); py.setZero(n); pz.setZero(n);
+    dx.setZero(n); dy.setZero(n); dz.setZero(n);
+    r.setZero(n);
+}
+
+SegmentDistanceBatch::SegmentDistanceBatch(const int n)
+{
+    resize(n);
+}
+
+void SegmentDistanceBatch::resize(const int n)
+{
+    for(Eigen::ArrayXd* v : {&distance, &wax, &way, &waz, &wbx, &wby, &wbz, &nx, &ny, &nz,
+                             &_rx, &_ry, &_rz, &_a, &_b, &_c, &_e, &_f, &_denom,
+                             &_s, &_t, &_tmp, &_cx, &_cy, &_cz, &_norm})
+        v->setZero(n);
+}
+
+void SegmentDistanceBatch::compute(const SegmentBatch& A, const SegmentBatch& B)
+{
+    compute(A, B, size());
+}
+
+void SegmentDistanceBatch::compute(const SegmentBatch& A, const SegmentBatch& B, const int n)
+{
+    static constexpr double eps = 1e-12;
+
+    // only the first n pairs are computed
+    auto h = [n](auto& v){ return v.head(n); };
+
+    // r = pA - pB
+    h(_rx) = h(A.px) - h(B.px);
+    h(_ry) = h(A.py) - h(B.py);
+    h(_rz) = h(A.pz) - h(B.pz);
+
+    h(_a) = h(A.dx).square() + h(A.dy).square() + h(A.dz).square();
+    h(_e) = h(B.dx).square() + h(B.dy).square() + h(B.dz).square();
+    h(_f) = h(B.dx)*h(_rx) + h(B.dy)*h(_ry) + h(B.dz)*h(_rz);
+    h(_c) = h(A.dx)*h(_rx) + h(A.dy)*h(_ry) + h(A.dz)*h(_rz);
+    h(_b) = h(A.dx)*h(B.dx) + h(A.dy)*h(B.dy) + h(A.dz)*h(B.dz);
+    h(_denom) = h(_a)*h(_e) - h(_b)*h(_b);
+
+    // general (non parallel) case, s on the infinite line clamped to the segment
+    h(_s) = (h(_denom) > eps).select(((h(_b)*h(_f) - h(_c)*h(_e))/h(_denom)).max(0.).min(1.), 0.);
+    h(_t) = (h(_b)*h(_s) + h(_f))/h(_e);
+
+    // t outside [0, 1]: clamp t and recompute s
+    h(_tmp) = (-h(_c)/h(_a)).max(0.).min(1.);
+    h(_s) = (h(_t) < 0.).select(h(_tmp), h(_s));
+    h(_tmp) = ((h(_b) - h(_c))/h(_a)).max(0.).min(1.);
+    h(_s) = (h(_t) > 1.).select(h(_tmp), h(_s));
+    h(_t) = h(_t).max(0.).min(1.);
+
+    // degenerate cases: B is a point
+    h(_tmp) = (-h(_c)/h(_a)).max(0.).min(1.);
+    h(_s) = (h(_e) <= eps).select(h(_tmp), h(_s));
+    h(_t) = (h(_e) <= eps).select(0., h(_t));
+
+    // degenerate cases: A is a point
+    h(_tmp) = (h(_f)/h(_e)).max(0.).min(1.);
+    h(_t) = (h(_a) <= eps).select(h(_tmp), h(_t));
+    h(_s) = (h(_a) <= eps).select(0., h(_s));
+
+    // both are points
+    h(_t) = (h(_a) <= eps && h(_e) <= eps).select(0., h(_t));
+
+    // closest points on the axes, stored in witness points
+    h(wax) = h(A.px) + h(A.dx)*h(_s);
+    h(way) = h(A.py) + h(A.dy)*h(_s);
+    h(waz) = h(A.pz) + h(A.dz)*h(_s);
+    h(wbx) = h(B.px) + h(B.dx)*h(_t);
+    h(wby) = h(B.py) + h(B.dy)*h(_t);
+    h(wbz) = h(B.pz) + h(B.dz)*h(_t);
+
+    h(_cx) = h(wbx) - h(wax);
+    h(_cy) = h(wby) - h(way);
+    h(_cz) = h(wbz) - h(waz);
+    h(_norm) = (h(_cx).square() + h(_cy).square() + h(_cz).square()).sqrt();
+
+    // normal from a to b, when axes intersect the z axis is chosen
+    h(nx) = (h(_norm) > eps).select(h(_cx)/h(_norm), 0.);
+    h(ny) = (h(_norm) > eps).select(h(_cy)/h(_norm), 0.);
+    h(nz) = (h(_norm) > eps).select(h(_cz)/h(_norm), 1.);
+
+    h(distance) = h(_norm) - h(A.r) - h(B.r);
+
+    // move closest points on the capsule surfaces
+    h(wax) += h(nx)*h(A.r);
+    h(way) += h(ny)*h(A.r);
+    h(waz) += h(nz)*h(A.r);
+    h(wbx) -= h(nx)*h(B.r);
+    h(wby) -= h(ny)*h(B.r);
+    h(wbz) -= h(nz)*h(B.r);
+}
+
+CapsuleCollisionModel::CapsuleCollisionModel(XBot::ModelInterface::ConstPtr model):
+    _model(model),
+    _all_links_vs_env(true),
+    _num_self_capsule_pairs(0),
+    _field_points(5)
+{
+
+}
+
+bool CapsuleCollisionModel::addCapsule(const std::string& name,
+                                       const std::string& link,
+                                       const Eigen::Vector3d& p0,
+                                       const Eigen::Vector3d& p1,
+                                       const double radius,
+                                       const std::vector<std::string>& disabled_collisions)
+{
+    for(const auto& capsule : _capsules)
+    {
+        if(capsule.name == name)
+        {
+            XBot::Logger::error("CapsuleCollisionModel: shape %s already exists \n", name.c_str());
+            return false;
+        }
+    }
+
+    if(link != WORLD_LINK && _model->getLinkId(link) < 0)
+    {
+        XBot::Logger::error("CapsuleCollisionModel: link %s does not exist \n", link.c_str());
+        return false;
+    }
+
+    Capsule capsule;
+    capsule.name = name;
+    capsule.link = link;
+    capsule.p0 = p0;
+    capsule.p1 = p1;
+    capsule.radius = std::fabs(radius);
+    capsule.disabled_links.insert(disabled_collisions.begin(), disabled_collisions.end());
+    _capsules.push_back(capsule);
+
+    if(link == WORLD_LINK)
+        _world_shapes_pose[name] = Eigen::Affine3d::Identity();
+
+    generatePairs();
+
+    return true;
+}
+
+bool CapsuleCollisionModel::addSphere(const std::string& name,
+                                      const std::string& link,
+                                      const Eigen::Vector3d& center,
+                                      const double radius,
+                                      const std::vector<std::string>& disabled_collisions)
+{
+    return addCapsule(name, link, center, center, radius, disabled_collisions);
+}
+
+bool CapsuleCollisionModel::addCollisionShape(const std::string& name,
+                                              const std::string& link,
+                                              const XBot::Collision::Shape::Variant& shape,
+                                              const Eigen::Affine3d& link_T_shape,
+                                              const std::vector<std::string>& disabled_collisions)
+{
+    // environment shapes are stored in shape frame, so that they can be moved later on
+    const bool is_env = link == WORLD_LINK;
+    const Eigen::Affine3d T = is_env ? Eigen::Affine3d::Identity() : link_T_shape;
+
+    bool success = false;
+    if(auto capsule = std::get_if<XBot::Collision::Shape::Capsule>(&shape))
+    {
+        Eigen::Vector3d half_axis = 0.5*capsule->l*T.linear().col(2);
+        success = addCapsule(name, link,
+                             T.translation() - half_axis,
+                             T.translation() + half_axis,
+                             capsule->r, disabled_collisions);
+    }
+    else if(auto sphere = std::get_if<XBot::Collision::Shape::Sphere>(&shape))
+    {
+        success = addSphere(name, link, T.translation(), sphere->r, disabled_collisions);
+    }
+    else
+    {
+        return false;
+    }
+
+    if(success && is_env)
+        _world_shapes_pose[name] = link_T_shape;
+
+    return success;
+}
+
+bool CapsuleCollisionModel::moveCollisionShape(const std::string& name, const Eigen::Affine3d& w_T_shape)
+{
+    auto it = _world_shapes_pose.find(name);
+    if(it == _world_shapes_pose.end())
+    {
+        XBot::Logger::error("CapsuleCollisionModel: %s is not an environment shape \n", name.c_str());
+        return false;
+    }
+
+    it->second = w_T_shape;
+    return true;
+}
+
+bool CapsuleCollisionModel::fitFromUrdf(const urdf::ModelInterface& urdf)
+{
+    bool success = true;
+
+    for(const auto& link : urdf.links_)
+    {
+        for(unsigned int i = 0; i < link.second->collision_array.size(); ++i)
+        {
+            const auto& collision = link.second->collision_array[i];
+            if(!collision || !collision->geometry)
+                continue;
+
+            const std::string name = link.first + "_collision_" + std::to_string(i);
+            const Eigen::Affine3d T = toEigen(collision->origin);
+
+            switch(collision->geometry->type)
+            {
+                case urdf::Geometry::SPHERE:
+                {
+                    auto sphere = std::static_pointer_cast<urdf::Sphere>(collision->geometry);
+                    success = addSphere(name, link.first, T.translation(), sphere->radius) && success;
+                    break;
+                }
+                case urdf::Geometry::CYLINDER:
+                {
+                    auto cylinder = std::static_pointer_cast<urdf::Cylinder>(collision->geometry);
+                    Eigen::Vector3d half_axis = 0.5*cylinder->length*T.linear().col(2);
+                    success = addCapsule(name, link.first,
+                                         T.translation() - half_axis, T.translation() + half_axis,
+                                         cylinder->radius) && success;
+                    break;
+                }
+                case urdf::Geometry::BOX:
+                {
+                    auto box = std::static_pointer_cast<urdf::Box>(collision->geometry);
+                    Eigen::Vector3d size(box->dim.x, box->dim.y, box->dim.z);
+                    int axis;
+                    size.maxCoeff(&axis);
+                    Eigen::Vector3d half_axis = 0.5*size[axis]*T.linear().col(axis);
+                    double radius = 0.5*std::sqrt(size.squaredNorm() - size[axis]*size[axis]);
+                    success = addCapsule(name, link.first,
+                                         T.translation() - half_axis, T.translation() + half_axis,
+                                         radius) && success;
+                    break;
+                }
+                default:
+                    XBot::Logger::warning("CapsuleCollisionModel: can not fit a capsule to collision %s (mesh) \n", name.c_str());
+                    success = false;
+            }
+        }
+    }
+
+    return success;
+}
+
+void CapsuleCollisionModel::setLinkPairs(const std::set<LinkPair>& pairs)
+{
+    _link_pairs = pairs;
+    generatePairs();
+}
+
+void CapsuleCollisionModel::setLinksVsEnvironment(const std::set<std::string>& links)
+{
+    _links_vs_env = links;
+    _all_links_vs_env = false;
+    generatePairs();
+}
+
+void CapsuleCollisionModel::setDistanceField(DistanceField::ConstPtr field, const unsigned int points_per_capsule)
+{
+    _field = field;
+    _field_points = points_per_capsule;
+    generatePairs();
+}
+
+void CapsuleCollisionModel::generatePairs()
+{
+    _links.clear();
+    _capsule_link.assign(_capsules.size(), -1);
+    for(unsigned int i = 0; i < _capsules.size(); ++i)
+    {
+        if(_capsules[i].link == WORLD_LINK)
+            continue;
+
+        auto it = std::find(_links.begin(), _links.end(), _capsules[i].link);
+        _capsule_link[i] = std::distance(_links.begin(), it);
+        if(it == _links.end())
+            _links.push_back(_capsules[i].link);
+    }
+
+    _w_T_link.assign(_links.size(), Eigen::Affine3d::Identity());
+    _J_link.assign(_links.size(), Eigen::MatrixXd::Zero(6, _model->getNv()));
+    _w_p0.assign(_capsules.size(), Eigen::Vector3d::Zero());
+    _w_d.assign(_capsules.size(), Eigen::Vector3d::Zero());
+
+    _self_pairs.clear();
+    _all_pairs.clear();
+    _pa.clear(); _pb.clear(); _pl.clear();
+
+    auto add_capsule_pairs = [this](const std::string& first, const std::string& second,
+                                    const bool second_is_shape)
+    {
+        bool found = false;
+        for(unsigned int i = 0; i < _capsules.size(); ++i)
+        {
+            if(_capsules[i].link != first)
+                continue;
+
+            for(unsigned int j = 0; j < _capsules.size(); ++j)
+            {
+                if((second_is_shape && _capsules[j].name != second) ||
+                   (!second_is_shape && _capsules[j].link != second))
+                    continue;
+
+                // same semantic of the disabled collisions of XBot::Collision::CollisionModel
+                if(_capsules[i].disabled_links.count(_capsules[j].link) ||
+                   _capsules[j].disabled_links.count(_capsules[i].link))
+                    continue;
+
+                _pa.push_back(i);
+                _pb.push_back(j);
+                _pl.push_back(_all_pairs.size());
+                found = true;
+            }
+        }
+
+        if(found)
+            _all_pairs.emplace_back(first, second);
+    };
+
+    for(const auto& pair : _link_pairs)
+    {
+        if(pair.first == WORLD_LINK || pair.second == WORLD_LINK)
+            continue;
+
+        add_capsule_pairs(pair.first, pair.second, false);
+    }
+
+    _self_pairs = _all_pairs;
+    _num_self_capsule_pairs = _pa.size();
+
+    const std::set<std::string> links_vs_env = _all_links_vs_env ?
+                std::set<std::string>(_links.begin(), _links.end()) : _links_vs_env;
+
+    _field_link.clear();
+    _field_capsules.clear();
+
+    if(_field)
+    {
+        for(const auto& link : links_vs_env)
+        {
+            auto it = std::find(_links.begin(), _links.end(), link);
+            if(it == _links.end())
+                continue;
+
+            _field_link.push_back(std::distance(_links.begin(), it));
+            _field_capsules.emplace_back();
+            for(unsigned int i = 0; i < _capsules.size(); ++i)
+            {
+                if(_capsule_link[i] == _field_link.back())
+                    _field_capsules.back().push_back(i);
+            }
+
+            _all_pairs.emplace_back(link, DISTANCE_FIELD);
+        }
+    }
+    else
+    {
+        for(const auto& link : links_vs_env)
+        {
+            for(const auto& shape : _world_shapes_pose)
+                add_capsule_pairs(link, shape.first, true);
+        }
+    }
+
+    _field_p.assign(_field_link.size(), Eigen::Vector3d::Zero());
+    _field_g.assign(_field_link.size(), Eigen::Vector3d::Zero());
+    _field_wp.assign(_field_link.size(), WitnessPoint(Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()));
+
+    _A.resize(_pa.size());
+    _B.resize(_pa.size());
+    _dist.resize(_pa.size());
+
+    _d.setConstant(_all_pairs.size(), std::numeric_limits<double>::max());
+    _argmin.assign(_all_pairs.size(), -1);
+    _ordered_idx.reserve(_all_pairs.size());
+    _ordered_idx.clear();
+}
+
+void CapsuleCollisionModel::update()
+{
+    for(unsigned int i = 0; i < _links.size(); ++i)
+    {
+        _model->getPose(_links[i], _w_T_link[i]);
+        _model->getJacobian(_links[i], _J_link[i]);
+    }
+
+    for(unsigned int i = 0; i < _capsules.size(); ++i)
+    {
+        const Capsule& capsule = _capsules[i];
+
+        const Eigen::Affine3d& w_T_l = _capsule_link[i] < 0 ?
+                    _world_shapes_pose.at(capsule.name) :
+                    _w_T_link[_capsule_link[i]];
+
+        _w_p0[i].noalias() = w_T_l*capsule.p0;
+        _w_d[i].noalias() = w_T_l.linear()*(capsule.p1 - capsule.p0);
+    }
+}
+
+int CapsuleCollisionModel::getNumCollisionPairs(const bool include_env) const
+{
+    return include_env ? _all_pairs.size() : _self_pairs.size();
+}
+
+const CapsuleCollisionModel::LinkPairVector& CapsuleCollisionModel::getCollisionPairs(const bool include_env) const
+{
+    return include_env ? _all_pairs : _self_pairs;
+}
+
+void CapsuleCollisionModel::computeDistance(Eigen::VectorXd& d, const bool include_env)
+{
+    const int num_capsule_pairs = include_env ? _pa.size() : _num_self_capsule_pairs;
+    const int num_pairs = getNumCollisionPairs(include_env);
+
+    // gather
+    for(int k = 0; k < num_capsule_pairs; ++k)
+    {
+        const int i = _pa[k];
+        const int j = _pb[k];
+
+        _A.px[k] = _w_p0[i].x(); _A.py[k] = _w_p0[i].y(); _A.pz[k] = _w_p0[i].z();
+        _A.dx[k] = _w_d[i].x();  _A.dy[k] = _w_d[i].y();  _A.dz[k] = _w_d[i].z();
+        _A.r[k] = _capsules[i].radius;
+
+        _B.px[k] = _w_p0[j].x(); _B.py[k] = _w_p0[j].y(); _B.pz[k] = _w_p0[j].z();
+        _B.dx[k] = _w_d[j].x();  _B.dy[k] = _w_d[j].y();  _B.dz[k] = _w_d[j].z();
+        _B.r[k] = _capsules[j].radius;
+    }
+
+    // batched distance computation, environment pairs are skipped if not needed
+    _dist.compute(_A, _B, num_capsule_pairs);
+
+    // min among the capsules of the same link pair
+    _d.head(num_pairs).setConstant(std::numeric_limits<double>::max());
+    for(int k = 0; k < num_capsule_pairs; ++k)
+    {
+        const int l = _pl[k];
+        if(_dist.distance[k] < _d[l])
+        {
+            _d[l] = _dist.distance[k];
+            _argmin[l] = k;
+        }
+    }
+
+    if(include_env && _field)
+        computeFieldDistance();
+
+    d = _d.head(num_pairs);
+
+    _ordered_idx.resize(num_pairs);
+    std::iota(_ordered_idx.begin(), _ordered_idx.end(), 0);
+    std::sort(_ordered_idx.begin(), _ordered_idx.end(),
+              [this](int i, int j){ return _d[i] < _d[j]; });
+}
+
+void CapsuleCollisionModel::computeFieldDistance()
+{
+    const int offset = _self_pairs.size();
+    const int n = std::max(_field_points, 1u);
+
+    for(unsigned int f = 0; f < _field_link.size(); ++f)
+    {
+        double& d = _d[offset + f];
+        d = std::numeric_limits<double>::max();
+
+        Eigen::Vector3d g;
+        for(int i : _field_capsules[f])
+        {
+            for(int s = 0; s < n; ++s)
+            {
+                const double t = n == 1 ? 0.5 : double(s)/(n - 1);
+                const Eigen::Vector3d p = _w_p0[i] + t*_w_d[i];
+
+                const double ds = _field->getDistance(p, g) - _capsules[i].radius;
+                if(ds < d)
+                {
+                    d = ds;
+                    _field_p[f] = p;
+                    _field_g[f] = g;
+
+                    // witness points along the (normalized) gradient
+                    const double norm = g.norm();
+                    const Eigen::Vector3d n_field = norm > 0. ? Eigen::Vector3d(g/norm) : Eigen::Vector3d::Zero();
+                    _field_wp[f].first = p - _capsules[i].radius*n_field;
+                    _field_wp[f].second = p - (ds + _capsules[i].radius)*n_field;
+                }
+            }
+        }
+    }
+}
+
+void CapsuleCollisionModel::getDistanceJacobian(Eigen::MatrixXd& J, const bool include_env)
+{
+    const int num_pairs = getNumCollisionPairs(include_env);
+    J.resize(num_pairs, _model->getNv());
+
+    for(int l = 0; l < num_pairs; ++l)
+    {
+        if(_field && l >= int(_self_pairs.size()))
+        {
+            // d_dot = g^T p_dot, p_dot = v_link + omega x (p - o_link)
+            const int f = l - _self_pairs.size();
+            const int link = _field_link[f];
+            Eigen::Vector3d r = _field_p[f] - _w_T_link[link].translation();
+            _wa << _field_g[f], r.cross(_field_g[f]);
+            J.row(l).noalias() = _wa.transpose()*_J_link[link];
+            continue;
+        }
+
+        const int k = _argmin[l];
+        const int la = _capsule_link[_pa[k]];
+        const int lb = _capsule_link[_pb[k]];
+
+        const Eigen::Vector3d n(_dist.nx[k], _dist.ny[k], _dist.nz[k]);
+
+        // d_dot = n^T (v_wb - v_wa), v_w = v_link + omega x (w - o_link)
+        J.row(l).setZero();
+
+        if(la >= 0)
+        {
+            Eigen::Vector3d r = Eigen::Vector3d(_dist.wax[k], _dist.way[k], _dist.waz[k]) -
+                    _w_T_link[la].translation();
+            _wa << n, r.cross(n);
+            J.row(l).noalias() -= _wa.transpose()*_J_link[la];
+        }
+
+        if(lb >= 0)
+        {
+            Eigen::Vector3d r = Eigen::Vector3d(_dist.wbx[k], _dist.wby[k], _dist.wbz[k]) -
+                    _w_T_link[lb].translation();
+            _wb << n, r.cross(n);
+            J.row(l).noalias() += _wb.transpose()*_J_link[lb];
+        }
+    }
+}
+
+void CapsuleCollisionModel::getWitnessPoints(WitnessPointVector& wp, const bool include_env) const
+{
+    const int num_pairs = getNumCollisionPairs(include_env);
+    wp.resize(num_pairs);
+
+    for(int l = 0; l < num_pairs; ++l)
+    {
+        if(_field && l >= int(_self_pairs.size()))
+        {
+            wp[l] = _field_wp[l - _self_pairs.size()];
+            continue;
+        }
+
+        const int k = _argmin[l];
+        wp[l].first << _dist.wax[k], _dist.way[k], _dist.waz[k];
+        wp[l].second << _dist.wbx[k], _dist.wby[k], _dist.wbz[k];
+    }
+}
+
+const std::vector<int>& CapsuleCollisionModel::getOrderedCollisionPairIndices() const
+{
+    return _ordered_idx;
+}
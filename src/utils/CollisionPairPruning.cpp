@@ -0,0 +1,157 @@
+#include <OpenSoT/utils/CollisionPairPruning.h>
+#include <xbot2_interface/logger.h>
+#include <fstream>
+#include <sstream>
+
+using namespace OpenSoT::utils;
+
+CollisionPairPruning::CollisionPairPruning(XBot::ModelInterface::Ptr model):
+    _model(model),
+    _number_of_samples(0)
+{
+    _collision_model = std::make_unique<XBot::Collision::CollisionModel>(_model);
+
+    // self-collision pairs only, SRDF disabled collisions are already removed
+    _pairs = _collision_model->getCollisionPairs(false);
+
+    _d.setZero(_pairs.size());
+    _min_d.setConstant(_pairs.size(), std::numeric_limits<double>::max());
+    _max_d.setConstant(_pairs.size(), std::numeric_limits<double>::lowest());
+    _max_rate.setZero(_pairs.size());
+    _colliding.setZero(_pairs.size());
+}
+
+void CollisionPairPruning::sample(const unsigned int number_of_samples)
+{
+    for(unsigned int i = 0; i < number_of_samples; ++i)
+        addSample(_model->generateRandomQ());
+}
+
+void CollisionPairPruning::addSample(const Eigen::VectorXd& q)
+{
+    _model->setJointPosition(q);
+    _model->update();
+    _collision_model->update();
+
+    _collision_model->computeDistance(_d, false, std::numeric_limits<double>::max());
+    _collision_model->getDistanceJacobian(_J, false);
+
+    _min_d = _min_d.cwiseMin(_d);
+    _max_d = _max_d.cwiseMax(_d);
+    _max_rate = _max_rate.cwiseMax(_J.rowwise().lpNorm<1>());
+    _colliding += (_d.array() <= 0.).cast<int>().matrix();
+
+    _number_of_samples++;
+}
+
+std::vector<CollisionPairPruning::PairReport> CollisionPairPruning::getReport(const double margin, const double resolution) const
+{
+    std::vector<PairReport> report;
+
+    for(unsigned int i = 0; i < _pairs.size(); ++i)
+    {
+        PairReport r;
+        r.pair = _pairs[i];
+        r.min_distance = _min_d[i];
+        r.max_distance = _max_d[i];
+        r.max_distance_rate = _max_rate[i];
+        r.colliding_samples = _colliding[i];
+
+        if(_number_of_samples > 0 && r.colliding_samples == int(_number_of_samples))
+            r.classification = PairClass::ALWAYS;
+        else if(r.min_distance - r.max_distance_rate*resolution > margin)
+            r.classification = PairClass::NEVER;
+        else
+            r.classification = PairClass::SOMETIMES;
+
+        report.push_back(r);
+    }
+
+    return report;
+}
+
+std::set<CollisionPairPruning::LinksPair> CollisionPairPruning::getPrunedPairs(const double margin, const double resolution) const
+{
+    std::set<LinksPair> pairs;
+
+    for(const auto& r : getReport(margin, resolution))
+    {
+        if(r.classification == PairClass::SOMETIMES)
+            pairs.insert(r.pair);
+    }
+
+    return pairs;
+}
+
+bool CollisionPairPruning::savePairList(const std::string& file_name, const std::set<LinksPair>& pairs)
+{
+    std::ofstream file(file_name);
+    if(!file.is_open())
+    {
+        XBot::Logger::error("CollisionPairPruning: can not open %s \n", file_name.c_str());
+        return false;
+    }
+
+    file << "# link1 link2\n";
+    for(const auto& pair : pairs)
+        file << pair.first << " " << pair.second << "\n";
+
+    return true;
+}
+
+std::set<CollisionPairPruning::LinksPair> CollisionPairPruning::loadPairList(const std::string& file_name)
+{
+    std::set<LinksPair> pairs;
+
+    std::ifstream file(file_name);
+    if(!file.is_open())
+    {
+        XBot::Logger::error("CollisionPairPruning: can not open %s \n", file_name.c_str());
+        return pairs;
+    }
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        if(line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream ss(line);
+        LinksPair pair;
+        if(ss >> pair.first >> pair.second)
+            pairs.insert(pair);
+    }
+
+    return pairs;
+}
+
+bool CollisionPairPruning::saveReport(const std::string& file_name, const double margin, const double resolution) const
+{
+    std::ofstream file(file_name);
+    if(!file.is_open())
+    {
+        XBot::Logger::error("CollisionPairPruning: can not open %s \n", file_name.c_str());
+        return false;
+    }
+
+    file << "# samples: " << _number_of_samples << ", margin: " << margin << ", resolution: " << resolution << "\n";
+    file << "# link1 link2 class min_distance max_distance max_distance_rate colliding_samples\n";
+    for(const auto& r : getReport(margin, resolution))
+    {
+        file << r.pair.first << " " << r.pair.second << " " << toString(r.classification) << " "
+             << r.min_distance << " " << r.max_distance << " " << r.max_distance_rate << " "
+             << r.colliding_samples << "\n";
+    }
+
+    return true;
+}
+
+std::string CollisionPairPruning::toString(const PairClass c)
+{
+    switch(c)
+    {
+        case PairClass::NEVER: return "NEVER";
+        case PairClass::ALWAYS: return "ALWAYS";
+        default: return "SOMETIMES";
+    }
+}
@@ -0,0 +1,361 @@
+#include <OpenSoT/utils/DistanceField.h>
+#include <xbot2_interface/logger.h>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <functional>
+#include <algorithm>
+
+using namespace OpenSoT::utils;
+
+namespace
+{
+    /**
+     * @brief binary file header, followed by size.prod()*4 floats
+     */
+    struct FileHeader
+    {
+        char magic[8];
+        double origin[3];
+        double resolution;
+        double max_distance;
+        int32_t size[3];
+        uint32_t version;
+    };
+
+    static_assert(sizeof(FileHeader) == 64, "unexpected DistanceField header size");
+
+    const char MAGIC[8] = "OSOTSDF";
+    const uint32_t VERSION = 1;
+
+    /**
+     * @brief squared distance transform of a sampled function (Felzenszwalb and Huttenlocher)
+     */
+    void distanceTransform1D(const std::vector<double>& f, std::vector<double>& d,
+                             std::vector<int>& v, std::vector<double>& z, const int n)
+    {
+        int k = 0;
+        v[0] = 0;
+        z[0] = std::numeric_limits<double>::lowest();
+        z[1] = std::numeric_limits<double>::max();
+
+        for(int q = 1; q < n; ++q)
+        {
+            double s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k]))/(2.*q - 2.*v[k]);
+            while(s <= z[k])
+            {
+                k--;
+                s = ((f[q] + q*q) - (f[v[k]] + v[k]*v[k]))/(2.*q - 2.*v[k]);
+            }
+            k++;
+            v[k] = q;
+            z[k] = s;
+            z[k+1] = std::numeric_limits<double>::max();
+        }
+
+        k = 0;
+        for(int q = 0; q < n; ++q)
+        {
+            while(z[k+1] < q)
+                k++;
+            d[q] = (q - v[k])*(q - v[k]) + f[v[k]];
+        }
+    }
+}
+
+DistanceField::DistanceField():
+    _resolution(0.),
+    _max_distance(0.),
+    _data(nullptr),
+    _mmap_ptr(nullptr),
+    _mmap_size(0)
+{
+
+}
+
+DistanceField::DistanceField(const Eigen::Vector3d& origin,
+                             const Eigen::Vector3i& size,
+                             const double resolution,
+                             const double max_distance):
+    _origin(origin),
+    _size(size),
+    _resolution(resolution),
+    _max_distance(max_distance),
+    _data(nullptr),
+    _mmap_ptr(nullptr),
+    _mmap_size(0)
+{
+    if((_size.array() < 2).any())
+        throw std::invalid_argument("DistanceField: size must be at least 2 along each axis");
+    if(_resolution <= 0.)
+        throw std::invalid_argument("DistanceField: resolution must be positive");
+
+    _storage.assign(size_t(_size.prod())*CHANNELS, 0.f);
+    _data = _storage.data();
+
+    for(int i = 0; i < _size.prod(); ++i)
+        _data[i*CHANNELS] = _max_distance;
+}
+
+DistanceField::~DistanceField()
+{
+    if(_mmap_ptr)
+        munmap(_mmap_ptr, _mmap_size);
+}
+
+DistanceField::Ptr DistanceField::load(const std::string& file_name)
+{
+    int fd = open(file_name.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        XBot::Logger::error("DistanceField: can not open %s \n", file_name.c_str());
+        return nullptr;
+    }
+
+    struct stat st;
+    if(fstat(fd, &st) < 0 || size_t(st.st_size) < sizeof(FileHeader))
+    {
+        XBot::Logger::error("DistanceField: %s is not a valid distance field \n", file_name.c_str());
+        close(fd);
+        return nullptr;
+    }
+
+    void* ptr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if(ptr == MAP_FAILED)
+    {
+        XBot::Logger::error("DistanceField: can not map %s \n", file_name.c_str());
+        return nullptr;
+    }
+
+    const FileHeader* header = static_cast<const FileHeader*>(ptr);
+    const Eigen::Vector3i size(header->size[0], header->size[1], header->size[2]);
+    if(std::strncmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION ||
+       (size.array() < 2).any() ||
+       size_t(st.st_size) != sizeof(FileHeader) + size_t(size.prod())*CHANNELS*sizeof(float))
+    {
+        XBot::Logger::error("DistanceField: %s is not a valid distance field \n", file_name.c_str());
+        munmap(ptr, st.st_size);
+        return nullptr;
+    }
+
+    Ptr field(new DistanceField());
+    field->_origin << header->origin[0], header->origin[1], header->origin[2];
+    field->_size = size;
+    field->_resolution = header->resolution;
+    field->_max_distance = header->max_distance;
+    field->_mmap_ptr = ptr;
+    field->_mmap_size = st.st_size;
+    field->_data = reinterpret_cast<float*>(static_cast<char*>(ptr) + sizeof(FileHeader));
+
+    return field;
+}
+
+bool DistanceField::save(const std::string& file_name) const
+{
+    std::ofstream file(file_name, std::ios::binary);
+    if(!file.is_open())
+    {
+        XBot::Logger::error("DistanceField: can not open %s \n", file_name.c_str());
+        return false;
+    }
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    for(int i = 0; i < 3; ++i)
+    {
+        header.origin[i] = _origin[i];
+        header.size[i] = _size[i];
+    }
+    header.resolution = _resolution;
+    header.max_distance = _max_distance;
+    header.version = VERSION;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(_data), size_t(_size.prod())*CHANNELS*sizeof(float));
+
+    return file.good();
+}
+
+bool DistanceField::addShape(const XBot::Collision::Shape::Variant& shape, const Eigen::Affine3d& w_T_shape)
+{
+    if(isReadOnly())
+    {
+        XBot::Logger::error("DistanceField: field is read-only \n");
+        return false;
+    }
+
+    std::function<double(const Eigen::Vector3d&)> sdf;
+
+    if(auto sphere = std::get_if<XBot::Collision::Shape::Sphere>(&shape))
+    {
+        const double r = sphere->r;
+        sdf = [r](const Eigen::Vector3d& p){ return p.norm() - r; };
+    }
+    else if(auto box = std::get_if<XBot::Collision::Shape::Box>(&shape))
+    {
+        const Eigen::Vector3d h = 0.5*box->size;
+        sdf = [h](const Eigen::Vector3d& p){
+            Eigen::Vector3d q = p.cwiseAbs() - h;
+            return q.cwiseMax(0.).norm() + std::min(q.maxCoeff(), 0.); };
+    }
+    else if(auto capsule = std::get_if<XBot::Collision::Shape::Capsule>(&shape))
+    {
+        const double r = capsule->r, h = 0.5*capsule->l;
+        sdf = [r, h](const Eigen::Vector3d& p){
+            return (p - Eigen::Vector3d(0., 0., std::clamp(p.z(), -h, h))).norm() - r; };
+    }
+    else if(auto cylinder = std::get_if<XBot::Collision::Shape::Cylinder>(&shape))
+    {
+        const double r = cylinder->r, h = 0.5*cylinder->l;
+        sdf = [r, h](const Eigen::Vector3d& p){
+            Eigen::Vector2d d(p.head<2>().norm() - r, std::fabs(p.z()) - h);
+            return std::min(d.maxCoeff(), 0.) + d.cwiseMax(0.).norm(); };
+    }
+    else
+    {
+        XBot::Logger::error("DistanceField: unsupported shape \n");
+        return false;
+    }
+
+    const Eigen::Affine3d shape_T_w = w_T_shape.inverse();
+
+    for(int k = 0; k < _size.z(); ++k)
+        for(int j = 0; j < _size.y(); ++j)
+            for(int i = 0; i < _size.x(); ++i)
+            {
+                float& d = _data[index(i, j, k)];
+                d = std::min<float>(d, sdf(shape_T_w*point(i, j, k)));
+            }
+
+    return true;
+}
+
+bool DistanceField::addPointCloud(const std::vector<Eigen::Vector3d>& points)
+{
+    if(isReadOnly())
+    {
+        XBot::Logger::error("DistanceField: field is read-only \n");
+        return false;
+    }
+
+    // squared distances in grid units, 0 on occupied cells
+    const double far = 1e20;
+    std::vector<double> g(_size.prod(), far);
+    auto flat = [this](int i, int j, int k){ return (k*_size.y() + j)*_size.x() + i; };
+
+    bool occupied = false;
+    for(const auto& p : points)
+    {
+        Eigen::Vector3i c = ((p - _origin)/_resolution).array().round().cast<int>();
+        if((c.array() < 0).any() || (c.array() >= _size.array()).any())
+            continue;
+        g[flat(c.x(), c.y(), c.z())] = 0.;
+        occupied = true;
+    }
+
+    if(!occupied)
+        return true;
+
+    // separable exact euclidean distance transform
+    const int n = _size.maxCoeff();
+    std::vector<double> f(n), d(n), z(n+1);
+    std::vector<int> v(n);
+
+    for(int k = 0; k < _size.z(); ++k)
+        for(int j = 0; j < _size.y(); ++j)
+        {
+            for(int i = 0; i < _size.x(); ++i) f[i] = g[flat(i, j, k)];
+            distanceTransform1D(f, d, v, z, _size.x());
+            for(int i = 0; i < _size.x(); ++i) g[flat(i, j, k)] = d[i];
+        }
+
+    for(int k = 0; k < _size.z(); ++k)
+        for(int i = 0; i < _size.x(); ++i)
+        {
+            for(int j = 0; j < _size.y(); ++j) f[j] = g[flat(i, j, k)];
+            distanceTransform1D(f, d, v, z, _size.y());
+            for(int j = 0; j < _size.y(); ++j) g[flat(i, j, k)] = d[j];
+        }
+
+    for(int j = 0; j < _size.y(); ++j)
+        for(int i = 0; i < _size.x(); ++i)
+        {
+            for(int k = 0; k < _size.z(); ++k) f[k] = g[flat(i, j, k)];
+            distanceTransform1D(f, d, v, z, _size.z());
+            for(int k = 0; k < _size.z(); ++k) g[flat(i, j, k)] = d[k];
+        }
+
+    const double half_diagonal = 0.5*std::sqrt(3.)*_resolution;
+    for(int l = 0; l < _size.prod(); ++l)
+    {
+        float& dist = _data[l*CHANNELS];
+        dist = std::min<float>(dist, std::sqrt(g[l])*_resolution - half_diagonal);
+    }
+
+    return true;
+}
+
+void DistanceField::computeGradient()
+{
+    if(isReadOnly())
+    {
+        XBot::Logger::error("DistanceField: field is read-only \n");
+        return;
+    }
+
+    for(int k = 0; k < _size.z(); ++k)
+        for(int j = 0; j < _size.y(); ++j)
+            for(int i = 0; i < _size.x(); ++i)
+            {
+                const int ip = std::min(i+1, _size.x()-1), im = std::max(i-1, 0);
+                const int jp = std::min(j+1, _size.y()-1), jm = std::max(j-1, 0);
+                const int kp = std::min(k+1, _size.z()-1), km = std::max(k-1, 0);
+
+                float* cell = _data + index(i, j, k);
+                cell[1] = (_data[index(ip, j, k)] - _data[index(im, j, k)])/((ip - im)*_resolution);
+                cell[2] = (_data[index(i, jp, k)] - _data[index(i, jm, k)])/((jp - jm)*_resolution);
+                cell[3] = (_data[index(i, j, kp)] - _data[index(i, j, km)])/((kp - km)*_resolution);
+            }
+}
+
+bool DistanceField::isInside(const Eigen::Vector3d& p) const
+{
+    Eigen::Array3d u = (p - _origin).array()/_resolution;
+    return (u >= 0.).all() && (u <= (_size.array() - 1).cast<double>()).all();
+}
+
+double DistanceField::getDistance(const Eigen::Vector3d& p, Eigen::Vector3d& gradient) const
+{
+    gradient.setZero();
+
+    Eigen::Array3d u = (p - _origin).array()/_resolution;
+    if(!((u >= 0.).all() && (u <= (_size.array() - 1).cast<double>()).all()))
+        return _max_distance;
+
+    Eigen::Array3i c = u.floor().cast<int>().min(_size.array() - 2);
+    Eigen::Array3d t = u - c.cast<double>();
+
+    Eigen::Vector4d value = Eigen::Vector4d::Zero();
+    for(int corner = 0; corner < 8; ++corner)
+    {
+        const int di = corner & 1, dj = (corner >> 1) & 1, dk = (corner >> 2) & 1;
+        const double w = (di ? t.x() : 1. - t.x())*(dj ? t.y() : 1. - t.y())*(dk ? t.z() : 1. - t.z());
+        value += w*Eigen::Map<const Eigen::Vector4f>(_data + index(c.x() + di, c.y() + dj, c.z() + dk)).cast<double>();
+    }
+
+    gradient = value.tail<3>();
+    return value[0];
+}
+
+double DistanceField::getDistance(const Eigen::Vector3d& p) const
+{
+    Eigen::Vector3d gradient;
+    return getDistance(p, gradient);
+}
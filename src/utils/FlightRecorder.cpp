@@ -0,0 +1,359 @@
+#include <OpenSoT/utils/FlightRecorder.h>
+#include <xbot2_interface/logger.h>
+#include <matlogger2/matlogger2.h>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace OpenSoT::utils;
+
+const char FlightRecorder::MAGIC[8] = {'O', 'S', 'O', 'T', 'F', 'R', 'C', '\0'};
+
+namespace {
+
+std::size_t slotSize(const FlightRecorder::ChannelHeader& header)
+{
+    // time, rows, cols and data
+    return sizeof(double)*(3 + header.rows*header.cols);
+}
+
+}
+
+FlightRecorder::FlightRecorder(const std::string& file_name,
+                               const unsigned int samples,
+                               const std::size_t queue_size,
+                               const std::chrono::microseconds period):
+    _file_name(file_name),
+    _samples(samples),
+    _period(period),
+    _queue(queue_size, 0.),
+    _head(0),
+    _tail(0),
+    _next_head(0),
+    _decimated(false),
+    _dropped(0),
+    _running(false),
+    _file(nullptr),
+    _file_size(0)
+{
+
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    stop();
+}
+
+int FlightRecorder::addChannel(const std::string& name, const int rows, const int cols,
+                               const int decimation, const unsigned int samples)
+{
+    if(isStarted())
+    {
+        XBot::Logger::error("FlightRecorder: channel %s can not be added after start() \n", name.c_str());
+        return -1;
+    }
+    if(name.size() >= sizeof(ChannelHeader::name) || getChannel(name) >= 0)
+    {
+        XBot::Logger::error("FlightRecorder: channel name %s is too long or already used \n", name.c_str());
+        return -1;
+    }
+    if(rows <= 0 || cols <= 0 || decimation <= 0 || SAMPLE_HEADER_SIZE + rows*cols > _queue.size())
+    {
+        XBot::Logger::error("FlightRecorder: channel %s has wrong size or decimation \n", name.c_str());
+        return -1;
+    }
+
+    Channel channel;
+    std::memset(&channel.header, 0, sizeof(ChannelHeader));
+    std::strncpy(channel.header.name, name.c_str(), sizeof(ChannelHeader::name) - 1);
+    channel.header.rows = rows;
+    channel.header.cols = cols;
+    channel.header.decimation = decimation;
+    channel.header.samples = samples > 0 ? samples : _samples;
+    channel.counter = 0;
+
+    _channels.push_back(channel);
+    return _channels.size() - 1;
+}
+
+int FlightRecorder::getChannel(const std::string& name) const
+{
+    for(unsigned int i = 0; i < _channels.size(); ++i)
+    {
+        if(name == _channels[i].header.name)
+            return i;
+    }
+    return -1;
+}
+
+bool FlightRecorder::start()
+{
+    if(isStarted())
+        return true;
+
+    _file_size = sizeof(FileHeader) + _channels.size()*sizeof(ChannelHeader);
+    for(auto& channel : _channels)
+    {
+        channel.header.offset = _file_size;
+        _file_size += channel.header.samples*slotSize(channel.header);
+    }
+
+    int fd = ::open(_file_name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || ::ftruncate(fd, _file_size) != 0)
+    {
+        XBot::Logger::error("FlightRecorder: can not create %s \n", _file_name.c_str());
+        if(fd >= 0)
+            ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, _file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED)
+    {
+        XBot::Logger::error("FlightRecorder: can not map %s \n", _file_name.c_str());
+        return false;
+    }
+    char* file = static_cast<char*>(data);
+
+    FileHeader* header = reinterpret_cast<FileHeader*>(file);
+    std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+    header->version = VERSION;
+    header->channels = _channels.size();
+    header->dropped = 0;
+
+    ChannelHeader* channel_headers = reinterpret_cast<ChannelHeader*>(file + sizeof(FileHeader));
+    for(unsigned int i = 0; i < _channels.size(); ++i)
+    {
+        channel_headers[i] = _channels[i].header;
+        _channels[i].counter = 0;
+    }
+
+    _head = 0;
+    _tail = 0;
+    _next_head = 0;
+    _dropped = 0;
+    _start_time = std::chrono::steady_clock::now();
+
+    // the file is published once the headers are written
+    _file.store(file, std::memory_order_release);
+
+    _running = true;
+    _thread = std::thread(&FlightRecorder::run, this);
+
+    return true;
+}
+
+void FlightRecorder::stop()
+{
+    if(!isStarted())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _condition.notify_one();
+    if(_thread.joinable())
+        _thread.join();
+
+    char* file = _file.load(std::memory_order_relaxed);
+    _file.store(nullptr, std::memory_order_release);
+    ::msync(file, _file_size, MS_SYNC);
+    ::munmap(file, _file_size);
+}
+
+double* FlightRecorder::reserve(const int channel, const Eigen::Index rows, const Eigen::Index cols)
+{
+    _decimated = false;
+
+    if(!isStarted() || channel < 0 || channel >= static_cast<int>(_channels.size()))
+        return nullptr;
+
+    // the counter wraps at the decimation, so it never overflows
+    Channel& c = _channels[channel];
+    const bool decimated = c.counter != 0;
+    if(++c.counter == c.header.decimation)
+        c.counter = 0;
+    if(decimated)
+    {
+        _decimated = true;
+        return nullptr;
+    }
+
+    if(rows > c.header.rows || cols > c.header.cols)
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    const std::size_t capacity = _queue.size();
+    const std::size_t size = SAMPLE_HEADER_SIZE + rows*cols;
+    const std::size_t head = _head.load(std::memory_order_relaxed);
+    const std::size_t tail = _tail.load(std::memory_order_acquire);
+
+    // samples are contiguous in the queue: if the sample does not fit before the end of the queue
+    // the remaining space is skipped
+    std::size_t position = head % capacity;
+    const std::size_t padding = position + size > capacity ? capacity - position : 0;
+
+    if(head + padding + size - tail > capacity)
+    {
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    if(padding > 0)
+    {
+        _queue[position] = -1.;
+        position = 0;
+    }
+
+    double* sample = _queue.data() + position;
+    sample[0] = channel;
+    sample[1] = rows;
+    sample[2] = cols;
+    sample[3] = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start_time).count();
+
+    _next_head = head + padding + size;
+
+    return sample + SAMPLE_HEADER_SIZE;
+}
+
+void FlightRecorder::commit()
+{
+    _head.store(_next_head, std::memory_order_release);
+}
+
+void FlightRecorder::consume()
+{
+    const std::size_t capacity = _queue.size();
+    const std::size_t head = _head.load(std::memory_order_acquire);
+    std::size_t tail = _tail.load(std::memory_order_relaxed);
+
+    char* file = _file.load(std::memory_order_acquire);
+    ChannelHeader* channel_headers = reinterpret_cast<ChannelHeader*>(file + sizeof(FileHeader));
+
+    while(tail != head)
+    {
+        const std::size_t position = tail % capacity;
+        const double* sample = _queue.data() + position;
+
+        if(sample[0] < 0.)
+        {
+            tail += capacity - position;
+            continue;
+        }
+
+        const int channel = sample[0];
+        const std::size_t rows = sample[1];
+        const std::size_t cols = sample[2];
+
+        ChannelHeader& header = channel_headers[channel];
+        double* slot = reinterpret_cast<double*>(file + header.offset +
+                                                 (header.count % header.samples)*slotSize(header));
+        slot[0] = sample[3];
+        slot[1] = rows;
+        slot[2] = cols;
+        std::memcpy(slot + 3, sample + SAMPLE_HEADER_SIZE, sizeof(double)*rows*cols);
+        header.count++;
+
+        tail += SAMPLE_HEADER_SIZE + rows*cols;
+    }
+
+    _tail.store(tail, std::memory_order_release);
+
+    reinterpret_cast<FileHeader*>(file)->dropped = _dropped.load(std::memory_order_relaxed);
+}
+
+void FlightRecorder::run()
+{
+    // the control thread never touches the mutex, which is used only to wake up the thread on stop()
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(!_condition.wait_for(lock, _period, [this]{ return !_running.load(); }))
+        consume();
+    consume();
+}
+
+bool FlightRecorder::convertToMat(const std::string& file_name, const std::string& mat_file_name)
+{
+    int fd = ::open(file_name.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        XBot::Logger::error("FlightRecorder: can not open %s \n", file_name.c_str());
+        return false;
+    }
+
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader)))
+    {
+        XBot::Logger::error("FlightRecorder: %s is not a valid recording \n", file_name.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    void* data = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(data == MAP_FAILED)
+    {
+        XBot::Logger::error("FlightRecorder: can not map %s \n", file_name.c_str());
+        return false;
+    }
+
+    const char* file = static_cast<const char*>(data);
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(file);
+    const ChannelHeader* channel_headers = reinterpret_cast<const ChannelHeader*>(file + sizeof(FileHeader));
+
+    bool valid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0 && header->version == VERSION &&
+            sizeof(FileHeader) + header->channels*sizeof(ChannelHeader) <= static_cast<std::size_t>(st.st_size);
+    for(unsigned int i = 0; valid && i < header->channels; ++i)
+        valid = channel_headers[i].offset + channel_headers[i].samples*slotSize(channel_headers[i]) <=
+                static_cast<std::size_t>(st.st_size);
+    if(!valid)
+    {
+        XBot::Logger::error("FlightRecorder: %s is not a valid recording \n", file_name.c_str());
+        ::munmap(data, st.st_size);
+        return false;
+    }
+
+    XBot::MatLogger2::Ptr logger = XBot::MatLogger2::MakeLogger(mat_file_name);
+
+    Eigen::MatrixXd sample;
+    Eigen::Vector2d sample_size;
+    for(unsigned int i = 0; i < header->channels; ++i)
+    {
+        const ChannelHeader& channel = channel_headers[i];
+        const std::string name = channel.name;
+
+        const std::uint64_t samples = std::min<std::uint64_t>(channel.count, channel.samples);
+        if(samples == 0)
+            continue;
+
+        logger->create(name, channel.rows, channel.cols, samples);
+        logger->create(name + "_time", 1, 1, samples);
+        logger->create(name + "_size", 2, 1, samples);
+
+        for(std::uint64_t k = channel.count - samples; k < channel.count; ++k)
+        {
+            const double* slot = reinterpret_cast<const double*>(file + channel.offset +
+                                                                 (k % channel.samples)*slotSize(channel));
+            const int rows = slot[1];
+            const int cols = slot[2];
+
+            sample.setZero(channel.rows, channel.cols);
+            sample.topLeftCorner(rows, cols) = Eigen::Map<const Eigen::MatrixXd>(slot + 3, rows, cols);
+            sample_size << rows, cols;
+
+            logger->add(name, sample);
+            logger->add(name + "_time", slot[0]);
+            logger->add(name + "_size", sample_size);
+        }
+    }
+
+    XBot::Logger::info("FlightRecorder: %s converted, %lu samples were dropped \n", file_name.c_str(), header->dropped);
+
+    ::munmap(data, st.st_size);
+    return true;
+}
@@ -1,84 +1,51 @@
 #include <OpenSoT/utils/Indices.h>
-
-std::list<unsigned int>::iterator OpenSoT::Indices::getNextAdjacentChunk(std::list<unsigned int>::iterator searchBegin)
-{
-    if(searchBegin != _rowsList.end())
-    {
-        for(std::list<unsigned int>::iterator i = searchBegin;
-            i != _rowsList.end();
-            ++i)
-        {
-            std::list<unsigned int>::iterator next = i; next++;
-            std::list<unsigned int>::iterator prev = i;
-
-            while(next != _rowsList.end() &&
-                  *next == *prev + 1) {
-                next++;
-                prev++;
-            }
-            return prev;
-        }
-    }
-    return _rowsList.end();
-}
+#include <algorithm>
+#include <iterator>
 
 void OpenSoT::Indices::generateChunks()
 {
-    _rowsList.sort(); _rowsList.unique();
+    std::sort(_rowsVector.begin(), _rowsVector.end());
+    _rowsVector.erase(std::unique(_rowsVector.begin(), _rowsVector.end()), _rowsVector.end());
+    _rowsList.assign(_rowsVector.begin(), _rowsVector.end());
 
-    this->_rowsVector.clear();
-    this->_rowsVector.insert(this->_rowsVector.end(),
-                             this->_rowsList.begin(),
-                             this->_rowsList.end());
     this->_contiguousChunks.clear();
 
-    for(std::list<unsigned int>::iterator i = _rowsList.begin();
-        i!= _rowsList.end();
-        ++i)
+    std::vector<unsigned int>::const_iterator chunkBegin = _rowsVector.begin();
+    while(chunkBegin != _rowsVector.end())
     {
-        std::list<unsigned int>::iterator chunkEnd =
-                this->getNextAdjacentChunk(i);
-        /* insert doesn't include the last extreme,
-         * so we need to increment chunkEnd */
-        if(chunkEnd != _rowsList.end())
-        {
-            std::list<unsigned int>::iterator chunkAfterEnd = chunkEnd;
-            ++chunkAfterEnd;
-            RowsChunk chunk; chunk.insert(chunk.end(), i, chunkAfterEnd);
-            this->_contiguousChunks.push_back(chunk);
-        }
-        i = chunkEnd;
+        std::vector<unsigned int>::const_iterator chunkEnd = chunkBegin + 1;
+        while(chunkEnd != _rowsVector.end() && *chunkEnd == *(chunkEnd - 1) + 1)
+            ++chunkEnd;
+
+        this->_contiguousChunks.push_back(RowsChunk(chunkBegin, chunkEnd));
+        chunkBegin = chunkEnd;
     }
 }
 
 OpenSoT::Indices::Indices(unsigned int i)
 {
-    _rowsList.push_back(i);
+    _rowsVector.push_back(i);
     this->generateChunks();
 }
 
 OpenSoT::Indices::Indices(const std::list<unsigned int> &rowsList)
-    : _rowsList(rowsList)
+    : _rowsVector(rowsList.begin(), rowsList.end())
 {
     this->generateChunks();
 }
 
 OpenSoT::Indices::Indices(const std::vector<unsigned int> &rowsVector)
+    : _rowsVector(rowsVector)
 {
-    for(std::vector<unsigned int>::const_iterator it = rowsVector.begin();
-        it != rowsVector.end();
-        ++it)
-    {
-        _rowsList.push_back(*it);
-    }
-
     this->generateChunks();
 }
 
 OpenSoT::Indices::Indices(const OpenSoT::Indices &subTaskMap)
-    : _rowsList(subTaskMap.asList())
+    : _contiguousChunks(subTaskMap.getChunks()),
+      _rowsList(subTaskMap.asList()),
+      _rowsVector(subTaskMap.asVector())
 {
-    this->generateChunks();
+
 }
 
 const OpenSoT::Indices::ChunkList& OpenSoT::Indices::getChunks() const
@@ -98,8 +65,8 @@ const std::vector<unsigned int> &OpenSoT::Indices::asVector() const
 
 OpenSoT::Indices &OpenSoT::Indices::shift(unsigned int amount)
 {
-    for(std::list<unsigned int>::iterator it = _rowsList.begin();
-        it != _rowsList.end();
+    for(std::vector<unsigned int>::iterator it = _rowsVector.begin();
+        it != _rowsVector.end();
         ++it)
         (*it) += amount;
     this->generateChunks();
@@ -109,10 +76,11 @@ OpenSoT::Indices &OpenSoT::Indices::shift(unsigned int amount)
 
 OpenSoT::Indices &OpenSoT::Indices::filter(const OpenSoT::Indices &f)
 {
-    _rowsList.clear();
-    std::vector<unsigned int> indices = f.asVector();
+    std::vector<unsigned int> rows;
+    const std::vector<unsigned int>& indices = f.asVector();
     for(unsigned int i = 0; i < indices.size(); ++i)
-        _rowsList.push_back(_rowsVector[indices[i]]);
+        rows.push_back(_rowsVector[indices[i]]);
+    _rowsVector.swap(rows);
     this->generateChunks();
     return *this;
 }
@@ -140,7 +108,7 @@ OpenSoT::Indices::operator std::list<unsigned int>() const
 OpenSoT::Indices::operator std::string() const
 {
     std::stringstream subTaskIdSuffix;
-    if(_rowsList.size() == 0)
+    if(_rowsVector.size() == 0)
         subTaskIdSuffix<<"empty";
     else
     {
@@ -168,41 +136,40 @@ OpenSoT::Indices::operator std::string() const
 
 OpenSoT::Indices OpenSoT::Indices::operator+(const OpenSoT::Indices &b) const
 {
-    std::list<unsigned int> rows = this->_rowsList;
-    rows.insert(rows.end(), b.asList().begin(), b.asList().end());
+    std::vector<unsigned int> rows = this->_rowsVector;
+    rows.insert(rows.end(), b.asVector().begin(), b.asVector().end());
     return Indices(rows);
 }
 
 OpenSoT::Indices OpenSoT::Indices::operator+(const unsigned int r) const
 {
-    std::list<unsigned int> rows = this->_rowsList;
+    std::vector<unsigned int> rows = this->_rowsVector;
     rows.push_back(r);
     return Indices(rows);
 }
 
 OpenSoT::Indices OpenSoT::Indices::operator-(const OpenSoT::Indices &b) const
 {
-    std::list<unsigned int> rows = this->_rowsList;
-    for(std::list<unsigned int>::const_iterator i = b.asList().begin();
-        i != b.asList().end();
-        ++i)
-        rows.remove(*i);
+    std::vector<unsigned int> rows;
+    std::set_difference(_rowsVector.begin(), _rowsVector.end(),
+                        b.asVector().begin(), b.asVector().end(),
+                        std::back_inserter(rows));
     return Indices(rows);
 }
 
 OpenSoT::Indices OpenSoT::Indices::operator-(const unsigned int r) const
 {
-    std::list<unsigned int> rows = this->_rowsList;
-    rows.remove(r);
+    std::vector<unsigned int> rows = this->_rowsVector;
+    rows.erase(std::remove(rows.begin(), rows.end(), r), rows.end());
     return Indices(rows);
 }
 
 bool OpenSoT::Indices::operator==(const OpenSoT::Indices &b) const
 {
-    return this->_rowsList == b.asList();
+    return this->_rowsVector == b.asVector();
 }
 
 int OpenSoT::Indices::size() const
 {
-    return this->_rowsList.size();
+    return this->_rowsVector.size();
 }
@@ -0,0 +1,223 @@
+#include <OpenSoT/utils/Rollout.h>
+#include <OpenSoT/SubTask.h>
+#include <OpenSoT/tasks/velocity/Cartesian.h>
+#include <OpenSoT/tasks/velocity/CoM.h>
+#include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/tasks/acceleration/Cartesian.h>
+#include <OpenSoT/tasks/acceleration/CoM.h>
+#include <OpenSoT/tasks/acceleration/Postural.h>
+#include <xbot2_interface/logger.h>
+#include <chrono>
+
+using namespace OpenSoT::utils;
+
+namespace {
+
+Eigen::Affine3d toPose(const Eigen::VectorXd& ref)
+{
+    Eigen::Affine3d pose;
+    pose.translation() = ref.head<3>();
+    pose.linear() = Eigen::Quaterniond(ref[6], ref[3], ref[4], ref[5]).normalized().toRotationMatrix();
+    return pose;
+}
+
+}
+
+Rollout::Rollout(XBot::ModelInterface& model,
+                 OpenSoT::AutoStack::Ptr stack,
+                 OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::SolverPtr solver,
+                 const Integration integration,
+                 const double dt):
+    _model(model),
+    _stack(stack),
+    _solver(solver),
+    _integration(integration),
+    _dt(dt),
+    _use_joint_variable(false)
+{
+
+}
+
+bool Rollout::setReference(OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr task, const Eigen::MatrixXd& trajectory)
+{
+    while(task && OpenSoT::SubTask::isSubTask(task))
+        task = OpenSoT::SubTask::asSubTask(task)->getTask();
+
+    if(!task)
+    {
+        XBot::Logger::error("Rollout: task is null \n");
+        return false;
+    }
+
+    Reference reference;
+    int cols = 0;
+
+    if(auto cartesian = std::dynamic_pointer_cast<OpenSoT::tasks::velocity::Cartesian>(task))
+    {
+        cols = 7;
+        reference.set = [cartesian](const Eigen::VectorXd& ref){ cartesian->setReference(toPose(ref)); };
+    }
+    else if(auto cartesian = std::dynamic_pointer_cast<OpenSoT::tasks::acceleration::Cartesian>(task))
+    {
+        cols = 7;
+        reference.set = [cartesian](const Eigen::VectorXd& ref){ cartesian->setReference(toPose(ref)); };
+    }
+    else if(auto com = std::dynamic_pointer_cast<OpenSoT::tasks::velocity::CoM>(task))
+    {
+        cols = 3;
+        reference.set = [com](const Eigen::VectorXd& ref){ com->setReference(Eigen::Vector3d(ref)); };
+    }
+    else if(auto com = std::dynamic_pointer_cast<OpenSoT::tasks::acceleration::CoM>(task))
+    {
+        cols = 3;
+        reference.set = [com](const Eigen::VectorXd& ref){ com->setReference(Eigen::Vector3d(ref)); };
+    }
+    else if(auto postural = std::dynamic_pointer_cast<OpenSoT::tasks::velocity::Postural>(task))
+    {
+        cols = _model.getNq();
+        reference.set = [postural](const Eigen::VectorXd& ref){ postural->setReference(ref); };
+    }
+    else if(auto postural = std::dynamic_pointer_cast<OpenSoT::tasks::acceleration::Postural>(task))
+    {
+        cols = _model.getNq();
+        reference.set = [postural](const Eigen::VectorXd& ref){ postural->setReference(ref); };
+    }
+    else
+    {
+        XBot::Logger::error("Rollout: task %s is not a Cartesian, CoM or Postural task \n", task->getTaskID().c_str());
+        return false;
+    }
+
+    if(trajectory.cols() != cols || trajectory.rows() == 0)
+    {
+        XBot::Logger::error("Rollout: reference of %s should have %i columns, it has %i \n",
+                            task->getTaskID().c_str(), cols, int(trajectory.cols()));
+        return false;
+    }
+
+    reference.trajectory = trajectory;
+    _references.push_back(reference);
+    return true;
+}
+
+bool Rollout::setReference(const std::string& task_id, const Eigen::MatrixXd& trajectory)
+{
+    OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr task = _stack->getTask(task_id);
+    if(!task)
+    {
+        XBot::Logger::error("Rollout: task %s not found in the stack \n", task_id.c_str());
+        return false;
+    }
+    return setReference(task, trajectory);
+}
+
+void Rollout::clearReferences()
+{
+    _references.clear();
+}
+
+void Rollout::setJointVariable(const AffineHelper& variable)
+{
+    _joint_variable = variable;
+    _use_joint_variable = true;
+}
+
+bool Rollout::run(const Eigen::VectorXd& q0, const Eigen::VectorXd& qdot0, const int steps, Result& result)
+{
+    const int nq = _model.getNq();
+    const int nv = _model.getNv();
+
+    if(steps < 0 || q0.size() != nq || (qdot0.size() != 0 && qdot0.size() != nv))
+    {
+        XBot::Logger::error("Rollout: wrong initial state or number of steps \n");
+        return false;
+    }
+    for(const auto& reference : _references)
+    {
+        if(reference.trajectory.rows() != 1 && reference.trajectory.rows() < steps)
+        {
+            XBot::Logger::error("Rollout: reference trajectory has %i rows, %i needed \n",
+                                int(reference.trajectory.rows()), steps);
+            return false;
+        }
+    }
+    if(_use_joint_variable && _joint_variable.getOutputSize() != nv)
+    {
+        XBot::Logger::error("Rollout: joint variable has size %i, should be %i \n", _joint_variable.getOutputSize(), nv);
+        return false;
+    }
+
+    _q = q0;
+    if(qdot0.size() == nv)
+        _qdot = qdot0;
+    else
+        _qdot.setZero(nv);
+    _joint.setZero(nv);
+
+    result.q.resize(steps + 1, nq);
+    result.qdot.resize(steps + 1, nv);
+    result.success.resize(steps);
+    result.solve_time.resize(steps);
+    result.solutions.setZero(steps, _stack->getStack().front()->getXSize());
+
+    result.q.row(0) = _q.transpose();
+    result.qdot.row(0) = _qdot.transpose();
+
+    for(int k = 0; k < steps; ++k)
+    {
+        _model.setJointPosition(_q);
+        if(_integration == Integration::ACCELERATION)
+            _model.setJointVelocity(_qdot);
+        _model.update();
+
+        for(const auto& reference : _references)
+        {
+            _ref = reference.trajectory.row(std::min<int>(k, reference.trajectory.rows() - 1)).transpose();
+            reference.set(_ref);
+        }
+
+        _stack->update();
+
+        auto tic = std::chrono::steady_clock::now();
+        bool success = _solver->solve(_x);
+        result.solve_time[k] = std::chrono::duration<double>(std::chrono::steady_clock::now() - tic).count();
+        result.success[k] = success;
+
+        if(_x.size() == result.solutions.cols())
+            result.solutions.row(k) = _x.transpose();
+
+        if(!success || _x.size() != result.solutions.cols() || (!_use_joint_variable && _x.size() < nv))
+            _joint.setZero();
+        else if(_use_joint_variable)
+            _joint_variable.getValue(_x, _joint);
+        else
+            _joint = _x.head(nv);
+
+        switch(_integration)
+        {
+        case Integration::DISPLACEMENT:
+            _qdot = _joint/_dt;
+            _q = _model.sum(_q, _joint);
+            break;
+        case Integration::VELOCITY:
+            _qdot = _joint;
+            _q = _model.sum(_q, _joint*_dt);
+            break;
+        case Integration::ACCELERATION:
+            // explicit: q uses the qdot of the beginning of the cycle
+            _q = _model.sum(_q, _qdot*_dt + 0.5*_joint*_dt*_dt);
+            _qdot += _joint*_dt;
+            break;
+        }
+
+        result.q.row(k+1) = _q.transpose();
+        result.qdot.row(k+1) = _qdot.transpose();
+    }
+
+    _model.setJointPosition(_q);
+    if(_integration == Integration::ACCELERATION)
+        _model.setJointVelocity(_qdot);
+    _model.update();
+
+    return true;
+}
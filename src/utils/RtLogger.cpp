@@ -0,0 +1,414 @@
+#include <OpenSoT/utils/RtLogger.h>
+#include <xbot2_interface/logger.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace OpenSoT::utils;
+
+namespace {
+
+const std::size_t QUEUE_SIZE = 128;
+const int MAX_THREADS = 64;
+const int PREALLOCATED_QUEUES = 4;
+const std::size_t PRINT_BUFFER_SIZE = 1024;
+
+/**
+ * @brief The Queue struct is a single-producer/single-consumer ring of messages
+ */
+struct Queue{
+    RtLogger::Message messages[QUEUE_SIZE];
+    std::atomic<std::size_t> head{0};
+    std::atomic<std::size_t> tail{0};
+};
+
+/**
+ * @brief The Slot struct owns a queue, used by at most one thread at a time.
+ * The queue is kept when the thread exits and reused by the next thread
+ */
+struct Slot{
+    std::unique_ptr<Queue> queue;
+    std::atomic<bool> used{false};
+};
+
+std::array<Slot, MAX_THREADS> slots;
+std::atomic<int> slots_size{0};
+std::mutex slots_mutex;
+
+/**
+ * @brief The ThreadSlot struct releases the slot of a thread when it exits
+ */
+struct ThreadSlot{
+    Queue* queue = nullptr;
+    int index = -1;
+
+    ~ThreadSlot()
+    {
+        if(index >= 0)
+            slots[index].used.store(false, std::memory_order_release);
+    }
+};
+
+thread_local ThreadSlot thread_slot;
+
+/**
+ * @brief acquireSlot assigns a free allocated queue to the calling thread, without locking nor allocating
+ */
+bool acquireSlot()
+{
+    const int size = slots_size.load(std::memory_order_acquire);
+    for(int i = 0; i < size; ++i)
+    {
+        bool used = false;
+        if(slots[i].used.compare_exchange_strong(used, true, std::memory_order_acq_rel))
+        {
+            thread_slot.queue = slots[i].queue.get();
+            thread_slot.index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief allocateSlot allocates a new free queue, slots_mutex has to be locked
+ */
+bool allocateSlot()
+{
+    const int size = slots_size.load();
+    if(size >= MAX_THREADS)
+        return false;
+
+    slots[size].queue.reset(new Queue());
+    slots_size.store(size + 1, std::memory_order_release);
+    return true;
+}
+
+std::atomic<bool> rt_mode{false};
+std::atomic<std::uint64_t> dropped{0};
+
+std::thread logger_thread;
+std::mutex thread_mutex;
+std::condition_variable thread_condition;
+bool running = false;
+
+std::mutex print_mutex;
+RtLogger::OnPrintCallback on_print;
+
+std::mutex consume_mutex;
+
+void print(const RtLogger::Message& message)
+{
+    char buffer[PRINT_BUFFER_SIZE];
+    RtLogger::format(message, buffer, PRINT_BUFFER_SIZE);
+
+    std::lock_guard<std::mutex> lock(print_mutex);
+    if(on_print)
+    {
+        on_print(buffer, message.level);
+        return;
+    }
+
+    switch(message.level)
+    {
+    case RtLogger::Level::INFO: XBot::Logger::info("%s", buffer); break;
+    case RtLogger::Level::WARNING: XBot::Logger::warning("%s", buffer); break;
+    case RtLogger::Level::ERROR: XBot::Logger::error("%s", buffer); break;
+    case RtLogger::Level::SUCCESS: XBot::Logger::success("%s", buffer); break;
+    }
+}
+
+void consume()
+{
+    std::lock_guard<std::mutex> lock(consume_mutex);
+
+    const int size = slots_size.load(std::memory_order_acquire);
+    for(int i = 0; i < size; ++i)
+    {
+        Queue* queue = slots[i].queue.get();
+        const std::size_t head = queue->head.load(std::memory_order_acquire);
+        std::size_t tail = queue->tail.load(std::memory_order_relaxed);
+        for(; tail != head; ++tail)
+            print(queue->messages[tail % QUEUE_SIZE]);
+        queue->tail.store(tail, std::memory_order_release);
+    }
+}
+
+void run()
+{
+    std::uint64_t reported_dropped = dropped.load();
+
+    std::unique_lock<std::mutex> lock(thread_mutex);
+    while(!thread_condition.wait_for(lock, std::chrono::milliseconds(1), []{ return !running; }))
+    {
+        consume();
+
+        const std::uint64_t d = dropped.load();
+        if(d != reported_dropped)
+        {
+            XBot::Logger::warning("RtLogger: %lu messages dropped \n", d - reported_dropped);
+            reported_dropped = d;
+        }
+    }
+    consume();
+}
+
+/**
+ * @brief formatArgument writes a single argument with its conversion specification
+ */
+int formatArgument(const std::string& spec, const std::string& length, const RtLogger::Argument& a,
+                   const char* strings, char* buffer, const std::size_t size)
+{
+    const char conversion = spec.back();
+
+    long long integer = 0;
+    unsigned long long unsigned_integer = 0;
+    double floating = 0.;
+    switch(a.type)
+    {
+    case RtLogger::Argument::Type::INTEGER:
+        integer = a.integer; unsigned_integer = a.integer; floating = a.integer; break;
+    case RtLogger::Argument::Type::UNSIGNED:
+        integer = a.unsigned_integer; unsigned_integer = a.unsigned_integer; floating = a.unsigned_integer; break;
+    case RtLogger::Argument::Type::DOUBLE:
+        integer = a.floating; unsigned_integer = a.floating; floating = a.floating; break;
+    default:
+        break;
+    }
+
+    switch(conversion)
+    {
+    case 'd': case 'i':
+        if(length == "ll" || length == "j")
+            return std::snprintf(buffer, size, spec.c_str(), integer);
+        if(length == "l" || length == "z" || length == "t")
+            return std::snprintf(buffer, size, spec.c_str(), static_cast<long>(integer));
+        return std::snprintf(buffer, size, spec.c_str(), static_cast<int>(integer));
+    case 'u': case 'o': case 'x': case 'X':
+        if(length == "ll" || length == "j")
+            return std::snprintf(buffer, size, spec.c_str(), unsigned_integer);
+        if(length == "l" || length == "z" || length == "t")
+            return std::snprintf(buffer, size, spec.c_str(), static_cast<unsigned long>(unsigned_integer));
+        return std::snprintf(buffer, size, spec.c_str(), static_cast<unsigned int>(unsigned_integer));
+    case 'c':
+        return std::snprintf(buffer, size, spec.c_str(), static_cast<int>(integer));
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        if(length == "L")
+            return std::snprintf(buffer, size, spec.c_str(), static_cast<long double>(floating));
+        return std::snprintf(buffer, size, spec.c_str(), floating);
+    case 's':
+        if(a.type == RtLogger::Argument::Type::STRING)
+            return std::snprintf(buffer, size, spec.c_str(), strings + a.string_offset);
+        return std::snprintf(buffer, size, "%s", spec.c_str());
+    case 'p':
+        if(a.type == RtLogger::Argument::Type::POINTER)
+            return std::snprintf(buffer, size, spec.c_str(), a.pointer);
+        return std::snprintf(buffer, size, "%s", spec.c_str());
+    default:
+        return std::snprintf(buffer, size, "%s", spec.c_str());
+    }
+}
+
+}
+
+void RtLogger::push(Message& message, const char* value)
+{
+    if(!value)
+        value = "(null)";
+
+    Argument& a = message.arguments[message.arguments_size++];
+    a.type = Argument::Type::STRING;
+    a.string_offset = message.strings_size;
+
+    // strings are truncated when the storage is full, the last character is always a terminator
+    const std::size_t n = strnlen(value, STRING_STORAGE - 1 - message.strings_size);
+    std::memcpy(message.strings + message.strings_size, value, n);
+    message.strings[message.strings_size + n] = '\0';
+    message.strings_size = std::min<std::size_t>(message.strings_size + n + 1, STRING_STORAGE - 1);
+}
+
+void RtLogger::push(Message& message, const void* value)
+{
+    Argument& a = message.arguments[message.arguments_size++];
+    a.type = Argument::Type::POINTER;
+    a.pointer = value;
+}
+
+RtLogger::Message* RtLogger::reserve()
+{
+    if(!rt_mode.load(std::memory_order_relaxed))
+        return nullptr;
+
+    // not registered threads only take a free queue, they never allocate
+    if(!thread_slot.queue && !acquireSlot())
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Queue* queue = thread_slot.queue;
+    const std::size_t head = queue->head.load(std::memory_order_relaxed);
+    if(head - queue->tail.load(std::memory_order_acquire) >= QUEUE_SIZE)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    return &queue->messages[head % QUEUE_SIZE];
+}
+
+void RtLogger::commit()
+{
+    thread_slot.queue->head.fetch_add(1, std::memory_order_release);
+}
+
+void RtLogger::print(const Message& message)
+{
+    ::print(message);
+}
+
+int RtLogger::format(const Message& message, char* buffer, const std::size_t size)
+{
+    std::size_t written = 0;
+    int argument = 0;
+
+    auto append = [&](const int n){
+        if(n > 0)
+            written = std::min(written + n, size > 0 ? size - 1 : 0);
+    };
+
+    const char* c = message.fmt;
+    while(*c && written + 1 < size)
+    {
+        if(*c != '%')
+        {
+            buffer[written++] = *c++;
+            continue;
+        }
+
+        if(c[1] == '%')
+        {
+            buffer[written++] = '%';
+            c += 2;
+            continue;
+        }
+
+        // conversion specification: %[flags][width][.precision][length]conversion
+        const char* begin = c++;
+        while(*c && std::strchr("-+ #0", *c)) c++;
+        while(*c && std::strchr("0123456789.", *c)) c++;
+        const char* length_begin = c;
+        while(*c && std::strchr("hljztL", *c)) c++;
+        const std::string length(length_begin, c);
+        if(*c)
+            c++;
+        const std::string spec(begin, c);
+
+        if(argument < message.arguments_size)
+            append(formatArgument(spec, length, message.arguments[argument++], message.strings,
+                                  buffer + written, size - written));
+        else
+            append(std::snprintf(buffer + written, size - written, "%s", spec.c_str()));
+    }
+
+    if(size > 0)
+        buffer[std::min(written, size - 1)] = '\0';
+    return written;
+}
+
+void RtLogger::setRtMode(const bool flag)
+{
+    std::lock_guard<std::mutex> lock(slots_mutex);
+
+    if(flag && !rt_mode)
+    {
+        while(slots_size.load() < PREALLOCATED_QUEUES && allocateSlot());
+
+        {
+            std::lock_guard<std::mutex> thread_lock(thread_mutex);
+            running = true;
+        }
+        logger_thread = std::thread(run);
+        rt_mode = true;
+    }
+    else if(!flag && rt_mode)
+    {
+        rt_mode = false;
+        {
+            std::lock_guard<std::mutex> thread_lock(thread_mutex);
+            running = false;
+        }
+        thread_condition.notify_one();
+        logger_thread.join();
+    }
+}
+
+bool RtLogger::isRtMode()
+{
+    return rt_mode.load(std::memory_order_relaxed);
+}
+
+bool RtLogger::registerThread()
+{
+    if(thread_slot.queue)
+        return true;
+
+    std::lock_guard<std::mutex> lock(slots_mutex);
+
+    while(!acquireSlot())
+    {
+        if(!allocateSlot())
+            return false;
+    }
+    return true;
+}
+
+void RtLogger::flush()
+{
+    while(isRtMode())
+    {
+        bool empty = true;
+        const int size = slots_size.load(std::memory_order_acquire);
+        for(int i = 0; i < size; ++i)
+        {
+            Queue* queue = slots[i].queue.get();
+            empty = empty && queue->head.load() == queue->tail.load();
+        }
+        if(empty)
+            return;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // messages committed after the real-time mode was disabled
+    consume();
+}
+
+std::uint64_t RtLogger::getDroppedMessages()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+void RtLogger::setOnPrintCallback(OnPrintCallback f)
+{
+    std::lock_guard<std::mutex> lock(print_mutex);
+    on_print = f;
+}
+
+namespace {
+
+/**
+ * @brief The ExitGuard struct stops the background thread at exit, printing the queued messages.
+ * It is destroyed before the other static objects of this file
+ */
+struct ExitGuard{
+    ~ExitGuard(){ RtLogger::setRtMode(false); }
+};
+
+ExitGuard exit_guard;
+
+}
@@ -18,23 +18,23 @@
 */
 
 #include <OpenSoT/utils/convex_hull_utils.h>
-#include <pcl/surface/convex_hull.h>
 #include <xbot2_interface/logger.h>
 
-#if PCL_MAJOR_VERSION == 1 && PCL_MINOR_VERSION >= 11
-#include <memory>
-#define make_shared std::make_shared
-#else
-#include <boost/make_shared.hpp>
-#define make_shared boost::make_shared
-#endif
-
-convex_hull::convex_hull():
-    _ransac_distance_thr(0.001)
+namespace
 {
-    _pointCloud = make_shared< pcl::PointCloud<pcl::PointXYZ> >();
-    _projectedPointCloud = make_shared< pcl::PointCloud<pcl::PointXYZ> >();
+    /**
+     * @brief cross z component of (a - o) x (b - o), positive for a counter-clockwise turn
+     */
+    inline double cross(const Eigen::Vector3d& o, const Eigen::Vector3d& a, const Eigen::Vector3d& b)
+    {
+        return (a.x() - o.x())*(b.y() - o.y()) - (a.y() - o.y())*(b.x() - o.x());
+    }
 
+    const double EPS = 1e-12;
+}
+
+convex_hull::convex_hull()
+{
     world_T_CoM.setIdentity();
 }
 
@@ -46,97 +46,77 @@ convex_hull::~convex_hull()
 bool convex_hull::getConvexHull(const std::list<Eigen::Vector3d>& points,
                                       std::vector<Eigen::Vector3d>& convex_hull)
 {
-    _pointCloud->clear();
-    for(auto point = points.begin(); point != points.end(); point++)
+    if(points.size() > MAX_POINTS)
     {
-        _tmp_pcl.x = point->x();
-        _tmp_pcl.y = point->y();
-        _tmp_pcl.z = point->z();
-        _pointCloud->push_back(_tmp_pcl);
+        XBot::Logger::error("Error: too many points for convex hull computation (%i > %i)! \n",
+                            int(points.size()), MAX_POINTS);
+        return false;
     }
 
-    //Filtering
-    projectPCL2Plane(_pointCloud, _ransac_distance_thr, _projectedPointCloud);
+    int n = 0;
+    for(const auto& point : points)
+        _points[n++] = point;
 
+    const int m = getConvexHullIndices(_points.data(), n, _indices);
+    if(m == 0)
+    {
+        XBot::Logger::error("Error: degenerate convex hull! \n");
+        return false;
+    }
 
-    pointsInConvexHull.clear();
-    indicesOfVertexes.clear();
+    convex_hull.resize(m);
+    for(int j = 0; j < m; ++j)
+        convex_hull[j] << _points[_indices[j]].x(), _points[_indices[j]].y(), 0.0;
 
-    // hullVertices.vertices is the list of vertices...
-    // by taking each point and the consequent in the list
-    // (i.e. vertices[1]-vertices[0] it is possible to compute
-    // bounding segments for the hull
-    huller.setInputCloud (_projectedPointCloud);
-    huller.reconstruct(pointsInConvexHull, indicesOfVertexes);
-    if(indicesOfVertexes.size() != 1)
-        XBot::Logger::error("Error: more than one polygon found! \n");
+    return true;
+}
 
-    //printIndexAndPointsInfo(pointsInConvexHull, indicesOfVertexes);
+int convex_hull::getConvexHullIndices(const Eigen::Vector3d* points, const int n,
+                                      std::array<int, MAX_POINTS>& indices)
+{
+    if(n < 3 || n > MAX_POINTS)
+        return 0;
 
-    const pcl::Vertices& vs = indicesOfVertexes[0];
-    convex_hull.clear();
-    for(unsigned int j = 0; j < vs.vertices.size(); ++j)
+    // sort lexicographically by (x, y), insertion sort is fine for few points
+    for(int i = 0; i < n; ++i)
     {
-        _tmp_pcl = pointsInConvexHull.at(vs.vertices[j]);
-        _tmp_vector.x() = _tmp_pcl.x;
-        _tmp_vector.y() = _tmp_pcl.y;
-        _tmp_vector.z() = _tmp_pcl.z;
-        convex_hull.push_back(_tmp_vector);
+        int j = i;
+        while(j > 0 && (points[_order[j-1]].x() > points[i].x() ||
+                        (points[_order[j-1]].x() == points[i].x() && points[_order[j-1]].y() > points[i].y())))
+        {
+            _order[j] = _order[j-1];
+            j--;
+        }
+        _order[j] = i;
     }
 
-    _pointCloud->clear();
-    _projectedPointCloud->clear();
+    // lower hull
+    int k = 0;
+    for(int i = 0; i < n; ++i)
+    {
+        while(k >= 2 && cross(points[_chain[k-2]], points[_chain[k-1]], points[_order[i]]) <= EPS)
+            k--;
+        _chain[k++] = _order[i];
+    }
 
-    return true;
-}
+    // upper hull
+    const int lower_size = k + 1;
+    for(int i = n - 2; i >= 0; --i)
+    {
+        while(k >= lower_size && cross(points[_chain[k-2]], points[_chain[k-1]], points[_order[i]]) <= EPS)
+            k--;
+        _chain[k++] = _order[i];
+    }
 
+    // last point is equal to the first one
+    k--;
+    if(k < 3)
+        return 0;
 
-void convex_hull::projectPCL2Plane(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr cloud, const double ransac_distance_thr,
-                                   pcl::PointCloud<pcl::PointXYZ>::Ptr projected_point_cloud)
-{
-    pcl::ModelCoefficients::Ptr coefficients = make_shared<pcl::ModelCoefficients>();
-
-    //We projects ALL the points in the plane (0 0 1)
-    coefficients->values.clear();
-    coefficients->values.resize(4, 0.0);
-    coefficients->values[0] = 0.0;
-    coefficients->values[1] = 0.0;
-    coefficients->values[2] = 1.0;
-    coefficients->values[3] = 0.0;
-
-//    pcl::PointIndices::Ptr inliers (new pcl::PointIndices);
-//    // Create the segmentation object
-//    pcl::SACSegmentation<pcl::PointXYZ> seg;
-//    // Optional
-//    seg.setOptimizeCoefficients (true);
-//    // Mandatory
-//    seg.setModelType (pcl::SACMODEL_PLANE);
-//    seg.setMethodType (pcl::SAC_RANSAC);
-//    seg.setDistanceThreshold (ransac_distance_thr);
-//    seg.setInputCloud (cloud);
-//    seg.segment (*inliers, *coefficients);
-
-
-
-    proj.setModelType (pcl::SACMODEL_PLANE);
-    proj.setInputCloud (cloud);
-    proj.setModelCoefficients (coefficients);
-    proj.filter (*projected_point_cloud);
-}
+    for(int i = 0; i < k; ++i)
+        indices[i] = _chain[i];
 
-void convex_hull::printIndexAndPointsInfo(const pcl::PointCloud<pcl::PointXYZ>& pointsInConvexHull, const std::vector<pcl::Vertices>& indicesOfVertexes)
-{
-    XBot::Logger::info("Indices of vertex has size %i\n", indicesOfVertexes.size());
-    for(unsigned int i = 0; i < indicesOfVertexes.size(); ++i){
-        pcl::Vertices vertices = indicesOfVertexes[i];
-        for(unsigned int ii = 0; ii < vertices.vertices.size(); ++ii)
-            XBot::Logger::info("vertex %i [%f, %f, %f] has index %i \n",
-                               ii,
-                               pointsInConvexHull.at(vertices.vertices[ii]).x,
-                               pointsInConvexHull.at(vertices.vertices[ii]).y,
-                               pointsInConvexHull.at(vertices.vertices[ii]).z,
-                               vertices.vertices[ii]);
-    }
+    return k;
 }
 
 bool convex_hull::getSupportPolygonPoints(std::list<Eigen::Vector3d>& points,
@@ -0,0 +1,65 @@
+#ifndef __TESTS_MALLOC_COUNTER_H__
+#define __TESTS_MALLOC_COUNTER_H__
+
+#include <cstddef>
+#include <cstdlib>
+
+/**
+ * MallocCounter counts the heap allocations made by the current thread while it is alive.
+ * Eigen allocates with malloc() and operator new calls malloc(), hence malloc(), calloc() and realloc()
+ * of the test executable are replaced by functions which count the calls and forward them to glibc.
+ * NOTE: include this header in a single translation unit of the test executable
+ */
+
+extern "C"
+{
+void* __libc_malloc(std::size_t size);
+void* __libc_calloc(std::size_t n, std::size_t size);
+void* __libc_realloc(void* ptr, std::size_t size);
+}
+
+namespace {
+
+thread_local bool malloc_counter_active = false;
+thread_local int malloc_counter_calls = 0;
+
+class MallocCounter
+{
+public:
+    MallocCounter() { malloc_counter_calls = 0; malloc_counter_active = true; }
+    ~MallocCounter() { malloc_counter_active = false; }
+
+    /**
+     * @brief calls
+     * @return the number of allocations since the counter was created
+     */
+    int calls() const { return malloc_counter_calls; }
+};
+
+}
+
+extern "C"
+{
+void* malloc(std::size_t size)
+{
+    if(malloc_counter_active)
+        ++malloc_counter_calls;
+    return __libc_malloc(size);
+}
+
+void* calloc(std::size_t n, std::size_t size)
+{
+    if(malloc_counter_active)
+        ++malloc_counter_calls;
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, std::size_t size)
+{
+    if(malloc_counter_active)
+        ++malloc_counter_calls;
+    return __libc_realloc(ptr, size);
+}
+}
+
+#endif
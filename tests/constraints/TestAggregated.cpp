@@ -131,10 +131,66 @@ TEST_F(testAggregated, UnilateralToBilateralWorks) {
 
 }
 
-/**
- * @todo implement
- */
+class RandomConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
+public:
+    RandomConstraint(const std::string& id, const int x_size, const int rows,
+                     bool equality, bool upper, bool lower):
+        Constraint(id, x_size)
+    {
+        if(equality) {
+            _Aeq.setRandom(rows, x_size);
+            _beq.setRandom(rows);
+        }
+        if(upper || lower)
+            _Aineq.setRandom(rows, x_size);
+        if(upper)
+            _bUpperBound.setRandom(rows);
+        if(lower)
+            _bLowerBound.setRandom(rows);
+    }
+
+    void update() {}
+};
+
 TEST_F(testAggregated, EqualityToInequalityWorks) {
+    using namespace OpenSoT::constraints;
+    const int x_size = 4;
+
+    auto eq = std::make_shared<RandomConstraint>("eq", x_size, 2, true, false, false);
+    auto upper = std::make_shared<RandomConstraint>("upper", x_size, 3, false, true, false);
+    auto lower = std::make_shared<RandomConstraint>("lower", x_size, 2, false, false, true);
+    std::list<Aggregated::ConstraintPtr> constraints = {eq, upper, lower};
+
+    /* unilateral: Aeq x <= beq, -Aeq x <= -beq, Aineq x <= bu, -Aineq x <= -bl */
+    Aggregated unilateral(constraints, x_size, Aggregated::EQUALITIES_TO_INEQUALITIES);
+    unilateral.update();
+    ASSERT_EQ(unilateral.getAeq().rows(), 0);
+    ASSERT_EQ(unilateral.getAineq().rows(), 2*2 + 3 + 2);
+    ASSERT_EQ(unilateral.getbUpperBound().size(), unilateral.getAineq().rows());
+    EXPECT_EQ(unilateral.getbLowerBound().size(), 0);
+    EXPECT_TRUE(unilateral.getAineq().topRows(2).isApprox(eq->getAeq()));
+    EXPECT_TRUE(unilateral.getAineq().middleRows(2, 2).isApprox(-eq->getAeq()));
+    EXPECT_TRUE(unilateral.getbUpperBound().segment(2, 2).isApprox(-eq->getbeq()));
+    EXPECT_TRUE(unilateral.getAineq().middleRows(4, 3).isApprox(upper->getAineq()));
+    EXPECT_TRUE(unilateral.getAineq().bottomRows(2).isApprox(-lower->getAineq()));
+    EXPECT_TRUE(unilateral.getbUpperBound().tail(2).isApprox(-lower->getbLowerBound()));
+
+    /* bilateral: beq <= Aeq x <= beq, missing bounds are set to infinity */
+    Aggregated bilateral(constraints, x_size,
+                         Aggregated::EQUALITIES_TO_INEQUALITIES | Aggregated::UNILATERAL_TO_BILATERAL);
+    bilateral.update();
+    ASSERT_EQ(bilateral.getAineq().rows(), 2 + 3 + 2);
+    ASSERT_EQ(bilateral.getbLowerBound().size(), bilateral.getAineq().rows());
+    EXPECT_TRUE(bilateral.getbUpperBound().head(2).isApprox(eq->getbeq()));
+    EXPECT_TRUE(bilateral.getbLowerBound().head(2).isApprox(eq->getbeq()));
+    EXPECT_TRUE((bilateral.getbLowerBound().segment(2, 3).array() == -std::numeric_limits<double>::max()).all());
+    EXPECT_TRUE((bilateral.getbUpperBound().tail(2).array() == std::numeric_limits<double>::infinity()).all());
+    EXPECT_TRUE(bilateral.getbLowerBound().tail(2).isApprox(lower->getbLowerBound()));
+
+    /* updating with unchanged sizes keeps the same storage */
+    const double* data = bilateral.getAineq().data();
+    bilateral.update();
+    EXPECT_EQ(data, bilateral.getAineq().data());
 }
 
 TEST_F(testAggregated, MultipleAggregationdWork) {
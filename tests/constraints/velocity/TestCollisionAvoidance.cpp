@@ -3,6 +3,7 @@
 #include <OpenSoT/constraints/velocity/VelocityLimits.h>
 #include <OpenSoT/constraints/velocity/CartesianPositionConstraint.h>
 #include <OpenSoT/constraints/velocity/CollisionAvoidance.h>
+#include <OpenSoT/tasks/velocity/CollisionAvoidance.h>
 #include <OpenSoT/tasks/velocity/Cartesian.h>
 #include <OpenSoT/tasks/velocity/Postural.h>
 #include <OpenSoT/solvers/iHQP.h>
@@ -1194,6 +1195,69 @@ TEST_F(testSelfCollisionAvoidanceConstraint, testChangeWhitelistOnline){
 
 }
 
+TEST_F(testSelfCollisionAvoidanceConstraint, testSharedWithTask){
+
+    this->q = getGoodInitialPosition(this->_model_ptr);
+    this->_model_ptr->setJointPosition(this->q);
+    this->_model_ptr->update();
+
+    // large threshold so that some pairs are "in collision" for the task
+    this->sc_constraint->setLinkPairThreshold(0.1);
+
+    OpenSoT::tasks::velocity::CollisionAvoidance::Ptr sc_task =
+            std::make_shared<OpenSoT::tasks::velocity::CollisionAvoidance>(this->sc_constraint);
+
+    this->sc_constraint->update();
+    Eigen::MatrixXd Aineq = this->sc_constraint->getAineq();
+    Eigen::VectorXd bUpperBound = this->sc_constraint->getbUpperBound();
+    std::vector<double> d;
+    this->sc_constraint->getOrderedDistanceVector(d);
+
+    // the task reuses the distances computed by the constraint
+    sc_task->update();
+    EXPECT_TRUE(Aineq.isApprox(this->sc_constraint->getAineq()));
+    EXPECT_TRUE(bUpperBound.isApprox(this->sc_constraint->getbUpperBound()));
+
+    Eigen::VectorXd e;
+    this->sc_constraint->getActivePairsError(e);
+    EXPECT_EQ(e.size(), Aineq.rows());
+    EXPECT_EQ(sc_task->getA().rows(), Aineq.rows());
+
+    int in_collision = 0;
+    for(unsigned int i = 0; i < e.size(); ++i)
+    {
+        if(i < d.size())
+            EXPECT_NEAR(e[i], d[i] - 0.1, 1e-12);
+
+        if(e[i] <= 0.)
+        {
+            EXPECT_TRUE(sc_task->getA().row(i).isApprox(Aineq.row(i)));
+            EXPECT_DOUBLE_EQ(sc_task->getb()[i], e[i]);
+            in_collision++;
+        }
+        else
+        {
+            EXPECT_TRUE(sc_task->getA().row(i).isZero());
+        }
+    }
+    EXPECT_GT(in_collision, 0);
+
+    // a new joint position triggers a new collision computation
+    this->q[this->_model_ptr->getQIndex("LElbj")] = -10.0*M_PI/180.0;
+    this->_model_ptr->setJointPosition(this->q);
+    this->_model_ptr->update();
+
+    sc_task->update();
+    std::vector<double> d2;
+    this->sc_constraint->getOrderedDistanceVector(d2);
+    EXPECT_FALSE(d == d2);
+
+    this->sc_constraint->update();
+    std::vector<double> d3;
+    this->sc_constraint->getOrderedDistanceVector(d3);
+    EXPECT_TRUE(d2 == d3);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
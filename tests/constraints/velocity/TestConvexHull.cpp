@@ -347,6 +347,69 @@ TEST_F(testConvexHull, BoundsAreCorrect) {
 
 }
 
+TEST_F(testConvexHull, checkMonotoneChain) {
+
+    // square with an interior point, a point on an edge and a duplicated vertex
+    std::vector<Eigen::Vector3d> points = {Eigen::Vector3d(0.,0.,0.1), Eigen::Vector3d(1.,0.,0.),
+                                           Eigen::Vector3d(1.,1.,0.), Eigen::Vector3d(0.,1.,0.),
+                                           Eigen::Vector3d(0.5,0.5,0.), Eigen::Vector3d(0.5,0.,0.),
+                                           Eigen::Vector3d(1.,1.,0.)};
+
+    convex_hull huller;
+    std::array<int, convex_hull::MAX_POINTS> indices;
+    ASSERT_EQ(huller.getConvexHullIndices(points.data(), points.size(), indices), 4);
+
+    std::list<Eigen::Vector3d> points_list(points.begin(), points.end());
+    std::vector<Eigen::Vector3d> ch;
+    ASSERT_TRUE(huller.getConvexHull(points_list, ch));
+    ASSERT_EQ(ch.size(), 4);
+
+    // counter-clockwise, projected on z = 0
+    for(unsigned int i = 0; i < ch.size(); ++i)
+    {
+        const Eigen::Vector3d& a = ch[i];
+        const Eigen::Vector3d& b = ch[(i+1)%ch.size()];
+        const Eigen::Vector3d& c = ch[(i+2)%ch.size()];
+        EXPECT_GT((b-a).cross(c-b).z(), 0.);
+        EXPECT_DOUBLE_EQ(a.z(), 0.);
+    }
+
+    // degenerate hull
+    std::vector<Eigen::Vector3d> collinear = {Eigen::Vector3d(0.,0.,0.), Eigen::Vector3d(1.,1.,0.),
+                                              Eigen::Vector3d(2.,2.,0.)};
+    EXPECT_EQ(huller.getConvexHullIndices(collinear.data(), collinear.size(), indices), 0);
+}
+
+TEST_F(testConvexHull, checkContactTolerance) {
+
+    _convexHull->setContactTolerance(1e-3);
+    _convexHull->update();
+
+    std::vector<Eigen::Vector3d> ch;
+    ASSERT_TRUE(_convexHull->getConvexHull(ch));
+
+    std::list<Eigen::Vector3d> points;
+    std::vector<Eigen::Vector3d> ch2;
+    convex_hull huller;
+    huller.getSupportPolygonPoints(points,_links_in_contact,*(_model_ptr.get()),"COM");
+    huller.getConvexHull(points, ch2);
+
+    // cached vertices are evaluated at the current contact positions
+    Eigen::VectorXd q = _model_ptr->getNeutralQ();
+    q[_model_ptr->getQIndex("LAnkLat")] = toRad(0.01);
+    updateModel(q, _model_ptr);
+    _convexHull->update();
+    ASSERT_TRUE(_convexHull->getConvexHull(ch));
+
+    points.clear();
+    huller.getSupportPolygonPoints(points,_links_in_contact,*(_model_ptr.get()),"COM");
+    huller.getConvexHull(points, ch2);
+
+    ASSERT_EQ(ch.size(), ch2.size());
+    for(unsigned int i = 0; i < ch.size(); ++i)
+        EXPECT_TRUE(ch[i].isApprox(ch2[i], 1e-9));
+}
+
 }  // namespace
 
 int main(int argc, char **argv) {
@@ -590,6 +590,89 @@ TEST_F(testGLPKProblem, testMILPProblem)
 
 }
 
+TEST_F(testGLPKProblem, testWarmStart)
+{
+    std::srand(0);
+
+    const int nx = 6, nc = 8;
+    Eigen::VectorXd c = Eigen::VectorXd::Random(nx);
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(nc, nx);
+    Eigen::VectorXd lA = -1e30*Eigen::VectorXd::Ones(nc);
+    Eigen::VectorXd uA = Eigen::VectorXd::Ones(nc);
+    Eigen::VectorXd l = -Eigen::VectorXd::Ones(nx);
+    Eigen::VectorXd u = Eigen::VectorXd::Ones(nx);
+
+    // the same problem is solved as a LP and as a MIP with the first half of the variables integer
+    for(bool mip : {false, true})
+    {
+        OpenSoT::solvers::BackEnd::Ptr warm = OpenSoT::solvers::BackEndFactory(
+                    OpenSoT::solvers::solver_back_ends::GLPK, nx, nc, OpenSoT::HST_ZERO, 0.0);
+        OpenSoT::solvers::BackEnd::Ptr cold = OpenSoT::solvers::BackEndFactory(
+                    OpenSoT::solvers::solver_back_ends::GLPK, nx, nc, OpenSoT::HST_ZERO, 0.0);
+
+        OpenSoT::solvers::GLPKBackEnd::GLPKBackEndOptions opt;
+        if(mip)
+        {
+            for(int i = 0; i < nx/2; ++i)
+                opt.var_id_kind_.push_back(std::pair<int,int>(i, GLP_IV));
+
+            // parameters passed before initProblem() are kept
+            opt.param = std::make_shared<glp_iocp>();
+            glp_init_iocp(opt.param.get());
+            opt.param->tol_int = 1e-7;
+        }
+        warm->setOptions(opt);
+        opt.WARM_START = false;
+        cold->setOptions(opt);
+
+        ASSERT_TRUE(warm->initProblem(Eigen::MatrixXd(0,0), c, A, lA, uA, l, u));
+        ASSERT_TRUE(cold->initProblem(Eigen::MatrixXd(0,0), c, A, lA, uA, l, u));
+        EXPECT_NEAR(warm->getObjective(), cold->getObjective(), 1e-9);
+        if(mip)
+        {
+            auto warm_opt = boost::any_cast<OpenSoT::solvers::GLPKBackEnd::GLPKBackEndOptions>(warm->getOptions());
+            ASSERT_TRUE(bool(warm_opt.param));
+            EXPECT_EQ(warm_opt.param->tol_int, 1e-7);
+        }
+
+        // slowly varying problem as in a control loop: constraint matrix, bounds and cost change
+        int warm_iterations = 0, cold_iterations = 0;
+        for(unsigned int k = 0; k < 100; ++k)
+        {
+            Eigen::MatrixXd Ak = A;
+            Ak.col(k%nx) *= 1. + 0.1*std::sin(0.1*k);
+            Eigen::VectorXd uAk = uA + 0.2*std::cos(0.05*k)*Eigen::VectorXd::Ones(nc);
+            Eigen::VectorXd ck = c + 0.1*std::sin(0.02*k)*Eigen::VectorXd::Ones(nx);
+
+            for(auto& solver : {warm, cold})
+            {
+                ASSERT_TRUE(solver->updateTask(Eigen::MatrixXd(0,0), ck));
+                ASSERT_TRUE(solver->updateConstraints(Ak, lA, uAk));
+                ASSERT_TRUE(solver->solve());
+            }
+            warm_iterations += std::static_pointer_cast<OpenSoT::solvers::GLPKBackEnd>(warm)->getSimplexIterations();
+            cold_iterations += std::static_pointer_cast<OpenSoT::solvers::GLPKBackEnd>(cold)->getSimplexIterations();
+
+            // the optimal MIP solution may be not unique, the LP one is unique for random data
+            if(!mip)
+                EXPECT_NEAR((warm->getSolution() - cold->getSolution()).norm(), 0., 1e-9) << "cycle " << k;
+            EXPECT_NEAR(warm->getObjective(), cold->getObjective(), 1e-9) << "cycle " << k;
+            EXPECT_NEAR(warm->getObjective(), ck.dot(warm->getSolution()), 1e-9);
+            EXPECT_LE((Ak*warm->getSolution() - uAk).maxCoeff(), 1e-9);
+            EXPECT_LE(warm->getSolution().cwiseAbs().maxCoeff(), 1. + 1e-9);
+            if(mip)
+            {
+                const Eigen::VectorXd integers = warm->getSolution().head(nx/2);
+                EXPECT_NEAR((integers - integers.array().round().matrix()).norm(), 0., 1e-6) << "cycle " << k;
+            }
+        }
+
+        // the warm start needs fewer simplex iterations than starting from the standard basis
+        EXPECT_GT(cold_iterations, 0);
+        EXPECT_LT(warm_iterations, cold_iterations);
+    }
+}
+
 }
 
 int main(int argc, char **argv) {
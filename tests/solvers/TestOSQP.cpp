@@ -518,6 +518,67 @@ TEST_F(testOSQPProblem, testContructor2Problems)
 
 }
 
+TEST_F(testOSQPProblem, testSparsity)
+{
+    std::srand(0);
+
+    // two decoupled blocks of variables, as joint accelerations and contact wrenches
+    const int nx = 12, nc = 6;
+    Eigen::MatrixXd M1 = Eigen::MatrixXd::Random(6, 6), M2 = Eigen::MatrixXd::Random(6, 6);
+    Eigen::MatrixXd H(nx, nx);
+    H.setZero();
+    H.topLeftCorner(6, 6) = M1.transpose()*M1 + Eigen::MatrixXd::Identity(6, 6);
+    H.bottomRightCorner(6, 6) = M2.transpose()*M2 + Eigen::MatrixXd::Identity(6, 6);
+    Eigen::VectorXd g = Eigen::VectorXd::Random(nx);
+
+    Eigen::MatrixXd A(nc, nx);
+    A.setZero();
+    A.topLeftCorner(4, 6).setRandom();
+    A.bottomRightCorner(2, 6).setRandom();
+    Eigen::VectorXd lA = -0.5*Eigen::VectorXd::Ones(nc), uA = 0.5*Eigen::VectorXd::Ones(nc);
+    Eigen::VectorXd l = -Eigen::VectorXd::Ones(nx), u = Eigen::VectorXd::Ones(nx);
+
+    OpenSoT::solvers::BackEnd::Ptr osqp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, nx, nc, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr qpoases = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, nx, nc, OpenSoT::HST_POSDEF, 0.);
+
+    EXPECT_FALSE(osqp->setHessianSparsity(Eigen::SparseMatrix<double>(nx, nx+1)));
+
+    ASSERT_TRUE(osqp->initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(qpoases->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_NEAR((osqp->getSolution() - qpoases->getSolution()).norm(), 0., 1e-3);
+
+    // same data: P and A are not passed to OSQP again (see TestOSQPUpdates)
+    Eigen::VectorXd x = osqp->getSolution();
+    ASSERT_TRUE(osqp->solve());
+    EXPECT_NEAR((osqp->getSolution() - x).norm(), 0., 1e-3);
+
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        Eigen::MatrixXd Hk = H;
+        Hk.topLeftCorner(6, 6) *= 1. + 0.2*std::sin(0.1*k);
+        Eigen::MatrixXd Ak = A;
+        Ak.topLeftCorner(4, 6) *= 1. + 0.2*std::cos(0.1*k);
+
+        // from half of the loop the two blocks are coupled: no pattern is given, H and A are dense
+        if(k >= 50)
+        {
+            Hk(0, 6) = Hk(6, 0) = 0.1;
+            Ak(0, 8) = 0.5;
+        }
+
+        for(auto& solver : {osqp, qpoases})
+        {
+            ASSERT_TRUE(solver->updateTask(Hk, g));
+            ASSERT_TRUE(solver->updateConstraints(Ak, lA, uA));
+            ASSERT_TRUE(solver->solve());
+        }
+
+        EXPECT_NEAR((osqp->getSolution() - qpoases->getSolution()).norm(), 0., 1e-3) << "cycle " << k;
+    }
+}
+
 class testiHQP: public TestBase
 {
 protected:
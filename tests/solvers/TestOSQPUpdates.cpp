@@ -0,0 +1,260 @@
+#include <OpenSoT/solvers/OSQPBackEnd.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include <gtest/gtest.h>
+#include "../MallocCounter.h"
+
+namespace {
+
+/**
+ * @brief The CountingOSQPBackEnd class counts the values of P and A passed to OSQP after the setup
+ */
+class CountingOSQPBackEnd: public OpenSoT::solvers::OSQPBackEnd
+{
+public:
+    CountingOSQPBackEnd(const int number_of_variables, const int number_of_constraints):
+        OSQPBackEnd(number_of_variables, number_of_constraints),
+        update_P_calls(0), update_A_calls(0)
+    {
+
+    }
+
+    int update_P_calls;
+    int update_A_calls;
+
+protected:
+    c_int updateP() override
+    {
+        ++update_P_calls;
+        return OSQPBackEnd::updateP();
+    }
+
+    c_int updateA() override
+    {
+        ++update_A_calls;
+        return OSQPBackEnd::updateA();
+    }
+};
+
+}
+
+namespace {
+
+class testOSQPUpdates: public ::testing::Test
+{
+protected:
+
+    testOSQPUpdates():
+        nx(12), nc(6)
+    {
+        std::srand(0);
+
+        // two decoupled blocks of variables, as joint accelerations and contact wrenches
+        Eigen::MatrixXd M1 = Eigen::MatrixXd::Random(6, 6), M2 = Eigen::MatrixXd::Random(6, 6);
+        H.setZero(nx, nx);
+        H.topLeftCorner(6, 6) = M1.transpose()*M1 + Eigen::MatrixXd::Identity(6, 6);
+        H.bottomRightCorner(6, 6) = M2.transpose()*M2 + Eigen::MatrixXd::Identity(6, 6);
+        g = Eigen::VectorXd::Random(nx);
+
+        A.setZero(nc, nx);
+        A.topLeftCorner(4, 6).setRandom();
+        A.bottomRightCorner(2, 6).setRandom();
+        lA = -0.5*Eigen::VectorXd::Ones(nc);
+        uA = 0.5*Eigen::VectorXd::Ones(nc);
+        l = -Eigen::VectorXd::Ones(nx);
+        u = Eigen::VectorXd::Ones(nx);
+    }
+
+    virtual ~testOSQPUpdates() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    const int nx, nc;
+    Eigen::MatrixXd H, A;
+    Eigen::VectorXd g, lA, uA, l, u;
+};
+
+TEST_F(testOSQPUpdates, testSkipUnchangedUpdates)
+{
+    CountingOSQPBackEnd osqp(nx, nc);
+    ASSERT_TRUE(osqp.initProblem(H, g, A, lA, uA, l, u));
+
+    // P and A are passed by the setup
+    EXPECT_EQ(osqp.update_P_calls, 0);
+    EXPECT_EQ(osqp.update_A_calls, 0);
+
+    // same data, or only cost vector and bounds changed: P and A are not passed again
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        ASSERT_TRUE(osqp.updateTask(H, g + 0.1*k*Eigen::VectorXd::Ones(nx)));
+        ASSERT_TRUE(osqp.updateConstraints(A, lA, uA + 0.01*k*Eigen::VectorXd::Ones(nc)));
+        ASSERT_TRUE(osqp.updateBounds(l, u));
+        ASSERT_TRUE(osqp.solve());
+    }
+    EXPECT_EQ(osqp.update_P_calls, 0);
+    EXPECT_EQ(osqp.update_A_calls, 0);
+
+    // only H changes
+    Eigen::MatrixXd H2 = H;
+    H2.topLeftCorner(6, 6) *= 2.;
+    ASSERT_TRUE(osqp.updateTask(H2, g));
+    ASSERT_TRUE(osqp.updateConstraints(A, lA, uA));
+    ASSERT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.update_P_calls, 1);
+    EXPECT_EQ(osqp.update_A_calls, 0);
+
+    // only A changes
+    Eigen::MatrixXd A2 = A;
+    A2.topLeftCorner(4, 6) *= 2.;
+    ASSERT_TRUE(osqp.updateTask(H2, g));
+    ASSERT_TRUE(osqp.updateConstraints(A2, lA, uA));
+    ASSERT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.update_P_calls, 1);
+    EXPECT_EQ(osqp.update_A_calls, 1);
+
+    // nothing changes
+    ASSERT_TRUE(osqp.solve());
+    EXPECT_EQ(osqp.update_P_calls, 1);
+    EXPECT_EQ(osqp.update_A_calls, 1);
+}
+
+TEST_F(testOSQPUpdates, testSparsityPattern)
+{
+    // by default H and A are dense, the pattern is used only if given
+    OpenSoT::solvers::OSQPBackEnd dense(nx, nc);
+    OpenSoT::solvers::OSQPBackEnd sparse(nx, nc);
+
+    EXPECT_FALSE(sparse.setHessianSparsity(Eigen::SparseMatrix<double>(nx, nx+1)));
+    EXPECT_FALSE(sparse.setConstraintsSparsity(Eigen::SparseMatrix<double>(nc+1, nx)));
+    EXPECT_TRUE(sparse.setHessianSparsity(H.sparseView()));
+    EXPECT_TRUE(sparse.setConstraintsSparsity(A.sparseView()));
+
+    ASSERT_TRUE(dense.initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(sparse.initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_NEAR((dense.getSolution() - sparse.getSolution()).norm(), 0., 1e-4);
+
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        Eigen::MatrixXd Hk = H;
+        Hk.topLeftCorner(6, 6) *= 1. + 0.2*std::sin(0.1*k);
+        Eigen::MatrixXd Ak = A;
+        Ak.topLeftCorner(4, 6) *= 1. + 0.2*std::cos(0.1*k);
+
+        for(auto solver : {&dense, &sparse})
+        {
+            ASSERT_TRUE(solver->updateTask(Hk, g));
+            ASSERT_TRUE(solver->updateConstraints(Ak, lA, uA));
+            ASSERT_TRUE(solver->solve());
+        }
+
+        EXPECT_NEAR((dense.getSolution() - sparse.getSolution()).norm(), 0., 1e-4) << "cycle " << k;
+    }
+}
+
+#ifndef NDEBUG
+TEST_F(testOSQPUpdates, testOutOfPattern)
+{
+    OpenSoT::solvers::OSQPBackEnd osqp(nx, nc);
+    EXPECT_TRUE(osqp.setHessianSparsity(H.sparseView()));
+    EXPECT_TRUE(osqp.setConstraintsSparsity(A.sparseView()));
+    ASSERT_TRUE(osqp.initProblem(H, g, A, lA, uA, l, u));
+
+    // entries outside the pattern are reported in debug builds
+    Eigen::MatrixXd H2 = H;
+    H2(0, nx-1) = H2(nx-1, 0) = 0.1;
+    EXPECT_FALSE(osqp.updateTask(H2, g));
+    EXPECT_TRUE(osqp.updateTask(H, g));
+
+    Eigen::MatrixXd A2 = A;
+    A2(0, nx-1) = 1.;
+    EXPECT_FALSE(osqp.updateConstraints(A2, lA, uA));
+    EXPECT_TRUE(osqp.updateConstraints(A, lA, uA));
+}
+#endif
+
+TEST_F(testOSQPUpdates, testiHQPSparsityPattern)
+{
+    // an aggregated of two tasks on decoupled blocks of variables, constrained on the first block
+    Eigen::MatrixXd A1 = Eigen::MatrixXd::Zero(6, nx), A2 = Eigen::MatrixXd::Zero(6, nx);
+    A1.leftCols(6).setRandom();
+    A2.rightCols(6).setRandom();
+    auto t1 = std::make_shared<OpenSoT::tasks::GenericTask>("t1", A1, Eigen::VectorXd::Random(6));
+    auto t2 = std::make_shared<OpenSoT::tasks::GenericTask>("t2", A2, Eigen::VectorXd::Random(6));
+
+    Eigen::MatrixXd Ac = Eigen::MatrixXd::Zero(4, nx);
+    Ac.leftCols(6).setRandom();
+    OpenSoT::AffineHelper var(Ac, Eigen::VectorXd::Zero(4));
+    auto c = std::make_shared<OpenSoT::constraints::GenericConstraint>("c", var,
+                uA.head(4), lA.head(4), OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, l, nx);
+
+    OpenSoT::AutoStack::Ptr stack = std::make_shared<OpenSoT::AutoStack>((t1 + t2) << c);
+    stack << bounds;
+    OpenSoT::solvers::iHQP osqp_solver(*stack, 0., OpenSoT::solvers::solver_back_ends::OSQP);
+    OpenSoT::solvers::iHQP dense_solver(*stack, 0., OpenSoT::solvers::solver_back_ends::eiQuadProg);
+
+    OpenSoT::solvers::BackEnd::Ptr back_end;
+    ASSERT_TRUE(osqp_solver.getBackEnd(0, back_end));
+    auto osqp = std::dynamic_pointer_cast<OpenSoT::solvers::OSQPBackEnd>(back_end);
+    ASSERT_TRUE(bool(osqp));
+
+    // upper triangular part of the two diagonal blocks of H, the constraint on 6 columns and the bounds
+    EXPECT_EQ(osqp->getHessianPattern().nonZeros(), 2*21);
+    EXPECT_EQ(osqp->getConstraintsPattern().nonZeros(), 4*6 + nx);
+
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        A1.leftCols(6) *= 1. + 0.1*std::sin(0.1*k);
+        t1->setA(A1);
+        stack->update();
+
+        Eigen::VectorXd x_osqp, x_dense;
+        ASSERT_TRUE(osqp_solver.solve(x_osqp));
+        ASSERT_TRUE(dense_solver.solve(x_dense));
+        EXPECT_NEAR((x_osqp - x_dense).norm(), 0., 1e-3) << "cycle " << k;
+    }
+}
+
+TEST_F(testOSQPUpdates, testNoMalloc)
+{
+    OpenSoT::solvers::OSQPBackEnd osqp(nx, nc);
+    ASSERT_TRUE(osqp.initProblem(H, g, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        Eigen::MatrixXd Hk = H;
+        Hk.topLeftCorner(6, 6) *= 1. + 0.2*std::sin(0.1*k);
+        Eigen::MatrixXd Ak = A;
+        Ak.topLeftCorner(4, 6) *= 1. + 0.2*std::cos(0.1*k);
+
+        bool success = true;
+        int allocations = 0;
+        {
+            MallocCounter counter;
+            success = osqp.updateTask(Hk, g) && success;
+            success = osqp.updateConstraints(Ak, lA, uA) && success;
+            success = osqp.solve() && success;
+            allocations = counter.calls();
+        }
+
+        EXPECT_TRUE(success);
+        EXPECT_EQ(allocations, 0) << "cycle " << k;
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
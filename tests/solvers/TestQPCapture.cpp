@@ -0,0 +1,216 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/QPCapture.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace{
+
+class testQPCapture: public ::testing::Test{
+public:
+    testQPCapture()
+    {
+        H = Eigen::MatrixXd::Identity(n, n);
+        g.setZero(n);
+
+        A.setZero(m, n);
+        A.row(0).setOnes();
+        A(1,0) = 1.; A(1,1) = -1.;
+        lA.setConstant(m, -0.5);
+        uA.setConstant(m, 0.5);
+
+        l.setConstant(n, -1.);
+        u.setConstant(n, 1.);
+    }
+
+    const int n = 4;
+    const int m = 2;
+
+    Eigen::MatrixXd H;
+    Eigen::VectorXd g;
+    Eigen::MatrixXd A;
+    Eigen::VectorXd lA, uA;
+    Eigen::VectorXd l, u;
+};
+
+TEST_F(testQPCapture, testTrigger)
+{
+    OpenSoT::solvers::QPCapture capture("/tmp/testQPCaptureTrigger.qpc",
+                                        OpenSoT::solvers::QPCapture::Trigger::ALWAYS, 1e-3);
+    EXPECT_TRUE(capture.isOpen());
+
+    EXPECT_TRUE(capture.isTriggered(true, 0.));
+    EXPECT_TRUE(capture.isTriggered(false, 0.));
+
+    capture.setTrigger(OpenSoT::solvers::QPCapture::Trigger::FAILURE);
+    EXPECT_FALSE(capture.isTriggered(true, 1.));
+    EXPECT_TRUE(capture.isTriggered(false, 0.));
+
+    capture.setTrigger(OpenSoT::solvers::QPCapture::Trigger::SLOW_SOLVE);
+    EXPECT_FALSE(capture.isTriggered(false, 1e-4));
+    EXPECT_TRUE(capture.isTriggered(true, 1e-2));
+
+    capture.setTrigger(OpenSoT::solvers::QPCapture::Trigger::SLOW_SOLVE_OR_FAILURE);
+    EXPECT_FALSE(capture.isTriggered(true, 1e-4));
+    EXPECT_TRUE(capture.isTriggered(false, 1e-4));
+    EXPECT_TRUE(capture.isTriggered(true, 1e-2));
+
+    Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+    capture.setTrigger(OpenSoT::solvers::QPCapture::Trigger::FAILURE);
+    EXPECT_TRUE(capture.capture(0, true, 0., H, g, A, lA, uA, l, u, x, x));
+    EXPECT_EQ(capture.getNumberOfCapturedProblems(), 0);
+    EXPECT_TRUE(capture.capture(0, false, 0., H, g, A, lA, uA, l, u, x, x));
+    EXPECT_EQ(capture.getNumberOfCapturedProblems(), 1);
+}
+
+TEST_F(testQPCapture, testCaptureAndReplay)
+{
+    const std::string file_name = "/tmp/testQPCapture.qpc";
+
+    OpenSoT::solvers::BackEnd::Ptr back_end = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::eiQuadProg, n, m, OpenSoT::HST_POSDEF, 0.);
+    EXPECT_TRUE(back_end->initProblem(H, g, A, lA, uA, l, u));
+
+    auto capture = std::make_shared<OpenSoT::solvers::QPCapture>(file_name);
+    back_end->setCapture(capture, 3);
+    EXPECT_EQ(back_end->getCapture(), capture);
+
+    const int problems = 5;
+    std::vector<Eigen::VectorXd> gs, solutions, warm_starts;
+    for(int i = 0; i < problems; ++i)
+    {
+        g.setRandom(n);
+        warm_starts.push_back(back_end->getSolution());
+        EXPECT_TRUE(back_end->updateTask(H, g));
+        EXPECT_TRUE(back_end->solveAndCapture());
+        gs.push_back(g);
+        solutions.push_back(back_end->getSolution());
+    }
+    EXPECT_EQ(capture->getNumberOfCapturedProblems(), problems);
+
+    // a detached capture is not used anymore
+    back_end->setCapture(nullptr);
+    EXPECT_TRUE(back_end->solveAndCapture());
+    EXPECT_EQ(capture->getNumberOfCapturedProblems(), problems);
+
+    capture->flush();
+
+    OpenSoT::solvers::QPCaptureReader reader(file_name);
+    EXPECT_TRUE(reader.isOpen());
+    EXPECT_EQ(reader.size(), problems);
+
+    for(int i = 0; i < problems; ++i)
+    {
+        OpenSoT::solvers::QPCaptureReader::Problem problem = reader.getProblem(i);
+
+        EXPECT_EQ(problem.header->sequence, i+1);
+        EXPECT_EQ(problem.header->id, 3);
+        EXPECT_EQ(problem.header->n, n);
+        EXPECT_EQ(problem.header->m, m);
+        EXPECT_TRUE(problem.header->success);
+        EXPECT_GE(problem.header->solve_time, 0.);
+
+        EXPECT_TRUE(problem.H == H);
+        EXPECT_TRUE(problem.g == gs[i]);
+        EXPECT_TRUE(problem.A == A);
+        EXPECT_TRUE(problem.lA == lA);
+        EXPECT_TRUE(problem.uA == uA);
+        EXPECT_TRUE(problem.l == l);
+        EXPECT_TRUE(problem.u == u);
+        EXPECT_TRUE(problem.warm_start == warm_starts[i]);
+        EXPECT_TRUE(problem.solution == solutions[i]);
+
+        // replay
+        OpenSoT::solvers::BackEnd::Ptr replay = OpenSoT::solvers::BackEndFactory(
+                    OpenSoT::solvers::solver_back_ends::eiQuadProg, n, m, OpenSoT::HST_POSDEF, 0.);
+        EXPECT_TRUE(replay->initProblem(problem.H, problem.g, problem.A, problem.lA, problem.uA, problem.l, problem.u));
+        EXPECT_NEAR((replay->getSolution() - problem.solution).lpNorm<Eigen::Infinity>(), 0., 1e-9);
+    }
+
+    EXPECT_THROW(reader.getProblem(problems), std::out_of_range);
+}
+
+TEST_F(testQPCapture, testArmed)
+{
+    const std::string file_name = "/tmp/testQPCaptureArmed.qpc";
+
+    OpenSoT::solvers::BackEnd::Ptr back_end = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::eiQuadProg, n, m, OpenSoT::HST_POSDEF, 0.);
+    EXPECT_TRUE(back_end->initProblem(H, g, A, lA, uA, l, u));
+
+    auto capture = std::make_shared<OpenSoT::solvers::QPCapture>(file_name);
+    back_end->setCapture(capture);
+    EXPECT_TRUE(capture->isArmed());
+
+    // a disarmed capture writes nothing
+    capture->setArmed(false);
+    EXPECT_FALSE(capture->isArmed());
+    EXPECT_TRUE(back_end->solveAndCapture());
+    EXPECT_TRUE(back_end->solveAndCapture());
+    EXPECT_EQ(capture->getNumberOfCapturedProblems(), 0);
+
+    Eigen::VectorXd warm_start = back_end->getSolution();
+    capture->setArmed(true);
+    g.setRandom(n);
+    EXPECT_TRUE(back_end->updateTask(H, g));
+    EXPECT_TRUE(back_end->solveAndCapture());
+    EXPECT_EQ(capture->getNumberOfCapturedProblems(), 1);
+
+    capture->flush();
+
+    OpenSoT::solvers::QPCaptureReader reader(file_name);
+    ASSERT_EQ(reader.size(), 1);
+
+    // the disarmed solves are counted in the sequence
+    OpenSoT::solvers::QPCaptureReader::Problem problem = reader.getProblem(0);
+    EXPECT_EQ(problem.header->sequence, 3);
+    EXPECT_TRUE(problem.g == g);
+    EXPECT_TRUE(problem.warm_start == warm_start);
+}
+
+TEST_F(testQPCapture, testExportQPS)
+{
+    const std::string file_name = "/tmp/testQPCaptureQPS.qpc";
+
+    l[3] = -std::numeric_limits<double>::infinity();
+    u[3] = std::numeric_limits<double>::infinity();
+    lA[1] = -1e30;
+    g.setOnes(n);
+
+    {
+        OpenSoT::solvers::QPCapture capture(file_name);
+        Eigen::VectorXd x = Eigen::VectorXd::Zero(n);
+        EXPECT_TRUE(capture.capture(0, true, 0., H, g, A, lA, uA, l, u, x, x));
+    }
+
+    OpenSoT::solvers::QPCaptureReader reader(file_name);
+    EXPECT_EQ(reader.size(), 1);
+    EXPECT_TRUE(OpenSoT::solvers::QPCaptureReader::exportQPS(reader.getProblem(0), "/tmp/testQPCapture.qps", "TEST"));
+
+    std::ifstream qps("/tmp/testQPCapture.qps");
+    std::stringstream buffer;
+    buffer << qps.rdbuf();
+    std::string content = buffer.str();
+
+    std::cout << content << std::endl;
+
+    EXPECT_NE(content.find("NAME TEST"), std::string::npos);
+    EXPECT_NE(content.find(" G c0"), std::string::npos);
+    EXPECT_NE(content.find(" L c1"), std::string::npos);
+    EXPECT_NE(content.find(" rng c0 1"), std::string::npos);
+    EXPECT_EQ(content.find(" rng c1"), std::string::npos);
+    EXPECT_NE(content.find(" FR bnd x3"), std::string::npos);
+    EXPECT_NE(content.find(" LO bnd x0 -1"), std::string::npos);
+    EXPECT_NE(content.find(" UP bnd x0 1"), std::string::npos);
+    EXPECT_NE(content.find(" x0 x0 1"), std::string::npos);
+    EXPECT_EQ(content.find(" x1 x0"), std::string::npos);
+    EXPECT_NE(content.find("ENDATA"), std::string::npos);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
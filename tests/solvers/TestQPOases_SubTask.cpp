@@ -4,6 +4,7 @@
 #include <OpenSoT/solvers/iHQP.h>
 #include <OpenSoT/tasks/Aggregated.h>
 #include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/tasks/GenericTask.h>
 #include "DefaultHumanoidStack.h"
 #include <fstream>
 #include <xbot2_interface/xbotinterface2.h>
@@ -62,6 +63,57 @@ Eigen::VectorXd getGoodInitialPosition(XBot::ModelInterface::Ptr _model_ptr) {
 }
 
 
+TEST_F(testQPOases_SubTask, testFatherWeight)
+{
+    std::srand(0);
+
+    // subtask of an overdetermined task: the solution depends on the weight of the father task
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(6, 2);
+    Eigen::VectorXd b = Eigen::VectorXd::Random(6);
+    auto father = std::make_shared<OpenSoT::tasks::GenericTask>("father", A, b);
+    father->setWeight(Eigen::MatrixXd(Eigen::VectorXd::LinSpaced(6, 1., 100.).asDiagonal()));
+
+    std::list<unsigned int> rows = {0, 2, 3, 5};
+    auto sub_task = father%rows;
+    sub_task->update();
+
+    Eigen::MatrixXd As(4, 2);
+    Eigen::VectorXd bs(4);
+    Eigen::VectorXd ws(4);
+    unsigned int k = 0;
+    for(auto r : rows)
+    {
+        As.row(k) = A.row(r);
+        bs[k] = b[r];
+        ws[k] = father->getWeight()(r, r);
+        ++k;
+    }
+    Eigen::VectorXd x_ref = (As.transpose()*ws.asDiagonal()*As).ldlt().solve(As.transpose()*ws.asDiagonal()*bs);
+
+    // the weight has not been selected from the father task yet
+    OpenSoT::solvers::iHQP::Stack stack = {sub_task};
+    OpenSoT::solvers::iHQP sot(stack, 0.);
+    sot.setPerTaskHessian(false);
+
+    Eigen::VectorXd x;
+    sub_task->update();
+    EXPECT_FALSE(sub_task->isWeightIdentity());
+    ASSERT_TRUE(sot.solve(x));
+    EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6);
+
+    // same through an Aggregated
+    auto other = std::make_shared<OpenSoT::tasks::GenericTask>("other", Eigen::MatrixXd::Zero(1, 2), Eigen::VectorXd::Zero(1));
+    OpenSoT::solvers::iHQP::Stack aggregated_stack = {sub_task + other};
+    aggregated_stack.front()->update();
+    OpenSoT::solvers::iHQP sot_aggregated(aggregated_stack, 0.);
+    sot_aggregated.setPerTaskHessian(false);
+
+    aggregated_stack.front()->update();
+    EXPECT_FALSE(aggregated_stack.front()->isWeightIdentity());
+    ASSERT_TRUE(sot_aggregated.solve(x));
+    EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6);
+}
+
 TEST_F(testQPOases_SubTask, testSolveUsingSubTasks)
 {
 
@@ -189,6 +189,78 @@ TEST_F(testSOTH, constrainedVariableLinearSystemOpenSoT)
 }
 
 
+TEST_F(testSOTH, testWarmStartAndWeights)
+{
+    std::srand(0);
+
+    const int nx = 10;
+    Eigen::MatrixXd A1 = Eigen::MatrixXd::Random(4, nx);
+    Eigen::MatrixXd A2 = Eigen::MatrixXd::Random(nx, nx);
+    Eigen::VectorXd b1 = Eigen::VectorXd::Random(4);
+    Eigen::VectorXd b2 = 2.*Eigen::VectorXd::Random(nx);
+
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", A1, b1);
+    auto task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", A2, b2);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds",
+                                                                             0.5*Eigen::VectorXd::Ones(nx),
+                                                                             -0.5*Eigen::VectorXd::Ones(nx),
+                                                                             nx);
+
+    OpenSoT::AutoStack::Ptr stack = (task1 / task2) << bounds;
+    stack->update();
+
+    OpenSoT::solvers::HCOD warm(*stack, 0.);
+    OpenSoT::solvers::HCOD cold(*stack, 0.);
+    EXPECT_TRUE(warm.getActiveSetWarmStart());
+    cold.setActiveSetWarmStart(false);
+    EXPECT_FALSE(cold.getActiveSetWarmStart());
+
+    // the active set changes slowly along the cycles, both solvers reach the same optimum
+    Eigen::VectorXd x_warm, x_cold;
+    for(int k = 0; k < 200; ++k)
+    {
+        Eigen::VectorXd b = b2;
+        b += std::sin(0.05*k)*Eigen::VectorXd::Ones(nx);
+        task2->setb(b);
+        stack->update();
+
+        ASSERT_TRUE(warm.solve(x_warm));
+        ASSERT_TRUE(cold.solve(x_cold));
+        EXPECT_NEAR((x_warm - x_cold).norm(), 0., 1e-6) << "cycle " << k;
+        EXPECT_LE(x_warm.cwiseAbs().maxCoeff(), 0.5 + 1e-6);
+    }
+
+    // a diagonal weight is equivalent to scaling the rows by its square root
+    Eigen::VectorXd w = Eigen::VectorXd::LinSpaced(nx, 1., 10.);
+    task2->setWeight(Eigen::MatrixXd(w.asDiagonal()));
+    task2->setWeightIsDiagonalFlag(true);
+    stack->update();
+    ASSERT_TRUE(warm.solve(x_warm));
+
+    auto task2_scaled = std::make_shared<OpenSoT::tasks::GenericTask>("task2_scaled",
+                                                                       w.cwiseSqrt().asDiagonal()*task2->getA(),
+                                                                       w.cwiseSqrt().asDiagonal()*task2->getb());
+    OpenSoT::AutoStack::Ptr stack_scaled = (task1 / task2_scaled) << bounds;
+    stack_scaled->update();
+    OpenSoT::solvers::HCOD scaled(*stack_scaled, 0.);
+    ASSERT_TRUE(scaled.solve(x_cold));
+    EXPECT_NEAR((x_warm - x_cold).norm(), 0., 1e-6);
+
+    // the same dense weight as W = S*S, S symmetric
+    Eigen::MatrixXd S = Eigen::MatrixXd::Random(nx, nx);
+    S = S*S.transpose() + Eigen::MatrixXd::Identity(nx, nx);
+    task2->setWeight(S*S);
+    task2->setWeightIsDiagonalFlag(false);
+    stack->update();
+    ASSERT_TRUE(warm.solve(x_warm));
+
+    task2_scaled->setA(S*task2->getA());
+    task2_scaled->setb(S*task2->getb());
+    stack_scaled->update();
+    ASSERT_TRUE(scaled.solve(x_cold));
+    EXPECT_NEAR((x_warm - x_cold).norm(), 0., 1e-6);
+}
+
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,165 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include "../MallocCounter.h"
+
+namespace {
+
+class testeHQP: public ::testing::Test
+{
+protected:
+
+    testeHQP():
+        _nx(15)
+    {
+        std::srand(0);
+
+        _A1 = Eigen::MatrixXd::Random(6, _nx);
+        _b1 = Eigen::VectorXd::Random(6);
+        _A2 = Eigen::MatrixXd::Random(5, _nx);
+        _b2 = Eigen::VectorXd::Random(5);
+
+        _task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", _A1, _b1);
+        _task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", _A2, _b2);
+        _task1->update();
+        _task2->update();
+
+        _stack.push_back(_task1);
+        _stack.push_back(_task2);
+    }
+
+    // x = pinv(A1)*b1 + N1*pinv(A2*N1)*(b2 - A2*x1), weights as L'*A and L'*b
+    Eigen::VectorXd reference() const
+    {
+        const Eigen::MatrixXd L1t = _task1->getWeight().llt().matrixU();
+        const Eigen::MatrixXd L2t = _task2->getWeight().llt().matrixU();
+
+        const Eigen::MatrixXd J1 = L1t*_A1;
+        const Eigen::MatrixXd J1pinv = J1.completeOrthogonalDecomposition().pseudoInverse();
+        const Eigen::VectorXd x1 = J1pinv*L1t*_b1;
+        const Eigen::MatrixXd N1 = Eigen::MatrixXd::Identity(_nx, _nx) - J1pinv*J1;
+
+        const Eigen::MatrixXd J2 = L2t*_A2*N1;
+        return x1 + J2.completeOrthogonalDecomposition().pseudoInverse()*L2t*(_b2 - _A2*x1);
+    }
+
+    int _nx;
+    Eigen::MatrixXd _A1, _A2;
+    Eigen::VectorXd _b1, _b2;
+    OpenSoT::tasks::GenericTask::Ptr _task1, _task2;
+    OpenSoT::solvers::eHQP::Stack _stack;
+};
+
+TEST_F(testeHQP, testSolution)
+{
+    OpenSoT::solvers::eHQP solver(_stack);
+
+    Eigen::VectorXd x;
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - reference()).norm(), 0., 1e-9);
+    EXPECT_NEAR((_A1*x - _b1).norm(), 0., 1e-9);
+    EXPECT_NEAR((_A2*x - _b2).norm(), 0., 1e-9);
+}
+
+TEST_F(testeHQP, testWeights)
+{
+    // a conflicting second task, its solution depends on the weight
+    _A2 = Eigen::MatrixXd::Random(10, _nx);
+    _b2 = Eigen::VectorXd::Random(10);
+    _task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", _A2, _b2);
+    _task2->update();
+    _stack[1] = _task2;
+
+    OpenSoT::solvers::eHQP solver(_stack);
+
+    Eigen::VectorXd x;
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - reference()).norm(), 0., 1e-9);
+
+    // diagonal weight
+    Eigen::VectorXd w = Eigen::VectorXd::LinSpaced(10, 1., 10.);
+    _task2->setWeight(Eigen::MatrixXd(w.asDiagonal()));
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - reference()).norm(), 0., 1e-9);
+
+    // dense weight
+    Eigen::MatrixXd R = Eigen::MatrixXd::Random(10, 10);
+    _task2->setWeight(R*R.transpose() + Eigen::MatrixXd::Identity(10, 10));
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - reference()).norm(), 0., 1e-9);
+
+    // back to identity, the cached factorization is dropped
+    _task2->setWeight(1.);
+    Eigen::VectorXd x_identity;
+    EXPECT_TRUE(solver.solve(x_identity));
+    EXPECT_NEAR((x_identity - reference()).norm(), 0., 1e-9);
+
+    // same result solving again with the same data
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_TRUE(x == x_identity);
+}
+
+TEST_F(testeHQP, testRankDeficient)
+{
+    // the third row of the first task is the sum of the first two: rank 2, with a consistent b
+    _A1 = Eigen::MatrixXd::Random(3, _nx);
+    _A1.row(2) = _A1.row(0) + _A1.row(1);
+    _b1 = Eigen::VectorXd::Random(3);
+    _b1[2] = _b1[0] + _b1[1];
+    _task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", _A1, _b1);
+    _task1->update();
+    _stack[0] = _task1;
+
+    // the second task can be solved exactly only in the whole nullspace of the first one (13 directions)
+    _A2 = Eigen::MatrixXd::Random(_nx - 2, _nx);
+    _b2 = Eigen::VectorXd::Random(_nx - 2);
+    _task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", _A2, _b2);
+    _task2->update();
+    _stack[1] = _task2;
+
+    OpenSoT::solvers::eHQP solver(_stack);
+
+    Eigen::VectorXd x;
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - reference()).norm(), 0., 1e-8);
+    EXPECT_NEAR((_A1*x - _b1).norm(), 0., 1e-9);
+    EXPECT_NEAR((_A2*x - _b2).norm(), 0., 1e-8);
+
+    // the previous projector P = I - V*V' used all the thin V, removing also a direction of the nullspace
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(_A1, Eigen::ComputeThinU|Eigen::ComputeThinV);
+    const Eigen::MatrixXd P_old = Eigen::MatrixXd::Identity(_nx, _nx) - svd.matrixV()*svd.matrixV().transpose();
+    const Eigen::VectorXd x1 = _A1.completeOrthogonalDecomposition().solve(_b1);
+    const Eigen::VectorXd x_old = x1 + (_A2*P_old).completeOrthogonalDecomposition().solve(_b2 - _A2*x1);
+    EXPECT_GT((_A2*x_old - _b2).norm(), 1e-3);
+}
+
+TEST_F(testeHQP, testNoMalloc)
+{
+    // a dense weight, factorized by the first solve
+    Eigen::MatrixXd R = Eigen::MatrixXd::Random(5, 5);
+    _task2->setWeight(R*R.transpose() + Eigen::MatrixXd::Identity(5, 5));
+
+    OpenSoT::solvers::eHQP solver(_stack);
+
+    Eigen::VectorXd x;
+    EXPECT_TRUE(solver.solve(x));
+
+    bool success;
+    int allocations;
+    {
+        MallocCounter counter;
+        success = solver.solve(x);
+        allocations = counter.calls();
+    }
+
+    EXPECT_TRUE(success);
+    EXPECT_EQ(allocations, 0);
+    EXPECT_NEAR((x - reference()).norm(), 0., 1e-9);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
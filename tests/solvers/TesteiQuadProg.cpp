@@ -6,9 +6,12 @@
 #include <OpenSoT/constraints/velocity/JointLimits.h>
 #include <OpenSoT/tasks/velocity/Cartesian.h>
 #include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/eiQuadProgBackEnd.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
 #include <OpenSoT/constraints/velocity/VelocityLimits.h>
 #include <eigen_conversions/eigen_kdl.h>
 #include "../common.h"
+#include "../MallocCounter.h"
 
 
 #define GREEN "\033[0;32m"
@@ -133,6 +136,67 @@ TEST_F(testeiQuadProgProblem, testSimpleProblem)
 }
 
 
+TEST_F(testeiQuadProgProblem, testFixedSizeSolver)
+{
+    // 7 DoF problem with joint limits and a 3 rows constraint, as in a small arm IK
+    const int nv = 7;
+    typedef Eigen::QuadProgSolver<nv, 2*nv + 6> FixedSolver;
+
+    Eigen::MatrixXd M = Eigen::MatrixXd::Random(nv + 2, nv);
+    Eigen::MatrixXd H = M.transpose()*M + 1e-3*Eigen::MatrixXd::Identity(nv, nv);
+    Eigen::VectorXd g = 10.*Eigen::VectorXd::Random(nv);
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(3, nv);
+
+    Eigen::MatrixXd CI(nv, 2*nv + 6);
+    CI << Eigen::MatrixXd::Identity(nv, nv), -Eigen::MatrixXd::Identity(nv, nv), A.transpose(), -A.transpose();
+    Eigen::VectorXd ci0 = Eigen::VectorXd::Ones(2*nv + 6);
+    Eigen::MatrixXd CE(nv, 0);
+    Eigen::VectorXd ce0(0);
+
+    Eigen::QuadProgSolver<> dynamic_solver;
+    Eigen::VectorXd x_dynamic;
+    double f_dynamic = dynamic_solver.solve(H, g, CE, ce0, CI, ci0, x_dynamic);
+
+    // every problem data is fixed size: no heap allocations
+    FixedSolver fixed_solver;
+    FixedSolver::MatrixNN H_fixed = H;
+    FixedSolver::VectorN g_fixed = g, x_fixed;
+    Eigen::Matrix<double, nv, Eigen::Dynamic, Eigen::ColMajor, nv, 2*nv + 6> CI_fixed = CI, CE_fixed(nv, 0);
+    FixedSolver::VectorM ci0_fixed = ci0, ce0_fixed(0);
+    double f_fixed;
+    int allocations;
+    {
+        MallocCounter counter;
+        f_fixed = fixed_solver.solve(H_fixed, g_fixed, CE_fixed, ce0_fixed, CI_fixed, ci0_fixed, x_fixed);
+        allocations = counter.calls();
+    }
+    EXPECT_EQ(allocations, 0);
+
+    // G is not modified
+    EXPECT_TRUE(H_fixed == H);
+
+    EXPECT_FALSE(std::isinf(f_dynamic));
+    EXPECT_EQ(f_dynamic, f_fixed);
+    for(unsigned int i = 0; i < nv; ++i)
+        EXPECT_EQ(x_dynamic[i], x_fixed[i]);
+
+    EXPECT_TRUE(((CI.transpose()*x_dynamic + ci0).array() >= -1e-9).all());
+
+    // the solver can be reused
+    g = 10.*Eigen::VectorXd::Random(nv);
+    g_fixed = g;
+    f_dynamic = dynamic_solver.solve(H, g, CE, ce0, CI, ci0, x_dynamic);
+    {
+        MallocCounter counter;
+        f_fixed = fixed_solver.solve(H_fixed, g_fixed, CE_fixed, ce0_fixed, CI_fixed, ci0_fixed, x_fixed);
+        allocations = counter.calls();
+    }
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(f_dynamic, f_fixed);
+    EXPECT_NEAR((x_dynamic - Eigen::VectorXd(x_fixed)).norm(), 0., 1e-12);
+}
+
+
 TEST_F(testeiQuadProgProblem, testTask)
 {
     Eigen::VectorXd q_ref = _model_ptr->getNeutralQ();
@@ -425,6 +489,42 @@ TEST_F(testeiQuadProgProblem, testEpsRegularisation)
                 EXPECT_NEAR(T(i,j), T_ref(i,j), 1E-4);
 }
 
+TEST_F(testeiQuadProgProblem, testSinglePrecision)
+{
+    std::srand(0);
+    const unsigned int rows = 12, cols = 30;
+
+    Eigen::VectorXd l = -Eigen::VectorXd::Ones(cols);
+    Eigen::VectorXd u = Eigen::VectorXd::Ones(cols);
+    Eigen::MatrixXd A(0, cols);
+    Eigen::VectorXd lA(0), uA(0);
+
+    OpenSoT::solvers::BackEnd::Ptr solver_double = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::eiQuadProg, cols, 0, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr solver_float = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::eiQuadProg, cols, 0, OpenSoT::HST_POSDEF, 0.);
+
+    OpenSoT::solvers::eiQuadProgOptions opt;
+    opt.single_precision = true;
+    solver_float->setOptions(opt);
+    EXPECT_TRUE(boost::any_cast<OpenSoT::solvers::eiQuadProgOptions>(solver_float->getOptions()).single_precision);
+
+    for(unsigned int i = 0; i < 100; ++i)
+    {
+        // damped velocity IK: H = J^T J + lambda I, g = -J^T v
+        Eigen::MatrixXd J = Eigen::MatrixXd::Random(rows, cols);
+        Eigen::VectorXd v = Eigen::VectorXd::Random(rows);
+        Eigen::MatrixXd H = J.transpose()*J + 1e-2*Eigen::MatrixXd::Identity(cols, cols);
+        Eigen::VectorXd g = -J.transpose()*v;
+
+        ASSERT_TRUE(solver_double->initProblem(H, g, A, lA, uA, l, u));
+        ASSERT_TRUE(solver_float->initProblem(H, g, A, lA, uA, l, u));
+
+        // millimetre accuracy is enough for velocity IK
+        EXPECT_LE((solver_double->getSolution() - solver_float->getSolution()).cwiseAbs().maxCoeff(), 1e-3);
+    }
+}
+
 TEST_F(testeiQuadProgProblem, testContructor2Problems)
 {
     Eigen::VectorXd q = getGoodInitialPosition(_model_ptr);
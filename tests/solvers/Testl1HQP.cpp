@@ -7,6 +7,7 @@
 #include <OpenSoT/tasks/GenericTask.h>
 #include <OpenSoT/utils/AutoStack.h>
 #include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
 
 #include "../common.h"
 
@@ -175,6 +176,74 @@ TEST_F(testl1HQP, testContructor)
     std::cout<<"solution: "<<solution.transpose()<<std::endl;
 
 }
+
+TEST_F(testl1HQP, testInPlaceUpdate)
+{
+    std::srand(0);
+
+    const int nx = 10;
+    Eigen::MatrixXd A1 = Eigen::MatrixXd::Random(3, nx);
+    Eigen::MatrixXd A2 = Eigen::MatrixXd::Random(nx, nx);
+    Eigen::VectorXd b1 = Eigen::VectorXd::Random(3);
+    Eigen::VectorXd b2 = Eigen::VectorXd::Random(nx);
+
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", A1, b1);
+    auto task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", A2, b2);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds",
+                                                                             Eigen::VectorXd::Ones(nx),
+                                                                             -Eigen::VectorXd::Ones(nx),
+                                                                             nx);
+    auto inequality = std::make_shared<OpenSoT::constraints::GenericConstraint>("inequality",
+                                                                                 OpenSoT::AffineHelper(Eigen::MatrixXd::Random(2, nx), Eigen::VectorXd::Zero(2)),
+                                                                                 Eigen::VectorXd::Ones(2),
+                                                                                 -Eigen::VectorXd::Ones(2),
+                                                                                 OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+
+    OpenSoT::AutoStack::Ptr stack = (task1 / task2) << bounds << inequality;
+
+    // OSQP is warm-started by the in place solver while the reference is solved from scratch
+    std::vector<std::pair<OpenSoT::solvers::solver_back_ends, double>> back_ends =
+        {{OpenSoT::solvers::solver_back_ends::qpOASES, 1e-9},
+         {OpenSoT::solvers::solver_back_ends::OSQP, 1e-3}};
+
+    for(const auto& be : back_ends)
+    {
+        task1->setA(A1);
+        task2->setb(b2);
+        task2->setWeight(1.);
+        bounds->setBounds(Eigen::VectorXd::Ones(nx), -Eigen::VectorXd::Ones(nx));
+        stack->update();
+
+        OpenSoT::solvers::l1HQP l1_solver(*stack, DEFAULT_EPS_REGULARISATION, be.first);
+        OpenSoT::solvers::BackEnd::Ptr back_end;
+        l1_solver.getBackEnd(back_end);
+
+        for(int k = 0; k < 20; ++k)
+        {
+            task1->setA(A1 + 0.1*std::sin(0.1*k)*Eigen::MatrixXd::Ones(3, nx));
+            task2->setb(b2 + std::cos(0.1*k)*Eigen::VectorXd::Ones(nx));
+            task2->setWeight(1. + k);
+            bounds->setBounds((1. + 0.01*k)*Eigen::VectorXd::Ones(nx), -Eigen::VectorXd::Ones(nx));
+            stack->update();
+
+            Eigen::VectorXd solution;
+            ASSERT_TRUE(l1_solver.solve(solution));
+
+            // the constraints updated in place are the same of a problem assembled from scratch
+            OpenSoT::solvers::l1HQP reference(*stack, DEFAULT_EPS_REGULARISATION, be.first);
+            OpenSoT::solvers::BackEnd::Ptr reference_back_end;
+            reference.getBackEnd(reference_back_end);
+
+            Eigen::VectorXd reference_solution;
+            ASSERT_TRUE(reference.solve(reference_solution));
+
+            EXPECT_TRUE(back_end->getA() == reference_back_end->getA());
+            EXPECT_TRUE(back_end->getlA() == reference_back_end->getlA());
+            EXPECT_TRUE(back_end->getuA() == reference_back_end->getuA());
+            EXPECT_NEAR((solution - reference_solution).norm(), 0., be.second);
+        }
+    }
+}
 }
 
 
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/nHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/utils/AutoStack.h>
+
+namespace {
+
+class EqualityConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+{
+public:
+    typedef std::shared_ptr<EqualityConstraint> Ptr;
+
+    EqualityConstraint(const std::string& constraint_id, const Eigen::MatrixXd& Aeq, const Eigen::VectorXd& beq):
+        Constraint(constraint_id, Aeq.cols())
+    {
+        _Aeq = Aeq;
+        _beq = beq;
+    }
+
+    void setAeq(const Eigen::MatrixXd& Aeq){ _Aeq = Aeq; }
+};
+
+class testnHQP: public ::testing::Test
+{
+protected:
+
+    testnHQP():
+        _nx(20)
+    {
+        std::srand(0);
+
+        std::vector<int> task_sizes = {6, 6, 4, _nx};
+        for(unsigned int i = 0; i < task_sizes.size(); ++i)
+        {
+            _A.push_back(Eigen::MatrixXd::Random(task_sizes[i], _nx));
+            _b.push_back(Eigen::VectorXd::Random(task_sizes[i]));
+            _tasks.push_back(std::make_shared<OpenSoT::tasks::GenericTask>("task_" + std::to_string(i), _A[i], _b[i]));
+        }
+
+        _bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds",
+                                                                             10.*Eigen::VectorXd::Ones(_nx),
+                                                                             -10.*Eigen::VectorXd::Ones(_nx),
+                                                                             _nx);
+
+        _stack = std::make_shared<OpenSoT::AutoStack>(_tasks[0]);
+        for(unsigned int i = 1; i < _tasks.size(); ++i)
+            _stack = _stack / _tasks[i];
+        _stack << _bounds;
+        _stack->update();
+    }
+
+    // slowly varying task matrices, as in a control loop
+    void update(const int k)
+    {
+        for(unsigned int i = 0; i < _tasks.size(); ++i)
+        {
+            Eigen::MatrixXd A = _A[i];
+            A += 0.1*std::sin(0.01*k)*Eigen::MatrixXd::Ones(A.rows(), A.cols());
+            A.col(i) *= 1. + 0.5*std::cos(0.02*k);
+            _tasks[i]->setA(A);
+        }
+        _stack->update();
+    }
+
+    int _nx;
+    std::vector<Eigen::MatrixXd> _A;
+    std::vector<Eigen::VectorXd> _b;
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> _tasks;
+    OpenSoT::constraints::GenericConstraint::Ptr _bounds;
+    OpenSoT::AutoStack::Ptr _stack;
+};
+
+TEST_F(testnHQP, testNullSpaceTracking)
+{
+    OpenSoT::solvers::nHQP tracking(_stack->getStack(), _stack->getBounds(), 1e-9);
+    OpenSoT::solvers::nHQP svd(_stack->getStack(), _stack->getBounds(), 1e-9);
+    tracking.setNullSpaceTracking(true);
+
+    EXPECT_THROW(tracking.setNullSpaceTracking(4, false), std::invalid_argument);
+
+    Eigen::VectorXd x_tracking, x_svd;
+    for(int k = 0; k < 500; ++k)
+    {
+        update(k);
+
+        ASSERT_TRUE(tracking.solve(x_tracking));
+        ASSERT_TRUE(svd.solve(x_svd));
+
+        // the nullspace bases differ by a rotation which does not change the solution
+        EXPECT_NEAR((x_tracking - x_svd).norm(), 0., 1e-6) << "cycle " << k;
+    }
+
+    // the first layer is solved exactly
+    EXPECT_NEAR((_tasks[0]->getA()*x_tracking - _tasks[0]->getb()).norm(), 0., 1e-6);
+}
+
+TEST_F(testnHQP, testEqualityConstraints)
+{
+    auto equality = std::make_shared<EqualityConstraint>("equality",
+                                                         Eigen::MatrixXd::Random(6, _nx),
+                                                         Eigen::VectorXd::Random(6));
+
+    auto stack = (_tasks[0] / _tasks[1] / _tasks[3]) << _bounds << equality;
+    stack->update();
+
+    OpenSoT::solvers::nHQP solver(stack->getStack(), stack->getBounds(), 1e-9);
+    solver.setPerformAbRegularization(false);
+
+    Eigen::VectorXd x;
+    ASSERT_TRUE(solver.solve(x));
+
+    EXPECT_NEAR((equality->getAeq()*x - equality->getbeq()).norm(), 0., 1e-6);
+    EXPECT_NEAR((_A[0]*x - _b[0]).norm(), 0., 1e-6);
+    EXPECT_NEAR((_A[1]*x - _b[1]).norm(), 0., 1e-6);
+
+    // the last layer is solved in the nullspace of the equalities and of the previous layers
+    Eigen::MatrixXd J(18, _nx);
+    J << equality->getAeq(), _A[0], _A[1];
+    Eigen::VectorXd r(18);
+    r << equality->getbeq(), _b[0], _b[1];
+
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(J, Eigen::ComputeFullU|Eigen::ComputeFullV);
+    Eigen::VectorXd x_p = svd.solve(r);
+    Eigen::MatrixXd Z = svd.matrixV().rightCols(_nx - 18);
+    Eigen::VectorXd y = (_A[3]*Z).jacobiSvd(Eigen::ComputeThinU|Eigen::ComputeThinV).solve(_b[3] - _A[3]*x_p);
+    EXPECT_NEAR((x - x_p - Z*y).norm(), 0., 1e-6);
+}
+
+TEST_F(testnHQP, testEqualityNullSpaceTracking)
+{
+    const Eigen::MatrixXd Aeq0 = Eigen::MatrixXd::Random(6, _nx);
+    auto equality = std::make_shared<EqualityConstraint>("equality", Aeq0, Eigen::VectorXd::Random(6));
+
+    auto stack = (_tasks[0] / _tasks[3]) << _bounds << equality;
+    stack->update();
+
+    OpenSoT::solvers::nHQP tracking(stack->getStack(), stack->getBounds(), 1e-9);
+    OpenSoT::solvers::nHQP svd(stack->getStack(), stack->getBounds(), 1e-9);
+    tracking.setNullSpaceTracking(true);
+
+    EXPECT_THROW(tracking.getNullSpaceBasis(2), std::invalid_argument);
+
+    Eigen::VectorXd x_tracking, x_svd;
+    Eigen::MatrixXd N_previous;
+    double max_svd_distance = 0.;
+    for(int k = 0; k < 200; ++k)
+    {
+        // slowly varying equality constraints
+        Eigen::MatrixXd Aeq = Aeq0;
+        Aeq.row(0) += 0.5*std::sin(0.02*k)*Aeq0.row(1);
+        Aeq.col(k % _nx) *= 1. + 0.01*std::cos(0.05*k);
+        equality->setAeq(Aeq);
+        update(k);
+        stack->update();
+
+        ASSERT_TRUE(tracking.solve(x_tracking));
+        ASSERT_TRUE(svd.solve(x_svd));
+
+        // same solution, the bases span the same nullspace
+        EXPECT_NEAR((x_tracking - x_svd).norm(), 0., 1e-6) << "cycle " << k;
+
+        const Eigen::MatrixXd& N = tracking.getNullSpaceBasis(0);
+        const Eigen::MatrixXd& N_svd = svd.getNullSpaceBasis(0);
+        ASSERT_EQ(N.cols(), _nx - 6);
+        EXPECT_NEAR((Aeq*N).norm(), 0., 1e-9);
+        EXPECT_NEAR((N.transpose()*N - Eigen::MatrixXd::Identity(N.cols(), N.cols())).norm(), 0., 1e-9);
+        EXPECT_NEAR((N*N.transpose() - N_svd*N_svd.transpose()).norm(), 0., 1e-9);
+
+        // the tracked basis is continuous
+        if(k > 0)
+        {
+            EXPECT_LT((N - N_previous).norm(), 0.1) << "cycle " << k;
+        }
+        N_previous = N;
+
+        max_svd_distance = std::max(max_svd_distance, (N - N_svd).norm());
+    }
+
+    // the tracking is engaged: the basis is not the one given by the SVD anymore
+    EXPECT_GT(max_svd_distance, 0.1);
+}
+
+TEST_F(testnHQP, testLocalConstraints)
+{
+    // local equality on the first layer, local equality and inequality on the last one
+    auto equality_0 = std::make_shared<EqualityConstraint>("equality_0",
+                                                           Eigen::MatrixXd::Random(2, _nx),
+                                                           Eigen::VectorXd::Random(2));
+    _tasks[0]->getConstraints().push_back(equality_0);
+
+    auto equality_3 = std::make_shared<EqualityConstraint>("equality_3",
+                                                           Eigen::MatrixXd::Random(2, _nx),
+                                                           Eigen::VectorXd::Random(2));
+    _tasks[3]->getConstraints().push_back(equality_3);
+
+    auto stack = (_tasks[0] / _tasks[1] / _tasks[3]) << _bounds;
+    stack->update();
+
+    OpenSoT::solvers::nHQP solver(stack->getStack(), stack->getBounds(), 1e-9);
+    solver.setPerformAbRegularization(false);
+
+    Eigen::VectorXd x;
+    ASSERT_TRUE(solver.solve(x));
+
+    EXPECT_NEAR((_A[0]*x - _b[0]).norm(), 0., 1e-6);
+    EXPECT_NEAR((_A[1]*x - _b[1]).norm(), 0., 1e-6);
+    EXPECT_NEAR((equality_3->getAeq()*x - equality_3->getbeq()).norm(), 0., 1e-6);
+
+    // an inequality on the last layer which is active at the solution
+    Eigen::MatrixXd c = Eigen::MatrixXd::Ones(1, _nx);
+    const double c_max = (c*x)(0) - 0.5;
+    auto inequality = std::make_shared<OpenSoT::constraints::GenericConstraint>("inequality",
+                                                                                 OpenSoT::AffineHelper(c, Eigen::VectorXd::Zero(1)),
+                                                                                 c_max*Eigen::VectorXd::Ones(1),
+                                                                                 -1e3*Eigen::VectorXd::Ones(1),
+                                                                                 OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+    _tasks[3]->getConstraints().push_back(inequality);
+    stack->update();
+
+    OpenSoT::solvers::nHQP solver_ineq(stack->getStack(), stack->getBounds(), 1e-9);
+    solver_ineq.setPerformAbRegularization(false);
+    ASSERT_TRUE(solver_ineq.solve(x));
+
+    EXPECT_NEAR((_A[0]*x - _b[0]).norm(), 0., 1e-6);
+    EXPECT_NEAR((_A[1]*x - _b[1]).norm(), 0., 1e-6);
+    EXPECT_NEAR((equality_3->getAeq()*x - equality_3->getbeq()).norm(), 0., 1e-6);
+    EXPECT_NEAR((c*x)(0), c_max, 1e-6);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
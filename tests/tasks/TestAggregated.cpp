@@ -489,6 +489,10 @@ TEST_F(testAggregatedTask, testWeightsUpdate)
     EXPECT_TRUE(matrixAreEqual(waist->getWeight(), t1->getWeight().block(6,6,6,6)));
     EXPECT_TRUE(matrixAreEqual(lwrist->getWeight(), t1->getWeight().block(0,0,6,6)));
     Eigen::MatrixXd W2(12,12); W2.setOnes();
+    /* off-diagonal blocks would couple lwrist and waist */
+    EXPECT_THROW(t1->setWeight(W2), std::runtime_error);
+    W2.block(0,6,6,6).setZero();
+    W2.block(6,0,6,6).setZero();
     t1->setWeight(W2);
     t1->update();
     std::cout<<"t1->getWeight(): \n"<<t1->getWeight()<<std::endl;
@@ -548,6 +552,109 @@ TEST_F(testAggregatedTask, testWeightsUpdate)
 
 }
 
+TEST_F(testAggregatedTask, testBlockDiagonalWeight)
+{
+    q = _model_ptr->generateRandomQ();
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    OpenSoT::tasks::velocity::Cartesian::Ptr waist(
+            new OpenSoT::tasks::velocity::Cartesian("cartesian::Waist",
+                                                    *_model_ptr, "Waist", "world"));
+    OpenSoT::tasks::velocity::Cartesian::Ptr lwrist(
+            new OpenSoT::tasks::velocity::Cartesian("cartesian::l_wrist",
+                                                    *_model_ptr, "l_wrist", "world"));
+    OpenSoT::tasks::velocity::Cartesian::Ptr rwrist(
+            new OpenSoT::tasks::velocity::Cartesian("cartesian::r_wrist",
+                                                    *_model_ptr, "r_wrist", "world"));
+
+    Eigen::MatrixXd W(6,6); W.setRandom();
+    waist->setWeight(W*W.transpose());
+    lwrist->setWeight(2.);
+    rwrist->setWeight(Eigen::VectorXd::LinSpaced(6, 1., 6.).asDiagonal());
+    rwrist->setWeightIsDiagonalFlag(true);
+
+    OpenSoT::tasks::Aggregated::Ptr t(
+                new OpenSoT::tasks::Aggregated(lwrist + waist, rwrist, _model_ptr->getNv()));
+    t->update();
+
+    /* nested aggregates are flattened */
+    ASSERT_EQ(t->getWeightBlocks().size(), 3);
+    EXPECT_EQ(t->getWeightBlocks()[1].offset, 6);
+    EXPECT_TRUE(t->getWeightBlocks()[1].task == waist);
+    EXPECT_FALSE(t->isWeightIdentity());
+
+    const Eigen::MatrixXd Wdense = t->getWeight();
+    EXPECT_TRUE(matrixAreEqual(Wdense.block(6,6,6,6), waist->getWeight()));
+    EXPECT_TRUE(Wdense.block(0,6,6,12).isZero());
+
+    EXPECT_TRUE(matrixAreEqual(t->getWA(), Wdense*t->getA()));
+    EXPECT_NEAR((t->getWb() - Wdense*t->getb()).norm(), 0., 1e-12);
+
+    /* the weight of a task is copied by the update of the Aggregated */
+    waist->setWeight(5.);
+    t->update();
+    EXPECT_TRUE(matrixAreEqual(t->getWeight().block(6,6,6,6), 5.*Eigen::MatrixXd::Identity(6,6)));
+    EXPECT_TRUE(t->getWeight().block(0,6,6,12).isZero());
+    waist->setWeight(W*W.transpose());
+    t->update();
+
+    /* the weight is flagged as diagonal only if all the weights are */
+    EXPECT_FALSE(t->getWeightIsDiagonalFlag());
+    Eigen::MatrixXd WM;
+    t->weight(t->getA(), WM);
+    EXPECT_TRUE(matrixAreEqual(WM, Wdense*t->getA()));
+
+    Eigen::MatrixXd Wcoupled = Wdense;
+    Wcoupled(0,6) = Wcoupled(6,0) = 1.;
+    EXPECT_THROW(t->setWeight(Wcoupled), std::runtime_error);
+    EXPECT_TRUE(matrixAreEqual(t->getWeight(), Wdense));
+
+    t->setWeight(1.);
+    EXPECT_TRUE(t->isWeightIdentity());
+    EXPECT_TRUE(matrixAreEqual(t->getWeight(), Eigen::MatrixXd::Identity(18,18)));
+    EXPECT_TRUE(matrixAreEqual(waist->getWeight(), Eigen::MatrixXd::Identity(6,6)));
+}
+
+TEST_F(testAggregatedTask, testPerTaskHessian)
+{
+    q = _model_ptr->generateRandomQ();
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    OpenSoT::tasks::velocity::Cartesian::Ptr lwrist(
+            new OpenSoT::tasks::velocity::Cartesian("cartesian::l_wrist",
+                                                    *_model_ptr, "l_wrist", "Waist"));
+    OpenSoT::tasks::velocity::Cartesian::Ptr rwrist(
+            new OpenSoT::tasks::velocity::Cartesian("cartesian::r_wrist",
+                                                    *_model_ptr, "r_wrist", "Waist"));
+    OpenSoT::tasks::velocity::Postural::Ptr postural(
+            new OpenSoT::tasks::velocity::Postural(*_model_ptr));
+    lwrist->setWeight(3.);
+    postural->setWeight(0.1);
+
+    auto t = lwrist + rwrist + postural;
+
+    Eigen::MatrixXd H;
+    Eigen::VectorXd g;
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        if(i == 2)
+            _model_ptr->setJointPosition(_model_ptr->generateRandomQ());
+        else
+            rwrist->setReference(Eigen::Affine3d::Identity());
+        _model_ptr->update();
+        t->update();
+
+        t->computeHessianAndGradient(H, g);
+
+        Eigen::MatrixXd Hd = t->getA().transpose()*t->getWA();
+        Eigen::VectorXd gd = -t->getA().transpose()*t->getWb();
+        EXPECT_NEAR((H - Hd).norm(), 0., 1e-9);
+        EXPECT_NEAR((g - gd).norm(), 0., 1e-9);
+    }
+}
+
 TEST_F(testAggregatedTask, testSingleTask)
 {
 
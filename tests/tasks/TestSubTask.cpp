@@ -749,6 +749,57 @@ TEST_F(TestSubTask, testSubTaskCost)
     EXPECT_DOUBLE_EQ(left_leg_cost, position_cost + orientation_cost);
 }
 
+TEST_F(TestSubTask, testRowSelection)
+{
+    using namespace OpenSoT::tasks::velocity;
+
+    _model_ptr->setJointPosition(_model_ptr->generateRandomQ());
+    _model_ptr->update();
+
+    Cartesian::Ptr left_arm = std::make_shared<Cartesian>("larm",  *_model_ptr,
+                                          "LSoftHand", "Waist");
+    Eigen::MatrixXd W(6,6); W.setRandom();
+    left_arm->setWeight(W*W.transpose());
+
+    std::vector<unsigned int> rows = {0, 2, 3, 5};
+    OpenSoT::Indices indices(rows.begin(), rows.end());
+    EXPECT_EQ(indices.getChunks().size(), 3);
+    OpenSoT::SubTask::Ptr sub_task = std::make_shared<OpenSoT::SubTask>(left_arm, indices.asList());
+    sub_task->update();
+
+    Eigen::MatrixXd A(rows.size(), _model_ptr->getNv()), Ws(rows.size(), rows.size());
+    Eigen::VectorXd b(rows.size());
+    for(unsigned int i = 0; i < rows.size(); ++i)
+    {
+        A.row(i) = left_arm->getA().row(rows[i]);
+        b[i] = left_arm->getb()[rows[i]];
+        for(unsigned int j = 0; j < rows.size(); ++j)
+            Ws(i,j) = left_arm->getWeight()(rows[i], rows[j]);
+    }
+
+    /* rows and weight are selected by chunks of the father task */
+    EXPECT_TRUE(sub_task->getWA().isApprox(Ws*A));
+
+    Eigen::MatrixXd H;
+    Eigen::VectorXd g;
+    sub_task->computeHessianAndGradient(H, g);
+    EXPECT_TRUE(H.isApprox(A.transpose()*Ws*A));
+    EXPECT_TRUE(g.isApprox(-A.transpose()*Ws*b));
+
+    EXPECT_TRUE(sub_task->getA() == A);
+    EXPECT_TRUE(sub_task->getWeight() == Ws);
+
+    sub_task->setWeight(2.);
+    EXPECT_TRUE(sub_task->getWeight() == 2.*Eigen::MatrixXd::Identity(rows.size(), rows.size()));
+    EXPECT_DOUBLE_EQ(left_arm->getWeight()(2,3), 0.);
+    EXPECT_DOUBLE_EQ(left_arm->getWeight()(5,5), 2.);
+
+    sub_task->setActive(false);
+    sub_task->update();
+    EXPECT_TRUE(sub_task->getA().isZero());
+    EXPECT_TRUE(sub_task->getWA().isZero());
+}
+
 TEST_F(TestSubTask, testWithPostural)
 {
     Eigen::VectorXd q = _model_ptr->getNeutralQ();
@@ -2,6 +2,7 @@
 #include <OpenSoT/utils/AutoStack.h>
 #include "DefaultHumanoidStack.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include "../common.h"
 
 
@@ -488,6 +489,113 @@ TEST_F(testAutoStack, testOperatorTaskToConstraint)
 
 }
 
+TEST_F(testAutoStack, testCompile)
+{
+    using namespace OpenSoT;
+
+    std::list<unsigned int> xyz = {0, 1, 2};
+    auto left_arm_position = DHS->leftArm%xyz;
+    auto right_arm_position = DHS->rightArm%xyz;
+
+    // leftArm is used in two levels
+    AutoStack::Ptr auto_stack = (DHS->leftArm + right_arm_position)/
+                                (left_arm_position + DHS->com)/
+                                DHS->postural;
+
+    Eigen::VectorXd q = _model_ptr->generateRandomQ();
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    auto_stack->update();
+
+    std::vector<Eigen::MatrixXd> A;
+    std::vector<Eigen::VectorXd> b;
+    for(auto task : auto_stack->getStack())
+    {
+        A.push_back(task->getA());
+        b.push_back(task->getb());
+    }
+
+    EXPECT_FALSE(auto_stack->isCompiled());
+    auto_stack->compile();
+    EXPECT_TRUE(auto_stack->isCompiled());
+
+    // every task once, Aggregated and SubTask excluded
+    const auto& update_list = auto_stack->getUpdateList();
+    EXPECT_EQ(update_list.size(), 4);
+    EXPECT_EQ(std::count(update_list.begin(), update_list.end(), DHS->leftArm), 1);
+    EXPECT_EQ(std::count(update_list.begin(), update_list.end(), DHS->rightArm), 1);
+    EXPECT_EQ(std::count(update_list.begin(), update_list.end(), DHS->com), 1);
+    EXPECT_EQ(std::count(update_list.begin(), update_list.end(), DHS->postural), 1);
+
+    // the compiled update gives the same levels
+    auto_stack->update();
+    for(unsigned int i = 0; i < auto_stack->getStack().size(); ++i)
+    {
+        EXPECT_TRUE(auto_stack->getStack()[i]->getA() == A[i]);
+        EXPECT_TRUE(auto_stack->getStack()[i]->getb() == b[i]);
+    }
+
+    // the Aggregated and SubTask are not changed by the compiled update
+    auto aggregated = std::dynamic_pointer_cast<tasks::Aggregated>(auto_stack->getStack()[0]);
+    EXPECT_TRUE(aggregated->getUpdateTasks());
+    EXPECT_TRUE(right_arm_position->getUpdateFatherTask());
+
+    // the plan follows the changes of the stack
+    q = _model_ptr->generateRandomQ();
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    auto_stack->getStack().push_back(DHS->rightLeg);
+    auto_stack->update();
+    EXPECT_EQ(auto_stack->getUpdateList().size(), 5);
+    EXPECT_EQ(std::count(auto_stack->getUpdateList().begin(), auto_stack->getUpdateList().end(), DHS->rightLeg), 1);
+
+    EXPECT_TRUE(auto_stack->getStack()[0]->getA().topRows(6) == DHS->leftArm->getA());
+    EXPECT_TRUE(auto_stack->getStack()[1]->getA().topRows(3) == DHS->leftArm->getA().topRows(3));
+}
+
+class ThrowingAggregated: public OpenSoT::tasks::Aggregated
+{
+public:
+    using OpenSoT::tasks::Aggregated::Aggregated;
+
+    bool throw_on_update = false;
+
+    void _update()
+    {
+        if(throw_on_update)
+            throw std::runtime_error("update failed");
+        OpenSoT::tasks::Aggregated::_update();
+    }
+};
+
+TEST_F(testAutoStack, testCompileRestoresUpdateFlags)
+{
+    using namespace OpenSoT;
+
+    auto aggregated = std::make_shared<ThrowingAggregated>(DHS->leftArm, DHS->com, _model_ptr->getNv());
+    std::list<unsigned int> xyz = {0, 1, 2};
+    auto left_arm_position = aggregated%xyz;
+
+    AutoStack::Ptr auto_stack = std::make_shared<AutoStack>(left_arm_position);
+    auto_stack->update();
+    auto_stack->compile();
+    auto_stack->update();
+
+    // the update of the children is enabled again also if the update of the composite task throws
+    aggregated->throw_on_update = true;
+    EXPECT_THROW(auto_stack->update(), std::runtime_error);
+    EXPECT_TRUE(aggregated->getUpdateTasks());
+    EXPECT_TRUE(left_arm_position->getUpdateFatherTask());
+
+    // a setting of the user is kept
+    aggregated->throw_on_update = false;
+    left_arm_position->setUpdateFatherTask(false);
+    auto_stack->update();
+    EXPECT_FALSE(left_arm_position->getUpdateFatherTask());
+}
+
 }
 
 int main(int argc, char **argv) {
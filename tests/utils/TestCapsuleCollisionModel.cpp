@@ -0,0 +1,203 @@
+#include <OpenSoT/utils/CapsuleCollisionModel.h>
+#include <gtest/gtest.h>
+#include "../common.h"
+
+namespace{
+
+class testCapsuleCollisionModel: public TestBase
+{
+protected:
+
+    testCapsuleCollisionModel(): TestBase("coman")
+    {
+
+    }
+
+    virtual ~testCapsuleCollisionModel() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+double bruteForceDistance(const Eigen::Vector3d& pa, const Eigen::Vector3d& da,
+                          const Eigen::Vector3d& pb, const Eigen::Vector3d& db)
+{
+    double d = std::numeric_limits<double>::max();
+    const int N = 300;
+    for(int i = 0; i <= N; ++i)
+        for(int j = 0; j <= N; ++j)
+            d = std::min(d, (pa + da*double(i)/N - pb - db*double(j)/N).norm());
+    return d;
+}
+
+TEST_F(testCapsuleCollisionModel, checkSegmentDistanceBatch)
+{
+    const int N = 100;
+    OpenSoT::utils::SegmentBatch A, B;
+    A.resize(N);
+    B.resize(N);
+
+    for(int k = 0; k < N; ++k)
+    {
+        Eigen::Vector3d p = Eigen::Vector3d::Random();
+        Eigen::Vector3d d = Eigen::Vector3d::Random();
+        A.px[k] = p.x(); A.py[k] = p.y(); A.pz[k] = p.z();
+        A.dx[k] = d.x(); A.dy[k] = d.y(); A.dz[k] = d.z();
+        A.r[k] = 0.1;
+
+        p.setRandom();
+        d.setRandom();
+        // spheres and parallel segments
+        if(k%10 == 0)
+            d.setZero();
+        if(k%7 == 0)
+            d << 2.*A.dx[k], 2.*A.dy[k], 2.*A.dz[k];
+        B.px[k] = p.x(); B.py[k] = p.y(); B.pz[k] = p.z();
+        B.dx[k] = d.x(); B.dy[k] = d.y(); B.dz[k] = d.z();
+        B.r[k] = 0.05;
+    }
+
+    OpenSoT::utils::SegmentDistanceBatch dist(N);
+    dist.compute(A, B);
+
+    for(int k = 0; k < N; ++k)
+    {
+        double d = bruteForceDistance(Eigen::Vector3d(A.px[k], A.py[k], A.pz[k]),
+                                      Eigen::Vector3d(A.dx[k], A.dy[k], A.dz[k]),
+                                      Eigen::Vector3d(B.px[k], B.py[k], B.pz[k]),
+                                      Eigen::Vector3d(B.dx[k], B.dy[k], B.dz[k])) - A.r[k] - B.r[k];
+        EXPECT_NEAR(dist.distance[k], d, 1e-3);
+        EXPECT_LE(dist.distance[k], d + 1e-9);
+
+        Eigen::Vector3d wa(dist.wax[k], dist.way[k], dist.waz[k]);
+        Eigen::Vector3d wb(dist.wbx[k], dist.wby[k], dist.wbz[k]);
+        Eigen::Vector3d n(dist.nx[k], dist.ny[k], dist.nz[k]);
+        EXPECT_NEAR(n.norm(), 1., 1e-9);
+        EXPECT_NEAR((wb - wa).dot(n), dist.distance[k], 1e-9);
+    }
+}
+
+TEST_F(testCapsuleCollisionModel, checkSegmentDistanceBatchHead)
+{
+    const int N = 20;
+    OpenSoT::utils::SegmentBatch A, B;
+    A.resize(N);
+    B.resize(N);
+    for(Eigen::ArrayXd* v : {&A.px, &A.py, &A.pz, &A.dx, &A.dy, &A.dz, &B.px, &B.py, &B.pz, &B.dx, &B.dy, &B.dz})
+        v->setRandom();
+    A.r.setConstant(0.1);
+    B.r.setConstant(0.05);
+
+    OpenSoT::utils::SegmentDistanceBatch all(N), head(N);
+    all.compute(A, B);
+    head.compute(A, B, N/2);
+
+    // the first pairs are the same, the others are not computed
+    EXPECT_TRUE(head.distance.head(N/2).isApprox(all.distance.head(N/2)));
+    EXPECT_TRUE(head.nx.head(N/2).isApprox(all.nx.head(N/2)));
+    EXPECT_TRUE(head.distance.tail(N - N/2).isZero());
+}
+
+TEST_F(testCapsuleCollisionModel, checkDistanceJacobian)
+{
+    Eigen::VectorXd q = _model_ptr->getNeutralQ();
+    q[_model_ptr->getQIndex("LShSag")] = 20.0*M_PI/180.0;
+    q[_model_ptr->getQIndex("LElbj")] = -80.0*M_PI/180.0;
+    q[_model_ptr->getQIndex("RShSag")] = 20.0*M_PI/180.0;
+    q[_model_ptr->getQIndex("RElbj")] = -80.0*M_PI/180.0;
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    OpenSoT::utils::CapsuleCollisionModel capsules(_model_ptr);
+    EXPECT_TRUE(capsules.addCapsule("left_forearm", "LForearm", Eigen::Vector3d(0,0,-0.1), Eigen::Vector3d(0,0,0.1), 0.04));
+    EXPECT_TRUE(capsules.addCapsule("right_forearm", "RForearm", Eigen::Vector3d(0,0,-0.1), Eigen::Vector3d(0,0,0.1), 0.04));
+    EXPECT_TRUE(capsules.addSphere("torso", "torso", Eigen::Vector3d(0.05,0,0), 0.1));
+    EXPECT_FALSE(capsules.addSphere("torso", "torso", Eigen::Vector3d(0.05,0,0), 0.1));
+
+    XBot::Collision::Shape::Sphere sphere;
+    sphere.r = 0.1;
+    Eigen::Affine3d w_T_s; w_T_s.setIdentity();
+    w_T_s.translation() << 0.5, 0., 0.5;
+    EXPECT_TRUE(capsules.addCollisionShape("obstacle", "world", sphere, w_T_s));
+
+    capsules.setLinkPairs({{"LForearm", "RForearm"},
+                           {"LForearm", "torso"},
+                           {"RForearm", "torso"}});
+    EXPECT_EQ(capsules.getNumCollisionPairs(false), 3);
+    EXPECT_EQ(capsules.getNumCollisionPairs(true), 6);
+
+    capsules.update();
+    Eigen::VectorXd d0, d1;
+    Eigen::MatrixXd J;
+    capsules.computeDistance(d0);
+    capsules.getDistanceJacobian(J);
+    EXPECT_EQ(J.rows(), 6);
+    EXPECT_EQ(J.cols(), _model_ptr->getNv());
+
+    const auto& idx = capsules.getOrderedCollisionPairIndices();
+    for(unsigned int i = 1; i < idx.size(); ++i)
+        EXPECT_LE(d0[idx[i-1]], d0[idx[i]]);
+
+    // self pairs only, they come first
+    Eigen::VectorXd d_self;
+    Eigen::MatrixXd J_self;
+    capsules.computeDistance(d_self, false);
+    capsules.getDistanceJacobian(J_self, false);
+    EXPECT_EQ(d_self.size(), 3);
+    EXPECT_TRUE(d_self == d0.head(3));
+    EXPECT_TRUE(J_self == J.topRows(3));
+
+    double h = 1e-6;
+    Eigen::VectorXd dq;
+    dq.setRandom(_model_ptr->getNv());
+    _model_ptr->setJointPosition(_model_ptr->sum(q, h*dq));
+    _model_ptr->update();
+    capsules.update();
+    capsules.computeDistance(d1);
+
+    for(unsigned int i = 0; i < d0.size(); ++i)
+        EXPECT_NEAR((d1[i] - d0[i])/h, J.row(i).dot(dq), 1e-4);
+}
+
+TEST_F(testCapsuleCollisionModel, checkDisabledCollisions)
+{
+    OpenSoT::utils::CapsuleCollisionModel capsules(_model_ptr);
+    EXPECT_TRUE(capsules.addCapsule("left_forearm", "LForearm", Eigen::Vector3d(0,0,-0.1), Eigen::Vector3d(0,0,0.1), 0.04));
+    EXPECT_TRUE(capsules.addCapsule("right_forearm", "RForearm", Eigen::Vector3d(0,0,-0.1), Eigen::Vector3d(0,0,0.1), 0.04,
+                                    {"LForearm"}));
+    EXPECT_TRUE(capsules.addSphere("torso", "torso", Eigen::Vector3d(0.05,0,0), 0.1));
+
+    XBot::Collision::Shape::Sphere sphere;
+    sphere.r = 0.1;
+    Eigen::Affine3d w_T_s; w_T_s.setIdentity();
+    w_T_s.translation() << 0.5, 0., 0.5;
+    EXPECT_TRUE(capsules.addCollisionShape("obstacle", "world", sphere, w_T_s, {"torso"}));
+
+    capsules.setLinkPairs({{"LForearm", "RForearm"},
+                           {"LForearm", "torso"},
+                           {"RForearm", "torso"}});
+
+    // LForearm-RForearm and torso-obstacle are disabled
+    EXPECT_EQ(capsules.getNumCollisionPairs(false), 2);
+    EXPECT_EQ(capsules.getNumCollisionPairs(true), 4);
+    for(const auto& pair : capsules.getCollisionPairs(true))
+    {
+        EXPECT_FALSE(pair.first == "LForearm" && pair.second == "RForearm");
+        EXPECT_FALSE(pair.first == "torso" && pair.second == "obstacle");
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+#include <OpenSoT/utils/CollisionPairPruning.h>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "../common.h"
+
+namespace{
+
+class testCollisionPairPruning: public TestBase
+{
+protected:
+
+    testCollisionPairPruning(): TestBase("coman")
+    {
+
+    }
+
+    virtual ~testCollisionPairPruning() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+TEST_F(testCollisionPairPruning, checkPruning)
+{
+    OpenSoT::utils::CollisionPairPruning pruning(_model_ptr);
+
+    pruning.addSample(_model_ptr->getNeutralQ());
+    pruning.sample(500);
+    EXPECT_EQ(pruning.getNumberOfSamples(), 501);
+
+    XBot::Collision::CollisionModel collision_model(_model_ptr);
+    const auto all_pairs = collision_model.getCollisionPairs(false);
+
+    const double margin = 0.05;
+    auto report = pruning.getReport(margin);
+    ASSERT_EQ(report.size(), all_pairs.size());
+
+    int never = 0, always = 0;
+    for(const auto& r : report)
+    {
+        EXPECT_LE(r.min_distance, r.max_distance);
+        EXPECT_GE(r.max_distance_rate, 0.);
+
+        switch(r.classification)
+        {
+        case OpenSoT::utils::CollisionPairPruning::PairClass::NEVER:
+            EXPECT_GT(r.min_distance, margin);
+            never++;
+            break;
+        case OpenSoT::utils::CollisionPairPruning::PairClass::ALWAYS:
+            EXPECT_EQ(r.colliding_samples, 501);
+            always++;
+            break;
+        default:
+            EXPECT_LE(r.min_distance, margin);
+        }
+    }
+
+    // something has been pruned, the SOMETIMES pairs are the pruned list
+    auto pairs = pruning.getPrunedPairs(margin);
+    EXPECT_GT(never + always, 0);
+    EXPECT_EQ(pairs.size() + never + always, all_pairs.size());
+
+    // a coarser joint space resolution is more conservative: less pairs are removed
+    auto conservative_pairs = pruning.getPrunedPairs(margin, 0.1);
+    EXPECT_GE(conservative_pairs.size(), pairs.size());
+    for(const auto& pair : pairs)
+        EXPECT_TRUE(conservative_pairs.count(pair));
+
+    // removed pairs are not colliding in new samples
+    auto removed = pruning.getReport(margin, 0.1);
+    for(unsigned int i = 0; i < 100; ++i)
+    {
+        _model_ptr->setJointPosition(_model_ptr->generateRandomQ());
+        _model_ptr->update();
+        collision_model.update();
+
+        Eigen::VectorXd d;
+        collision_model.computeDistance(d, false, std::numeric_limits<double>::max());
+        for(unsigned int j = 0; j < removed.size(); ++j)
+        {
+            if(removed[j].classification == OpenSoT::utils::CollisionPairPruning::PairClass::NEVER)
+                EXPECT_GT(d[j], 0.);
+        }
+    }
+
+    // save and load
+    const std::string file_name = "/tmp/opensot_collision_pairs.txt";
+    EXPECT_TRUE(OpenSoT::utils::CollisionPairPruning::savePairList(file_name, pairs));
+    EXPECT_TRUE(OpenSoT::utils::CollisionPairPruning::loadPairList(file_name) == pairs);
+    std::remove(file_name.c_str());
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,201 @@
+#include <OpenSoT/utils/DistanceField.h>
+#include <OpenSoT/utils/CapsuleCollisionModel.h>
+#include <gtest/gtest.h>
+#include "../common.h"
+
+namespace{
+
+class testDistanceField: public TestBase
+{
+protected:
+
+    testDistanceField(): TestBase("coman")
+    {
+
+    }
+
+    virtual ~testDistanceField() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+TEST_F(testDistanceField, checkShapes)
+{
+    const double resolution = 0.02;
+    OpenSoT::utils::DistanceField field(Eigen::Vector3d(-0.5, -0.5, -0.5), Eigen::Vector3i(51, 51, 51), resolution);
+
+    XBot::Collision::Shape::Sphere sphere;
+    sphere.r = 0.1;
+    Eigen::Affine3d w_T_sphere; w_T_sphere.setIdentity();
+    w_T_sphere.translation() << 0.2, 0., 0.;
+    EXPECT_TRUE(field.addShape(sphere, w_T_sphere));
+
+    XBot::Collision::Shape::Box box;
+    box.size << 0.1, 0.2, 0.3;
+    Eigen::Affine3d w_T_box; w_T_box.setIdentity();
+    w_T_box.translation() << -0.2, 0., 0.;
+    EXPECT_TRUE(field.addShape(box, w_T_box));
+
+    field.computeGradient();
+
+    for(unsigned int i = 0; i < 100; ++i)
+    {
+        Eigen::Vector3d p = 0.45*Eigen::Vector3d::Random();
+        EXPECT_TRUE(field.isInside(p));
+
+        Eigen::Vector3d q = (p - w_T_box.translation()).cwiseAbs() - 0.5*box.size;
+        double d_box = q.cwiseMax(0.).norm() + std::min(q.maxCoeff(), 0.);
+        double d_sphere = (p - w_T_sphere.translation()).norm() - sphere.r;
+
+        EXPECT_NEAR(field.getDistance(p), std::min(d_box, d_sphere), resolution);
+    }
+
+    // gradient points away from the sphere
+    Eigen::Vector3d g;
+    double d = field.getDistance(Eigen::Vector3d(0.4, 0., 0.), g);
+    EXPECT_NEAR(d, 0.1, 1e-3);
+    EXPECT_NEAR(g.x(), 1., 1e-2);
+    EXPECT_NEAR(g.tail<2>().norm(), 0., 1e-2);
+
+    // outside the grid
+    EXPECT_FALSE(field.isInside(Eigen::Vector3d(1., 0., 0.)));
+    EXPECT_DOUBLE_EQ(field.getDistance(Eigen::Vector3d(1., 0., 0.), g), field.getMaxDistance());
+    EXPECT_TRUE(g.isZero());
+}
+
+TEST_F(testDistanceField, checkPointCloud)
+{
+    const double resolution = 0.02;
+    OpenSoT::utils::DistanceField field(Eigen::Vector3d::Zero(), Eigen::Vector3i(40, 30, 20), resolution);
+
+    std::vector<Eigen::Vector3d> points;
+    for(unsigned int i = 0; i < 20; ++i)
+        points.push_back(Eigen::Vector3d(0.2 + 0.01*i, 0.3, 0.2));
+    EXPECT_TRUE(field.addPointCloud(points));
+
+    for(unsigned int i = 0; i < 100; ++i)
+    {
+        Eigen::Vector3d p = Eigen::Vector3d(0.39, 0.29, 0.19).cwiseProduct(
+                    0.5*(Eigen::Vector3d::Random() + Eigen::Vector3d::Ones()));
+
+        double d = std::numeric_limits<double>::max();
+        for(const auto& point : points)
+            d = std::min(d, (p - point).norm());
+
+        // conservative up to the grid resolution
+        EXPECT_LE(field.getDistance(p), d + 1e-6);
+        EXPECT_GE(field.getDistance(p), d - 2.*resolution);
+    }
+}
+
+TEST_F(testDistanceField, checkSaveLoad)
+{
+    OpenSoT::utils::DistanceField field(Eigen::Vector3d(-0.5, -0.5, 0.), Eigen::Vector3i(21, 21, 21), 0.05, 2.);
+
+    XBot::Collision::Shape::Capsule capsule;
+    capsule.r = 0.1;
+    capsule.l = 0.4;
+    Eigen::Affine3d w_T_c; w_T_c.setIdentity();
+    w_T_c.translation() << 0., 0., 0.5;
+    EXPECT_TRUE(field.addShape(capsule, w_T_c));
+    field.computeGradient();
+
+    const std::string file_name = "/tmp/testDistanceField.sdf";
+    EXPECT_TRUE(field.save(file_name));
+
+    auto loaded = OpenSoT::utils::DistanceField::load(file_name);
+    ASSERT_TRUE(bool(loaded));
+    EXPECT_TRUE(loaded->isReadOnly());
+    EXPECT_FALSE(loaded->addShape(capsule, w_T_c));
+    EXPECT_TRUE(loaded->getSize() == field.getSize());
+    EXPECT_TRUE(loaded->getOrigin().isApprox(field.getOrigin()));
+    EXPECT_DOUBLE_EQ(loaded->getResolution(), field.getResolution());
+    EXPECT_DOUBLE_EQ(loaded->getMaxDistance(), field.getMaxDistance());
+
+    for(unsigned int i = 0; i < 100; ++i)
+    {
+        Eigen::Vector3d p = 0.5*Eigen::Vector3d::Random() + Eigen::Vector3d(0., 0., 0.5);
+        Eigen::Vector3d g0, g1;
+        EXPECT_DOUBLE_EQ(loaded->getDistance(p, g1), field.getDistance(p, g0));
+        EXPECT_TRUE(g0.isApprox(g1) || g0.isZero());
+    }
+
+    EXPECT_FALSE(bool(OpenSoT::utils::DistanceField::load("/tmp/testDistanceField_does_not_exist.sdf")));
+}
+
+TEST_F(testDistanceField, checkCapsuleCollisionModelDistanceField)
+{
+    Eigen::VectorXd q = _model_ptr->getNeutralQ();
+    q[_model_ptr->getQIndex("LShSag")] = 20.0*M_PI/180.0;
+    q[_model_ptr->getQIndex("LElbj")] = -80.0*M_PI/180.0;
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    Eigen::Vector3d p_forearm = _model_ptr->getPose("LForearm").translation();
+
+    // obstacle in front of the left forearm
+    auto field = std::make_shared<OpenSoT::utils::DistanceField>(
+                p_forearm - Eigen::Vector3d::Constant(0.6), Eigen::Vector3i(121, 121, 121), 0.01);
+    XBot::Collision::Shape::Sphere sphere;
+    sphere.r = 0.3;
+    Eigen::Affine3d w_T_s; w_T_s.setIdentity();
+    w_T_s.translation() = p_forearm + Eigen::Vector3d(0.5, 0., 0.);
+    EXPECT_TRUE(field->addShape(sphere, w_T_s));
+    field->computeGradient();
+
+    OpenSoT::utils::CapsuleCollisionModel capsules(_model_ptr);
+    EXPECT_TRUE(capsules.addCapsule("left_forearm", "LForearm", Eigen::Vector3d(0,0,-0.1), Eigen::Vector3d(0,0,0.1), 0.04));
+    EXPECT_TRUE(capsules.addCapsule("right_forearm", "RForearm", Eigen::Vector3d(0,0,-0.1), Eigen::Vector3d(0,0,0.1), 0.04));
+    capsules.setLinkPairs({{"LForearm", "RForearm"}});
+    capsules.setLinksVsEnvironment({"LForearm"});
+    capsules.setDistanceField(field, 11);
+
+    EXPECT_EQ(capsules.getNumCollisionPairs(false), 1);
+    EXPECT_EQ(capsules.getNumCollisionPairs(true), 2);
+    EXPECT_EQ(capsules.getCollisionPairs(true)[1].first, "LForearm");
+
+    capsules.update();
+    Eigen::VectorXd d0, d1;
+    Eigen::MatrixXd J;
+    capsules.computeDistance(d0);
+    capsules.getDistanceJacobian(J);
+
+    // compare with the sampled analytic distance
+    const auto& w_T_l = _model_ptr->getPose("LForearm");
+    double d = std::numeric_limits<double>::max();
+    for(unsigned int i = 0; i <= 10; ++i)
+        d = std::min(d, (w_T_l*Eigen::Vector3d(0, 0, -0.1 + 0.02*i) - w_T_s.translation()).norm() - sphere.r - 0.04);
+    EXPECT_NEAR(d0[1], d, 1e-3);
+
+    OpenSoT::utils::CapsuleCollisionModel::WitnessPointVector wp;
+    capsules.getWitnessPoints(wp);
+    EXPECT_NEAR((wp[1].second - wp[1].first).norm(), d0[1], 1e-3);
+
+    double h = 1e-6;
+    Eigen::VectorXd dq;
+    dq.setRandom(_model_ptr->getNv());
+    _model_ptr->setJointPosition(_model_ptr->sum(q, h*dq));
+    _model_ptr->update();
+    capsules.update();
+    capsules.computeDistance(d1);
+
+    EXPECT_NEAR((d1[0] - d0[0])/h, J.row(0).dot(dq), 1e-4);
+    // gradient is interpolated from finite differences on the grid
+    EXPECT_NEAR((d1[1] - d0[1])/h, J.row(1).dot(dq), 1e-2*dq.norm());
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
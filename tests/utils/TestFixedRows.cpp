@@ -0,0 +1,86 @@
+#include <OpenSoT/utils/FixedRows.h>
+#include <gtest/gtest.h>
+
+namespace{
+
+class testFixedRows: public ::testing::TestWithParam<int>
+{
+protected:
+
+    testFixedRows()
+    {
+
+    }
+
+    virtual ~testFixedRows() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+TEST_P(testFixedRows, checkKernels)
+{
+    const int rows = GetParam();
+    const int ncols = 30;
+
+    Eigen::MatrixXd A(rows, ncols);
+    A.setRandom();
+    Eigen::VectorXd b(rows);
+    b.setRandom();
+
+    Eigen::MatrixXd W(rows, rows);
+    W.setRandom();
+    W = W*W.transpose() + Eigen::MatrixXd::Identity(rows, rows);
+
+    Eigen::MatrixXd H, WA;
+    Eigen::VectorXd g;
+
+    OpenSoT::utils::hessian(A, H);
+    EXPECT_TRUE(H.isApprox(A.transpose()*A, 1e-12));
+
+    OpenSoT::utils::gradient(A, b, g);
+    EXPECT_TRUE(g.isApprox(-A.transpose()*b, 1e-12));
+
+    OpenSoT::utils::weight(A, W, false, WA);
+    EXPECT_TRUE(WA.isApprox(W*A, 1e-12));
+
+    OpenSoT::utils::hessian(A, WA, H);
+    EXPECT_TRUE(H.isApprox(A.transpose()*W*A, 1e-12));
+
+    OpenSoT::utils::gradient(WA, b, g);
+    EXPECT_TRUE(g.isApprox(-A.transpose()*W*b, 1e-12));
+
+    OpenSoT::utils::weight(A, W, true, WA);
+    EXPECT_TRUE(WA.isApprox(W.diagonal().asDiagonal()*A, 1e-12));
+
+    // blocks are used in place
+    Eigen::MatrixXd Abig(rows + 4, ncols);
+    Abig.setRandom();
+    Eigen::VectorXd bbig(rows + 4);
+    bbig.setRandom();
+
+    OpenSoT::utils::weight(Abig.middleRows(2, rows), W, false, WA);
+    OpenSoT::utils::hessian(Abig.middleRows(2, rows), WA, H);
+    OpenSoT::utils::gradient(WA, bbig.segment(2, rows), g);
+
+    Eigen::MatrixXd Ablock = Abig.middleRows(2, rows);
+    EXPECT_TRUE(H.isApprox(Ablock.transpose()*W*Ablock, 1e-12));
+    EXPECT_TRUE(g.isApprox(-Ablock.transpose()*W*bbig.segment(2, rows), 1e-12));
+}
+
+INSTANTIATE_TEST_CASE_P(Rows, testFixedRows, ::testing::Values(3, 6, 5));
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,271 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/utils/FlightRecorder.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <fstream>
+#include <iterator>
+
+namespace{
+
+class testFlightRecorder: public ::testing::Test{
+public:
+    typedef OpenSoT::utils::FlightRecorder FlightRecorder;
+
+    /**
+     * @brief read returns the samples of a channel in the recording, from the oldest to the newest
+     */
+    static std::vector<Eigen::MatrixXd> read(const std::string& file_name, const std::string& channel_name,
+                                             std::vector<double>& time)
+    {
+        std::ifstream file(file_name, std::ios::binary);
+        std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        const FlightRecorder::FileHeader* header = reinterpret_cast<const FlightRecorder::FileHeader*>(data.data());
+        const FlightRecorder::ChannelHeader* channels =
+                reinterpret_cast<const FlightRecorder::ChannelHeader*>(data.data() + sizeof(FlightRecorder::FileHeader));
+
+        std::vector<Eigen::MatrixXd> samples;
+        time.clear();
+        for(unsigned int i = 0; i < header->channels; ++i)
+        {
+            if(channel_name != channels[i].name)
+                continue;
+
+            const std::size_t slot_size = 3 + channels[i].rows*channels[i].cols;
+            const std::uint64_t n = std::min<std::uint64_t>(channels[i].count, channels[i].samples);
+            for(std::uint64_t k = channels[i].count - n; k < channels[i].count; ++k)
+            {
+                const double* slot = reinterpret_cast<const double*>(data.data() + channels[i].offset) +
+                        (k % channels[i].samples)*slot_size;
+                time.push_back(slot[0]);
+                samples.push_back(Eigen::Map<const Eigen::MatrixXd>(slot + 3, int(slot[1]), int(slot[2])));
+            }
+        }
+        return samples;
+    }
+};
+
+TEST_F(testFlightRecorder, testChannels)
+{
+    FlightRecorder recorder("/tmp/testFlightRecorderChannels.bin", 10);
+
+    EXPECT_EQ(recorder.addChannel("a", 3, 2), 0);
+    EXPECT_EQ(recorder.addChannel("b", Eigen::VectorXd::Zero(4), 2), 1);
+    EXPECT_EQ(recorder.addChannel("c", Eigen::VectorXd(0)), -1);
+    EXPECT_EQ(recorder.addChannel("a", 3, 2), -1);
+    EXPECT_EQ(recorder.addChannel("d", 0, 2), -1);
+    EXPECT_EQ(recorder.addChannel("e", 1, 1, 0), -1);
+    EXPECT_EQ(recorder.addChannel(std::string(64, 'f'), 1, 1), -1);
+
+    EXPECT_EQ(recorder.getChannel("a"), 0);
+    EXPECT_EQ(recorder.getChannel("b"), 1);
+    EXPECT_EQ(recorder.getChannel("c"), -1);
+
+    // not started
+    EXPECT_FALSE(recorder.log(0, Eigen::MatrixXd::Zero(3, 2)));
+
+    EXPECT_TRUE(recorder.start());
+    EXPECT_TRUE(recorder.isStarted());
+    EXPECT_EQ(recorder.addChannel("g", 1, 1), -1);
+
+    // too big
+    EXPECT_FALSE(recorder.log(0, Eigen::MatrixXd::Zero(4, 2)));
+    EXPECT_EQ(recorder.getDroppedSamples(), 1);
+
+    recorder.stop();
+    EXPECT_FALSE(recorder.isStarted());
+}
+
+TEST_F(testFlightRecorder, testLog)
+{
+    const std::string file_name = "/tmp/testFlightRecorderLog.bin";
+    const unsigned int samples = 20;
+
+    // the queue wraps around during the test
+    FlightRecorder recorder(file_name, samples, 1 << 11, std::chrono::microseconds(100));
+    int a = recorder.addChannel("a", 3, 2);
+    int b = recorder.addChannel("b", 4, 1, 3);
+    int c = recorder.addChannel("c", 1, 1, 1, 5);
+    EXPECT_TRUE(recorder.start());
+
+    std::vector<Eigen::MatrixXd> as, bs;
+    const int N = 100;
+    for(int k = 0; k < N; ++k)
+    {
+        Eigen::MatrixXd A = Eigen::MatrixXd::Random(3, 2);
+        // variable size samples
+        if(k % 2)
+            A.conservativeResize(2, 2);
+        Eigen::VectorXd B = Eigen::VectorXd::Constant(4, k);
+
+        EXPECT_TRUE(recorder.log(a, A));
+        EXPECT_TRUE(recorder.log(b, B));
+        EXPECT_TRUE(recorder.log(c, double(k)));
+
+        as.push_back(A);
+        if(k % 3 == 0)
+            bs.push_back(B);
+
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+    }
+
+    recorder.stop();
+    EXPECT_EQ(recorder.getDroppedSamples(), 0);
+
+    std::vector<double> time;
+    std::vector<Eigen::MatrixXd> logged = read(file_name, "a", time);
+    EXPECT_EQ(logged.size(), samples);
+    for(unsigned int k = 0; k < samples; ++k)
+    {
+        EXPECT_TRUE(logged[k] == as[N - samples + k]);
+        if(k > 0)
+        {
+            EXPECT_GE(time[k], time[k-1]);
+        }
+    }
+
+    // decimation
+    logged = read(file_name, "b", time);
+    EXPECT_EQ(logged.size(), samples);
+    for(unsigned int k = 0; k < samples; ++k)
+        EXPECT_TRUE(logged[k] == bs[bs.size() - samples + k]);
+
+    // per channel number of samples
+    logged = read(file_name, "c", time);
+    EXPECT_EQ(logged.size(), 5);
+    for(unsigned int k = 0; k < 5; ++k)
+        EXPECT_EQ(logged[k](0,0), N - 5 + k);
+}
+
+TEST_F(testFlightRecorder, testQueueFull)
+{
+    const std::string file_name = "/tmp/testFlightRecorderQueueFull.bin";
+
+    // the background thread does not run while logging: 10 doubles per sample, 7 samples in the queue
+    FlightRecorder recorder(file_name, 100, 75, std::chrono::seconds(10));
+    int a = recorder.addChannel("a", 3, 2);
+    EXPECT_TRUE(recorder.start());
+
+    int logged = 0;
+    for(int k = 0; k < 20; ++k)
+        logged += recorder.log(a, Eigen::MatrixXd::Constant(3, 2, k));
+
+    EXPECT_EQ(logged, 7);
+    EXPECT_EQ(recorder.getDroppedSamples(), 13);
+
+    recorder.stop();
+
+    std::vector<double> time;
+    std::vector<Eigen::MatrixXd> samples = read(file_name, "a", time);
+    EXPECT_EQ(samples.size(), 7);
+    for(unsigned int k = 0; k < samples.size(); ++k)
+        EXPECT_TRUE(samples[k] == Eigen::MatrixXd::Constant(3, 2, k));
+}
+
+TEST_F(testFlightRecorder, testTask)
+{
+    const std::string file_name = "/tmp/testFlightRecorderTask.bin";
+
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(4, 6);
+    Eigen::VectorXd b = Eigen::VectorXd::Random(4);
+    OpenSoT::tasks::GenericTask::Ptr task = std::make_shared<OpenSoT::tasks::GenericTask>("task", A, b);
+
+    auto recorder = std::make_shared<FlightRecorder>(file_name, 10);
+    task->setFlightRecorder(recorder);
+    EXPECT_GE(recorder->getChannel("task_A"), 0);
+    EXPECT_GE(recorder->getChannel("task_b"), 0);
+    EXPECT_GE(recorder->getChannel("task_W"), 0);
+    EXPECT_GE(recorder->getChannel("task_lambda"), 0);
+
+    EXPECT_TRUE(recorder->start());
+    task->update();
+    task->record();
+    recorder->stop();
+
+    std::vector<double> time;
+    std::vector<Eigen::MatrixXd> samples = read(file_name, "task_A", time);
+    EXPECT_EQ(samples.size(), 1);
+    EXPECT_TRUE(samples[0] == task->getA());
+
+    samples = read(file_name, "task_b", time);
+    EXPECT_EQ(samples.size(), 1);
+    EXPECT_TRUE(samples[0] == task->getb());
+}
+
+TEST_F(testFlightRecorder, testSharedConstraint)
+{
+    const std::string file_name = "/tmp/testFlightRecorderSharedConstraint.bin";
+
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", Eigen::MatrixXd::Random(4, 6), Eigen::VectorXd::Random(4));
+    auto task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", Eigen::MatrixXd::Random(3, 6), Eigen::VectorXd::Random(3));
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", Eigen::VectorXd::Ones(6),
+                                                                            -Eigen::VectorXd::Ones(6), 6);
+    task1->getConstraints().push_back(bounds);
+    task2->getConstraints().push_back(bounds);
+
+    // the shared constraint is registered once, also by a task registered twice
+    auto recorder = std::make_shared<FlightRecorder>(file_name, 10);
+    EXPECT_TRUE(task1->setFlightRecorder(recorder));
+    EXPECT_TRUE(task2->setFlightRecorder(recorder));
+    EXPECT_FALSE(task2->setFlightRecorder(recorder));
+    EXPECT_FALSE(bounds->setFlightRecorder(recorder));
+    EXPECT_GE(recorder->getChannel("bounds_upperBound"), 0);
+
+    EXPECT_TRUE(recorder->start());
+    const int cycles = 3;
+    for(int k = 0; k < cycles; ++k)
+    {
+        task1->update();
+        task2->update();
+        task1->record();
+        task2->record();
+    }
+    recorder->stop();
+    EXPECT_EQ(recorder->getDroppedSamples(), 0);
+
+    // one sample per cycle
+    std::vector<double> time;
+    std::vector<Eigen::MatrixXd> samples = read(file_name, "bounds_upperBound", time);
+    ASSERT_EQ(samples.size(), cycles);
+    EXPECT_TRUE(samples[0] == Eigen::VectorXd::Ones(6));
+
+    samples = read(file_name, "task2_A", time);
+    ASSERT_EQ(samples.size(), cycles);
+    EXPECT_TRUE(samples[0] == task2->getA());
+}
+
+TEST_F(testFlightRecorder, testRestart)
+{
+    const std::string file_name = "/tmp/testFlightRecorderRestart.bin";
+
+    FlightRecorder recorder(file_name, 10);
+    int a = recorder.addChannel("a", 1, 1, 3);
+    EXPECT_FALSE(recorder.isStarted());
+
+    // the decimation restarts with the recorder
+    EXPECT_TRUE(recorder.start());
+    EXPECT_TRUE(recorder.isStarted());
+    recorder.log(a, 0.);
+    recorder.log(a, 1.);
+    recorder.stop();
+    EXPECT_FALSE(recorder.isStarted());
+
+    EXPECT_TRUE(recorder.start());
+    for(int k = 0; k < 7; ++k)
+        recorder.log(a, double(k));
+    recorder.stop();
+
+    std::vector<double> time;
+    std::vector<Eigen::MatrixXd> samples = read(file_name, "a", time);
+    ASSERT_EQ(samples.size(), 3);
+    EXPECT_EQ(samples[0](0,0), 0.);
+    EXPECT_EQ(samples[1](0,0), 3.);
+    EXPECT_EQ(samples[2](0,0), 6.);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/utils/Rollout.h>
+#include <OpenSoT/tasks/velocity/Cartesian.h>
+#include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/solvers/iHQP.h>
+
+#include "../common.h"
+
+namespace{
+
+class testRollout: public TestBase
+{
+protected:
+
+    testRollout(): TestBase("coman")
+    {
+        _q = _model_ptr->getNeutralQ();
+        _q[_model_ptr->getDofIndex("LShSag")] =  20.0*M_PI/180.0;
+        _q[_model_ptr->getDofIndex("LElbj")] = -80.0*M_PI/180.0;
+        _q[_model_ptr->getDofIndex("RShSag")] =  20.0*M_PI/180.0;
+        _q[_model_ptr->getDofIndex("RElbj")] = -80.0*M_PI/180.0;
+
+        _model_ptr->setJointPosition(_q);
+        _model_ptr->update();
+
+        _l_wrist = std::make_shared<OpenSoT::tasks::velocity::Cartesian>("l_wrist", *_model_ptr, "l_wrist", "Waist");
+        _postural = std::make_shared<OpenSoT::tasks::velocity::Postural>(*_model_ptr);
+
+        Eigen::VectorXd qmin, qmax;
+        _model_ptr->getJointLimits(qmin, qmax);
+        auto joint_limits = std::make_shared<OpenSoT::constraints::velocity::JointLimits>(*_model_ptr, qmax, qmin);
+
+        _stack = (_l_wrist / _postural) << joint_limits;
+        _stack->update();
+
+        _solver = std::make_shared<OpenSoT::solvers::iHQP>(_stack->getStack(), _stack->getBounds(), 1e6);
+    }
+
+    Eigen::VectorXd _q;
+    OpenSoT::tasks::velocity::Cartesian::Ptr _l_wrist;
+    OpenSoT::tasks::velocity::Postural::Ptr _postural;
+    OpenSoT::AutoStack::Ptr _stack;
+    OpenSoT::solvers::iHQP::Ptr _solver;
+};
+
+TEST_F(testRollout, testReferences)
+{
+    OpenSoT::utils::Rollout rollout(*_model_ptr, _stack, _solver, OpenSoT::utils::Rollout::Integration::DISPLACEMENT, 0.01);
+
+    EXPECT_TRUE(rollout.setReference(_l_wrist, Eigen::MatrixXd::Zero(1, 7)));
+    EXPECT_TRUE(rollout.setReference("l_wrist", Eigen::MatrixXd::Zero(10, 7)));
+    EXPECT_TRUE(rollout.setReference(_postural, Eigen::MatrixXd::Zero(1, _model_ptr->getNq())));
+    EXPECT_FALSE(rollout.setReference(_l_wrist, Eigen::MatrixXd::Zero(1, 3)));
+    EXPECT_FALSE(rollout.setReference(_postural, Eigen::MatrixXd::Zero(0, _model_ptr->getNq())));
+    EXPECT_FALSE(rollout.setReference("unknown", Eigen::MatrixXd::Zero(1, 7)));
+
+    // a subtask is resolved to the original task
+    std::list<unsigned int> position = {0, 1, 2};
+    EXPECT_TRUE(rollout.setReference(_l_wrist%position, Eigen::MatrixXd::Zero(1, 7)));
+
+    OpenSoT::utils::Rollout::Result result;
+    EXPECT_FALSE(rollout.run(_q, Eigen::VectorXd(), 20, result));
+    EXPECT_FALSE(rollout.run(Eigen::VectorXd::Zero(3), Eigen::VectorXd(), 5, result));
+}
+
+TEST_F(testRollout, testRun)
+{
+    Eigen::Affine3d pose;
+    _l_wrist->getActualPose(pose);
+
+    const int steps = 300;
+    Eigen::MatrixXd trajectory(steps, 7);
+    Eigen::Quaterniond orientation(pose.linear());
+    for(int k = 0; k < steps; ++k)
+    {
+        const double s = std::min(1., 2.*k/steps);
+        trajectory.row(k) << pose.translation().transpose() + s*Eigen::RowVector3d(0.1, 0., 0.1),
+                orientation.x(), orientation.y(), orientation.z(), orientation.w();
+    }
+
+    OpenSoT::utils::Rollout rollout(*_model_ptr, _stack, _solver, OpenSoT::utils::Rollout::Integration::DISPLACEMENT, 0.01);
+    EXPECT_TRUE(rollout.setReference(_l_wrist, trajectory));
+    EXPECT_TRUE(rollout.setReference(_postural, _q.transpose()));
+
+    OpenSoT::utils::Rollout::Result result;
+    EXPECT_TRUE(rollout.run(_q, Eigen::VectorXd(), steps, result));
+
+    EXPECT_EQ(result.q.rows(), steps + 1);
+    EXPECT_EQ(result.q.cols(), _model_ptr->getNq());
+    EXPECT_EQ(result.qdot.rows(), steps + 1);
+    EXPECT_EQ(result.solutions.rows(), steps);
+    EXPECT_EQ(result.solutions.cols(), _model_ptr->getNv());
+    EXPECT_EQ(result.success.size(), steps);
+    EXPECT_EQ(result.success.sum(), steps);
+    EXPECT_TRUE(result.q.row(0).transpose() == _q);
+
+    // the same loop written by hand
+    Eigen::VectorXd q = _q, dq;
+    for(int k = 0; k < steps; ++k)
+    {
+        _model_ptr->setJointPosition(q);
+        _model_ptr->update();
+
+        Eigen::Affine3d ref;
+        ref.translation() = trajectory.row(k).head<3>().transpose();
+        ref.linear() = orientation.toRotationMatrix();
+        _l_wrist->setReference(ref);
+        _postural->setReference(_q);
+
+        _stack->update();
+        EXPECT_TRUE(_solver->solve(dq));
+        EXPECT_NEAR((dq - result.solutions.row(k).transpose()).norm(), 0., 1e-6);
+
+        q = _model_ptr->sum(q, dq);
+    }
+    EXPECT_NEAR((q - result.q.row(steps).transpose()).norm(), 0., 1e-6);
+
+    // the reference is reached
+    _model_ptr->setJointPosition(result.q.row(steps).transpose());
+    _model_ptr->update();
+    _l_wrist->update();
+    Eigen::Affine3d final_pose;
+    _l_wrist->getActualPose(final_pose);
+    EXPECT_NEAR((final_pose.translation() - trajectory.row(steps-1).head<3>().transpose()).norm(), 0., 1e-3);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/utils/RtLogger.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace{
+
+class testRtLogger: public ::testing::Test{
+public:
+    typedef OpenSoT::utils::RtLogger RtLogger;
+
+    virtual void SetUp()
+    {
+        RtLogger::setOnPrintCallback([this](const char* msg, RtLogger::Level level){
+            std::lock_guard<std::mutex> lock(mutex);
+            messages.push_back(msg);
+            levels.push_back(level);
+        });
+    }
+
+    virtual void TearDown()
+    {
+        RtLogger::setRtMode(false);
+        RtLogger::setOnPrintCallback(RtLogger::OnPrintCallback());
+    }
+
+    template <typename... Args>
+    static std::string format(const char* fmt, const Args&... args)
+    {
+        RtLogger::setRtMode(false);
+        std::vector<std::string> out;
+        RtLogger::setOnPrintCallback([&out](const char* msg, RtLogger::Level){ out.push_back(msg); });
+        RtLogger::info(fmt, args...);
+        return out.at(0);
+    }
+
+    std::mutex mutex;
+    std::vector<std::string> messages;
+    std::vector<RtLogger::Level> levels;
+};
+
+TEST_F(testRtLogger, testFormat)
+{
+    char expected[256];
+
+    std::snprintf(expected, 256, "A rows: %i \n", 12);
+    EXPECT_EQ(format("A rows: %i \n", long(12)), expected);
+
+    std::snprintf(expected, 256, "%d %5.2f %s %lu %x %% %c %e", -3, 3.14159, "abc", 42ul, 255u, 'z', 1e-7);
+    EXPECT_EQ(format("%d %5.2f %s %lu %x %% %c %e", -3, 3.14159, "abc", 42ul, 255u, 'z', 1e-7), expected);
+
+    std::string id = "task_id";
+    std::snprintf(expected, 256, "%s: weight is not block diagonal", id.c_str());
+    EXPECT_EQ(format("%s: weight is not block diagonal", id), expected);
+
+    // integers printed as floating point and vice-versa are converted
+    EXPECT_EQ(format("%f", 2), "2.000000");
+    EXPECT_EQ(format("%i", 2.7), "2");
+
+    // missing arguments
+    EXPECT_EQ(format("%i %i", 1), "1 %i");
+
+    // truncated strings
+    std::string long_string(1000, 'a');
+    EXPECT_EQ(format("%s", long_string).size(), RtLogger::STRING_STORAGE - 1);
+}
+
+TEST_F(testRtLogger, testSynchronous)
+{
+    EXPECT_FALSE(RtLogger::isRtMode());
+
+    RtLogger::error("error %i \n", 1);
+    RtLogger::warning("warning %i \n", 2);
+
+    ASSERT_EQ(messages.size(), 2);
+    EXPECT_EQ(messages[0], "error 1 \n");
+    EXPECT_EQ(levels[0], RtLogger::Level::ERROR);
+    EXPECT_EQ(messages[1], "warning 2 \n");
+    EXPECT_EQ(levels[1], RtLogger::Level::WARNING);
+}
+
+TEST_F(testRtLogger, testRtMode)
+{
+    RtLogger::setRtMode(true);
+    EXPECT_TRUE(RtLogger::isRtMode());
+
+    EXPECT_TRUE(RtLogger::registerThread());
+
+    const std::uint64_t dropped = RtLogger::getDroppedMessages();
+
+    const int N = 50;
+    for(int i = 0; i < N; ++i)
+        RtLogger::info("message %i from %s \n", i, "main");
+
+    std::thread other([](){
+        EXPECT_TRUE(RtLogger::registerThread());
+        RtLogger::success("message from %s \n", "other");
+    });
+    other.join();
+
+    RtLogger::flush();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(RtLogger::getDroppedMessages(), dropped);
+    ASSERT_EQ(messages.size(), N + 1);
+
+    int main_messages = 0;
+    for(unsigned int i = 0; i < messages.size(); ++i)
+    {
+        if(levels[i] == RtLogger::Level::SUCCESS)
+        {
+            EXPECT_EQ(messages[i], "message from other \n");
+        }
+        else
+        {
+            EXPECT_EQ(messages[i], "message " + std::to_string(main_messages) + " from main \n");
+            main_messages++;
+        }
+    }
+}
+
+TEST_F(testRtLogger, testDroppedMessages)
+{
+    std::atomic<bool> release(false);
+    std::atomic<int> printed(0);
+    RtLogger::setOnPrintCallback([&](const char*, RtLogger::Level){
+        while(!release)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        printed++;
+    });
+
+    RtLogger::setRtMode(true);
+
+    const std::uint64_t dropped = RtLogger::getDroppedMessages();
+
+    // the background thread is blocked by the first message: the queue gets full
+    const int N = 1000;
+    for(int i = 0; i < N; ++i)
+        RtLogger::error("message %i \n", i);
+
+    EXPECT_GT(RtLogger::getDroppedMessages() - dropped, 0);
+
+    release = true;
+    RtLogger::flush();
+
+    EXPECT_EQ(printed + RtLogger::getDroppedMessages() - dropped, N);
+
+    // messages queued when the real-time mode is disabled are printed
+    release = false;
+    RtLogger::info("last message \n");
+    release = true;
+    RtLogger::setRtMode(false);
+    EXPECT_EQ(printed + RtLogger::getDroppedMessages() - dropped, N + 1);
+}
+
+TEST_F(testRtLogger, testThreadQueuesReuse)
+{
+    RtLogger::setRtMode(true);
+
+    const std::uint64_t dropped = RtLogger::getDroppedMessages();
+
+    // more threads than the maximum number of queues, one after the other
+    const int N = 200;
+    for(int i = 0; i < N; ++i)
+    {
+        std::thread t([i](){ RtLogger::info("thread %i \n", i); });
+        t.join();
+    }
+
+    RtLogger::flush();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    EXPECT_EQ(RtLogger::getDroppedMessages(), dropped);
+    EXPECT_EQ(messages.size(), N);
+}
+
+TEST_F(testRtLogger, testExitInRtMode)
+{
+    // the queued messages are printed and the background thread is joined
+    EXPECT_EXIT({
+        RtLogger::setOnPrintCallback([](const char* msg, RtLogger::Level){ std::fprintf(stderr, "%s", msg); });
+        RtLogger::setRtMode(true);
+        RtLogger::info("exit %i \n", 1);
+        std::exit(0);
+    }, ::testing::ExitedWithCode(0), "exit 1");
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}